@@ -25,6 +25,7 @@
 #include "nimble/nimble_opt.h"
 #include "log/log.h"
 #include "os/queue.h"
+#include "os/os_time.h"
 
 #include "host/ble_gatt.h"
 #include "host/ble_gap.h"
@@ -73,6 +74,15 @@ SLIST_HEAD(btshell_svc_list, btshell_svc);
 struct btshell_l2cap_coc {
     SLIST_ENTRY(btshell_l2cap_coc) next;
     struct ble_l2cap_chan *chan;
+
+    /* Throughput test counters; see l2cap-send and gatt-show-coc. */
+    uint16_t tx_sdu_len;
+    uint16_t tx_sdu_left;
+    uint32_t tx_bytes;
+    os_time_t tx_start;
+    uint32_t rx_bytes;
+    os_time_t rx_start;
+    os_time_t rx_last;
 };
 
 SLIST_HEAD(btshell_l2cap_coc_list, btshell_l2cap_coc);
@@ -153,10 +163,11 @@ int btshell_sec_restart(uint16_t conn_handle, uint8_t *ltk, uint16_t ediv,
 int btshell_tx_start(uint16_t handle, uint16_t len, uint16_t rate,
                      uint16_t num);
 int btshell_rssi(uint16_t conn_handle, int8_t *out_rssi);
-int btshell_l2cap_create_srv(uint16_t psm);
-int btshell_l2cap_connect(uint16_t conn, uint16_t psm);
+int btshell_l2cap_create_srv(uint16_t psm, int stream);
+int btshell_l2cap_connect(uint16_t conn, uint16_t psm, int stream);
 int btshell_l2cap_disconnect(uint16_t conn, uint16_t idx);
-int btshell_l2cap_send(uint16_t conn, uint16_t idx, uint16_t bytes);
+int btshell_l2cap_send(uint16_t conn, uint16_t idx, uint16_t bytes,
+                       uint16_t count);
 #define BTSHELL_LOG_MODULE  (LOG_MODULE_PERUSER + 0)
 #define BTSHELL_LOG(lvl, ...) \
     LOG_ ## lvl(&btshell_log, BTSHELL_LOG_MODULE, __VA_ARGS__)
@@ -2645,6 +2645,7 @@ static const struct shell_cmd_help l2cap_update_help = {
 
 static const struct shell_param l2cap_create_server_params[] = {
     {"psm", "usage: =<UINT16>"},
+    {"stream", "deliver data as it arrives, usage: =[0-1], default=0"},
     {NULL, NULL}
 };
 
@@ -2661,6 +2662,7 @@ static const struct shell_cmd_help l2cap_create_server_help = {
 static const struct shell_param l2cap_connect_params[] = {
     {"conn", "connection handle, usage: =<UINT16>"},
     {"psm", "usage: =<UINT16>"},
+    {"stream", "deliver data as it arrives, usage: =[0-1], default=0"},
     {NULL, NULL}
 };
 
@@ -2694,6 +2696,8 @@ static const struct shell_param l2cap_send_params[] = {
     {"conn", "connection handle, usage: =<UINT16>"},
     {"idx", "usage: =<UINT16>"},
     {"bytes", "number of bytes to send, usage: =<UINT16>"},
+    {"count", "number of SDUs to send back to back, usage: =<UINT16>, "
+              "default=1"},
     {NULL, NULL}
 };
 
@@ -480,6 +480,7 @@ cmd_gatt_show_coc(int argc, char **argv)
 {
     struct btshell_conn *conn = NULL;
     struct btshell_l2cap_coc *coc;
+    uint32_t ms;
     int i, j;
 
     for (i = 0; i < btshell_num_conns; i++) {
@@ -496,6 +497,16 @@ cmd_gatt_show_coc(int argc, char **argv)
         j = 0;
         SLIST_FOREACH(coc, &conn->coc_list, next) {
             console_printf("    idx: %i, chan pointer = %p\n", j++, coc->chan);
+
+            ms = (coc->rx_last - coc->rx_start) * 1000 / OS_TICKS_PER_SEC;
+            console_printf("        rx: %lu bytes in %lu ms",
+                           (unsigned long)coc->rx_bytes, (unsigned long)ms);
+            if (ms != 0) {
+                console_printf(", %lu bytes/s",
+                               (unsigned long)((uint64_t)coc->rx_bytes * 1000 /
+                                               ms));
+            }
+            console_printf("; tx: %lu bytes\n", (unsigned long)coc->tx_bytes);
         }
     }
 
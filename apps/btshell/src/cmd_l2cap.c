@@ -95,6 +95,7 @@ int
 cmd_l2cap_create_server(int argc, char **argv)
 {
     uint16_t psm = 0;
+    uint8_t stream;
     int rc;
 
     rc = parse_arg_all(argc - 1, argv + 1);
@@ -108,7 +109,13 @@ cmd_l2cap_create_server(int argc, char **argv)
         return rc;
     }
 
-    rc = btshell_l2cap_create_srv(psm);
+    stream = parse_arg_bool_dflt("stream", 0, &rc);
+    if (rc != 0) {
+        console_printf("invalid 'stream' parameter\n");
+        return rc;
+    }
+
+    rc = btshell_l2cap_create_srv(psm, stream);
     if (rc) {
         console_printf("Server create error: 0x%02x", rc);
     }
@@ -125,6 +132,7 @@ cmd_l2cap_connect(int argc, char **argv)
 {
     uint16_t conn = 0;
     uint16_t psm = 0;
+    uint8_t stream;
     int rc;
 
     rc = parse_arg_all(argc - 1, argv + 1);
@@ -144,7 +152,13 @@ cmd_l2cap_connect(int argc, char **argv)
         return rc;
     }
 
-    return btshell_l2cap_connect(conn, psm);
+    stream = parse_arg_bool_dflt("stream", 0, &rc);
+    if (rc != 0) {
+        console_printf("invalid 'stream' parameter\n");
+        return rc;
+    }
+
+    return btshell_l2cap_connect(conn, psm, stream);
 }
 
 /*****************************************************************************
@@ -188,6 +202,7 @@ cmd_l2cap_send(int argc, char **argv)
     uint16_t conn;
     uint16_t idx;
     uint16_t bytes;
+    uint16_t count;
     int rc;
 
     rc = parse_arg_all(argc - 1, argv + 1);
@@ -213,5 +228,11 @@ cmd_l2cap_send(int argc, char **argv)
        return rc;
     }
 
-    return btshell_l2cap_send(conn, idx, bytes);
+    count = parse_arg_uint16_dflt("count", 1, &rc);
+    if (rc != 0) {
+       console_printf("invalid 'count' parameter\n");
+       return rc;
+    }
+
+    return btshell_l2cap_send(conn, idx, bytes, count);
 }
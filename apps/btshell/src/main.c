@@ -70,7 +70,8 @@
 #if MYNEWT_VAL(BLE_L2CAP_COC_MAX_NUM)
 #define BTSHELL_COC_MTU               (256)
 /* We use same pool for incoming and outgoing sdu */
-#define BTSHELL_COC_BUF_COUNT         (3 * MYNEWT_VAL(BLE_L2CAP_COC_MAX_NUM))
+#define BTSHELL_COC_BUF_COUNT         (3 * MYNEWT_VAL(BLE_L2CAP_COC_MAX_NUM) * \
+                                       MYNEWT_VAL(BLE_L2CAP_COC_TX_SDU_MAX))
 #endif
 
 struct log btshell_log;
@@ -1739,6 +1740,7 @@ btshell_l2cap_coc_add(uint16_t conn_handle, struct ble_l2cap_chan *chan)
         return ENOMEM;
     }
 
+    memset(coc, 0, sizeof(*coc));
     coc->chan = chan;
 
     prev = NULL;
@@ -1755,38 +1757,67 @@ btshell_l2cap_coc_add(uint16_t conn_handle, struct ble_l2cap_chan *chan)
     return 0;
 }
 
-static void
-btshell_l2cap_coc_remove(uint16_t conn_handle, struct ble_l2cap_chan *chan)
+static struct btshell_l2cap_coc *
+btshell_l2cap_coc_find(uint16_t conn_handle, struct ble_l2cap_chan *chan)
 {
     struct btshell_conn *conn;
-    struct btshell_l2cap_coc *coc;
     struct btshell_l2cap_coc *cur;
 
     conn = btshell_conn_find(conn_handle);
     assert(conn != NULL);
 
-    coc = NULL;
     SLIST_FOREACH(cur, &conn->coc_list, next) {
         if (cur->chan == chan) {
-            coc = cur;
-            break;
+            return cur;
         }
     }
 
+    return NULL;
+}
+
+static void
+btshell_l2cap_coc_remove(uint16_t conn_handle, struct ble_l2cap_chan *chan)
+{
+    struct btshell_conn *conn;
+    struct btshell_l2cap_coc *coc;
+
+    coc = btshell_l2cap_coc_find(conn_handle, chan);
     if (!coc) {
         return;
     }
 
+    conn = btshell_conn_find(conn_handle);
     SLIST_REMOVE(&conn->coc_list, coc, btshell_l2cap_coc, next);
     os_memblock_put(&btshell_coc_conn_pool, coc);
 }
 
 static void
-btshell_l2cap_coc_recv(struct ble_l2cap_chan *chan, struct os_mbuf *sdu)
+btshell_l2cap_coc_rx_count(uint16_t conn_handle, struct ble_l2cap_chan *chan,
+                           uint16_t len)
+{
+    struct btshell_l2cap_coc *coc;
+
+    coc = btshell_l2cap_coc_find(conn_handle, chan);
+    if (!coc) {
+        return;
+    }
+
+    coc->rx_last = os_time_get();
+    if (coc->rx_bytes == 0) {
+        coc->rx_start = coc->rx_last;
+    }
+    coc->rx_bytes += len;
+}
+
+static void
+btshell_l2cap_coc_recv(uint16_t conn_handle, struct ble_l2cap_chan *chan,
+                       struct os_mbuf *sdu)
 {
     console_printf("LE CoC SDU received, chan: 0x%08lx, data len %d\n",
                    (uint32_t) chan, OS_MBUF_PKTLEN(sdu));
 
+    btshell_l2cap_coc_rx_count(conn_handle, chan, OS_MBUF_PKTLEN(sdu));
+
     os_mbuf_free_chain(sdu);
     sdu = os_mbuf_get_pkthdr(&sdu_os_mbuf_pool, 0);
     assert(sdu != NULL);
@@ -1794,6 +1825,114 @@ btshell_l2cap_coc_recv(struct ble_l2cap_chan *chan, struct os_mbuf *sdu)
     ble_l2cap_recv_ready(chan, sdu);
 }
 
+static void
+btshell_l2cap_coc_recv_frag(uint16_t conn_handle, struct ble_l2cap_chan *chan,
+                            struct os_mbuf *om, uint16_t sdu_len,
+                            uint16_t sdu_off)
+{
+    uint16_t len;
+
+    len = OS_MBUF_PKTLEN(om);
+    btshell_l2cap_coc_rx_count(conn_handle, chan, len);
+
+    if (sdu_off + len == sdu_len) {
+        console_printf("LE CoC SDU streamed, chan: 0x%08lx, data len %d\n",
+                       (uint32_t) chan, sdu_len);
+    }
+
+    os_mbuf_free_chain(om);
+
+    /* Data is consumed; let the host give credits back to the peer */
+    ble_l2cap_recv_ready(chan, NULL);
+}
+
+static struct os_mbuf *
+btshell_l2cap_sdu_alloc(uint16_t bytes)
+{
+    struct os_mbuf *sdu_tx;
+    uint8_t b[] = {0x00, 0x11,0x22,0x33,0x44,0x55,0x66,0x77,0x88, 0x99};
+    int i;
+    int rc;
+
+    sdu_tx = os_mbuf_get_pkthdr(&sdu_os_mbuf_pool, 0);
+    if (sdu_tx == NULL) {
+        console_printf("No memory in the test sdu pool\n");
+        return NULL;
+    }
+
+    /* For the testing purpose we fill up buffer with known data, easy
+     * to validate on other side. In this loop we add as many full chunks as we
+     * can
+     */
+    for (i = 0; i < bytes / sizeof(b); i++) {
+        rc = os_mbuf_append(sdu_tx, b, sizeof(b));
+        if (rc) {
+            console_printf("Cannot append data %i !\n", i);
+            os_mbuf_free_chain(sdu_tx);
+            return NULL;
+        }
+    }
+
+    /* Here we add the rest < sizeof(b) */
+    rc = os_mbuf_append(sdu_tx, b, bytes - (sizeof(b) * i));
+    if (rc) {
+        console_printf("Cannot append data %i !\n", i);
+        os_mbuf_free_chain(sdu_tx);
+        return NULL;
+    }
+
+    return sdu_tx;
+}
+
+/**
+ * Sends as many of the remaining SDUs of an l2cap-send run as the host
+ * accepts.  The rest is sent on BLE_L2CAP_EVENT_COC_TX_UNSTALLED.
+ */
+static int
+btshell_l2cap_coc_tx(struct btshell_l2cap_coc *coc)
+{
+    struct os_mbuf *sdu_tx;
+    uint32_t ms;
+    int rc;
+
+    while (coc->tx_sdu_left > 0) {
+        sdu_tx = btshell_l2cap_sdu_alloc(coc->tx_sdu_len);
+        if (sdu_tx == NULL) {
+            coc->tx_sdu_left = 0;
+            return BLE_HS_ENOMEM;
+        }
+
+        rc = ble_l2cap_send(coc->chan, sdu_tx);
+        if (rc == BLE_HS_EBUSY) {
+            os_mbuf_free_chain(sdu_tx);
+            return 0;
+        }
+        if (rc) {
+            console_printf("Could not send data rc=%d\n", rc);
+            if (rc == BLE_HS_EBADDATA) {
+                os_mbuf_free_chain(sdu_tx);
+            }
+            coc->tx_sdu_left = 0;
+            return rc;
+        }
+
+        coc->tx_bytes += coc->tx_sdu_len;
+        coc->tx_sdu_left--;
+    }
+
+    /* All SDUs are queued in the host, not necessarily on air yet */
+    ms = (os_time_get() - coc->tx_start) * 1000 / OS_TICKS_PER_SEC;
+    console_printf("LE CoC sent %lu bytes in %lu ms", (unsigned long)coc->tx_bytes,
+                   (unsigned long)ms);
+    if (ms != 0) {
+        console_printf(", %lu bytes/s",
+                       (unsigned long)((uint64_t)coc->tx_bytes * 1000 / ms));
+    }
+    console_printf("\n");
+
+    return 0;
+}
+
 static int
 btshell_l2cap_coc_accept(uint16_t conn_handle, uint16_t peer_mtu,
                            struct ble_l2cap_chan *chan)
@@ -1816,6 +1955,9 @@ btshell_l2cap_coc_accept(uint16_t conn_handle, uint16_t peer_mtu,
 static int
 btshell_l2cap_event(struct ble_l2cap_event *event, void *arg)
 {
+    struct btshell_l2cap_coc *coc;
+    int rc;
+
     switch(event->type) {
         case BLE_L2CAP_EVENT_COC_CONNECTED:
             if (event->connect.status) {
@@ -1830,6 +1972,14 @@ btshell_l2cap_event(struct ble_l2cap_event *event, void *arg)
             btshell_l2cap_coc_add(event->connect.conn_handle,
                                   event->connect.chan);
 
+            if ((intptr_t)arg) {
+                rc = ble_l2cap_set_rx_stream(event->connect.chan, 1);
+                if (rc) {
+                    console_printf("Could not enable stream mode rc=%d\n",
+                                   rc);
+                }
+            }
+
             return 0;
         case BLE_L2CAP_EVENT_COC_DISCONNECTED:
             console_printf("LE CoC disconnected, chan: 0x%08lx\n",
@@ -1844,7 +1994,22 @@ btshell_l2cap_event(struct ble_l2cap_event *event, void *arg)
                                             event->accept.chan);
 
         case BLE_L2CAP_EVENT_COC_DATA_RECEIVED:
-            btshell_l2cap_coc_recv(event->receive.chan, event->receive.sdu_rx);
+            btshell_l2cap_coc_recv(event->receive.conn_handle,
+                                   event->receive.chan, event->receive.sdu_rx);
+            return 0;
+        case BLE_L2CAP_EVENT_COC_DATA_RX_FRAG:
+            btshell_l2cap_coc_recv_frag(event->receive_frag.conn_handle,
+                                        event->receive_frag.chan,
+                                        event->receive_frag.om,
+                                        event->receive_frag.sdu_len,
+                                        event->receive_frag.sdu_off);
+            return 0;
+        case BLE_L2CAP_EVENT_COC_TX_UNSTALLED:
+            coc = btshell_l2cap_coc_find(event->tx_unstalled.conn_handle,
+                                         event->tx_unstalled.chan);
+            if (coc != NULL) {
+                btshell_l2cap_coc_tx(coc);
+            }
             return 0;
         default:
             return 0;
@@ -1853,7 +2018,7 @@ btshell_l2cap_event(struct ble_l2cap_event *event, void *arg)
 #endif
 
 int
-btshell_l2cap_create_srv(uint16_t psm)
+btshell_l2cap_create_srv(uint16_t psm, int stream)
 {
 #if MYNEWT_VAL(BLE_L2CAP_COC_MAX_NUM) == 0
     console_printf("BLE L2CAP LE COC not supported.");
@@ -1862,12 +2027,12 @@ btshell_l2cap_create_srv(uint16_t psm)
 #else
 
     return ble_l2cap_create_server(psm, BTSHELL_COC_MTU, btshell_l2cap_event,
-                                                                       NULL);
+                                   (void *)(intptr_t)stream);
 #endif
 }
 
 int
-btshell_l2cap_connect(uint16_t conn_handle, uint16_t psm)
+btshell_l2cap_connect(uint16_t conn_handle, uint16_t psm, int stream)
 {
 #if MYNEWT_VAL(BLE_L2CAP_COC_MAX_NUM) == 0
     console_printf("BLE L2CAP LE COC not supported.");
@@ -1881,7 +2046,7 @@ btshell_l2cap_connect(uint16_t conn_handle, uint16_t psm)
     assert(sdu_rx != NULL);
 
     return ble_l2cap_connect(conn_handle, psm, BTSHELL_COC_MTU, sdu_rx,
-                             btshell_l2cap_event, NULL);
+                             btshell_l2cap_event, (void *)(intptr_t)stream);
 #endif
 }
 
@@ -1921,7 +2086,8 @@ btshell_l2cap_disconnect(uint16_t conn_handle, uint16_t idx)
 }
 
 int
-btshell_l2cap_send(uint16_t conn_handle, uint16_t idx, uint16_t bytes)
+btshell_l2cap_send(uint16_t conn_handle, uint16_t idx, uint16_t bytes,
+                   uint16_t count)
 {
 #if MYNEWT_VAL(BLE_L2CAP_COC_MAX_NUM) == 0
     console_printf("BLE L2CAP LE COC not supported.");
@@ -1931,12 +2097,10 @@ btshell_l2cap_send(uint16_t conn_handle, uint16_t idx, uint16_t bytes)
 
     struct btshell_conn *conn;
     struct btshell_l2cap_coc *coc;
-    struct os_mbuf *sdu_tx;
-    uint8_t b[] = {0x00, 0x11,0x22,0x33,0x44,0x55,0x66,0x77,0x88, 0x99};
     int i;
-    int rc;
 
-    console_printf("conn=%d, idx=%d, bytes=%d\n", conn_handle, idx, bytes);
+    console_printf("conn=%d, idx=%d, bytes=%d, count=%d\n", conn_handle, idx,
+                   bytes, count);
 
     conn = btshell_conn_find(conn_handle);
     if (conn == NULL) {
@@ -1956,42 +2120,17 @@ btshell_l2cap_send(uint16_t conn_handle, uint16_t idx, uint16_t bytes)
         return 0;
     }
 
-    sdu_tx = os_mbuf_get_pkthdr(&sdu_os_mbuf_pool, 0);
-    if (sdu_tx == NULL) {
-        console_printf("No memory in the test sdu pool\n");
-        return 0;
-    }
-
-    /* For the testing purpose we fill up buffer with known data, easy
-     * to validate on other side. In this loop we add as many full chunks as we
-     * can
-     */
-    for (i = 0; i < bytes / sizeof(b); i++) {
-        rc = os_mbuf_append(sdu_tx, b, sizeof(b));
-        if (rc) {
-            console_printf("Cannot append data %i !\n", i);
-            os_mbuf_free_chain(sdu_tx);
-            return rc;
-        }
-    }
-
-    /* Here we add the rest < sizeof(b) */
-    rc = os_mbuf_append(sdu_tx, b, bytes - (sizeof(b) * i));
-    if (rc) {
-        console_printf("Cannot append data %i !\n", i);
-        os_mbuf_free_chain(sdu_tx);
-        return rc;
+    if (coc->tx_sdu_left > 0) {
+        console_printf("Previous send still in progress\n");
+        return BLE_HS_EBUSY;
     }
 
-    rc = ble_l2cap_send(coc->chan, sdu_tx);
-    if (rc) {
-        console_printf("Could not send data rc=%d\n", rc);
-        if (rc == BLE_HS_EBUSY) {
-            os_mbuf_free_chain(sdu_tx);
-        }
-    }
+    coc->tx_sdu_len = bytes;
+    coc->tx_sdu_left = count;
+    coc->tx_bytes = 0;
+    coc->tx_start = os_time_get();
 
-    return rc;
+    return btshell_l2cap_coc_tx(coc);
 
 #endif
 }
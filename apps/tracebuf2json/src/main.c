@@ -0,0 +1,312 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+
+#include "os/os_trace_api.h"
+#include "tracebuf/tracebuf.h"
+
+/* Trace viewer thread for interrupts. */
+#define TB2J_TID_ISR        (TRACEBUF_TASK_NONE)
+
+static const char *progname;
+static FILE *out;
+static int first_event = 1;
+
+static struct tracebuf_file_task tb2j_tasks[256];
+static int tb2j_task_cnt;
+
+static const char *
+tb2j_call_name(unsigned id)
+{
+    static char buf[16];
+
+    switch (id) {
+    case OS_TRACE_ID_EVQ_PUT:
+        return "evq_put";
+    case OS_TRACE_ID_EVQ_GET:
+        return "evq_get";
+    case OS_TRACE_ID_MUTEX_INIT:
+        return "mutex_init";
+    case OS_TRACE_ID_MUTEX_RELEASE:
+        return "mutex_release";
+    case OS_TRACE_ID_MUTEX_PEND:
+        return "mutex_pend";
+    case OS_TRACE_ID_SEM_RELEASE:
+        return "sem_release";
+    case OS_TRACE_ID_SEM_PEND:
+        return "sem_pend";
+    case OS_TRACE_ID_MBUF_GET:
+        return "mbuf_get";
+    case OS_TRACE_ID_MBUF_FREE:
+        return "mbuf_free";
+    default:
+        snprintf(buf, sizeof buf, "id_%u", id);
+        return buf;
+    }
+}
+
+static const char *
+tb2j_task_name(int id)
+{
+    static char buf[16];
+    int i;
+
+    for (i = 0; i < tb2j_task_cnt; i++) {
+        if (tb2j_tasks[i].tft_id == id) {
+            return tb2j_tasks[i].tft_name;
+        }
+    }
+    snprintf(buf, sizeof buf, "task_%d", id);
+    return buf;
+}
+
+static void
+tb2j_begin_event(void)
+{
+    fprintf(out, "%s\n  ", first_event ? "" : ",");
+    first_event = 0;
+}
+
+static void
+tb2j_slice(const char *name, int tid, double ts, double dur)
+{
+    tb2j_begin_event();
+    fprintf(out, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%d,"
+            "\"ts\":%.3f,\"dur\":%.3f}", name, tid, ts, dur);
+}
+
+static void
+tb2j_edge(const char *name, const char *ph, int tid, double ts)
+{
+    tb2j_begin_event();
+    fprintf(out, "{\"name\":\"%s\",\"ph\":\"%s\",\"pid\":0,\"tid\":%d,"
+            "\"ts\":%.3f}", name, ph, tid, ts);
+}
+
+static void
+tb2j_instant(const char *name, int tid, double ts,
+             const struct tracebuf_entry *te)
+{
+    tb2j_begin_event();
+    fprintf(out, "{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":0,"
+            "\"tid\":%d,\"ts\":%.3f", name, tid, ts);
+    if (te->te_argc > 0) {
+        fprintf(out, ",\"args\":{\"arg0\":\"0x%08" PRIx32 "\"", te->te_arg[0]);
+        if (te->te_argc > 1) {
+            fprintf(out, ",\"arg1\":\"0x%08" PRIx32 "\"", te->te_arg[1]);
+        }
+        fprintf(out, "}");
+    }
+    fprintf(out, "}");
+}
+
+static void
+tb2j_thread_name(int tid, const char *name)
+{
+    tb2j_begin_event();
+    fprintf(out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,"
+            "\"tid\":%d,\"args\":{\"name\":\"%s\"}}", tid, name);
+}
+
+static int
+tb2j_convert(FILE *in)
+{
+    struct tracebuf_file_hdr tfh;
+    struct tracebuf_entry te;
+    char name[48];
+    uint64_t ticks;
+    uint32_t last_time;
+    uint32_t i;
+    double run_start;
+    double ts;
+    int running;
+    int tid;
+
+    if (fread(&tfh, sizeof tfh, 1, in) != 1 ||
+        tfh.tfh_magic != TRACEBUF_FILE_MAGIC ||
+        tfh.tfh_entry_size != sizeof te) {
+
+        fprintf(stderr, "%s: not a trace file\n", progname);
+        return -1;
+    }
+
+    tb2j_task_cnt = tfh.tfh_task_cnt;
+    if (tb2j_task_cnt > 256 ||
+        fread(tb2j_tasks, sizeof tb2j_tasks[0], tb2j_task_cnt, in) !=
+        (size_t)tb2j_task_cnt) {
+
+        fprintf(stderr, "%s: bad task table\n", progname);
+        return -1;
+    }
+
+    fprintf(out, "{\"traceEvents\":[");
+    for (i = 0; i < tfh.tfh_task_cnt; i++) {
+        tb2j_tasks[i].tft_name[TRACEBUF_FILE_NAME_LEN - 1] = '\0';
+        tb2j_thread_name(tb2j_tasks[i].tft_id, tb2j_tasks[i].tft_name);
+    }
+    tb2j_thread_name(TB2J_TID_ISR, "interrupts");
+
+    /* cputime is 32 bits; sum the differences so that it does not wrap. */
+    ticks = 0;
+    last_time = 0;
+    running = -1;
+    run_start = 0;
+    ts = 0;
+
+    for (i = 0; i < tfh.tfh_entry_cnt; i++) {
+        if (fread(&te, sizeof te, 1, in) != 1) {
+            fprintf(stderr, "%s: trace truncated\n", progname);
+            break;
+        }
+
+        if (i != 0) {
+            ticks += (uint32_t)(te.te_time - last_time);
+        }
+        last_time = te.te_time;
+        ts = (double)ticks * 1000000.0 / tfh.tfh_freq;
+
+        tid = te.te_task;
+        switch (te.te_id) {
+        case TRACEBUF_ID_TASK_START_EXEC:
+            if (running >= 0) {
+                tb2j_slice(tb2j_task_name(running), running, run_start,
+                           ts - run_start);
+            }
+            running = te.te_arg[0];
+            run_start = ts;
+            break;
+
+        case TRACEBUF_ID_TASK_STOP_EXEC:
+            if (running >= 0) {
+                tb2j_slice(tb2j_task_name(running), running, run_start,
+                           ts - run_start);
+            }
+            running = -1;
+            break;
+
+        case TRACEBUF_ID_ISR_ENTER:
+            tb2j_edge("isr", "B", TB2J_TID_ISR, ts);
+            break;
+
+        case TRACEBUF_ID_ISR_EXIT:
+        case TRACEBUF_ID_ISR_EXIT_TO_SCHED:
+            tb2j_edge("isr", "E", TB2J_TID_ISR, ts);
+            break;
+
+        case TRACEBUF_ID_TIMER_ENTER:
+            tb2j_edge("timer", "B", TB2J_TID_ISR, ts);
+            break;
+
+        case TRACEBUF_ID_TIMER_EXIT:
+            tb2j_edge("timer", "E", TB2J_TID_ISR, ts);
+            break;
+
+        case TRACEBUF_ID_TASK_START_READY:
+            tb2j_instant("ready", te.te_arg[0], ts, &te);
+            break;
+
+        case TRACEBUF_ID_TASK_STOP_READY:
+            tb2j_instant("blocked", te.te_arg[0], ts, &te);
+            break;
+
+        case TRACEBUF_ID_END_CALL:
+            snprintf(name, sizeof name, "%s end",
+                     tb2j_call_name(te.te_arg[0]));
+            tb2j_instant(name, tid, ts, &te);
+            break;
+
+        case TRACEBUF_ID_TASK_INFO:
+        case TRACEBUF_ID_TASK_CREATE:
+        case TRACEBUF_ID_IDLE:
+            break;
+
+        default:
+            tb2j_instant(tb2j_call_name(te.te_id), tid, ts, &te);
+            break;
+        }
+    }
+
+    if (running >= 0) {
+        tb2j_slice(tb2j_task_name(running), running, run_start,
+                   ts - run_start);
+    }
+
+    fprintf(out, "\n],\"otherData\":{\"lost_events\":%" PRIu32 "}}\n",
+            tfh.tfh_lost);
+    return 0;
+}
+
+static void
+usage(int rc)
+{
+    printf("%s [-o out.json] trace_file\n", progname);
+    printf("  Converts a sys/tracebuf trace file to Chrome trace JSON\n");
+    printf("   -o: write to out.json instead of stdout\n");
+    exit(rc);
+}
+
+int
+main(int argc, char **argv)
+{
+    FILE *in;
+    int ch;
+    int rc;
+
+    progname = argv[0];
+    out = stdout;
+
+    while ((ch = getopt(argc, argv, "o:h")) != -1) {
+        switch (ch) {
+        case 'o':
+            out = fopen(optarg, "w");
+            if (out == NULL) {
+                perror("fopen()");
+                return 1;
+            }
+            break;
+        case 'h':
+            usage(0);
+            break;
+        default:
+            usage(1);
+        }
+    }
+    if (optind != argc - 1) {
+        usage(1);
+    }
+
+    in = fopen(argv[optind], "rb");
+    if (in == NULL) {
+        perror("fopen()");
+        return 1;
+    }
+
+    rc = tb2j_convert(in);
+    fclose(in);
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    return rc ? 1 : 0;
+}
@@ -26,6 +26,7 @@
 #include <ctype.h>
 #include <stdio.h>
 #include <sys/types.h>
+#include "syscfg/syscfg.h"
 #include <tinycbor/cbor.h>
 
 #ifdef __cplusplus
@@ -139,14 +140,44 @@ struct cbor_attr_t {
 
 #define CBORATTR_ATTR_UNNAMED (char *)(-1)
 
+/*
+ * Precompiled lookup table for an attribute array.  Named attributes are
+ * kept sorted by name length, then name, so a key is matched by narrowing
+ * down the attributes of the same length as it is read in place, instead of
+ * copying it out and comparing it against every attribute.
+ *
+ * The table holds indices only, so it can be built once and reused with any
+ * attribute array that has the same names and types in the same order,
+ * e.g. one built on the stack on each call.  It applies to the top level
+ * object; nested objects are matched the usual way.
+ */
+struct cbor_attr_desc {
+    uint8_t num_attrs;
+    uint8_t num_named;
+    uint8_t order[MYNEWT_VAL(CBORATTR_DESC_MAX_ATTRS)];
+    uint16_t lens[MYNEWT_VAL(CBORATTR_DESC_MAX_ATTRS)];
+};
+
+int cbor_attr_desc_init(struct cbor_attr_desc *desc,
+                        const struct cbor_attr_t *attrs);
+
 int cbor_read_object(struct CborValue *, const struct cbor_attr_t *);
+int cbor_read_object_desc(struct CborValue *value,
+                          const struct cbor_attr_t *attrs,
+                          const struct cbor_attr_desc *desc);
 int cbor_read_array(struct CborValue *, const struct cbor_array_t *);
 
 int cbor_read_flat_attrs(const uint8_t *data, int len,
                          const struct cbor_attr_t *attrs);
+int cbor_read_flat_attrs_desc(const uint8_t *data, int len,
+                              const struct cbor_attr_t *attrs,
+                              const struct cbor_attr_desc *desc);
 struct os_mbuf;
 int cbor_read_mbuf_attrs(struct os_mbuf *m, uint16_t off, uint16_t len,
                          const struct cbor_attr_t *attrs);
+int cbor_read_mbuf_attrs_desc(struct os_mbuf *m, uint16_t off, uint16_t len,
+                              const struct cbor_attr_t *attrs,
+                              const struct cbor_attr_desc *desc);
 
 #ifdef __cplusplus
 }
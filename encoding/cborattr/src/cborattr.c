@@ -133,9 +133,125 @@ cbor_target_address(const struct cbor_attr_t *cursor,
     return targetaddr;
 }
 
+/* Returns the last unnamed attribute that accepts a value of the given
+ * type, or NULL if there is none. */
+static const struct cbor_attr_t *
+cbor_find_unnamed_attr(const struct cbor_attr_t *attrs, CborType type)
+{
+    const struct cbor_attr_t *cursor, *best_match;
+
+    best_match = NULL;
+    for (cursor = attrs; cursor->attribute != NULL; cursor++) {
+        if (cursor->attribute == CBORATTR_ATTR_UNNAMED &&
+            valid_attr_type(type, cursor->type)) {
+            best_match = cursor;
+        }
+    }
+    return best_match;
+}
+
+/* Looks the key up in a precompiled table.  The range of attributes with
+ * the same length is narrowed down as the key is read in place; the first
+ * one left, in array order, with a valid type wins, like in the linear
+ * search. */
+static const struct cbor_attr_t *
+cbor_desc_find_attr(const struct cbor_attr_desc *desc,
+                    const struct cbor_attr_t *attrs, const CborValue *key,
+                    CborType type)
+{
+    struct cbor_decoder_reader *d;
+    const struct cbor_attr_t *cursor;
+    const char *first, *last;
+    bool equal;
+    size_t len;
+    size_t k, n;
+    uint8_t c;
+    int lo, hi, mid;
+    int off;
+    int i;
+
+    if (key == NULL) {
+        return cbor_find_unnamed_attr(attrs, type);
+    }
+
+    if (cbor_value_get_string_offset(key, &off, &len) != CborNoError) {
+        /* chunked key; try all of them */
+        for (i = 0; i < desc->num_named; i++) {
+            cursor = &attrs[desc->order[i]];
+            if (valid_attr_type(type, cursor->type) &&
+                cbor_value_text_string_equals(key, cursor->attribute,
+                                              &equal) == CborNoError &&
+                equal) {
+                return cursor;
+            }
+        }
+        return NULL;
+    }
+
+    /* range of attributes of this length */
+    lo = 0;
+    hi = desc->num_named;
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        if (desc->lens[mid] < len) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    hi = lo;
+    while (hi < desc->num_named && desc->lens[hi] == len) {
+        hi++;
+    }
+
+    d = key->parser->d;
+    k = 0;
+    while (lo < hi && k < len) {
+        /* the candidates are sorted, so the characters the first and the
+         * last one share are shared by all; compare those in one go */
+        first = attrs[desc->order[lo]].attribute;
+        last = attrs[desc->order[hi - 1]].attribute;
+        n = k;
+        while (n < len && first[n] == last[n]) {
+            n++;
+        }
+        if (n > k) {
+            if (!d->cmp(d, (char *)first + k, off + k, n - k)) {
+                hi = lo;
+            }
+            k = n;
+            continue;
+        }
+
+        c = d->get8(d, off + k);
+        while (lo < hi &&
+               (uint8_t)attrs[desc->order[lo]].attribute[k] < c) {
+            lo++;
+        }
+        while (lo < hi &&
+               (uint8_t)attrs[desc->order[hi - 1]].attribute[k] > c) {
+            hi--;
+        }
+        k++;
+    }
+
+    for (i = lo; i < hi; i++) {
+        cursor = &attrs[desc->order[i]];
+        if (valid_attr_type(type, cursor->type)) {
+            return cursor;
+        }
+    }
+
+    if (len == 0) {
+        return cbor_find_unnamed_attr(attrs, type);
+    }
+    return NULL;
+}
+
 static int
 cbor_internal_read_object(CborValue *root_value,
                           const struct cbor_attr_t *attrs,
+                          const struct cbor_attr_desc *desc,
                           const struct cbor_array_t *parent,
                           int offset)
 {
@@ -143,6 +259,8 @@ cbor_internal_read_object(CborValue *root_value,
     char attrbuf[MYNEWT_VAL(CBORATTR_MAX_SIZE) + 1];
     void *lptr;
     CborValue cur_value;
+    CborValue key_value;
+    const CborValue *key;
     CborError err = 0;
     size_t len;
     CborType type = CborInvalidType;
@@ -188,14 +306,22 @@ cbor_internal_read_object(CborValue *root_value,
     /* contains key value pairs */
     while (cbor_value_is_valid(&cur_value)) {
         /* get the attribute */
+        key = NULL;
         if (cbor_value_is_text_string(&cur_value)) {
-            if (cbor_value_calculate_string_length(&cur_value, &len) == 0) {
+            if (desc != NULL) {
+                /* matched in place once the value type is known */
+                key_value = cur_value;
+                key = &key_value;
+            } else if (cbor_value_calculate_string_length(&cur_value,
+                                                          &len) == 0) {
                 if (len > MYNEWT_VAL(CBORATTR_MAX_SIZE)) {
                     err |= CborErrorDataTooLarge;
                     goto err_return;
                 }
                 err |= cbor_value_copy_text_string(&cur_value, attrbuf, &len,
                                                      NULL);
+                /* an empty key is not terminated by the copy */
+                attrbuf[len] = '\0';
             }
 
             /* at least get the type of the next value so we can match the
@@ -214,14 +340,20 @@ cbor_internal_read_object(CborValue *root_value,
 
         /* find this attribute in our list */
         best_match = NULL;
-        for (cursor = attrs; cursor->attribute != NULL; cursor++) {
-            if (valid_attr_type(type, cursor->type)) {
-                if (cursor->attribute == CBORATTR_ATTR_UNNAMED &&
-                    attrbuf[0] == '\0') {
-                    best_match = cursor;
-                } else if (strlen(cursor->attribute) == len &&
-                    !memcmp(cursor->attribute, attrbuf, len)) {
-                    break;
+        if (desc != NULL) {
+            best_match = cbor_desc_find_attr(desc, attrs, key, type);
+            cursor = &attrs[desc->num_attrs];
+        } else {
+            for (cursor = attrs; cursor->attribute != NULL; cursor++) {
+                if (valid_attr_type(type, cursor->type)) {
+                    if (cursor->attribute == CBORATTR_ATTR_UNNAMED) {
+                        if (attrbuf[0] == '\0') {
+                            best_match = cursor;
+                        }
+                    } else if (strlen(cursor->attribute) == len &&
+                        !memcmp(cursor->attribute, attrbuf, len)) {
+                        break;
+                    }
                 }
             }
         }
@@ -270,7 +402,7 @@ cbor_internal_read_object(CborValue *root_value,
                 continue;
             case CborAttrObjectType:
                 err |= cbor_internal_read_object(&cur_value, cursor->addr.obj,
-                                                 NULL, 0);
+                                                 NULL, NULL, 0);
                 continue;
             default:
                 err |= CborErrorIllegalType;
@@ -329,7 +461,7 @@ cbor_read_array(struct CborValue *value, const struct cbor_array_t *arr)
             break;
         case CborAttrStructObjectType:
             err |= cbor_internal_read_object(&elem, arr->arr.objects.subtype,
-                                             arr, off);
+                                             NULL, arr, off);
             break;
         default:
             err |= CborErrorIllegalType;
@@ -359,10 +491,75 @@ cbor_read_object(struct CborValue *value, const struct cbor_attr_t *attrs)
 {
     int st;
 
-    st = cbor_internal_read_object(value, attrs, NULL, 0);
+    st = cbor_internal_read_object(value, attrs, NULL, NULL, 0);
     return st;
 }
 
+/*
+ * Build a precompiled lookup table for attrs.
+ *
+ * @param desc                Table to fill in
+ * @param attrs               Array of cbor objects to look for.
+ *
+ * @return                    0 on success; -1 if attrs has too many
+ *                            entries.
+ */
+int
+cbor_attr_desc_init(struct cbor_attr_desc *desc,
+                    const struct cbor_attr_t *attrs)
+{
+    size_t len;
+    int num;
+    int i;
+
+    desc->num_named = 0;
+    for (num = 0; attrs[num].attribute != NULL; num++) {
+        if (num >= MYNEWT_VAL(CBORATTR_DESC_MAX_ATTRS)) {
+            return -1;
+        }
+        if (attrs[num].attribute == CBORATTR_ATTR_UNNAMED) {
+            continue;
+        }
+
+        /* insertion sort by length, then name; equal names stay in array
+         * order */
+        len = strlen(attrs[num].attribute);
+        if (len > UINT16_MAX) {
+            return -1;
+        }
+        i = desc->num_named;
+        while (i > 0 &&
+               (desc->lens[i - 1] > len ||
+                (desc->lens[i - 1] == len &&
+                 strcmp(attrs[desc->order[i - 1]].attribute,
+                        attrs[num].attribute) > 0))) {
+            desc->order[i] = desc->order[i - 1];
+            desc->lens[i] = desc->lens[i - 1];
+            i--;
+        }
+        desc->order[i] = num;
+        desc->lens[i] = len;
+        desc->num_named++;
+    }
+    desc->num_attrs = num;
+
+    return 0;
+}
+
+/*
+ * Same as cbor_read_object(), but looks keys up with a table built by
+ * cbor_attr_desc_init() for an array laid out like attrs.
+ */
+int
+cbor_read_object_desc(struct CborValue *value,
+                      const struct cbor_attr_t *attrs,
+                      const struct cbor_attr_desc *desc)
+{
+    assert(attrs[desc->num_attrs].attribute == NULL);
+
+    return cbor_internal_read_object(value, attrs, desc, NULL, 0);
+}
+
 /*
  * Read in cbor key/values from flat buffer pointed by data, and fill them
  * into attrs.
@@ -390,6 +587,28 @@ cbor_read_flat_attrs(const uint8_t *data, int len,
     return cbor_read_object(&value, attrs);
 }
 
+/*
+ * Same as cbor_read_flat_attrs(), but looks keys up with a table built by
+ * cbor_attr_desc_init().
+ */
+int
+cbor_read_flat_attrs_desc(const uint8_t *data, int len,
+                          const struct cbor_attr_t *attrs,
+                          const struct cbor_attr_desc *desc)
+{
+    struct cbor_buf_reader reader;
+    struct CborParser parser;
+    struct CborValue value;
+    CborError err;
+
+    cbor_buf_reader_init(&reader, data, len);
+    err = cbor_parser_init(&reader.r, 0, &parser, &value);
+    if (err != CborNoError) {
+        return -1;
+    }
+    return cbor_read_object_desc(&value, attrs, desc);
+}
+
 /*
  * Read in cbor key/values from os_mbuf pointed by m, and fill them
  * into attrs.
@@ -417,3 +636,25 @@ cbor_read_mbuf_attrs(struct os_mbuf *m, uint16_t off, uint16_t len,
     }
     return cbor_read_object(&value, attrs);
 }
+
+/*
+ * Same as cbor_read_mbuf_attrs(), but looks keys up with a table built by
+ * cbor_attr_desc_init().
+ */
+int
+cbor_read_mbuf_attrs_desc(struct os_mbuf *m, uint16_t off, uint16_t len,
+                          const struct cbor_attr_t *attrs,
+                          const struct cbor_attr_desc *desc)
+{
+    struct cbor_mbuf_reader cmr;
+    struct CborParser parser;
+    struct CborValue value;
+    CborError err;
+
+    cbor_mbuf_reader_init(&cmr, m, off);
+    err = cbor_parser_init(&cmr.r, 0, &parser, &value);
+    if (err != CborNoError) {
+        return -1;
+    }
+    return cbor_read_object_desc(&value, attrs, desc);
+}
@@ -34,6 +34,8 @@ TEST_SUITE(test_cborattr_suite)
     test_cborattr_decode_object_array();
     test_cborattr_decode_unnamed_array();
     test_cborattr_decode_substring_key();
+    test_cborattr_decode_desc();
+    test_cborattr_bench_desc();
 }
 
 #if MYNEWT_VAL(SELFTEST)
@@ -0,0 +1,119 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <stdio.h>
+#include "console/console.h"
+#include "test_cborattr.h"
+#include "tinycbor/cbor_buf_writer.h"
+
+#define TEST_BENCH_ATTRS    (16)
+#define TEST_BENCH_RUNS     (1000)
+#define TEST_BENCH_ROUNDS   (5)
+
+static char test_bench_names[TEST_BENCH_ATTRS][16];
+static long long unsigned int test_bench_vals[TEST_BENCH_ATTRS];
+static uint8_t test_bench_buf[TEST_BENCH_ATTRS * 24];
+static int test_bench_len;
+
+/*
+ * Returns the best time of TEST_BENCH_ROUNDS rounds for one decode, in
+ * nsecs.
+ */
+static uint32_t
+test_bench_decode(const struct cbor_attr_t *attrs,
+                  const struct cbor_attr_desc *desc)
+{
+    uint32_t start;
+    uint32_t usecs;
+    uint32_t best;
+    int round;
+    int rc;
+    int i;
+
+    best = UINT32_MAX;
+    for (round = 0; round < TEST_BENCH_ROUNDS; round++) {
+        start = tu_time_usecs();
+        for (i = 0; i < TEST_BENCH_RUNS; i++) {
+            if (desc != NULL) {
+                rc = cbor_read_flat_attrs_desc(test_bench_buf, test_bench_len,
+                                               attrs, desc);
+            } else {
+                rc = cbor_read_flat_attrs(test_bench_buf, test_bench_len,
+                                          attrs);
+            }
+            TEST_ASSERT_FATAL(rc == 0);
+        }
+        usecs = tu_time_usecs() - start;
+        if (usecs < best) {
+            best = usecs;
+        }
+    }
+
+    for (i = 0; i < TEST_BENCH_ATTRS; i++) {
+        TEST_ASSERT(test_bench_vals[i] == i * 1000);
+    }
+
+    return (uint64_t)best * 1000 / TEST_BENCH_RUNS;
+}
+
+/*
+ * Times the decode of a map with many keys, with and without a
+ * precompiled table.
+ */
+TEST_CASE(test_cborattr_bench_desc)
+{
+    struct cbor_attr_t attrs[TEST_BENCH_ATTRS + 1];
+    struct cbor_attr_desc desc;
+    struct cbor_buf_writer writer;
+    CborEncoder encoder;
+    CborEncoder map;
+    uint32_t linear_ns;
+    uint32_t desc_ns;
+    int rc;
+    int i;
+
+    memset(attrs, 0, sizeof attrs);
+    for (i = 0; i < TEST_BENCH_ATTRS; i++) {
+        snprintf(test_bench_names[i], sizeof test_bench_names[i],
+                 "sensor_attr_%02d", i);
+        attrs[i].attribute = test_bench_names[i];
+        attrs[i].type = CborAttrUnsignedIntegerType;
+        attrs[i].addr.uinteger = &test_bench_vals[i];
+    }
+
+    /* Keys appear in the reverse order of the attributes. */
+    cbor_buf_writer_init(&writer, test_bench_buf, sizeof test_bench_buf);
+    cbor_encoder_init(&encoder, &writer.enc, 0);
+    cbor_encoder_create_map(&encoder, &map, TEST_BENCH_ATTRS);
+    for (i = TEST_BENCH_ATTRS - 1; i >= 0; i--) {
+        cbor_encode_text_stringz(&map, test_bench_names[i]);
+        cbor_encode_uint(&map, i * 1000);
+    }
+    cbor_encoder_close_container(&encoder, &map);
+    test_bench_len = cbor_buf_writer_buffer_size(&writer, test_bench_buf);
+
+    rc = cbor_attr_desc_init(&desc, attrs);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    linear_ns = test_bench_decode(attrs, NULL);
+    desc_ns = test_bench_decode(attrs, &desc);
+
+    console_printf("cborattr decode, %d attrs: linear %lu ns, desc %lu ns\n",
+                   TEST_BENCH_ATTRS, (unsigned long)linear_ns,
+                   (unsigned long)desc_ns);
+}
@@ -0,0 +1,138 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "test_cborattr.h"
+#include "tinycbor/cbor_buf_writer.h"
+
+static uint8_t test_cbor_buf[256];
+static int test_cbor_len;
+
+/*
+ * {"ab": 1, "cd": "xy", "dup": 7, "a": true, "zz": 5, "": 9}
+ */
+static void
+test_encode_desc_data(void)
+{
+    struct cbor_buf_writer writer;
+    CborEncoder encoder;
+    CborEncoder data;
+
+    cbor_buf_writer_init(&writer, test_cbor_buf, sizeof test_cbor_buf);
+    cbor_encoder_init(&encoder, &writer.enc, 0);
+
+    cbor_encoder_create_map(&encoder, &data, CborIndefiniteLength);
+    cbor_encode_text_stringz(&data, "ab");
+    cbor_encode_uint(&data, 1);
+    cbor_encode_text_stringz(&data, "cd");
+    cbor_encode_text_stringz(&data, "xy");
+    cbor_encode_text_stringz(&data, "dup");
+    cbor_encode_uint(&data, 7);
+    cbor_encode_text_stringz(&data, "a");
+    cbor_encode_boolean(&data, true);
+    cbor_encode_text_stringz(&data, "zz");
+    cbor_encode_uint(&data, 5);
+    cbor_encode_text_stringz(&data, "");
+    cbor_encode_uint(&data, 9);
+    cbor_encoder_close_container(&encoder, &data);
+
+    test_cbor_len = cbor_buf_writer_buffer_size(&writer, test_cbor_buf);
+}
+
+/*
+ * Decode through a precompiled table and through the linear search, and
+ * check that both fill in the same values.
+ */
+TEST_CASE(test_cborattr_decode_desc)
+{
+    struct cbor_attr_desc desc;
+    long long unsigned int ab;
+    long long unsigned int dup;
+    long long unsigned int unnamed;
+    char dup_str[8];
+    char cd[8];
+    bool a;
+    int pass;
+    int rc;
+    struct cbor_attr_t test_attrs[] = {
+        [0] = {
+            .attribute = "dup",
+            .type = CborAttrTextStringType,
+            .addr.string = dup_str,
+            .len = sizeof(dup_str),
+        },
+        [1] = {
+            .attribute = "cd",
+            .type = CborAttrTextStringType,
+            .addr.string = cd,
+            .len = sizeof(cd),
+        },
+        [2] = {
+            .attribute = CBORATTR_ATTR_UNNAMED,
+            .type = CborAttrUnsignedIntegerType,
+            .addr.uinteger = &unnamed,
+            .nodefault = true,
+        },
+        [3] = {
+            .attribute = "ab",
+            .type = CborAttrUnsignedIntegerType,
+            .addr.uinteger = &ab,
+        },
+        [4] = {
+            .attribute = "dup",
+            .type = CborAttrUnsignedIntegerType,
+            .addr.uinteger = &dup,
+        },
+        [5] = {
+            .attribute = "a",
+            .type = CborAttrBooleanType,
+            .addr.boolean = &a,
+        },
+        [6] = {
+            .attribute = NULL
+        }
+    };
+
+    test_encode_desc_data();
+
+    rc = cbor_attr_desc_init(&desc, test_attrs);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(desc.num_attrs == 6);
+    TEST_ASSERT(desc.num_named == 5);
+
+    for (pass = 0; pass < 2; pass++) {
+        ab = 0;
+        dup = 0;
+        unnamed = 0;
+        a = false;
+        memset(cd, 0, sizeof cd);
+
+        if (pass == 0) {
+            rc = cbor_read_flat_attrs(test_cbor_buf, test_cbor_len,
+                                      test_attrs);
+        } else {
+            rc = cbor_read_flat_attrs_desc(test_cbor_buf, test_cbor_len,
+                                           test_attrs, &desc);
+        }
+        TEST_ASSERT(rc == 0);
+        TEST_ASSERT(ab == 1);
+        TEST_ASSERT(!strcmp(cd, "xy"));
+        TEST_ASSERT(dup == 7);
+        TEST_ASSERT(a == true);
+        TEST_ASSERT(unnamed == 9, "pass %d", pass);
+    }
+}
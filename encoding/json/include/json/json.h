@@ -203,6 +203,27 @@ struct json_buffer {
 int json_read_object(struct json_buffer *, const struct json_attr_t *);
 int json_read_array(struct json_buffer *, const struct json_array_t *);
 
+#define JSON_ATTR_DESC_MAX  32         /* max attrs in a precompiled table */
+
+/*
+ * Precompiled lookup table for an attribute array.  Attribute names are
+ * kept sorted, so a key is matched one character at a time as it is read,
+ * rather than buffered and compared against every attribute.
+ *
+ * The table holds indices only, and can be reused with any attribute array
+ * with the same names in the same order.  It applies to the top level
+ * object; nested objects are matched the usual way.
+ */
+struct json_attr_desc {
+    uint8_t jad_num_attrs;
+    uint8_t jad_order[JSON_ATTR_DESC_MAX];
+};
+
+int json_attr_desc_init(struct json_attr_desc *desc,
+                        const struct json_attr_t *attrs);
+int json_read_object_desc(struct json_buffer *, const struct json_attr_t *,
+                          const struct json_attr_desc *);
+
 #define JSON_ERR_OBSTART     1   /* non-WS when expecting object start */
 #define JSON_ERR_ATTRSTART   2   /* non-WS when expecting attrib start */
 #define JSON_ERR_BADATTR     3   /* unknown attribute name */
@@ -226,6 +247,7 @@ int json_read_array(struct json_buffer *, const struct json_array_t *);
 #define JSON_ERR_MISC        20  /* other data conversion error */
 #define JSON_ERR_BADNUM      21  /* error while parsing a numerical argument */
 #define JSON_ERR_NULLPTR     22  /* unexpected null value or attribute pointer */
+#define JSON_ERR_DESCLEN     23  /* too many attributes for precompiled table */
 
 /*
  * Use the following macros to declare template initializers for structobject
@@ -147,6 +147,7 @@ json_target_address(const struct json_attr_t *cursor,
 static int
 json_internal_read_object(struct json_buffer *jb,
                           const struct json_attr_t *attrs,
+                          const struct json_attr_desc *desc,
                           const struct json_array_t *parent,
                           int offset)
 {
@@ -164,6 +165,8 @@ json_internal_read_object(struct json_buffer *jb,
     unsigned int u;
     const struct json_enum_t *mp;
     char *lptr;
+    const char *lo_name = NULL, *hi_name = NULL;
+    int lo = 0, hi = 0, k = 0;
 
 #ifdef S_SPLINT_S
     /* prevents gripes about buffers not being completely defined */
@@ -230,6 +233,15 @@ json_internal_read_object(struct json_buffer *jb,
             } else if (c == '"') {
                 state = in_attr;
                 pattr = attrbuf;
+                if (desc != NULL) {
+                    lo = 0;
+                    hi = desc->jad_num_attrs;
+                    k = 0;
+                    if (hi > 0) {
+                        lo_name = attrs[desc->jad_order[0]].attribute;
+                        hi_name = attrs[desc->jad_order[hi - 1]].attribute;
+                    }
+                }
             } else if (c == '}') {
                 break;
             } else {
@@ -241,11 +253,42 @@ json_internal_read_object(struct json_buffer *jb,
                 /* don't update end here, leave at attribute start */
                 return JSON_ERR_NULLPTR;
             }
+            if (desc != NULL && c != '"') {
+                /*
+                 * Narrow the range of sorted names down to those that
+                 * match the key so far.
+                 */
+                if (k >= JSON_ATTR_MAX - 1) {
+                    return JSON_ERR_ATTRLEN;
+                }
+                while (lo < hi && (unsigned char)lo_name[k] <
+                                  (unsigned char)c) {
+                    if (++lo < hi) {
+                        lo_name = attrs[desc->jad_order[lo]].attribute;
+                    }
+                }
+                while (lo < hi && (unsigned char)hi_name[k] >
+                                  (unsigned char)c) {
+                    if (lo < --hi) {
+                        hi_name = attrs[desc->jad_order[hi - 1]].attribute;
+                    }
+                }
+                k++;
+                break;
+            }
             if (c == '"') {
                 *pattr++ = '\0';
-                for (cursor = attrs; cursor->attribute != NULL; cursor++) {
-                    if (strcmp(cursor->attribute, attrbuf) == 0) {
-                        break;
+                if (desc != NULL) {
+                    /* shortest name, and first in array order, comes first */
+                    cursor = &attrs[desc->jad_num_attrs];
+                    if (lo < hi && lo_name[k] == '\0') {
+                        cursor = &attrs[desc->jad_order[lo]];
+                    }
+                } else {
+                    for (cursor = attrs; cursor->attribute != NULL; cursor++) {
+                        if (strcmp(cursor->attribute, attrbuf) == 0) {
+                            break;
+                        }
                     }
                 }
                 if (cursor->attribute == NULL) {
@@ -402,7 +445,7 @@ json_internal_read_object(struct json_buffer *jb,
                 if (cursor[1].attribute==NULL) {       /* out of possiblities */
                     break;
                 }
-                if (strcmp(cursor[1].attribute, attrbuf)!=0) {
+                if (strcmp(cursor[1].attribute, cursor->attribute)!=0) {
                     break;
                 }
                 ++cursor;
@@ -564,8 +607,8 @@ json_read_array(struct json_buffer *jb, const struct json_array_t *arr)
         case t_object:
         case t_structobject:
             substatus =
-                json_internal_read_object(jb, arr->arr.objects.subtype, arr,
-                                          offset);
+                json_internal_read_object(jb, arr->arr.objects.subtype, NULL,
+                                          arr, offset);
             if (substatus != 0) {
                 return substatus;
             }
@@ -664,7 +707,41 @@ json_read_object(struct json_buffer *jb, const struct json_attr_t *attrs)
 {
     int st;
 
-    st = json_internal_read_object(jb, attrs, NULL, 0);
+    st = json_internal_read_object(jb, attrs, NULL, NULL, 0);
     return st;
 }
 
+int
+json_attr_desc_init(struct json_attr_desc *desc,
+                    const struct json_attr_t *attrs)
+{
+    int num;
+    int i;
+
+    /* insertion sort by name; equal names stay in array order */
+    for (num = 0; attrs[num].attribute != NULL; num++) {
+        if (num >= JSON_ATTR_DESC_MAX) {
+            return JSON_ERR_DESCLEN;
+        }
+        i = num;
+        while (i > 0 && strcmp(attrs[desc->jad_order[i - 1]].attribute,
+                               attrs[num].attribute) > 0) {
+            desc->jad_order[i] = desc->jad_order[i - 1];
+            i--;
+        }
+        desc->jad_order[i] = num;
+    }
+    desc->jad_num_attrs = num;
+
+    return 0;
+}
+
+int
+json_read_object_desc(struct json_buffer *jb, const struct json_attr_t *attrs,
+                      const struct json_attr_desc *desc)
+{
+    assert(attrs[desc->jad_num_attrs].attribute == NULL);
+
+    return json_internal_read_object(jb, attrs, desc, NULL, 0);
+}
+
@@ -24,10 +24,12 @@
 
 TEST_CASE_DECL(test_json_simple_encode);
 TEST_CASE_DECL(test_json_simple_decode);
+TEST_CASE_DECL(test_json_decode_desc);
 
 TEST_SUITE(test_json_suite) {
     test_json_simple_encode();
     test_json_simple_decode();
+    test_json_decode_desc();
 }
 
 #if MYNEWT_VAL(SELFTEST)
@@ -0,0 +1,112 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "test_json.h"
+
+static char *test_desc_input =
+    "{\"abc\": 3, \"a\": 1, \"dup\": 7, \"ab\": \"xy\", \"b\": true}";
+
+/* Decode through the precompiled table gives the same result as the linear
+ * search, including for names that are prefixes of each other and for
+ * adjacent attributes sharing a name. */
+TEST_CASE(test_json_decode_desc)
+{
+    struct json_attr_desc desc;
+    struct test_jbuf tjb;
+    long long int a;
+    long long int abc;
+    long long int dup_int;
+    char dup_str[8];
+    char ab[8];
+    bool b;
+    int rc;
+
+    struct json_attr_t test_attr[] = {
+        [0] = {
+            .attribute = "b",
+            .type = t_boolean,
+            .addr.boolean = &b,
+        },
+        [1] = {
+            .attribute = "abc",
+            .type = t_integer,
+            .addr.integer = &abc,
+        },
+        [2] = {
+            .attribute = "dup",
+            .type = t_string,
+            .addr.string = dup_str,
+            .len = sizeof(dup_str)
+        },
+        [3] = {
+            .attribute = "dup",
+            .type = t_integer,
+            .addr.integer = &dup_int,
+        },
+        [4] = {
+            .attribute = "ab",
+            .type = t_string,
+            .addr.string = ab,
+            .len = sizeof(ab)
+        },
+        [5] = {
+            .attribute = "a",
+            .type = t_integer,
+            .addr.integer = &a,
+        },
+        [6] = {
+            .attribute = NULL
+        }
+    };
+
+    rc = json_attr_desc_init(&desc, test_attr);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(desc.jad_num_attrs == 6);
+
+    test_buf_init(&tjb, test_desc_input);
+    rc = json_read_object_desc(&tjb.json_buf, test_attr, &desc);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(a == 1);
+    TEST_ASSERT(abc == 3);
+    TEST_ASSERT(dup_int == 7);
+    TEST_ASSERT(strcmp(ab, "xy") == 0);
+    TEST_ASSERT(b == true);
+
+    /* Unknown keys, including prefixes and extensions of known ones. */
+    test_buf_init(&tjb, "{\"abd\": 1}");
+    rc = json_read_object_desc(&tjb.json_buf, test_attr, &desc);
+    TEST_ASSERT(rc == JSON_ERR_BADATTR);
+
+    test_buf_init(&tjb, "{\"abcd\": 1}");
+    rc = json_read_object_desc(&tjb.json_buf, test_attr, &desc);
+    TEST_ASSERT(rc == JSON_ERR_BADATTR);
+
+    test_buf_init(&tjb, "{\"du\": 1}");
+    rc = json_read_object_desc(&tjb.json_buf, test_attr, &desc);
+    TEST_ASSERT(rc == JSON_ERR_BADATTR);
+
+    test_buf_init(&tjb, "{\"\": 1}");
+    rc = json_read_object_desc(&tjb.json_buf, test_attr, &desc);
+    TEST_ASSERT(rc == JSON_ERR_BADATTR);
+
+    test_buf_init(&tjb,
+                  "{\"abcdefghijklmnopqrstuvwxyzabcdefgh\": 1}");
+    rc = json_read_object_desc(&tjb.json_buf, test_attr, &desc);
+    TEST_ASSERT(rc == JSON_ERR_ATTRLEN);
+}
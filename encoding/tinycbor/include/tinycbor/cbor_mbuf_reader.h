@@ -27,15 +27,48 @@
 extern "C" {
 #endif
 
+/*
+ * The reader remembers the mbuf holding the last byte it accessed, so a
+ * parse that moves forward through the chain costs O(n) in total rather
+ * than walking the chain from the head on every access.  Seeking backwards
+ * past the start of the cached mbuf restarts from the head.
+ */
 struct cbor_mbuf_reader {
     struct cbor_decoder_reader r;
     int init_off;                     /* initial offset into the data */
     struct os_mbuf *m;
+    struct os_mbuf *cur;              /* cached mbuf */
+    int cur_off;                      /* chain offset of cur's first byte */
 };
 
 void cbor_mbuf_reader_init(struct cbor_mbuf_reader *cb, struct os_mbuf *m,
                            int intial_offset);
 
+/**
+ * Gets direct access to the contents of the definite-length byte or text
+ * string at value, without copying it.  If the string is contained in a
+ * single mbuf, *ptr is pointed at its first byte; otherwise *ptr is set to
+ * NULL and the caller has to fall back to cbor_value_copy_*_string().  In
+ * both cases *len is set to the length of the string.
+ *
+ * The parser of value must be reading through a cbor_mbuf_reader.
+ *
+ * @param value                 The string to access.
+ * @param ptr                   On success, points to the string contents,
+ *                                  or NULL if the string spans mbufs.
+ * @param len                   On success, the string length.
+ * @param next                  If not NULL, updated to point to the item
+ *                                  following the string.
+ *
+ * @return                      CborNoError on success;
+ *                              CborErrorUnknownLength if the string is
+ *                                  chunked;
+ *                              Other CborError on malformed input.
+ */
+CborError cbor_mbuf_reader_string_ptr(const CborValue *value,
+                                      const uint8_t **ptr, size_t *len,
+                                      CborValue *next);
+
 #ifdef __cplusplus
 }
 #endif
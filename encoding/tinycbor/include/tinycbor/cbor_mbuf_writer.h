@@ -27,12 +27,22 @@
 extern "C" {
 #endif
 
+/*
+ * Encodes into an mbuf chain.  Data is copied straight into the free space
+ * at the end of the chain; the mbuf being written to is remembered, so the
+ * chain is not walked on every write.  Room can be reserved up front with
+ * cbor_mbuf_writer_reserve(), e.g. after measuring the encoding with a
+ * cbor_cnt_writer, so the whole response is allocated at once.
+ */
 struct cbor_mbuf_writer {
     struct cbor_encoder_writer enc;
     struct os_mbuf *m;
+    struct os_mbuf *last;
 };
 
 void cbor_mbuf_writer_init(struct cbor_mbuf_writer *cb, struct os_mbuf *m);
+int cbor_mbuf_writer_reserve(struct cbor_mbuf_writer *cb, int len);
+void cbor_mbuf_writer_release(struct cbor_mbuf_writer *cb);
 
 #ifdef __cplusplus
 }
@@ -17,48 +17,155 @@
  * under the License.
  */
 
+#include <string.h>
 #include <tinycbor/cbor_mbuf_reader.h>
-#include <tinycbor/compilersupport_p.h>
+#include <tinycbor/extract_number_p.h>
 #include <os/os_mbuf.h>
 
+/**
+ * Positions the cursor on the mbuf containing the given offset into the
+ * data and returns a pointer to that byte.  The number of bytes that can be
+ * read contiguously from the returned pointer is written to *contig.
+ *
+ * @return                      Pointer to the byte at offset;
+ *                              NULL if offset is past the end of the chain.
+ */
+static uint8_t *
+cbor_mbuf_reader_seek(struct cbor_mbuf_reader *cb, int offset, int *contig)
+{
+    struct os_mbuf *om;
+    int off;
+
+    offset += cb->init_off;
+
+    om = cb->cur;
+    off = cb->cur_off;
+    if (offset < off) {
+        om = cb->m;
+        off = 0;
+    }
+
+    while (om != NULL && offset >= off + om->om_len) {
+        off += om->om_len;
+        om = SLIST_NEXT(om, om_next);
+    }
+    if (om == NULL) {
+        return NULL;
+    }
+
+    cb->cur = om;
+    cb->cur_off = off;
+
+    *contig = off + om->om_len - offset;
+    return om->om_data + (offset - off);
+}
+
+/**
+ * Walks len bytes of data starting at offset one contiguous piece at a
+ * time, either copying them to or comparing them against buf.
+ *
+ * @return                      0 if all bytes were copied or are equal;
+ *                              nonzero otherwise.
+ */
+static int
+cbor_mbuf_reader_walk(struct cbor_mbuf_reader *cb, uint8_t *buf, int offset,
+                      size_t len, int cmp)
+{
+    uint8_t *src;
+    int contig;
+    int chunk;
+    int rc;
+
+    while (len > 0) {
+        src = cbor_mbuf_reader_seek(cb, offset, &contig);
+        if (src == NULL) {
+            return -1;
+        }
+
+        chunk = contig;
+        if ((size_t)chunk > len) {
+            chunk = len;
+        }
+        if (cmp) {
+            rc = memcmp(buf, src, chunk);
+            if (rc != 0) {
+                return rc;
+            }
+        } else {
+            memcpy(buf, src, chunk);
+        }
+
+        buf += chunk;
+        offset += chunk;
+        len -= chunk;
+    }
+
+    return 0;
+}
+
 static uint8_t
 cbor_mbuf_reader_get8(struct cbor_decoder_reader *d, int offset)
 {
-    uint8_t val;
     struct cbor_mbuf_reader *cb = (struct cbor_mbuf_reader *) d;
+    uint8_t *src;
+    int contig;
 
-    os_mbuf_copydata(cb->m, offset + cb->init_off, sizeof(val), &val);
-    return val;
+    src = cbor_mbuf_reader_seek(cb, offset, &contig);
+    if (src == NULL) {
+        return 0;
+    }
+    return *src;
 }
 
 static uint16_t
 cbor_mbuf_reader_get16(struct cbor_decoder_reader *d, int offset)
 {
-    uint16_t val;
     struct cbor_mbuf_reader *cb = (struct cbor_mbuf_reader *) d;
+    uint8_t buf[sizeof(uint16_t)];
+    uint8_t *src;
+    int contig;
 
-    os_mbuf_copydata(cb->m, offset + cb->init_off, sizeof(val), &val);
-    return cbor_ntohs(val);
+    src = cbor_mbuf_reader_seek(cb, offset, &contig);
+    if (src == NULL || contig < (int)sizeof(buf)) {
+        memset(buf, 0, sizeof(buf));
+        cbor_mbuf_reader_walk(cb, buf, offset, sizeof(buf), 0);
+        src = buf;
+    }
+    return get16(src);
 }
 
 static uint32_t
 cbor_mbuf_reader_get32(struct cbor_decoder_reader *d, int offset)
 {
-    uint32_t val;
     struct cbor_mbuf_reader *cb = (struct cbor_mbuf_reader *) d;
+    uint8_t buf[sizeof(uint32_t)];
+    uint8_t *src;
+    int contig;
 
-    os_mbuf_copydata(cb->m, offset + cb->init_off, sizeof(val), &val);
-    return cbor_ntohl(val);
+    src = cbor_mbuf_reader_seek(cb, offset, &contig);
+    if (src == NULL || contig < (int)sizeof(buf)) {
+        memset(buf, 0, sizeof(buf));
+        cbor_mbuf_reader_walk(cb, buf, offset, sizeof(buf), 0);
+        src = buf;
+    }
+    return get32(src);
 }
 
 static uint64_t
 cbor_mbuf_reader_get64(struct cbor_decoder_reader *d, int offset)
 {
-    uint64_t val;
     struct cbor_mbuf_reader *cb = (struct cbor_mbuf_reader *) d;
+    uint8_t buf[sizeof(uint64_t)];
+    uint8_t *src;
+    int contig;
 
-    os_mbuf_copydata(cb->m, offset + cb->init_off, sizeof(val), &val);
-    return cbor_ntohll(val);
+    src = cbor_mbuf_reader_seek(cb, offset, &contig);
+    if (src == NULL || contig < (int)sizeof(buf)) {
+        memset(buf, 0, sizeof(buf));
+        cbor_mbuf_reader_walk(cb, buf, offset, sizeof(buf), 0);
+        src = buf;
+    }
+    return get64(src);
 }
 
 static uintptr_t
@@ -66,21 +173,65 @@ cbor_mbuf_reader_cmp(struct cbor_decoder_reader *d, char *buf, int offset,
                      size_t len)
 {
     struct cbor_mbuf_reader *cb = (struct cbor_mbuf_reader *) d;
-    return os_mbuf_cmpf(cb->m, offset + cb->init_off, buf, len);
+
+    /* The parser expects true if the strings match. */
+    return cbor_mbuf_reader_walk(cb, (uint8_t *)buf, offset, len, 1) == 0;
 }
 
 static uintptr_t
 cbor_mbuf_reader_cpy(struct cbor_decoder_reader *d, char *dst, int offset,
                      size_t len)
 {
-    int rc;
     struct cbor_mbuf_reader *cb = (struct cbor_mbuf_reader *) d;
 
-    rc = os_mbuf_copydata(cb->m, offset + cb->init_off, len, dst);
-    if (rc == 0) {
-        return true;
+    return cbor_mbuf_reader_walk(cb, (uint8_t *)dst, offset, len, 0) == 0;
+}
+
+CborError
+cbor_mbuf_reader_string_ptr(const CborValue *value, const uint8_t **ptr,
+                            size_t *len, CborValue *next)
+{
+    struct cbor_mbuf_reader *cb;
+    uint64_t total;
+    CborError err;
+    uint8_t *src;
+    int offset;
+    int contig;
+
+    assert(cbor_value_is_byte_string(value) ||
+           cbor_value_is_text_string(value));
+    assert(value->parser->d->get8 == &cbor_mbuf_reader_get8);
+
+    if (!cbor_value_is_length_known(value)) {
+        return CborErrorUnknownLength;
+    }
+
+    cb = (struct cbor_mbuf_reader *) value->parser->d;
+    offset = value->offset;
+    err = extract_number(value->parser, &offset, &total);
+    if (err != CborNoError) {
+        return err;
+    }
+    if (total > (uint64_t)(value->parser->end - offset)) {
+        return CborErrorUnexpectedEOF;
+    }
+
+    *ptr = NULL;
+    if (total == 0) {
+        *ptr = (const uint8_t *)"";
+    } else {
+        src = cbor_mbuf_reader_seek(cb, offset, &contig);
+        if (src != NULL && (uint64_t)contig >= total) {
+            *ptr = src;
+        }
+    }
+    *len = total;
+
+    if (next != NULL) {
+        *next = *value;
+        return cbor_value_advance(next);
     }
-    return false;
+    return CborNoError;
 }
 
 void
@@ -100,5 +251,7 @@ cbor_mbuf_reader_init(struct cbor_mbuf_reader *cb, struct os_mbuf *m,
     hdr = OS_MBUF_PKTHDR(m);
     cb->m = m;
     cb->init_off = initial_offset;
+    cb->cur = m;
+    cb->cur_off = 0;
     cb->r.message_size = hdr->omp_len - initial_offset;
 }
@@ -17,31 +17,126 @@
  * under the License.
  */
 
+#include <string.h>
 #include <tinycbor/cbor.h>
 #include <os/os_mbuf.h>
 #include <tinycbor/cbor.h>
 #include <tinycbor/cbor_mbuf_writer.h>
 
+/* Returns the mbuf the next byte goes into; mbufs that were appended to the
+ * chain since the last write are skipped, reserved (empty) ones are not. */
+static struct os_mbuf *
+cbor_mbuf_writer_tail(struct cbor_mbuf_writer *cb)
+{
+    struct os_mbuf *next;
+
+    while ((next = SLIST_NEXT(cb->last, om_next)) != NULL &&
+           next->om_len != 0) {
+        cb->last = next;
+    }
+    return cb->last;
+}
+
 int
 cbor_mbuf_writer(struct cbor_encoder_writer *arg, const char *data, int len)
 {
-    int rc;
     struct cbor_mbuf_writer *cb = (struct cbor_mbuf_writer *) arg;
+    struct os_mbuf *last;
+    struct os_mbuf *om;
+    int space;
+    int rem;
+
+    last = cbor_mbuf_writer_tail(cb);
+    rem = len;
+    while (rem > 0) {
+        space = OS_MBUF_TRAILINGSPACE(last);
+        if (space == 0) {
+            /* use reserved room first, then extend the chain */
+            om = SLIST_NEXT(last, om_next);
+            if (om == NULL) {
+                om = os_mbuf_get(last->om_omp, 0);
+                if (om == NULL) {
+                    break;
+                }
+                SLIST_NEXT(last, om_next) = om;
+            }
+            last = om;
+            continue;
+        }
+        if (space > rem) {
+            space = rem;
+        }
+        memcpy(OS_MBUF_DATA(last, uint8_t *) + last->om_len, data, space);
+        last->om_len += space;
+        data += space;
+        rem -= space;
+    }
+    cb->last = last;
 
-    rc = os_mbuf_append(cb->m, data, len);
-    if (rc) {
+    if (OS_MBUF_IS_PKTHDR(cb->m)) {
+        OS_MBUF_PKTHDR(cb->m)->omp_len += len - rem;
+    }
+    if (rem != 0) {
         return CborErrorOutOfMemory;
     }
     cb->enc.bytes_written += len;
     return CborNoError;
 }
 
+/*
+ * Makes sure there is room for len more bytes at the end of the chain.
+ * What is missing is allocated from msys in as few mbufs as the pools
+ * allow, and linked to the chain empty.  Room left unused once encoding is
+ * done can be given back with cbor_mbuf_writer_release().
+ */
+int
+cbor_mbuf_writer_reserve(struct cbor_mbuf_writer *cb, int len)
+{
+    struct os_mbuf *last;
+    struct os_mbuf *om;
+    int space;
+
+    last = cbor_mbuf_writer_tail(cb);
+    space = OS_MBUF_TRAILINGSPACE(last);
+    while (SLIST_NEXT(last, om_next) != NULL) {
+        last = SLIST_NEXT(last, om_next);
+        space += OS_MBUF_TRAILINGSPACE(last);
+    }
+
+    while (space < len) {
+        om = os_msys_get(len - space, 0);
+        if (om == NULL) {
+            return CborErrorOutOfMemory;
+        }
+        SLIST_NEXT(last, om_next) = om;
+        last = om;
+        space += OS_MBUF_TRAILINGSPACE(om);
+    }
+    return CborNoError;
+}
+
+/*
+ * Frees the reserved mbufs that were not written to.
+ */
+void
+cbor_mbuf_writer_release(struct cbor_mbuf_writer *cb)
+{
+    struct os_mbuf *last;
+    struct os_mbuf *om;
+
+    last = cbor_mbuf_writer_tail(cb);
+    om = SLIST_NEXT(last, om_next);
+    if (om != NULL) {
+        SLIST_NEXT(last, om_next) = NULL;
+        os_mbuf_free_chain(om);
+    }
+}
 
 void
 cbor_mbuf_writer_init(struct cbor_mbuf_writer *cb, struct os_mbuf *m)
 {
     cb->m = m;
+    cb->last = m;
     cb->enc.bytes_written = 0;
     cb->enc.write = &cbor_mbuf_writer;
 }
-
@@ -903,6 +903,31 @@ CborError cbor_value_calculate_string_length(const CborValue *value, size_t *len
     return _cbor_value_copy_string(value, NULL, len, NULL);
 }
 
+/**
+ * Retrieves the offset at which the contents of the byte or text string that
+ * \a value points to start in the reader, and the length of the string, so
+ * that it can be examined in place with the reader's get8 and cmp functions.
+ *
+ * This function only works for strings of known length; for strings sent in
+ * chunks it returns \ref CborErrorUnknownLength.
+ *
+ * \sa cbor_value_get_string_length(), cbor_value_is_length_known()
+ */
+CborError cbor_value_get_string_offset(const CborValue *value, int *offset, size_t *len)
+{
+    assert(cbor_value_is_byte_string(value) || cbor_value_is_text_string(value));
+    if (!cbor_value_is_length_known(value))
+        return CborErrorUnknownLength;
+
+    *offset = value->offset;
+    CborError err = extract_length(value->parser, offset, len);
+    if (err)
+        return err;
+    if (*len > (size_t)(value->parser->end - *offset))
+        return CborErrorUnexpectedEOF;
+    return CborNoError;
+}
+
 /* We return uintptr_t so that we can pass memcpy directly as the iteration
  * function. The choice is to optimize for memcpy, which is used in the base
  * parser API (cbor_value_copy_string), while memcmp is used in convenience API
@@ -0,0 +1,82 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef TEST_TINYCBOR_H
+#define TEST_TINYCBOR_H
+
+#include <assert.h>
+#include <string.h>
+#include "os/os.h"
+#include "testutil/testutil.h"
+#include "tinycbor/cbor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Largest payload built by the tests. */
+#define TEST_TINYCBOR_PAYLOAD_MAX       (2048)
+
+/* Data bytes in each mbuf of the test pool. */
+#define TEST_TINYCBOR_MBUF_DATA         (32)
+
+/*
+ * Sets up the test mbuf pool.
+ */
+void test_tinycbor_mbuf_init(void);
+
+/*
+ * Encodes a map of the given number of entries with the writer.  Each entry
+ * holds integers, a byte string and a text string.
+ */
+void test_tinycbor_encode(struct cbor_encoder_writer *writer,
+                          int num_entries);
+
+/*
+ * Encodes a map of the given number of entries into buf.  Each entry holds
+ * integers, a byte string and a text string.  Returns the encoded length.
+ */
+int test_tinycbor_payload(uint8_t *buf, int buflen, int num_entries);
+
+/*
+ * Builds a packet of hdr_len bytes of filler followed by data, with at most
+ * seg_len bytes in each mbuf.
+ */
+struct os_mbuf *test_tinycbor_chain(const uint8_t *data, int len,
+                                    int hdr_len, int seg_len);
+
+/*
+ * Walks every item reachable from the value, copying out strings.  Returns a
+ * checksum of the contents, or -1 on a parse error.
+ */
+int64_t test_tinycbor_walk(CborValue *value);
+
+/*
+ * Testcases
+ */
+TEST_CASE_DECL(test_tinycbor_mbuf_chain);
+TEST_CASE_DECL(test_tinycbor_mbuf_string_ptr);
+TEST_CASE_DECL(test_tinycbor_mbuf_bench);
+TEST_CASE_DECL(test_tinycbor_mbuf_writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEST_TINYCBOR_H */
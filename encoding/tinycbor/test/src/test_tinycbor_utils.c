@@ -0,0 +1,201 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdio.h>
+#include "tinycbor/cbor.h"
+#include "tinycbor/cbor_buf_writer.h"
+#include "test_tinycbor.h"
+
+#define TEST_TINYCBOR_MBUF_BLOCK_SIZE                                   \
+    (TEST_TINYCBOR_MBUF_DATA + sizeof(struct os_mbuf) +                 \
+     sizeof(struct os_mbuf_pkthdr))
+#define TEST_TINYCBOR_MBUF_COUNT                                        \
+    (TEST_TINYCBOR_PAYLOAD_MAX / 16 + 32)
+
+static os_membuf_t test_tinycbor_membuf[
+    OS_MEMPOOL_SIZE(TEST_TINYCBOR_MBUF_COUNT, TEST_TINYCBOR_MBUF_BLOCK_SIZE)];
+
+static struct os_mbuf_pool test_tinycbor_mbuf_pool;
+static struct os_mempool test_tinycbor_mempool;
+
+void
+test_tinycbor_mbuf_init(void)
+{
+    int rc;
+
+    rc = os_mempool_init(&test_tinycbor_mempool, TEST_TINYCBOR_MBUF_COUNT,
+                         TEST_TINYCBOR_MBUF_BLOCK_SIZE, test_tinycbor_membuf,
+                         "tinycbor_mbuf");
+    TEST_ASSERT_FATAL(rc == 0);
+
+    rc = os_mbuf_pool_init(&test_tinycbor_mbuf_pool, &test_tinycbor_mempool,
+                           TEST_TINYCBOR_MBUF_BLOCK_SIZE,
+                           TEST_TINYCBOR_MBUF_COUNT);
+    TEST_ASSERT_FATAL(rc == 0);
+}
+
+void
+test_tinycbor_encode(struct cbor_encoder_writer *writer, int num_entries)
+{
+    CborEncoder encoder;
+    CborEncoder map;
+    CborEncoder array;
+    uint8_t bytes[24];
+    char str[16];
+    int i;
+    int j;
+
+    cbor_encoder_init(&encoder, writer, 0);
+
+    cbor_encoder_create_map(&encoder, &map, num_entries);
+    for (i = 0; i < num_entries; i++) {
+        snprintf(str, sizeof str, "key%d", i);
+        cbor_encode_text_stringz(&map, str);
+
+        cbor_encoder_create_array(&map, &array, CborIndefiniteLength);
+        cbor_encode_uint(&array, i);
+        cbor_encode_int(&array, -1000 * i);
+        cbor_encode_uint(&array, 0x100000000ULL + i);
+        for (j = 0; j < sizeof bytes; j++) {
+            bytes[j] = i + j;
+        }
+        cbor_encode_byte_string(&array, bytes, (i % sizeof bytes) + 1);
+        snprintf(str, sizeof str, "value-%d", i * 7);
+        cbor_encode_text_stringz(&array, str);
+        cbor_encoder_close_container(&map, &array);
+    }
+    cbor_encoder_close_container(&encoder, &map);
+}
+
+int
+test_tinycbor_payload(uint8_t *buf, int buflen, int num_entries)
+{
+    struct cbor_buf_writer writer;
+
+    cbor_buf_writer_init(&writer, buf, buflen);
+    test_tinycbor_encode(&writer.enc, num_entries);
+
+    TEST_ASSERT_FATAL(writer.ptr < writer.end);
+    return cbor_buf_writer_buffer_size(&writer, buf);
+}
+
+struct os_mbuf *
+test_tinycbor_chain(const uint8_t *data, int len, int hdr_len, int seg_len)
+{
+    struct os_mbuf *prev;
+    struct os_mbuf *om;
+    struct os_mbuf *m;
+    int off;
+    int n;
+    int i;
+
+    TEST_ASSERT_FATAL(seg_len <= TEST_TINYCBOR_MBUF_DATA);
+
+    m = os_mbuf_get_pkthdr(&test_tinycbor_mbuf_pool, 0);
+    TEST_ASSERT_FATAL(m != NULL);
+
+    prev = NULL;
+    om = m;
+    for (off = 0; off < hdr_len + len; off += n) {
+        if (prev != NULL) {
+            om = os_mbuf_get(&test_tinycbor_mbuf_pool, 0);
+            TEST_ASSERT_FATAL(om != NULL);
+            SLIST_NEXT(prev, om_next) = om;
+        }
+
+        n = min(seg_len, hdr_len + len - off);
+        for (i = 0; i < n; i++) {
+            if (off + i < hdr_len) {
+                om->om_data[i] = 0xee;
+            } else {
+                om->om_data[i] = data[off + i - hdr_len];
+            }
+        }
+        om->om_len = n;
+        OS_MBUF_PKTHDR(m)->omp_len += n;
+        prev = om;
+    }
+
+    return m;
+}
+
+int64_t
+test_tinycbor_walk(CborValue *value)
+{
+    CborValue inner;
+    uint8_t buf[64];
+    uint64_t sum;
+    int64_t rc;
+    uint64_t u;
+    size_t len;
+    int i;
+
+    sum = 0;
+    while (!cbor_value_at_end(value)) {
+        switch (cbor_value_get_type(value)) {
+        case CborIntegerType:
+            if (cbor_value_get_raw_integer(value, &u) != CborNoError) {
+                return -1;
+            }
+            sum += u;
+            break;
+
+        case CborByteStringType:
+        case CborTextStringType:
+            len = sizeof buf;
+            if (cbor_value_is_byte_string(value)) {
+                rc = cbor_value_copy_byte_string(value, buf, &len, NULL);
+            } else {
+                rc = cbor_value_copy_text_string(value, (char *)buf, &len,
+                                                 NULL);
+            }
+            if (rc != CborNoError) {
+                return -1;
+            }
+            for (i = 0; i < len; i++) {
+                sum = sum * 31 + buf[i];
+            }
+            break;
+
+        case CborArrayType:
+        case CborMapType:
+            if (cbor_value_enter_container(value, &inner) != CborNoError) {
+                return -1;
+            }
+            rc = test_tinycbor_walk(&inner);
+            if (rc < 0) {
+                return -1;
+            }
+            sum += rc;
+            if (cbor_value_leave_container(value, &inner) != CborNoError) {
+                return -1;
+            }
+            continue;
+
+        default:
+            return -1;
+        }
+
+        if (cbor_value_advance(value) != CborNoError) {
+            return -1;
+        }
+    }
+
+    return sum & INT64_MAX;
+}
@@ -0,0 +1,206 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "os/endian.h"
+#include "console/console.h"
+#include "tinycbor/cbor_buf_reader.h"
+#include "tinycbor/cbor_mbuf_reader.h"
+#include "test_tinycbor.h"
+
+#define TEST_BENCH_SEG_LEN      (16)
+#define TEST_BENCH_RUNS         (50)
+#define TEST_BENCH_ROUNDS       (5)
+
+static uint8_t test_bench_buf[TEST_TINYCBOR_PAYLOAD_MAX];
+
+/*
+ * Reference reader that looks up every access from the head of the chain,
+ * for comparison.
+ */
+struct test_bench_copy_reader {
+    struct cbor_decoder_reader r;
+    struct os_mbuf *m;
+};
+
+static uint8_t
+test_bench_copy_get8(struct cbor_decoder_reader *d, int offset)
+{
+    struct test_bench_copy_reader *cr = (struct test_bench_copy_reader *)d;
+    uint8_t val;
+
+    os_mbuf_copydata(cr->m, offset, sizeof val, &val);
+    return val;
+}
+
+static uint16_t
+test_bench_copy_get16(struct cbor_decoder_reader *d, int offset)
+{
+    struct test_bench_copy_reader *cr = (struct test_bench_copy_reader *)d;
+    uint16_t val;
+
+    os_mbuf_copydata(cr->m, offset, sizeof val, &val);
+    return ntohs(val);
+}
+
+static uint32_t
+test_bench_copy_get32(struct cbor_decoder_reader *d, int offset)
+{
+    struct test_bench_copy_reader *cr = (struct test_bench_copy_reader *)d;
+    uint32_t val;
+
+    os_mbuf_copydata(cr->m, offset, sizeof val, &val);
+    return ntohl(val);
+}
+
+static uint64_t
+test_bench_copy_get64(struct cbor_decoder_reader *d, int offset)
+{
+    struct test_bench_copy_reader *cr = (struct test_bench_copy_reader *)d;
+    uint32_t val[2];
+
+    os_mbuf_copydata(cr->m, offset, sizeof val, val);
+    return ((uint64_t)ntohl(val[0]) << 32) | ntohl(val[1]);
+}
+
+static uintptr_t
+test_bench_copy_cmp(struct cbor_decoder_reader *d, char *buf, int offset,
+                    size_t len)
+{
+    struct test_bench_copy_reader *cr = (struct test_bench_copy_reader *)d;
+
+    return os_mbuf_cmpf(cr->m, offset, buf, len) == 0;
+}
+
+static uintptr_t
+test_bench_copy_cpy(struct cbor_decoder_reader *d, char *dst, int offset,
+                    size_t len)
+{
+    struct test_bench_copy_reader *cr = (struct test_bench_copy_reader *)d;
+
+    return os_mbuf_copydata(cr->m, offset, len, dst) == 0;
+}
+
+static void
+test_bench_copy_reader_init(struct test_bench_copy_reader *cr,
+                            struct os_mbuf *m)
+{
+    cr->r.get8 = test_bench_copy_get8;
+    cr->r.get16 = test_bench_copy_get16;
+    cr->r.get32 = test_bench_copy_get32;
+    cr->r.get64 = test_bench_copy_get64;
+    cr->r.cmp = test_bench_copy_cmp;
+    cr->r.cpy = test_bench_copy_cpy;
+    cr->r.message_size = OS_MBUF_PKTLEN(m);
+    cr->m = m;
+}
+
+/*
+ * Parses the payload TEST_BENCH_RUNS times, TEST_BENCH_ROUNDS over, and
+ * returns the best time per byte in nsecs.  Taking the fastest round keeps
+ * the figure steady when the host preempts the simulator.
+ */
+static uint32_t
+test_bench_parse(struct cbor_decoder_reader *r, int64_t expected, int len)
+{
+    CborParser parser;
+    CborValue value;
+    uint32_t start;
+    uint32_t usecs;
+    uint32_t best;
+    int round;
+    int rc;
+    int i;
+
+    best = UINT32_MAX;
+    for (round = 0; round < TEST_BENCH_ROUNDS; round++) {
+        start = tu_time_usecs();
+        for (i = 0; i < TEST_BENCH_RUNS; i++) {
+            rc = cbor_parser_init(r, 0, &parser, &value);
+            TEST_ASSERT_FATAL(rc == CborNoError);
+            TEST_ASSERT(test_tinycbor_walk(&value) == expected);
+        }
+        usecs = tu_time_usecs() - start;
+        if (usecs < best) {
+            best = usecs;
+        }
+    }
+
+    return (uint64_t)best * 1000 / ((uint32_t)TEST_BENCH_RUNS * len);
+}
+
+/*
+ * Times a full parse of payloads of growing length, split into short mbufs,
+ * with the cursor reader and with the reference reader.  The cursor
+ * reader's time per byte must stay flat as the chain gets longer; the
+ * reference reader's grows with it.
+ */
+TEST_CASE(test_tinycbor_mbuf_bench)
+{
+    struct test_bench_copy_reader cr;
+    struct cbor_mbuf_reader cmr;
+    struct cbor_buf_reader cbr;
+    struct os_mbuf *m;
+    CborParser parser;
+    CborValue value;
+    int64_t expected;
+    uint32_t cursor_first;
+    uint32_t cursor_ns;
+    uint32_t copy_ns;
+    int entries;
+    int len;
+    int rc;
+
+    test_tinycbor_mbuf_init();
+
+    cursor_first = 0;
+    cursor_ns = 0;
+    for (entries = 5; entries <= 40; entries *= 2) {
+        len = test_tinycbor_payload(test_bench_buf, sizeof test_bench_buf,
+                                    entries);
+
+        cbor_buf_reader_init(&cbr, test_bench_buf, len);
+        rc = cbor_parser_init(&cbr.r, 0, &parser, &value);
+        TEST_ASSERT_FATAL(rc == CborNoError);
+        expected = test_tinycbor_walk(&value);
+
+        m = test_tinycbor_chain(test_bench_buf, len, 0, TEST_BENCH_SEG_LEN);
+
+        cbor_mbuf_reader_init(&cmr, m, 0);
+        cursor_ns = test_bench_parse(&cmr.r, expected, len);
+        if (cursor_first == 0) {
+            cursor_first = cursor_ns;
+        }
+
+        test_bench_copy_reader_init(&cr, m);
+        copy_ns = test_bench_parse(&cr.r, expected, len);
+
+        console_printf("cbor_mbuf_reader: %d bytes in %d mbufs: "
+                       "cursor %lu ns/byte, copydata %lu ns/byte\n",
+                       len, (len + TEST_BENCH_SEG_LEN - 1) / TEST_BENCH_SEG_LEN,
+                       (unsigned long)cursor_ns, (unsigned long)copy_ns);
+
+        os_mbuf_free_chain(m);
+    }
+
+    /*
+     * Eight times the chain length; allow for noise, but not for a cost
+     * that scales with the number of mbufs.
+     */
+    TEST_ASSERT(cursor_ns <= 2 * cursor_first + 1);
+}
@@ -0,0 +1,82 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "tinycbor/cbor_buf_reader.h"
+#include "tinycbor/cbor_mbuf_reader.h"
+#include "test_tinycbor.h"
+
+static uint8_t test_chain_buf[TEST_TINYCBOR_PAYLOAD_MAX];
+
+/*
+ * Parse the same payload from chains of various segment sizes and check
+ * that the result matches the flat buffer reader.
+ */
+TEST_CASE(test_tinycbor_mbuf_chain)
+{
+    static const int seg_lens[] = { 1, 2, 3, 7, 16, TEST_TINYCBOR_MBUF_DATA };
+    struct cbor_mbuf_reader cmr;
+    struct cbor_buf_reader cbr;
+    struct os_mbuf *m;
+    CborParser parser;
+    CborValue value;
+    CborValue elem;
+    int64_t expected;
+    int64_t sum;
+    int hdr_len;
+    int len;
+    int rc;
+    int i;
+
+    test_tinycbor_mbuf_init();
+
+    len = test_tinycbor_payload(test_chain_buf, sizeof test_chain_buf, 4);
+
+    cbor_buf_reader_init(&cbr, test_chain_buf, len);
+    rc = cbor_parser_init(&cbr.r, 0, &parser, &value);
+    TEST_ASSERT_FATAL(rc == CborNoError);
+    expected = test_tinycbor_walk(&value);
+    TEST_ASSERT_FATAL(expected > 0);
+
+    for (hdr_len = 0; hdr_len <= 5; hdr_len += 5) {
+        for (i = 0; i < sizeof seg_lens / sizeof seg_lens[0]; i++) {
+            m = test_tinycbor_chain(test_chain_buf, len, hdr_len, seg_lens[i]);
+
+            cbor_mbuf_reader_init(&cmr, m, hdr_len);
+            TEST_ASSERT(cmr.r.message_size == len);
+            rc = cbor_parser_init(&cmr.r, 0, &parser, &value);
+            TEST_ASSERT_FATAL(rc == CborNoError);
+            sum = test_tinycbor_walk(&value);
+            TEST_ASSERT(sum == expected, "seg_len=%d hdr_len=%d",
+                        seg_lens[i], hdr_len);
+
+            /* Key lookup seeks back to the start of the chain. */
+            rc = cbor_parser_init(&cmr.r, 0, &parser, &value);
+            TEST_ASSERT_FATAL(rc == CborNoError);
+            rc = cbor_value_map_find_value(&value, "key3", &elem);
+            TEST_ASSERT(rc == CborNoError);
+            TEST_ASSERT(cbor_value_is_array(&elem));
+
+            rc = cbor_value_map_find_value(&value, "key99", &elem);
+            TEST_ASSERT(rc == CborNoError);
+            TEST_ASSERT(!cbor_value_is_valid(&elem));
+
+            os_mbuf_free_chain(m);
+        }
+    }
+}
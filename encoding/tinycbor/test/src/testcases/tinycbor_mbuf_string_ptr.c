@@ -0,0 +1,106 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "tinycbor/cbor_mbuf_reader.h"
+#include "test_tinycbor.h"
+
+/* ["0123456789abcdefghij", 5] */
+static const uint8_t test_string_ptr_def[] = {
+    0x82, 0x74, '0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
+    'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 0x05
+};
+
+/* [(_ "ab", "c")] */
+static const uint8_t test_string_ptr_indef[] = {
+    0x81, 0x7f, 0x62, 'a', 'b', 0x61, 'c', 0xff
+};
+
+static void
+test_string_ptr_one(int hdr_len, int contiguous)
+{
+    struct cbor_mbuf_reader cmr;
+    struct os_mbuf *m;
+    CborParser parser;
+    CborValue value;
+    CborValue array;
+    CborValue next;
+    const uint8_t *ptr;
+    uint64_t u;
+    size_t len;
+    int rc;
+
+    m = test_tinycbor_chain(test_string_ptr_def,
+                            sizeof test_string_ptr_def, hdr_len,
+                            TEST_TINYCBOR_MBUF_DATA);
+    cbor_mbuf_reader_init(&cmr, m, hdr_len);
+    rc = cbor_parser_init(&cmr.r, 0, &parser, &value);
+    TEST_ASSERT_FATAL(rc == CborNoError);
+    rc = cbor_value_enter_container(&value, &array);
+    TEST_ASSERT_FATAL(rc == CborNoError);
+
+    rc = cbor_mbuf_reader_string_ptr(&array, &ptr, &len, &next);
+    TEST_ASSERT(rc == CborNoError);
+    TEST_ASSERT(len == 20);
+    if (contiguous) {
+        TEST_ASSERT_FATAL(ptr != NULL);
+        TEST_ASSERT(memcmp(ptr, "0123456789abcdefghij", 20) == 0);
+    } else {
+        TEST_ASSERT(ptr == NULL);
+    }
+
+    TEST_ASSERT(cbor_value_is_unsigned_integer(&next));
+    cbor_value_get_raw_integer(&next, &u);
+    TEST_ASSERT(u == 5);
+
+    os_mbuf_free_chain(m);
+}
+
+TEST_CASE(test_tinycbor_mbuf_string_ptr)
+{
+    struct cbor_mbuf_reader cmr;
+    struct os_mbuf *m;
+    CborParser parser;
+    CborValue value;
+    CborValue array;
+    const uint8_t *ptr;
+    size_t len;
+    int rc;
+
+    test_tinycbor_mbuf_init();
+
+    /* String within the first mbuf. */
+    test_string_ptr_one(0, 1);
+
+    /* String split across two mbufs. */
+    test_string_ptr_one(TEST_TINYCBOR_MBUF_DATA - 8, 0);
+
+    /* Chunked strings have no single location. */
+    m = test_tinycbor_chain(test_string_ptr_indef,
+                            sizeof test_string_ptr_indef, 0,
+                            TEST_TINYCBOR_MBUF_DATA);
+    cbor_mbuf_reader_init(&cmr, m, 0);
+    rc = cbor_parser_init(&cmr.r, 0, &parser, &value);
+    TEST_ASSERT_FATAL(rc == CborNoError);
+    rc = cbor_value_enter_container(&value, &array);
+    TEST_ASSERT_FATAL(rc == CborNoError);
+    rc = cbor_mbuf_reader_string_ptr(&array, &ptr, &len, NULL);
+    TEST_ASSERT(rc == CborErrorUnknownLength);
+
+    os_mbuf_free_chain(m);
+}
@@ -0,0 +1,108 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "tinycbor/cbor.h"
+#include "tinycbor/cbor_buf_writer.h"
+#include "tinycbor/cbor_cnt_writer.h"
+#include "tinycbor/cbor_mbuf_writer.h"
+#include "test_tinycbor.h"
+
+static uint8_t test_writer_flat[TEST_TINYCBOR_PAYLOAD_MAX];
+static uint8_t test_writer_copy[TEST_TINYCBOR_PAYLOAD_MAX];
+
+static void
+test_writer_check(struct os_mbuf *m, int hdr_len, int len)
+{
+    struct os_mbuf *om;
+    int rc;
+
+    TEST_ASSERT(OS_MBUF_PKTLEN(m) == hdr_len + len);
+    rc = os_mbuf_copydata(m, hdr_len, len, test_writer_copy);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(memcmp(test_writer_copy, test_writer_flat, len) == 0);
+
+    /* No empty mbufs are left behind. */
+    for (om = m; om != NULL; om = SLIST_NEXT(om, om_next)) {
+        TEST_ASSERT(om->om_len != 0);
+    }
+}
+
+/*
+ * Encode into mbuf chains, with and without a measuring pass, and check the
+ * result against the flat buffer encoding.
+ */
+TEST_CASE(test_tinycbor_mbuf_writer)
+{
+    struct cbor_mbuf_writer writer;
+    struct CborCntWriter cnt;
+    struct os_mbuf *m;
+    int len;
+    int rc;
+
+    test_tinycbor_mbuf_init();
+
+    len = test_tinycbor_payload(test_writer_flat, sizeof test_writer_flat,
+                                24);
+
+    /* The counting writer measures the same length. */
+    cbor_cnt_writer_init(&cnt);
+    test_tinycbor_encode(&cnt.enc, 24);
+    TEST_ASSERT_FATAL(cnt.enc.bytes_written == len);
+
+    /* Without reserving, the chain grows as needed. */
+    m = test_tinycbor_chain(NULL, 0, 3, TEST_TINYCBOR_MBUF_DATA);
+    cbor_mbuf_writer_init(&writer, m);
+    test_tinycbor_encode(&writer.enc, 24);
+    TEST_ASSERT(writer.enc.bytes_written == len);
+    test_writer_check(m, 3, len);
+    os_mbuf_free_chain(m);
+
+    /* Reserve the measured length first. */
+    m = test_tinycbor_chain(NULL, 0, 3, TEST_TINYCBOR_MBUF_DATA);
+    cbor_mbuf_writer_init(&writer, m);
+    rc = cbor_mbuf_writer_reserve(&writer, cnt.enc.bytes_written);
+    TEST_ASSERT_FATAL(rc == 0);
+    test_tinycbor_encode(&writer.enc, 24);
+    TEST_ASSERT(writer.enc.bytes_written == len);
+    cbor_mbuf_writer_release(&writer);
+    test_writer_check(m, 3, len);
+    os_mbuf_free_chain(m);
+
+    /* Room reserved but not used is given back. */
+    m = test_tinycbor_chain(NULL, 0, 3, TEST_TINYCBOR_MBUF_DATA);
+    cbor_mbuf_writer_init(&writer, m);
+    rc = cbor_mbuf_writer_reserve(&writer, 2 * len);
+    TEST_ASSERT_FATAL(rc == 0);
+    test_tinycbor_encode(&writer.enc, 24);
+    cbor_mbuf_writer_release(&writer);
+    test_writer_check(m, 3, len);
+    os_mbuf_free_chain(m);
+
+    /* Data appended to the chain between writes is not overwritten. */
+    m = test_tinycbor_chain(NULL, 0, 3, TEST_TINYCBOR_MBUF_DATA);
+    cbor_mbuf_writer_init(&writer, m);
+    rc = writer.enc.write(&writer.enc, (char *)test_writer_flat, 40);
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = os_mbuf_append(m, test_writer_flat + 40, 40);
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = writer.enc.write(&writer.enc, (char *)test_writer_flat + 80,
+                          len - 80);
+    TEST_ASSERT_FATAL(rc == 0);
+    test_writer_check(m, 3, len);
+    os_mbuf_free_chain(m);
+}
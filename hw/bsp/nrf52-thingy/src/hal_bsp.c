@@ -188,6 +188,7 @@ config_lis2dh12_sensor(void)
     cfg.lc_s_mask = SENSOR_TYPE_ACCELEROMETER;
     cfg.lc_rate = LIS2DH12_DATA_RATE_HN_1344HZ_L_5376HZ;
     cfg.lc_fs = LIS2DH12_FS_2G;
+    cfg.lc_int1_pin = -1;
     cfg.lc_pull_up_disc = 1;
 
     rc = lis2dh12_config((struct lis2dh12 *)dev, &cfg);
@@ -159,6 +159,10 @@ struct bno055_cfg {
     uint8_t bc_mag_opr_mode;
     uint8_t bc_use_ext_xtal;
     uint32_t bc_mask;
+    /* MCU pin the INT output is connected to, for data ready
+     * notification; -1 if not connected
+     */
+    int16_t bc_int_pin;
 };
 
 struct bno055 {
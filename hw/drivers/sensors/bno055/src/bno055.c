@@ -25,7 +25,9 @@
 #include "os/os.h"
 #include "sysinit/sysinit.h"
 #include "hal/hal_i2c.h"
+#include "hal/hal_gpio.h"
 #include "sensor/sensor.h"
+#include "sensor/sensor_bus.h"
 #include "sensor/accel.h"
 #include "sensor/mag.h"
 #include "sensor/quat.h"
@@ -73,12 +75,49 @@ static int bno055_sensor_read(struct sensor *, sensor_type_t,
         sensor_data_func_t, void *, uint32_t);
 static int bno055_sensor_get_config(struct sensor *, sensor_type_t,
         struct sensor_cfg *);
+static int bno055_sensor_set_data_ready(struct sensor *, sensor_type_t, int);
+static int bno055_int_reset(struct sensor *);
 
 static const struct sensor_driver g_bno055_sensor_driver = {
     bno055_sensor_read,
-    bno055_sensor_get_config
+    bno055_sensor_get_config,
+    NULL,
+    bno055_sensor_set_data_ready
 };
 
+/**
+ * Accesses registers through the sensor bus manager, which combines the
+ * register address write with the data transfer
+ *
+ * @param The Sensor interface
+ * @param The register address
+ * @param The data buffer
+ * @param Number of bytes
+ * @param 1 to write, 0 to read
+ *
+ * @return 0 on success, non-zero error on failure.
+ */
+static int
+bno055_bus_xfer(struct sensor_itf *itf, uint8_t reg, uint8_t *buffer,
+                uint8_t len, int write)
+{
+    int rc;
+
+    if (write) {
+        rc = sensor_bus_write_reg(itf, reg, buffer, len, NULL);
+    } else {
+        rc = sensor_bus_read_reg(itf, reg, buffer, len, NULL);
+    }
+    if (rc) {
+        BNO055_ERR("I2C access failed at 0x%02X:0x%02X\n", itf->si_addr, reg);
+#if MYNEWT_VAL(BNO055_STATS)
+        STATS_INC(g_bno055stats, errors);
+#endif
+    }
+
+    return rc;
+}
+
 /**
  * Writes a single byte to the specified register
  *
@@ -100,6 +139,10 @@ bno055_write8(struct sensor_itf *itf, uint8_t reg, uint8_t value)
         .buffer = payload
     };
 
+    if (sensor_bus_evq_get(itf) != NULL) {
+        return bno055_bus_xfer(itf, reg, &value, 1, 1);
+    }
+
     rc = hal_i2c_master_write(itf->si_num, &data_struct, OS_TICKS_PER_SEC, 1);
     if (rc) {
         BNO055_ERR("Failed to write to 0x%02X:0x%02X with value 0x%02X\n",
@@ -136,6 +179,10 @@ bno055_writelen(struct sensor_itf *itf, uint8_t reg, uint8_t *buffer,
         .buffer = payload
     };
 
+    if (sensor_bus_evq_get(itf) != NULL) {
+        return bno055_bus_xfer(itf, reg, buffer, len, 1);
+    }
+
     memcpy(&payload[1], buffer, len);
 
     /* Register write */
@@ -185,6 +232,10 @@ bno055_read8(struct sensor_itf *itf, uint8_t reg, uint8_t *value)
         .buffer = &payload
     };
 
+    if (sensor_bus_evq_get(itf) != NULL) {
+        return bno055_bus_xfer(itf, reg, value, 1, 0);
+    }
+
     /* Register write */
     payload = reg;
     rc = hal_i2c_master_write(itf->si_num, &data_struct, OS_TICKS_PER_SEC / 10, 0);
@@ -240,6 +291,10 @@ bno055_readlen(struct sensor_itf *itf, uint8_t reg, uint8_t *buffer,
     /* Clear the supplied buffer */
     memset(buffer, 0, len);
 
+    if (sensor_bus_evq_get(itf) != NULL) {
+        return bno055_bus_xfer(itf, reg, buffer, len, 0);
+    }
+
     /* Register write */
     rc = hal_i2c_master_write(itf->si_num, &data_struct, OS_TICKS_PER_SEC / 10, 1);
     if (rc) {
@@ -780,6 +835,7 @@ bno055_config(struct bno055 *bno055, struct bno055_cfg *cfg)
     }
 
     bno055->cfg.bc_use_ext_xtal = cfg->bc_use_ext_xtal;
+    bno055->cfg.bc_int_pin = cfg->bc_int_pin;
 
     /* Setting units and data output format */
     rc = bno055_set_units(itf, cfg->bc_units);
@@ -853,15 +909,11 @@ int
 bno055_get_quat_data(struct sensor_itf *itf, void *datastruct)
 {
     uint8_t buffer[8];
-    double scale;
     int rc;
     struct sensor_quat_data *sqd;
 
     sqd = (struct sensor_quat_data *)datastruct;
 
-    /* As per Section 3.6.5.5 Orientation (Quaternion) */
-    scale = (1.0 / (1<<14));
-
     memset (buffer, 0, 8);
 
     /* Read quat data */
@@ -871,10 +923,15 @@ bno055_get_quat_data(struct sensor_itf *itf, void *datastruct)
         goto err;
     }
 
-    sqd->sqd_w = ((((uint16_t)buffer[1]) << 8) | ((uint16_t)buffer[0])) * scale;
-    sqd->sqd_x = ((((uint16_t)buffer[3]) << 8) | ((uint16_t)buffer[2])) * scale;
-    sqd->sqd_y = ((((uint16_t)buffer[5]) << 8) | ((uint16_t)buffer[4])) * scale;
-    sqd->sqd_z = ((((uint16_t)buffer[7]) << 8) | ((uint16_t)buffer[6])) * scale;
+    /* As per Section 3.6.5.5 Orientation (Quaternion), 1 = 2^14 LSB */
+    sqd->sqd_w = SENSOR_VAL_SCALE((int16_t)((buffer[1] << 8) | buffer[0]),
+                                  1.0 / (1 << 14), SENSOR_QUAT_Q);
+    sqd->sqd_x = SENSOR_VAL_SCALE((int16_t)((buffer[3] << 8) | buffer[2]),
+                                  1.0 / (1 << 14), SENSOR_QUAT_Q);
+    sqd->sqd_y = SENSOR_VAL_SCALE((int16_t)((buffer[5] << 8) | buffer[4]),
+                                  1.0 / (1 << 14), SENSOR_QUAT_Q);
+    sqd->sqd_z = SENSOR_VAL_SCALE((int16_t)((buffer[7] << 8) | buffer[6]),
+                                  1.0 / (1 << 14), SENSOR_QUAT_Q);
 
     sqd->sqd_w_is_valid = 1;
     sqd->sqd_x_is_valid = 1;
@@ -944,9 +1001,9 @@ bno055_get_vector_data(struct sensor_itf *itf, void *datastruct, int type)
     struct sensor_euler_data *sed;
     uint8_t reg;
     uint8_t units;
-    float acc_div;
-    float gyro_div;
-    float euler_div;
+    int16_t acc_div;
+    int16_t gyro_div;
+    int16_t euler_div;
 
     int rc;
 
@@ -973,9 +1030,9 @@ bno055_get_vector_data(struct sensor_itf *itf, void *datastruct, int type)
         goto err;
     }
 
-    acc_div  = units & BNO055_ACC_UNIT_MG ? 1.0:100.0;
-    gyro_div = units & BNO055_ANGRATE_UNIT_RPS ? 900.0:16.0;
-    euler_div = units & BNO055_EULER_UNIT_RAD ? 16.0:900.0;
+    acc_div  = units & BNO055_ACC_UNIT_MG ? 1:100;
+    gyro_div = units & BNO055_ANGRATE_UNIT_RPS ? 900:16;
+    euler_div = units & BNO055_EULER_UNIT_RAD ? 900:16;
 
     /**
      * Convert the value to an appropriate range (section 3.6.4)
@@ -984,9 +1041,9 @@ bno055_get_vector_data(struct sensor_itf *itf, void *datastruct, int type)
         case SENSOR_TYPE_MAGNETIC_FIELD:
             smd = datastruct;
             /* 1uT = 16 LSB */
-            smd->smd_x = ((double)x)/16.0;
-            smd->smd_y = ((double)y)/16.0;
-            smd->smd_z = ((double)z)/16.0;
+            smd->smd_x = SENSOR_VAL_RATIO(x, 16, SENSOR_MAG_Q);
+            smd->smd_y = SENSOR_VAL_RATIO(y, 16, SENSOR_MAG_Q);
+            smd->smd_z = SENSOR_VAL_RATIO(z, 16, SENSOR_MAG_Q);
 
             smd->smd_x_is_valid = 1;
             smd->smd_y_is_valid = 1;
@@ -996,9 +1053,9 @@ bno055_get_vector_data(struct sensor_itf *itf, void *datastruct, int type)
         case SENSOR_TYPE_GYROSCOPE:
             sad = datastruct;
             /* 1rps = 900 LSB */
-            sad->sad_x = ((double)x)/gyro_div;
-            sad->sad_y = ((double)y)/gyro_div;
-            sad->sad_z = ((double)z)/gyro_div;
+            sad->sad_x = SENSOR_VAL_RATIO(x, gyro_div, SENSOR_GYRO_Q);
+            sad->sad_y = SENSOR_VAL_RATIO(y, gyro_div, SENSOR_GYRO_Q);
+            sad->sad_z = SENSOR_VAL_RATIO(z, gyro_div, SENSOR_GYRO_Q);
 
             sad->sad_x_is_valid = 1;
             sad->sad_y_is_valid = 1;
@@ -1007,9 +1064,9 @@ bno055_get_vector_data(struct sensor_itf *itf, void *datastruct, int type)
         case SENSOR_TYPE_EULER:
             sed = datastruct;
             /* 1 degree = 16 LSB */
-            sed->sed_h = ((double)x)/euler_div;
-            sed->sed_r = ((double)y)/euler_div;
-            sed->sed_p = ((double)z)/euler_div;
+            sed->sed_h = SENSOR_VAL_RATIO(x, euler_div, SENSOR_EULER_Q);
+            sed->sed_r = SENSOR_VAL_RATIO(y, euler_div, SENSOR_EULER_Q);
+            sed->sed_p = SENSOR_VAL_RATIO(z, euler_div, SENSOR_EULER_Q);
 
             sed->sed_h_is_valid = 1;
             sed->sed_r_is_valid = 1;
@@ -1020,9 +1077,9 @@ bno055_get_vector_data(struct sensor_itf *itf, void *datastruct, int type)
         case SENSOR_TYPE_GRAVITY:
             sad = datastruct;
             /* 1m/s^2 = 100 LSB */
-            sad->sad_x = ((double)x)/acc_div;
-            sad->sad_y = ((double)y)/acc_div;
-            sad->sad_z = ((double)z)/acc_div;
+            sad->sad_x = SENSOR_VAL_RATIO(x, acc_div, SENSOR_ACCEL_Q);
+            sad->sad_y = SENSOR_VAL_RATIO(y, acc_div, SENSOR_ACCEL_Q);
+            sad->sad_z = SENSOR_VAL_RATIO(z, acc_div, SENSOR_ACCEL_Q);
 
             sad->sad_x_is_valid = 1;
             sad->sad_y_is_valid = 1;
@@ -1241,11 +1298,114 @@ bno055_sensor_read(struct sensor *sensor, sensor_type_t type,
         }
     }
 
+    /* The INT pin is latched; release it for the next notification */
+    if (sensor->s_dr_enabled) {
+        rc = bno055_int_reset(sensor);
+        if (rc) {
+            goto err;
+        }
+    }
+
     return 0;
 err:
     return rc;
 }
 
+static void
+bno055_int_irq_handler(void *arg)
+{
+    sensor_mgr_data_ready(arg);
+}
+
+/**
+ * Resets the latched INT pin
+ *
+ * @param The sensor
+ * @return 0 on success, non-zero on failure
+ */
+static int
+bno055_int_reset(struct sensor *sensor)
+{
+    struct bno055 *bno055;
+    uint8_t val;
+
+    bno055 = (struct bno055 *) SENSOR_GET_DEVICE(sensor);
+
+    /* Keep the clock selection, the other bits are self clearing */
+    val = BNO055_SYS_TRIGGER_RST_INT;
+    if (bno055->cfg.bc_use_ext_xtal) {
+        val |= BNO055_SYS_TRIGGER_CLK_SEL;
+    }
+
+    return bno055_write8(SENSOR_GET_ITF(sensor), BNO055_SYS_TRIGGER_ADDR, val);
+}
+
+/**
+ * The BNO055 has no data ready interrupt; the interrupts enabled with
+ * bno055_set_int_enable() (any/no motion, high g, high rate) are routed to
+ * the INT pin instead, so the sensor is read when motion is detected.
+ */
+static int
+bno055_sensor_set_data_ready(struct sensor *sensor, sensor_type_t type,
+        int enable)
+{
+    struct bno055 *bno055;
+    struct sensor_itf *itf;
+    uint8_t mask;
+    int pin;
+    int rc;
+
+    bno055 = (struct bno055 *) SENSOR_GET_DEVICE(sensor);
+    itf = SENSOR_GET_ITF(sensor);
+    pin = bno055->cfg.bc_int_pin;
+
+    if (pin < 0) {
+        rc = SYS_ENOTSUP;
+        goto err;
+    }
+
+    rc = bno055_write8(itf, BNO055_PAGE_ID_ADDR, 1);
+    if (rc) {
+        goto err;
+    }
+
+    mask = 0;
+    if (enable) {
+        rc = bno055_read8(itf, BNO055_INT_EN_ADDR, &mask);
+        if (rc) {
+            goto page0;
+        }
+
+        /* Nothing would ever raise the pin */
+        if (mask == 0) {
+            rc = SYS_EINVAL;
+            goto page0;
+        }
+
+        rc = hal_gpio_irq_init(pin, bno055_int_irq_handler, sensor,
+                               HAL_GPIO_TRIG_RISING, HAL_GPIO_PULL_NONE);
+        if (rc) {
+            goto page0;
+        }
+        hal_gpio_irq_enable(pin);
+    }
+
+    rc = bno055_write8(itf, BNO055_INT_MASK_ADDR, mask);
+    if (rc || !enable) {
+        hal_gpio_irq_release(pin);
+    }
+
+page0:
+    if (bno055_write8(itf, BNO055_PAGE_ID_ADDR, 0) && !rc) {
+        rc = SYS_EIO;
+    }
+    if (rc == 0 && enable) {
+        rc = bno055_int_reset(sensor);
+    }
+err:
+    return rc;
+}
+
 /**
  * Gets system status, test results and errors if any from the sensor
  *
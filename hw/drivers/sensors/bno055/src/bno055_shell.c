@@ -260,10 +260,10 @@ bno055_shell_cmd_read(int argc, char **argv)
             }
             sqd = databuf;
 
-            console_printf("x:%s ", sensor_ftostr(sqd->sqd_x, tmpstr, 13));
-            console_printf("y:%s ", sensor_ftostr(sqd->sqd_y, tmpstr, 13));
-            console_printf("z:%s ", sensor_ftostr(sqd->sqd_z, tmpstr, 13));
-            console_printf("w:%s\n", sensor_ftostr(sqd->sqd_w, tmpstr, 13));
+            console_printf("x:%s ", sensor_vtostr(sqd->sqd_x, SENSOR_QUAT_Q, tmpstr, 13));
+            console_printf("y:%s ", sensor_vtostr(sqd->sqd_y, SENSOR_QUAT_Q, tmpstr, 13));
+            console_printf("z:%s ", sensor_vtostr(sqd->sqd_z, SENSOR_QUAT_Q, tmpstr, 13));
+            console_printf("w:%s\n", sensor_vtostr(sqd->sqd_w, SENSOR_QUAT_Q, tmpstr, 13));
 
         } else if (type == SENSOR_TYPE_EULER) {
             rc = bno055_get_vector_data(&g_sensor_itf, databuf, type);
@@ -273,9 +273,9 @@ bno055_shell_cmd_read(int argc, char **argv)
             }
             sed = databuf;
 
-            console_printf("h:%s ", sensor_ftostr(sed->sed_h, tmpstr, 13));
-            console_printf("r:%s ", sensor_ftostr(sed->sed_r, tmpstr, 13));
-            console_printf("p:%s\n", sensor_ftostr(sed->sed_p, tmpstr, 13));
+            console_printf("h:%s ", sensor_vtostr(sed->sed_h, SENSOR_EULER_Q, tmpstr, 13));
+            console_printf("r:%s ", sensor_vtostr(sed->sed_r, SENSOR_EULER_Q, tmpstr, 13));
+            console_printf("p:%s\n", sensor_vtostr(sed->sed_p, SENSOR_EULER_Q, tmpstr, 13));
 
         } else if (type == SENSOR_TYPE_TEMPERATURE) {
             rc = bno055_get_temp(&g_sensor_itf, databuf);
@@ -294,9 +294,9 @@ bno055_shell_cmd_read(int argc, char **argv)
             }
             sad = databuf;
 
-            console_printf("x:%s ", sensor_ftostr(sad->sad_x, tmpstr, 13));
-            console_printf("y:%s ", sensor_ftostr(sad->sad_y, tmpstr, 13));
-            console_printf("z:%s\n", sensor_ftostr(sad->sad_z, tmpstr, 13));
+            console_printf("x:%s ", sensor_vtostr(sad->sad_x, SENSOR_ACCEL_Q, tmpstr, 13));
+            console_printf("y:%s ", sensor_vtostr(sad->sad_y, SENSOR_ACCEL_Q, tmpstr, 13));
+            console_printf("z:%s\n", sensor_vtostr(sad->sad_z, SENSOR_ACCEL_Q, tmpstr, 13));
         }
     }
 
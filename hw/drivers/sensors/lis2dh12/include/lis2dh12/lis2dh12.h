@@ -23,6 +23,7 @@
 #include <os/os.h>
 #include "os/os_dev.h"
 #include "sensor/sensor.h"
+#include "sensor/accel.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -63,6 +64,9 @@ extern "C" {
 #define LIS2DH12_FIFO_M_STREAM                  0x02
 #define LIS2DH12_FIFO_M_STREAM_FIFO             0x03
 
+/* FIFO depth, in samples of 6 bytes (X, Y, Z) */
+#define LIS2DH12_FIFO_DEPTH                     32
+
 #define LIS2DH12_INT1_CFG_M_OR                   0x0
 #define LIS2DH12_INT1_CFG_M_6DM                  0x1
 #define LIS2DH12_INT1_CFG_M_AND                  0x2
@@ -83,6 +87,16 @@ struct lis2dh12_cfg {
     uint8_t lc_fs;
     uint8_t lc_pull_up_disc;
     sensor_type_t lc_s_mask;
+    /* LIS2DH12_FIFO_M_[...]; with LIS2DH12_FIFO, the sensor manager reads
+     * the whole FIFO at every poll
+     */
+    uint8_t lc_fifo_mode;
+    /* FIFO watermark, in samples */
+    uint8_t lc_fifo_wtm;
+    /* MCU pin the INT1 output is connected to, for data ready
+     * notification; -1 if not connected
+     */
+    int16_t lc_int1_pin;
 };
 
 struct lis2dh12 {
@@ -90,6 +104,11 @@ struct lis2dh12 {
     struct sensor sensor;
     struct lis2dh12_cfg cfg;
     os_time_t last_read_time;
+#if MYNEWT_VAL(LIS2DH12_FIFO)
+    /* FIFO contents, as read from the chip and converted */
+    uint8_t fifo_raw[LIS2DH12_FIFO_DEPTH * 6];
+    struct sensor_accel_data fifo[LIS2DH12_FIFO_DEPTH];
+#endif
 };
 
 /**
@@ -192,6 +211,29 @@ lis2dh12_calc_acc_ms2(int16_t raw_acc, float *facc);
 int
 lis2dh12_pull_up_disc(struct sensor_itf *itf, uint8_t disconnect);
 
+/**
+ * Set the FIFO mode
+ *
+ * @param The sensor interface
+ * @param The FIFO mode, LIS2DH12_FIFO_M_[...]
+ * @param The FIFO watermark, in samples
+ *
+ * @return 0 on success, non-zero on failure
+ */
+int
+lis2dh12_set_fifo_mode(struct sensor_itf *itf, uint8_t mode, uint8_t wtm);
+
+/**
+ * Get the number of samples in the FIFO
+ *
+ * @param The sensor interface
+ * @param ptr to the number of samples
+ *
+ * @return 0 on success, non-zero on failure
+ */
+int
+lis2dh12_get_fifo_samples(struct sensor_itf *itf, uint8_t *samples);
+
 /**
  * Reset lis2dh12
  *
@@ -29,9 +29,11 @@
 #include "hal/hal_i2c.h"
 #include "sensor/sensor.h"
 #include "sensor/accel.h"
+#include "sensor/sensor_bus.h"
 #include "lis2dh12/lis2dh12.h"
 #include "lis2dh12_priv.h"
 #include "hal/hal_gpio.h"
+#include "os/os_cputime.h"
 
 static struct hal_spi_settings spi_lis2dh12_settings = {
     .data_order = HAL_SPI_MSB_FIRST,
@@ -81,10 +83,22 @@ static int lis2dh12_sensor_read(struct sensor *, sensor_type_t,
         sensor_data_func_t, void *, uint32_t);
 static int lis2dh12_sensor_get_config(struct sensor *, sensor_type_t,
         struct sensor_cfg *);
+#if MYNEWT_VAL(LIS2DH12_FIFO)
+static int lis2dh12_sensor_read_batch(struct sensor *, sensor_type_t,
+        sensor_batch_func_t, void *, uint32_t);
+#endif
+static int lis2dh12_sensor_set_data_ready(struct sensor *, sensor_type_t,
+        int);
 
 static const struct sensor_driver g_lis2dh12_sensor_driver = {
     lis2dh12_sensor_read,
-    lis2dh12_sensor_get_config
+    lis2dh12_sensor_get_config,
+#if MYNEWT_VAL(LIS2DH12_FIFO)
+    lis2dh12_sensor_read_batch,
+#else
+    NULL,
+#endif
+    lis2dh12_sensor_set_data_ready
 };
 
 /**
@@ -102,16 +116,21 @@ lis2dh12_i2c_readlen(struct sensor_itf *itf, uint8_t addr, uint8_t *buffer,
                      uint8_t len)
 {
     int rc;
-    uint8_t payload[20] = { addr, 0, 0, 0, 0, 0, 0, 0,
-                              0, 0, 0, 0, 0, 0, 0, 0,
-                              0, 0, 0, 0};
 
     struct hal_i2c_master_data data_struct = {
         .address = itf->si_addr,
         .len = 1,
-        .buffer = payload
+        .buffer = &addr
     };
 
+    /*
+     * Auto register address increment is needed if the length
+     * requested is more than 1
+     */
+    if (len > 1) {
+        addr |= LIS2DH12_I2C_ADR_INC;
+    }
+
     /* Clear the supplied buffer */
     memset(buffer, 0, len);
 
@@ -125,9 +144,9 @@ lis2dh12_i2c_readlen(struct sensor_itf *itf, uint8_t addr, uint8_t *buffer,
         goto err;
     }
 
-    /* Read len bytes back */
-    memset(payload, 0, sizeof(payload));
+    /* Read len bytes back, straight into the supplied buffer */
     data_struct.len = len;
+    data_struct.buffer = buffer;
     rc = hal_i2c_master_read(itf->si_num, &data_struct, OS_TICKS_PER_SEC / 10, 1);
     if (rc) {
         LIS2DH12_ERR("Failed to read from 0x%02X:0x%02X\n", data_struct.address, addr);
@@ -137,9 +156,6 @@ lis2dh12_i2c_readlen(struct sensor_itf *itf, uint8_t addr, uint8_t *buffer,
         goto err;
     }
 
-    /* Copy the I2C results into the supplied buffer */
-    memcpy(buffer, payload, len);
-
     return 0;
 err:
 
@@ -339,7 +355,14 @@ lis2dh12_writelen(struct sensor_itf *itf, uint8_t addr, uint8_t *payload,
 {
     int rc;
 
-    if (itf->si_type == SENSOR_ITF_I2C) {
+    if (sensor_bus_evq_get(itf) != NULL) {
+        if (len > 1) {
+            addr |= itf->si_type == SENSOR_ITF_I2C ? LIS2DH12_I2C_ADR_INC :
+                                                     LIS2DH12_SPI_ADR_INC;
+        }
+        rc = sensor_bus_write_reg(itf, addr, payload, len,
+                                  &spi_lis2dh12_settings);
+    } else if (itf->si_type == SENSOR_ITF_I2C) {
         rc = lis2dh12_i2c_writelen(itf, addr, payload, len);
     } else {
         rc = lis2dh12_spi_writelen(itf, addr, payload, len);
@@ -363,7 +386,21 @@ lis2dh12_readlen(struct sensor_itf *itf, uint8_t addr, uint8_t *payload,
 {
     int rc;
 
-    if (itf->si_type == SENSOR_ITF_I2C) {
+    if (sensor_bus_evq_get(itf) != NULL) {
+        /* Register address write and data read in one queued transaction */
+        if (itf->si_type == SENSOR_ITF_I2C) {
+            if (len > 1) {
+                addr |= LIS2DH12_I2C_ADR_INC;
+            }
+        } else {
+            addr |= LIS2DH12_SPI_READ_CMD_BIT;
+            if (len > 1) {
+                addr |= LIS2DH12_SPI_ADR_INC;
+            }
+        }
+        rc = sensor_bus_read_reg(itf, addr, payload, len,
+                                 &spi_lis2dh12_settings);
+    } else if (itf->si_type == SENSOR_ITF_I2C) {
         rc = lis2dh12_i2c_readlen(itf, addr, payload, len);
     } else {
         rc = lis2dh12_spi_readlen(itf, addr, payload, len);
@@ -538,6 +575,55 @@ err:
     return rc;
 }
 
+/**
+ * Gets the full scale, in g
+ *
+ * @param The sensor interface
+ * @param ptr to full scale in g
+ *
+ * @return 0 on success, non-zero on failure
+ */
+static int
+lis2dh12_get_fs_g(struct sensor_itf *itf, uint8_t *fs_g)
+{
+    uint8_t fs;
+    int rc;
+
+    rc = lis2dh12_get_full_scale(itf, &fs);
+    if (rc) {
+        return rc;
+    }
+
+    /* 2g, 4g, 8g or 16g */
+    *fs_g = 2 << fs;
+
+    return 0;
+}
+
+/**
+ * Converts a raw, left justified, acceleration sample to mg
+ *
+ * @param raw acc value
+ * @param full scale in g
+ */
+static int16_t
+lis2dh12_raw_to_mg(int16_t raw, uint8_t fs_g)
+{
+    /*
+     * Since full scale is +/-(fs)g,
+     * fs should be multiplied by 2 to account for full scale.
+     * To calculate mg from g we use the 1000 multiple.
+     * Since the full scale is represented by 16 bit value,
+     * we use that as a divisor.
+     * The calculation is based on an example present in AN5005
+     * application note
+     */
+    return (fs_g * 2 * 1000 * raw) / UINT16_MAX;
+}
+
+/* m/s^2 per mg */
+#define LIS2DH12_MS2_PER_MG     (STANDARD_ACCEL_GRAVITY / 1000)
+
 /**
  * Calculates the acceleration in m/s^2 from mg
  *
@@ -547,7 +633,7 @@ err:
 void
 lis2dh12_calc_acc_ms2(int16_t raw_acc, float *facc)
 {
-    *facc = raw_acc * STANDARD_ACCEL_GRAVITY;
+    *facc = raw_acc * LIS2DH12_MS2_PER_MG;
 }
 
 /**
@@ -726,7 +812,7 @@ lis2dh12_get_data(struct sensor_itf *itf, int16_t *x, int16_t *y, int16_t *z)
 {
     int rc;
     uint8_t payload[6] = {0};
-    uint8_t fs;
+    uint8_t fs_g;
 
     *x = *y = *z = 0;
 
@@ -744,42 +830,137 @@ lis2dh12_get_data(struct sensor_itf *itf, int16_t *x, int16_t *y, int16_t *z)
     *y = payload[2] | (payload[3] << 8);
     *z = payload[4] | (payload[5] << 8);
 
-    rc = lis2dh12_get_full_scale(itf, &fs);
+    rc = lis2dh12_get_fs_g(itf, &fs_g);
     if (rc) {
         goto err;
     }
 
-    if (fs == LIS2DH12_FS_2G) {
-        fs = 2;
-    } else if (fs == LIS2DH12_FS_4G) {
-        fs = 4;
-    } else if (fs == LIS2DH12_FS_8G) {
-        fs = 8;
-    } else if (fs == LIS2DH12_FS_16G) {
-        fs = 16;
-    } else {
+    *x = lis2dh12_raw_to_mg(*x, fs_g);
+    *y = lis2dh12_raw_to_mg(*y, fs_g);
+    *z = lis2dh12_raw_to_mg(*z, fs_g);
+
+    return 0;
+err:
+    return rc;
+}
+
+/**
+ * Sets up the SPI bus for the LIS2DH12, which may share it with devices
+ * using other settings.  Does nothing for I2C, or on a bus run by the
+ * sensor bus manager, which applies the settings with every transfer.
+ *
+ * @param The sensor
+ *
+ * @return 0 on success, non-zero on failure
+ */
+static int
+lis2dh12_spi_prepare(struct sensor *sensor)
+{
+    int rc;
+
+    if (sensor->s_itf.si_type != SENSOR_ITF_SPI ||
+        sensor_bus_evq_get(&sensor->s_itf) != NULL) {
+        return 0;
+    }
+
+    rc = hal_spi_disable(sensor->s_itf.si_num);
+    if (rc) {
+        return rc;
+    }
+
+    rc = hal_spi_config(sensor->s_itf.si_num, &spi_lis2dh12_settings);
+    if (rc == EINVAL) {
+        /* If spi is already enabled, for nrf52, it returns -1, We should not
+         * fail if the spi is already enabled
+         */
+        return rc;
+    }
+
+    return hal_spi_enable(sensor->s_itf.si_num);
+}
+
+/**
+ * Sets the FIFO mode
+ *
+ * @param The sensor interface
+ * @param The FIFO mode, LIS2DH12_FIFO_M_[...]
+ * @param The FIFO watermark, in samples
+ *
+ * @return 0 on success, non-zero on failure
+ */
+int
+lis2dh12_set_fifo_mode(struct sensor_itf *itf, uint8_t mode, uint8_t wtm)
+{
+    uint8_t reg;
+    int rc;
+
+    if (mode > LIS2DH12_FIFO_M_STREAM_FIFO ||
+        wtm > LIS2DH12_FIFO_CTRL_REG_FTH) {
+        LIS2DH12_ERR("Invalid FIFO mode\n");
         rc = SYS_EINVAL;
         goto err;
     }
 
-    /*
-     * Since full scale is +/-(fs)g,
-     * fs should be multiplied by 2 to account for full scale.
-     * To calculate mg from g we use the 1000 multiple.
-     * Since the full scale is represented by 16 bit value,
-     * we use that as a divisor.
-     * The calculation is based on an example present in AN5005
-     * application note
-     */
-    *x = (fs * 2 * 1000 * *x)/UINT16_MAX;
-    *y = (fs * 2 * 1000 * *y)/UINT16_MAX;
-    *z = (fs * 2 * 1000 * *z)/UINT16_MAX;
+    rc = lis2dh12_readlen(itf, LIS2DH12_REG_CTRL_REG5, &reg, 1);
+    if (rc) {
+        goto err;
+    }
+
+    if (mode == LIS2DH12_FIFO_M_BYPASS) {
+        reg &= ~LIS2DH12_CTRL_REG5_FIFO_EN;
+    } else {
+        reg |= LIS2DH12_CTRL_REG5_FIFO_EN;
+    }
+
+    rc = lis2dh12_writelen(itf, LIS2DH12_REG_CTRL_REG5, &reg, 1);
+    if (rc) {
+        goto err;
+    }
+
+    /* Going through bypass mode empties the FIFO */
+    reg = LIS2DH12_FIFO_M_BYPASS << 6;
+    rc = lis2dh12_writelen(itf, LIS2DH12_REG_FIFO_CTRL_REG, &reg, 1);
+    if (rc) {
+        goto err;
+    }
+
+    reg = (mode << 6) | wtm;
+    rc = lis2dh12_writelen(itf, LIS2DH12_REG_FIFO_CTRL_REG, &reg, 1);
 
-    return 0;
 err:
     return rc;
 }
 
+/**
+ * Gets the number of samples in the FIFO
+ *
+ * @param The sensor interface
+ * @param ptr to the number of samples
+ *
+ * @return 0 on success, non-zero on failure
+ */
+int
+lis2dh12_get_fifo_samples(struct sensor_itf *itf, uint8_t *samples)
+{
+    uint8_t reg;
+    int rc;
+
+    rc = lis2dh12_readlen(itf, LIS2DH12_REG_FIFO_SRC_REG, &reg, 1);
+    if (rc) {
+        return rc;
+    }
+
+    if (reg & LIS2DH12_FIFO_SRC_EMPTY) {
+        *samples = 0;
+    } else if (reg & LIS2DH12_FIFO_SRC_OVRN_FIFO) {
+        *samples = LIS2DH12_FIFO_DEPTH;
+    } else {
+        *samples = reg & LIS2DH12_FIFO_SRC_FSS;
+    }
+
+    return 0;
+}
+
 /**
  * Expects to be called back through os_dev_create().
  *
@@ -911,7 +1092,6 @@ lis2dh12_sensor_read(struct sensor *sensor, sensor_type_t type,
     struct sensor_accel_data sad;
     struct sensor_itf *itf;
     int16_t x, y ,z;
-    float fx, fy ,fz;
     int rc;
 
     /* If the read isn't looking for accel or mag data, don't do anything. */
@@ -924,25 +1104,9 @@ lis2dh12_sensor_read(struct sensor *sensor, sensor_type_t type,
 
     x = y = z = 0;
 
-    if (itf->si_type == SENSOR_ITF_SPI) {
-
-        rc = hal_spi_disable(sensor->s_itf.si_num);
-        if (rc) {
-            goto err;
-        }
-
-        rc = hal_spi_config(sensor->s_itf.si_num, &spi_lis2dh12_settings);
-        if (rc == EINVAL) {
-            /* If spi is already enabled, for nrf52, it returns -1, We should not
-             * fail if the spi is already enabled
-             */
-            goto err;
-        }
-
-        rc = hal_spi_enable(sensor->s_itf.si_num);
-        if (rc) {
-            goto err;
-        }
+    rc = lis2dh12_spi_prepare(sensor);
+    if (rc) {
+        goto err;
     }
 
     rc = lis2dh12_get_data(itf, &x, &y, &z);
@@ -950,13 +1114,9 @@ lis2dh12_sensor_read(struct sensor *sensor, sensor_type_t type,
         goto err;
     }
 
-    lis2dh12_calc_acc_ms2(x, &fx);
-    lis2dh12_calc_acc_ms2(y, &fy);
-    lis2dh12_calc_acc_ms2(z, &fz);
-
-    sad.sad_x = fx;
-    sad.sad_y = fy;
-    sad.sad_z = fz;
+    sad.sad_x = SENSOR_VAL_SCALE(x, LIS2DH12_MS2_PER_MG, SENSOR_ACCEL_Q);
+    sad.sad_y = SENSOR_VAL_SCALE(y, LIS2DH12_MS2_PER_MG, SENSOR_ACCEL_Q);
+    sad.sad_z = SENSOR_VAL_SCALE(z, LIS2DH12_MS2_PER_MG, SENSOR_ACCEL_Q);
 
     sad.sad_x_is_valid = 1;
     sad.sad_y_is_valid = 1;
@@ -973,6 +1133,205 @@ err:
     return rc;
 }
 
+#if MYNEWT_VAL(LIS2DH12_FIFO)
+/**
+ * Gets the time between two samples at the current data rate
+ *
+ * @param The sensor interface
+ * @param ptr to the sample interval, in cputime ticks
+ *
+ * @return 0 on success, non-zero on failure
+ */
+static int
+lis2dh12_get_sample_itvl(struct sensor_itf *itf, uint32_t *itvl)
+{
+    static const uint16_t rate_hz[] = {
+        0, 1, 10, 25, 50, 100, 200, 400, 1620, 1344
+    };
+    uint16_t hz;
+    uint8_t reg;
+    int rc;
+
+    rc = lis2dh12_readlen(itf, LIS2DH12_REG_CTRL_REG1, &reg, 1);
+    if (rc) {
+        return rc;
+    }
+
+    hz = rate_hz[min((reg & LIS2DH12_CTRL_REG1_ODR) >> 4, 9)];
+    if (hz == 1344 && (reg & LIS2DH12_CTRL_REG1_LPEN)) {
+        hz = 5376;
+    }
+
+    *itvl = hz ? os_cputime_usecs_to_ticks(1000000 / hz) : 0;
+
+    return 0;
+}
+
+/**
+ * Reads all the samples in the FIFO with one bus transfer, and hands them
+ * to the batch function.  In bypass mode, a single sample is read.
+ */
+static int
+lis2dh12_sensor_read_batch(struct sensor *sensor, sensor_type_t type,
+        sensor_batch_func_t batch_func, void *batch_arg, uint32_t timeout)
+{
+    struct lis2dh12 *lis2dh12;
+    struct sensor_accel_data *sad;
+    struct sensor_batch sb;
+    struct sensor_itf *itf;
+    uint32_t now;
+    uint8_t samples;
+    uint8_t fs_g;
+    uint8_t *raw;
+    int16_t mg;
+    int rc;
+    int i;
+
+    if (!(type & SENSOR_TYPE_ACCELEROMETER)) {
+        rc = SYS_EINVAL;
+        goto err;
+    }
+
+    lis2dh12 = (struct lis2dh12 *) SENSOR_GET_DEVICE(sensor);
+    itf = SENSOR_GET_ITF(sensor);
+
+    rc = lis2dh12_spi_prepare(sensor);
+    if (rc) {
+        goto err;
+    }
+
+    if (lis2dh12->cfg.lc_fifo_mode == LIS2DH12_FIFO_M_BYPASS) {
+        samples = 1;
+    } else {
+        rc = lis2dh12_get_fifo_samples(itf, &samples);
+        if (rc) {
+            goto err;
+        }
+        if (samples == 0) {
+            return 0;
+        }
+    }
+
+    /* The newest sample was taken about now */
+    now = os_cputime_get32();
+
+    /* With the FIFO on, the address wraps from OUT_Z_H back to OUT_X_L, so
+     * the FIFO can be emptied in one burst.
+     */
+    rc = lis2dh12_readlen(itf, LIS2DH12_REG_OUT_X_L, lis2dh12->fifo_raw,
+                          samples * 6);
+    if (rc) {
+        goto err;
+    }
+
+    rc = lis2dh12_get_fs_g(itf, &fs_g);
+    if (rc) {
+        goto err;
+    }
+
+    rc = lis2dh12_get_sample_itvl(itf, &sb.sb_itvl);
+    if (rc) {
+        goto err;
+    }
+
+    for (i = 0; i < samples; i++) {
+        raw = &lis2dh12->fifo_raw[i * 6];
+        sad = &lis2dh12->fifo[i];
+
+        mg = lis2dh12_raw_to_mg(raw[0] | (raw[1] << 8), fs_g);
+        sad->sad_x = SENSOR_VAL_SCALE(mg, LIS2DH12_MS2_PER_MG, SENSOR_ACCEL_Q);
+        mg = lis2dh12_raw_to_mg(raw[2] | (raw[3] << 8), fs_g);
+        sad->sad_y = SENSOR_VAL_SCALE(mg, LIS2DH12_MS2_PER_MG, SENSOR_ACCEL_Q);
+        mg = lis2dh12_raw_to_mg(raw[4] | (raw[5] << 8), fs_g);
+        sad->sad_z = SENSOR_VAL_SCALE(mg, LIS2DH12_MS2_PER_MG, SENSOR_ACCEL_Q);
+
+        sad->sad_x_is_valid = 1;
+        sad->sad_y_is_valid = 1;
+        sad->sad_z_is_valid = 1;
+    }
+
+    sb.sb_type = SENSOR_TYPE_ACCELEROMETER;
+    sb.sb_count = samples;
+    sb.sb_sample_size = sizeof(struct sensor_accel_data);
+    sb.sb_cputime = now - (samples - 1) * sb.sb_itvl;
+    sb.sb_data = lis2dh12->fifo;
+
+    return batch_func(sensor, batch_arg, &sb);
+err:
+    return rc;
+}
+#endif
+
+static void
+lis2dh12_int1_irq_handler(void *arg)
+{
+    sensor_mgr_data_ready(arg);
+}
+
+/**
+ * Routes data ready to the INT1 pin, or with the FIFO in use, the FIFO
+ * watermark, so that the sensor manager reads whole batches.
+ */
+static int
+lis2dh12_sensor_set_data_ready(struct sensor *sensor, sensor_type_t type,
+        int enable)
+{
+    struct lis2dh12 *lis2dh12;
+    struct sensor_itf *itf;
+    uint8_t reg;
+    int pin;
+    int rc;
+
+    if (!(type & SENSOR_TYPE_ACCELEROMETER)) {
+        rc = SYS_EINVAL;
+        goto err;
+    }
+
+    lis2dh12 = (struct lis2dh12 *) SENSOR_GET_DEVICE(sensor);
+    itf = SENSOR_GET_ITF(sensor);
+    pin = lis2dh12->cfg.lc_int1_pin;
+
+    if (pin < 0) {
+        rc = SYS_ENOTSUP;
+        goto err;
+    }
+
+    rc = lis2dh12_spi_prepare(sensor);
+    if (rc) {
+        goto err;
+    }
+
+    if (!enable) {
+        reg = 0;
+        rc = lis2dh12_writelen(itf, LIS2DH12_REG_CTRL_REG3, &reg, 1);
+        hal_gpio_irq_release(pin);
+        goto err;
+    }
+
+    reg = LIS2DH12_CTRL_REG3_I1_ZYXDA;
+#if MYNEWT_VAL(LIS2DH12_FIFO)
+    if (lis2dh12->cfg.lc_fifo_mode != LIS2DH12_FIFO_M_BYPASS) {
+        reg = LIS2DH12_CTRL_REG3_I1_WTM;
+    }
+#endif
+
+    /* INT1 is active high; it stays high until the data is read */
+    rc = hal_gpio_irq_init(pin, lis2dh12_int1_irq_handler, sensor,
+                           HAL_GPIO_TRIG_RISING, HAL_GPIO_PULL_NONE);
+    if (rc) {
+        goto err;
+    }
+    hal_gpio_irq_enable(pin);
+
+    rc = lis2dh12_writelen(itf, LIS2DH12_REG_CTRL_REG3, &reg, 1);
+    if (rc) {
+        hal_gpio_irq_release(pin);
+    }
+
+err:
+    return rc;
+}
+
 static int
 lis2dh12_sensor_get_config(struct sensor *sensor, sensor_type_t type,
         struct sensor_cfg *cfg)
@@ -1008,25 +1367,9 @@ lis2dh12_config(struct lis2dh12 *lis2dh12, struct lis2dh12_cfg *cfg)
     itf = SENSOR_GET_ITF(&(lis2dh12->sensor));
     sensor = &(lis2dh12->sensor);
 
-    if (itf->si_type == SENSOR_ITF_SPI) {
-
-        rc = hal_spi_disable(sensor->s_itf.si_num);
-        if (rc) {
-            goto err;
-        }
-
-        rc = hal_spi_config(sensor->s_itf.si_num, &spi_lis2dh12_settings);
-        if (rc == EINVAL) {
-            /* If spi is already enabled, for nrf52, it returns -1, We should not
-             * fail if the spi is already enabled
-             */
-            goto err;
-        }
-
-        rc = hal_spi_enable(sensor->s_itf.si_num);
-        if (rc) {
-            goto err;
-        }
+    rc = lis2dh12_spi_prepare(sensor);
+    if (rc) {
+        goto err;
     }
 
     rc = lis2dh12_get_chip_id(itf, &chip_id);
@@ -1050,6 +1393,7 @@ lis2dh12_config(struct lis2dh12 *lis2dh12, struct lis2dh12_cfg *cfg)
     }
 
     lis2dh12->cfg.lc_pull_up_disc = cfg->lc_pull_up_disc;
+    lis2dh12->cfg.lc_int1_pin = cfg->lc_int1_pin;
 
     rc = lis2dh12_set_full_scale(itf, cfg->lc_fs);
     if (rc) {
@@ -1082,6 +1426,16 @@ lis2dh12_config(struct lis2dh12 *lis2dh12, struct lis2dh12_cfg *cfg)
         goto err;
     }
 
+#if MYNEWT_VAL(LIS2DH12_FIFO)
+    rc = lis2dh12_set_fifo_mode(itf, cfg->lc_fifo_mode, cfg->lc_fifo_wtm);
+    if (rc) {
+        goto err;
+    }
+
+    lis2dh12->cfg.lc_fifo_mode = cfg->lc_fifo_mode;
+    lis2dh12->cfg.lc_fifo_wtm = cfg->lc_fifo_wtm;
+#endif
+
     rc = sensor_set_type_mask(&(lis2dh12->sensor), cfg->lc_s_mask);
     if (rc) {
         goto err;
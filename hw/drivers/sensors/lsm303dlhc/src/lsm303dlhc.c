@@ -396,7 +396,7 @@ lsm303dlhc_sensor_read(struct sensor *sensor, sensor_type_t type,
 {
     int rc;
     int16_t x, y, z;
-    float mg_lsb;
+    int16_t mg_lsb;
     int16_t gauss_lsb_xy;
     int16_t gauss_lsb_z;
     uint8_t payload[6];
@@ -438,37 +438,43 @@ lsm303dlhc_sensor_read(struct sensor *sensor, sensor_type_t type,
 #if MYNEWT_VAL(LSM303DLHC_STATS)
                 STATS_INC(g_lsm303dlhcstats, samples_acc_2g);
 #endif
-                mg_lsb = 0.001F;
+                mg_lsb = 1;
                 break;
             case LSM303DLHC_ACCEL_RANGE_4:
 #if MYNEWT_VAL(LSM303DLHC_STATS)
                 STATS_INC(g_lsm303dlhcstats, samples_acc_4g);
 #endif
-                mg_lsb = 0.002F;
+                mg_lsb = 2;
                 break;
             case LSM303DLHC_ACCEL_RANGE_8:
 #if MYNEWT_VAL(LSM303DLHC_STATS)
                 STATS_INC(g_lsm303dlhcstats, samples_acc_8g);
 #endif
-                mg_lsb = 0.004F;
+                mg_lsb = 4;
                 break;
             case LSM303DLHC_ACCEL_RANGE_16:
 #if MYNEWT_VAL(LSM303DLHC_STATS)
                 STATS_INC(g_lsm303dlhcstats, samples_acc_16g);
 #endif
-                mg_lsb = 0.012F;
+                mg_lsb = 12;
                 break;
             default:
                 LSM303DLHC_ERR("Unknown accel range: 0x%02X. Assuming +/-2G.\n",
                     lsm->cfg.accel_range);
-                mg_lsb = 0.001F;
+                mg_lsb = 1;
                 break;
         }
 
         /* Convert from mg to Earth gravity in m/s^2 */
-        databuf.sad.sad_x = (float)x * mg_lsb * 9.80665F;
-        databuf.sad.sad_y = (float)y * mg_lsb * 9.80665F;
-        databuf.sad.sad_z = (float)z * mg_lsb * 9.80665F;
+        databuf.sad.sad_x = SENSOR_VAL_SCALE(x * mg_lsb,
+                                             STANDARD_ACCEL_GRAVITY / 1000,
+                                             SENSOR_ACCEL_Q);
+        databuf.sad.sad_y = SENSOR_VAL_SCALE(y * mg_lsb,
+                                             STANDARD_ACCEL_GRAVITY / 1000,
+                                             SENSOR_ACCEL_Q);
+        databuf.sad.sad_z = SENSOR_VAL_SCALE(z * mg_lsb,
+                                             STANDARD_ACCEL_GRAVITY / 1000,
+                                             SENSOR_ACCEL_Q);
 
         databuf.sad.sad_x_is_valid = 1;
         databuf.sad.sad_y_is_valid = 1;
@@ -556,9 +562,9 @@ lsm303dlhc_sensor_read(struct sensor *sensor, sensor_type_t type,
         }
 
         /* Convert from gauss to micro Tesla */
-        databuf.smd.smd_x = (float)x / gauss_lsb_xy * 100.0F;
-        databuf.smd.smd_y = (float)y / gauss_lsb_xy * 100.0F;
-        databuf.smd.smd_z = (float)z / gauss_lsb_z * 100.0F;
+        databuf.smd.smd_x = SENSOR_VAL_RATIO(x, gauss_lsb_xy, SENSOR_MAG_Q) * 100;
+        databuf.smd.smd_y = SENSOR_VAL_RATIO(y, gauss_lsb_xy, SENSOR_MAG_Q) * 100;
+        databuf.smd.smd_z = SENSOR_VAL_RATIO(z, gauss_lsb_z, SENSOR_MAG_Q) * 100;
 
         databuf.smd.smd_x_is_valid = 1;
         databuf.smd.smd_y_is_valid = 1;
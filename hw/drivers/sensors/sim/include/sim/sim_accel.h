@@ -23,11 +23,15 @@
 #include "os/os.h"
 #include "os/os_dev.h"
 #include "sensor/sensor.h"
+#include "sensor/accel.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Largest number of samples handed over in one batch */
+#define SIM_ACCEL_FIFO_DEPTH    (32)
+
 struct sim_accel_cfg {
     uint8_t sac_nr_samples;
     uint8_t sac_nr_axises;
@@ -40,6 +44,9 @@ struct sim_accel {
     struct sensor sa_sensor;
     struct sim_accel_cfg sa_cfg;
     os_time_t sa_last_read_time;
+    struct sensor_accel_data sa_fifo[SIM_ACCEL_FIFO_DEPTH];
+    /* Emulates the data ready interrupt, once every sample interval */
+    struct os_callout sa_dr_callout;
 };
 
 int sim_accel_init(struct os_dev *, void *);
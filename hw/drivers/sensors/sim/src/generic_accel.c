@@ -24,6 +24,7 @@
 #include "defs/error.h"
 
 #include "os/os.h"
+#include "os/os_cputime.h"
 #include "sysinit/sysinit.h"
 
 #include "sensor/sensor.h"
@@ -37,10 +38,17 @@ static int sim_accel_sensor_read(struct sensor *, sensor_type_t,
         sensor_data_func_t, void *, uint32_t);
 static int sim_accel_sensor_get_config(struct sensor *, sensor_type_t,
         struct sensor_cfg *);
+static int sim_accel_sensor_read_batch(struct sensor *, sensor_type_t,
+        sensor_batch_func_t, void *, uint32_t);
+static int sim_accel_sensor_set_data_ready(struct sensor *, sensor_type_t,
+        int);
+static void sim_accel_dr_event(struct os_event *);
 
 static const struct sensor_driver g_sim_accel_sensor_driver = {
     sim_accel_sensor_read,
-    sim_accel_sensor_get_config
+    sim_accel_sensor_get_config,
+    sim_accel_sensor_read_batch,
+    sim_accel_sensor_set_data_ready
 };
 
 /**
@@ -78,6 +86,9 @@ sim_accel_init(struct os_dev *dev, void *arg)
         goto err;
     }
 
+    os_callout_init(&sa->sa_dr_callout, sensor_mgr_evq_get(),
+                    sim_accel_dr_event, sa);
+
     return (0);
 err:
     return (rc);
@@ -92,57 +103,81 @@ sim_accel_config(struct sim_accel *sa, struct sim_accel_cfg *cfg)
     return (0);
 }
 
+/**
+ * Generates the samples taken since the last read, at most max of them.
+ *
+ * When a sensor is "read", we get the last 'n' samples from the device.
+ * Based on the sample interval provided to sim_accel_config() and the last
+ * time the device was read, 'n' samples are generated.
+ *
+ * @return The number of samples written to sads
+ */
 static int
-sim_accel_sensor_read(struct sensor *sensor, sensor_type_t type,
-        sensor_data_func_t data_func, void *data_arg, uint32_t timeout)
+sim_accel_generate(struct sim_accel *sa, struct sensor_accel_data *sads,
+        int max)
 {
-    struct sim_accel *sa;
-    struct sensor_accel_data sad;
+    struct sensor_accel_data *sad;
     os_time_t now;
     uint32_t num_samples;
     int i;
-    int rc;
 
-    /* If the read isn't looking for accel data, then don't do anything. */
-    if (!(type & SENSOR_TYPE_ACCELEROMETER)) {
-        rc = SYS_EINVAL;
-        goto err;
-    }
-
-    sa = (struct sim_accel *) SENSOR_GET_DEVICE(sensor);
-
-    /* When a sensor is "read", we get the last 'n' samples from the device
-     * and pass them to the sensor data function.  Based on the sample
-     * interval provided to sim_accel_config() and the last time this function
-     * was called, 'n' samples are generated.
-     */
     now = os_time_get();
 
     num_samples = (now - sa->sa_last_read_time) / sa->sa_cfg.sac_sample_itvl;
     num_samples = min(num_samples, sa->sa_cfg.sac_nr_samples);
+    num_samples = min(num_samples, max);
 
-    /* By default only readings are provided for 1-axis (x), however,
-     * if number of axises is configured, up to 3-axises of data can be
-     * returned.
+    /* Samples which could not be handed over are dropped, like a device
+     * FIFO overrunning would; otherwise the next read picks up where this
+     * one stopped.
      */
-    sad.sad_x = 0.0;
-    sad.sad_y = 0.0;
-    sad.sad_z = 0.0;
+    if (num_samples == max || num_samples == sa->sa_cfg.sac_nr_samples) {
+        sa->sa_last_read_time = now;
+    } else {
+        sa->sa_last_read_time += num_samples * sa->sa_cfg.sac_sample_itvl;
+    }
+
+    for (i = 0; i < num_samples; i++) {
+        sad = &sads[i];
 
-    sad.sad_x_is_valid = 1;
-    sad.sad_y_is_valid = 0;
-    sad.sad_z_is_valid = 0;
+        /* By default only readings are provided for 1-axis (x), however,
+         * if number of axises is configured, up to 3-axises of data can be
+         * returned.
+         */
+        sad->sad_x = 0.0;
+        sad->sad_y = 0.0;
+        sad->sad_z = 0.0;
 
-    if (sa->sa_cfg.sac_nr_axises > 1) {
-        sad.sad_y = 0.0;
+        sad->sad_x_is_valid = 1;
+        sad->sad_y_is_valid = sa->sa_cfg.sac_nr_axises > 1;
+        sad->sad_z_is_valid = sa->sa_cfg.sac_nr_axises > 2;
     }
-    if (sa->sa_cfg.sac_nr_axises > 2) {
-        sad.sad_z = 0.0;
+
+    return num_samples;
+}
+
+static int
+sim_accel_sensor_read(struct sensor *sensor, sensor_type_t type,
+        sensor_data_func_t data_func, void *data_arg, uint32_t timeout)
+{
+    struct sim_accel *sa;
+    int num_samples;
+    int i;
+    int rc;
+
+    /* If the read isn't looking for accel data, then don't do anything. */
+    if (!(type & SENSOR_TYPE_ACCELEROMETER)) {
+        rc = SYS_EINVAL;
+        goto err;
     }
 
+    sa = (struct sim_accel *) SENSOR_GET_DEVICE(sensor);
+
     /* Call data function for each of the generated readings. */
+    num_samples = sim_accel_generate(sa, sa->sa_fifo, SIM_ACCEL_FIFO_DEPTH);
     for (i = 0; i < num_samples; i++) {
-        rc = data_func(sensor, data_arg, &sad, SENSOR_TYPE_ACCELEROMETER);
+        rc = data_func(sensor, data_arg, &sa->sa_fifo[i],
+                SENSOR_TYPE_ACCELEROMETER);
         if (rc != 0) {
             goto err;
         }
@@ -153,6 +188,78 @@ err:
     return (rc);
 }
 
+/**
+ * Hands all the samples generated since the last read to the batch
+ * function in one go, as a device with a FIFO would.
+ */
+static int
+sim_accel_sensor_read_batch(struct sensor *sensor, sensor_type_t type,
+        sensor_batch_func_t batch_func, void *batch_arg, uint32_t timeout)
+{
+    struct sim_accel *sa;
+    struct sensor_batch sb;
+    int rc;
+
+    if (!(type & SENSOR_TYPE_ACCELEROMETER)) {
+        rc = SYS_EINVAL;
+        goto err;
+    }
+
+    sa = (struct sim_accel *) SENSOR_GET_DEVICE(sensor);
+
+    sb.sb_count = sim_accel_generate(sa, sa->sa_fifo, SIM_ACCEL_FIFO_DEPTH);
+    if (sb.sb_count == 0) {
+        return (0);
+    }
+
+    sb.sb_type = SENSOR_TYPE_ACCELEROMETER;
+    sb.sb_sample_size = sizeof(struct sensor_accel_data);
+    sb.sb_itvl = os_cputime_usecs_to_ticks(
+        (uint32_t)sa->sa_cfg.sac_sample_itvl * 1000000 / OS_TICKS_PER_SEC);
+    sb.sb_cputime = os_cputime_get32() - (sb.sb_count - 1) * sb.sb_itvl;
+    sb.sb_data = sa->sa_fifo;
+
+    return batch_func(sensor, batch_arg, &sb);
+err:
+    return (rc);
+}
+
+static void
+sim_accel_dr_event(struct os_event *ev)
+{
+    struct sim_accel *sa;
+
+    sa = ev->ev_arg;
+
+    sensor_mgr_data_ready(&sa->sa_sensor);
+    os_callout_reset(&sa->sa_dr_callout, sa->sa_cfg.sac_sample_itvl);
+}
+
+/**
+ * Emulates a data ready interrupt with a callout firing once every sample
+ * interval.
+ */
+static int
+sim_accel_sensor_set_data_ready(struct sensor *sensor, sensor_type_t type,
+        int enable)
+{
+    struct sim_accel *sa;
+
+    if (!(type & SENSOR_TYPE_ACCELEROMETER)) {
+        return (SYS_EINVAL);
+    }
+
+    sa = (struct sim_accel *) SENSOR_GET_DEVICE(sensor);
+
+    if (enable) {
+        os_callout_reset(&sa->sa_dr_callout, sa->sa_cfg.sac_sample_itvl);
+    } else {
+        os_callout_stop(&sa->sa_dr_callout);
+    }
+
+    return (0);
+}
+
 static int
 sim_accel_sensor_get_config(struct sensor *sensor, sensor_type_t type,
         struct sensor_cfg *cfg)
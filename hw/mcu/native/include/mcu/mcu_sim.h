@@ -19,18 +19,42 @@
 #ifndef __MCU_SIM_H__
 #define __MCU_SIM_H__
 
+#include <inttypes.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 #define OS_TICKS_PER_SEC    (100)
 
+/*
+ * Simulated flash counters.  Busy time is the modelled time spent in
+ * program and erase operations; see MCU_NATIVE_FLASH_* in syscfg.
+ */
+struct native_flash_stats {
+    uint32_t nfs_reads;
+    uint32_t nfs_writes;
+    uint32_t nfs_erases;
+    uint32_t nfs_erase_fails;       /* erases refused on worn sectors */
+    uint64_t nfs_read_bytes;
+    uint64_t nfs_write_bytes;
+    uint64_t nfs_pages_programmed;
+    uint64_t nfs_busy_usecs;
+};
+
 extern char *native_flash_file;
+extern char *native_flash_trace_file;
+extern char *native_flash_stats_file;
 extern char *native_uart_log_file;
 extern const char *native_uart_dev_strs[];
 
 void mcu_sim_parse_args(int argc, char **argv);
 
+void native_flash_stats_get(struct native_flash_stats *stats);
+uint32_t native_flash_erase_cnt(int sector);
+void native_flash_stats_reset(void);
+int native_flash_stats_dump(const char *path);
+
 #ifdef __cplusplus
 }
 #endif
@@ -23,12 +23,20 @@
 #include <string.h>
 #include <inttypes.h>
 #include <stdlib.h>
+#include <stdio.h>
+#include <errno.h>
+#include <time.h>
+#include "syscfg/syscfg.h"
 #include "hal/hal_flash_int.h"
 #include "mcu/mcu_sim.h"
 
 char *native_flash_file;
+char *native_flash_trace_file;
+char *native_flash_stats_file;
 static int file;
 static void *file_loc;
+static FILE *native_flash_trace;
+static struct native_flash_stats native_flash_stats;
 
 static int native_flash_init(const struct hal_flash *dev);
 static int native_flash_read(const struct hal_flash *dev, uint32_t address,
@@ -66,6 +74,14 @@ static const uint32_t native_flash_sectors[] = {
 #define FLASH_NUM_AREAS   (int)(sizeof native_flash_sectors /           \
                                 sizeof native_flash_sectors[0])
 
+static uint32_t native_flash_erase_cnts[FLASH_NUM_AREAS];
+
+#define NATIVE_FLASH_PAGE_SIZE          MYNEWT_VAL(MCU_NATIVE_FLASH_PAGE_SIZE)
+#define NATIVE_FLASH_PAGE_PROG_USECS    \
+    MYNEWT_VAL(MCU_NATIVE_FLASH_PAGE_PROG_USECS)
+#define NATIVE_FLASH_ERASE_KB_USECS     \
+    MYNEWT_VAL(MCU_NATIVE_FLASH_ERASE_KB_USECS)
+
 const struct hal_flash native_flash_dev = {
     .hf_itf = &native_flash_funcs,
     .hf_base_addr = 0,
@@ -80,6 +96,51 @@ flash_native_erase(uint32_t addr, uint32_t len)
     memset(file_loc + addr, 0xff, len);
 }
 
+/*
+ * Accounts for the modelled time of a flash operation, and writes it to the
+ * trace.  Trace lines are "<busy usecs before op> <op> <addr> <len> <usecs>",
+ * with op one of r(ead), w(rite) or e(rase); timestamps are in modelled
+ * flash time, so traces of the same workload compare across runs.
+ */
+static void
+native_flash_account(char op, uint32_t address, uint32_t length,
+                     uint32_t usecs)
+{
+#if MYNEWT_VAL(MCU_NATIVE_FLASH_STALL)
+    struct timespec ts;
+#endif
+
+    if (native_flash_trace) {
+        fprintf(native_flash_trace, "%" PRIu64 " %c 0x%08" PRIx32 " %" PRIu32
+                " %" PRIu32 "\n", native_flash_stats.nfs_busy_usecs, op,
+                address, length, usecs);
+    }
+    native_flash_stats.nfs_busy_usecs += usecs;
+
+#if MYNEWT_VAL(MCU_NATIVE_FLASH_STALL)
+    if (usecs) {
+        ts.tv_sec = usecs / 1000000;
+        ts.tv_nsec = (usecs % 1000000) * 1000;
+
+        /* OS signals interrupt the sleep; continue with what is left. */
+        while (nanosleep(&ts, &ts) < 0 && errno == EINTR) {
+        }
+    }
+#endif
+}
+
+static void
+native_flash_exit(void)
+{
+    if (native_flash_stats_file) {
+        native_flash_stats_dump(native_flash_stats_file);
+    }
+    if (native_flash_trace) {
+        fclose(native_flash_trace);
+        native_flash_trace = NULL;
+    }
+}
+
 static void
 flash_native_file_open(char *name)
 {
@@ -105,6 +166,12 @@ flash_native_file_open(char *name)
     if (created) {
         flash_native_erase(0, native_flash_dev.hf_size);
     }
+
+    if (native_flash_trace_file) {
+        native_flash_trace = fopen(native_flash_trace_file, "w");
+        assert(native_flash_trace);
+    }
+    atexit(native_flash_exit);
 }
 
 static void
@@ -163,8 +230,21 @@ static int
 native_flash_write(const struct hal_flash *dev, uint32_t address,
         const void *src, uint32_t length)
 {
+    uint32_t pages;
+    int rc;
+
     assert(address % native_flash_dev.hf_align == 0);
-    return flash_native_write_internal(address, src, length, 0);
+    rc = flash_native_write_internal(address, src, length, 0);
+    if (rc == 0 && length) {
+        pages = (address + length - 1) / NATIVE_FLASH_PAGE_SIZE -
+                address / NATIVE_FLASH_PAGE_SIZE + 1;
+        native_flash_stats.nfs_writes++;
+        native_flash_stats.nfs_write_bytes += length;
+        native_flash_stats.nfs_pages_programmed += pages;
+        native_flash_account('w', address, length,
+                             pages * NATIVE_FLASH_PAGE_PROG_USECS);
+    }
+    return rc;
 }
 
 int
@@ -181,6 +261,12 @@ native_flash_read(const struct hal_flash *dev, uint32_t address, void *dst,
     flash_native_ensure_file_open();
     memcpy(dst, (char *)file_loc + address, length);
 
+    if (dev) {
+        native_flash_stats.nfs_reads++;
+        native_flash_stats.nfs_read_bytes += length;
+        native_flash_account('r', address, length, 0);
+    }
+
     return 0;
 }
 
@@ -224,7 +310,20 @@ native_flash_erase_sector(const struct hal_flash *dev, uint32_t sector_address)
         return -1;
     }
     len = flash_sector_len(area_id);
+
+#if MYNEWT_VAL(MCU_NATIVE_FLASH_ENDURANCE)
+    if (native_flash_erase_cnts[area_id] >=
+        MYNEWT_VAL(MCU_NATIVE_FLASH_ENDURANCE)) {
+        native_flash_stats.nfs_erase_fails++;
+        return -1;
+    }
+#endif
+
     flash_native_erase(sector_address, len);
+    native_flash_erase_cnts[area_id]++;
+    native_flash_stats.nfs_erases++;
+    native_flash_account('e', sector_address, len,
+                         len / 1024 * NATIVE_FLASH_ERASE_KB_USECS);
     return 0;
 }
 
@@ -247,3 +346,67 @@ native_flash_init(const struct hal_flash *dev)
     }
     return 0;
 }
+
+void
+native_flash_stats_get(struct native_flash_stats *stats)
+{
+    *stats = native_flash_stats;
+}
+
+uint32_t
+native_flash_erase_cnt(int sector)
+{
+    if (sector < 0 || sector >= FLASH_NUM_AREAS) {
+        return 0;
+    }
+    return native_flash_erase_cnts[sector];
+}
+
+void
+native_flash_stats_reset(void)
+{
+    memset(&native_flash_stats, 0, sizeof native_flash_stats);
+    memset(native_flash_erase_cnts, 0, sizeof native_flash_erase_cnts);
+}
+
+/**
+ * Writes the flash counters and per-sector erase counts to the given file,
+ * or to stdout if path is NULL.
+ */
+int
+native_flash_stats_dump(const char *path)
+{
+    struct native_flash_stats *s;
+    FILE *fp;
+    int i;
+
+    if (path) {
+        fp = fopen(path, "w");
+        if (!fp) {
+            return -1;
+        }
+    } else {
+        fp = stdout;
+    }
+
+    s = &native_flash_stats;
+    fprintf(fp, "reads %" PRIu32 " bytes %" PRIu64 "\n",
+            s->nfs_reads, s->nfs_read_bytes);
+    fprintf(fp, "writes %" PRIu32 " bytes %" PRIu64 " pages %" PRIu64 "\n",
+            s->nfs_writes, s->nfs_write_bytes, s->nfs_pages_programmed);
+    fprintf(fp, "erases %" PRIu32 " fails %" PRIu32 "\n",
+            s->nfs_erases, s->nfs_erase_fails);
+    fprintf(fp, "busy_usecs %" PRIu64 "\n", s->nfs_busy_usecs);
+    for (i = 0; i < FLASH_NUM_AREAS; i++) {
+        fprintf(fp, "sector %d addr 0x%08" PRIx32 " size %d erases %" PRIu32
+                "\n", i, native_flash_sectors[i], flash_sector_len(i),
+                native_flash_erase_cnts[i]);
+    }
+
+    if (path) {
+        fclose(fp);
+    } else {
+        fflush(fp);
+    }
+    return 0;
+}
@@ -57,7 +57,9 @@ usage(char *progname, int rc)
       "        created if it doesn't already exist.\n"
       "     -u uart_log_file puts all UART data exchanges into a logfile.\n"
       "     -uart0 uart0_file connects UART0 to character device uart0_file.\n"
-      "     -uart1 uart1_file connects UART1 to character device uart1_file.\n";
+      "     -uart1 uart1_file connects UART1 to character device uart1_file.\n"
+      "     --flash_trace <file> logs every flash operation to file.\n"
+      "     --flash_stats <file> writes flash counters to file on exit.\n";
 
     write(2, msg1, strlen(msg1));
     write(2, progname, strlen(progname));
@@ -76,6 +78,8 @@ mcu_sim_parse_args(int argc, char **argv)
         { "help",       no_argument,            0, 'h' },
         { "uart0",      required_argument,      0, 0 },
         { "uart1",      required_argument,      0, 0 },
+        { "flash_trace", required_argument,     0, 0 },
+        { "flash_stats", required_argument,     0, 0 },
         { NULL }
     };
     int opt_idx;
@@ -116,6 +120,12 @@ mcu_sim_parse_args(int argc, char **argv)
             case 4:
                 native_uart_dev_strs[1] = optarg;
                 break;
+            case 5:
+                native_flash_trace_file = optarg;
+                break;
+            case 6:
+                native_flash_stats_file = optarg;
+                break;
             default:
                 usage(progname, -1);
                 break;
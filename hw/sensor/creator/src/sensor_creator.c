@@ -276,6 +276,7 @@ config_bno055_sensor(void)
     bcfg.bc_acc_bw = BNO055_ACC_CFG_BW_125HZ;
     bcfg.bc_acc_range =  BNO055_ACC_CFG_RNG_16G;
     bcfg.bc_use_ext_xtal = 1;
+    bcfg.bc_int_pin = -1;
     bcfg.bc_mask = SENSOR_TYPE_ACCELEROMETER|
                    SENSOR_TYPE_MAGNETIC_FIELD|
                    SENSOR_TYPE_GYROSCOPE|
@@ -28,13 +28,16 @@
 extern "C" {
 #endif
 
+/* Fractional bits of the values, with SENSOR_FIXED_POINT */
+#define SENSOR_ACCEL_Q (16)
+
 /* Data representing a singular read from an accelerometer.
  * All values are in MS^2
  */
 struct sensor_accel_data {
-    float sad_x;
-    float sad_y;
-    float sad_z;
+    sensor_val_t sad_x;
+    sensor_val_t sad_y;
+    sensor_val_t sad_z;
 
     /* Validity */
     uint8_t sad_x_is_valid:1;
@@ -28,14 +28,17 @@
 extern "C" {
 #endif
 
+/* Fractional bits of the values, with SENSOR_FIXED_POINT */
+#define SENSOR_EULER_Q (16)
+
 /* Data representing Euler angles
  * All values are in Degrees
  * Heading, Roll and Pitch
  */
 struct sensor_euler_data {
-    float sed_h;
-    float sed_r;
-    float sed_p;
+    sensor_val_t sed_h;
+    sensor_val_t sed_r;
+    sensor_val_t sed_p;
     /* Validity */
     uint8_t sed_h_is_valid:1;
     uint8_t sed_r_is_valid:1;
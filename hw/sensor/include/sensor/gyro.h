@@ -28,13 +28,16 @@
 extern "C" {
 #endif
 
+/* Fractional bits of the values, with SENSOR_FIXED_POINT */
+#define SENSOR_GYRO_Q (16)
+
 /* Data representing a singular read from a gyroscope
  * All values are in degress per sec
  */
 struct sensor_gyro_data {
-    float sgd_x;
-    float sgd_y;
-    float sgd_z;
+    sensor_val_t sgd_x;
+    sensor_val_t sgd_y;
+    sensor_val_t sgd_z;
     /* Validity */
     uint8_t sgd_x_is_valid:1;
     uint8_t sgd_y_is_valid:1;
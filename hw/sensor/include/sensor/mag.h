@@ -28,13 +28,16 @@
 extern "C" {
 #endif
 
+/* Fractional bits of the values, with SENSOR_FIXED_POINT */
+#define SENSOR_MAG_Q (16)
+
 /* Data representing a singular read from a magnetometer.
  * All values are in uTesla
  */
 struct sensor_mag_data {
-    float smd_x;
-    float smd_y;
-    float smd_z;
+    sensor_val_t smd_x;
+    sensor_val_t smd_y;
+    sensor_val_t smd_z;
     /* Validity */
     uint8_t smd_x_is_valid:1;
     uint8_t smd_y_is_valid:1;
@@ -28,13 +28,16 @@
 extern "C" {
 #endif
 
+/* Fractional bits of the values, with SENSOR_FIXED_POINT */
+#define SENSOR_QUAT_Q (30)
+
 /* Data representing a singular read from a quat sensor.
  */
 struct sensor_quat_data {
-    float sqd_x;
-    float sqd_y;
-    float sqd_z;
-    float sqd_w;
+    sensor_val_t sqd_x;
+    sensor_val_t sqd_y;
+    sensor_val_t sqd_z;
+    sensor_val_t sqd_w;
     /* Validity */
     uint8_t sqd_x_is_valid:1;
     uint8_t sqd_y_is_valid:1;
@@ -129,6 +129,33 @@ typedef enum {
  */
 #define STANDARD_ACCEL_GRAVITY 9.80665F
 
+/**
+ * Values of the vector sensor types: acceleration, magnetic field, angular
+ * rate, euler angles and quaternions.  With SENSOR_FIXED_POINT these are
+ * signed fixed point numbers, with SENSOR_<TYPE>_Q fractional bits, so no
+ * floating point is needed between the driver and the listeners; values
+ * are converted only where they leave the device.  Otherwise they are
+ * floats.
+ */
+#if MYNEWT_VAL(SENSOR_FIXED_POINT)
+typedef int32_t sensor_val_t;
+
+/* raw * scale, for a constant scale: one integer multiply at run time */
+#define SENSOR_VAL_SCALE(raw, scale, q)                                     \
+    ((sensor_val_t)(((int64_t)(raw) *                                       \
+                     (int64_t)((scale) * (1 << (q)) * 65536.0 + 0.5)) >> 16))
+/* num / den; num must fit in (31 - q) bits */
+#define SENSOR_VAL_RATIO(num, den, q)                                       \
+    ((sensor_val_t)((int32_t)(num) * (1 << (q)) / (den)))
+#define SENSOR_VAL_TO_FLOAT(val, q)     ((float)(val) / (1 << (q)))
+#else
+typedef float sensor_val_t;
+
+#define SENSOR_VAL_SCALE(raw, scale, q) ((sensor_val_t)(raw) * (scale))
+#define SENSOR_VAL_RATIO(num, den, q)   ((sensor_val_t)(num) / (den))
+#define SENSOR_VAL_TO_FLOAT(val, q)     ((float)(val))
+#endif
+
 /**
  * Configuration structure, describing a specific sensor type off of
  * an existing sensor.
@@ -156,6 +183,60 @@ struct sensor_cfg {
 typedef int (*sensor_data_func_t)(struct sensor *, void *, void *,
              sensor_type_t);
 
+/**
+ * A batch of samples of one sensor type, e.g. the contents of a hardware
+ * FIFO.  The samples are evenly spaced in time.
+ */
+struct sensor_batch {
+    /* The sensor type of the samples */
+    sensor_type_t sb_type;
+
+    /* Number of samples */
+    uint16_t sb_count;
+
+    /* Size of a sample, e.g. sizeof(struct sensor_accel_data) */
+    uint16_t sb_sample_size;
+
+    /* Cputime of the first (oldest) sample */
+    uint32_t sb_cputime;
+
+    /* Cputime ticks between two samples */
+    uint32_t sb_itvl;
+
+    /* The samples, oldest first */
+    void *sb_data;
+};
+
+/**
+ * Get a sample of a batch
+ *
+ * @param The batch
+ * @param Index of the sample, 0 being the oldest
+ */
+#define SENSOR_BATCH_SAMPLE(__sb, __i) \
+    ((void *)((uint8_t *)(__sb)->sb_data + (__i) * (__sb)->sb_sample_size))
+
+/**
+ * Get the cputime of a sample of a batch
+ *
+ * @param The batch
+ * @param Index of the sample, 0 being the oldest
+ */
+#define SENSOR_BATCH_CPUTIME(__sb, __i) \
+    ((__sb)->sb_cputime + (__i) * (__sb)->sb_itvl)
+
+/**
+ * Callback for handling a batch of sensor data.
+ *
+ * @param The sensor for which data is being returned
+ * @param The argument provided to sensor_read_batch() function.
+ * @param The batch of readings
+ *
+ * @return 0 on success, non-zero error code on failure.
+ */
+typedef int (*sensor_batch_func_t)(struct sensor *, void *,
+             struct sensor_batch *);
+
 /**
  *
  */
@@ -172,6 +253,12 @@ struct sensor_listener {
     /* Argument for the sensor listener */
     void *sl_arg;
 
+    /* Optional batch handler.  If set, batched reads deliver whole batches
+     * here instead of calling sl_func for every sample.  Single reads
+     * always go to sl_func.
+     */
+    sensor_batch_func_t sl_batch_func;
+
     /* Next item in the sensor listener list.  The head of this list is
      * contained within the sensor object.
      */
@@ -208,9 +295,42 @@ typedef int (*sensor_read_func_t)(struct sensor *, sensor_type_t,
 typedef int (*sensor_get_config_func_t)(struct sensor *, sensor_type_t,
         struct sensor_cfg *);
 
+/**
+ * Read all the samples a sensor has buffered, e.g. in a hardware FIFO, for
+ * the given sensor type(s), in as few bus transfers as possible.
+ *
+ * @param The sensor to read from
+ * @param The type(s) of sensor values to read.
+ * @param The function to call with each batch read.
+ * @param The argument to pass to the batch function.
+ * @param Timeout.
+ *
+ * @return 0 on success, non-zero error code on failure.
+ */
+typedef int (*sensor_read_batch_func_t)(struct sensor *, sensor_type_t,
+        sensor_batch_func_t, void *, uint32_t);
+
+/**
+ * Enable or disable the data ready notification of a sensor.  While it is
+ * enabled, the driver calls sensor_mgr_data_ready() whenever the device has
+ * new samples, typically from its data ready interrupt.
+ *
+ * @param The sensor
+ * @param The type(s) of sensor values to be notified about
+ * @param 1 to enable, 0 to disable
+ *
+ * @return 0 on success, non-zero error code on failure.
+ */
+typedef int (*sensor_set_data_ready_func_t)(struct sensor *, sensor_type_t,
+        int);
+
 struct sensor_driver {
     sensor_read_func_t sd_read;
     sensor_get_config_func_t sd_get_config;
+    /* Optional, for drivers that buffer samples */
+    sensor_read_batch_func_t sd_read_batch;
+    /* Optional, for devices that can signal new data */
+    sensor_set_data_ready_func_t sd_set_data_ready;
 };
 
 struct sensor_timestamp {
@@ -219,6 +339,32 @@ struct sensor_timestamp {
     uint32_t st_cputime;
 };
 
+/**
+ * Polling statistics of a sensor, kept by the sensor manager.  Times are in
+ * microseconds.
+ */
+struct sensor_poll_stats {
+    /* Number of polls */
+    uint32_t sps_polls;
+    /* Number of polls that failed */
+    uint32_t sps_errors;
+    /* Number of deadlines skipped because a poll ran more than a period
+     * late.
+     */
+    uint32_t sps_missed;
+    /* Delay between the deadline and the start of the poll */
+    uint32_t sps_lat_max;
+    uint64_t sps_lat_total;
+    /* Difference between the time from the previous poll and the poll
+     * period
+     */
+    uint32_t sps_jitter_max;
+    uint64_t sps_jitter_total;
+    /* Time spent reading the sensor */
+    uint32_t sps_read_max;
+    uint64_t sps_read_total;
+};
+
 struct sensor_itf {
 
     /* Sensor interface type */
@@ -270,6 +416,29 @@ struct sensor {
     /* The next time at which we want to poll data from this sensor */
     os_time_t s_next_run;
 
+    /* The poll period, in ticks and thousandths of a tick.  The fractions
+     * are carried over in s_poll_frac so that deadlines do not drift.
+     */
+    os_time_t s_poll_ticks;
+    uint16_t s_poll_frac_step;
+    uint16_t s_poll_frac;
+
+    /* Fires at s_next_run, on the event queue polling this sensor.  With
+     * data ready enabled, retries reads which found the sensor locked.
+     */
+    struct os_callout s_poll_callout;
+
+    /* Queued by sensor_mgr_data_ready() when the device has new data */
+    struct os_event s_dr_event;
+    uint8_t s_dr_enabled;
+
+#if MYNEWT_VAL(SENSOR_POLL_STATS)
+    /* Cputime at the start of the last poll */
+    uint32_t s_poll_cputime;
+
+    struct sensor_poll_stats s_poll_stats;
+#endif
+
     /* Sensor driver specific functions, created by the device registering the
      * sensor.
      */
@@ -319,9 +488,50 @@ int sensor_register_listener(struct sensor *, struct sensor_listener *);
 
 int sensor_unregister_listener(struct sensor *, struct sensor_listener *);
 
+/**
+ * Get the size of the sensor data structure of a sensor type, e.g.
+ * struct sensor_accel_data for SENSOR_TYPE_ACCELEROMETER.
+ *
+ * @param The sensor type
+ *
+ * @return The size, 0 if the type has no data structure.
+ */
+size_t sensor_data_size(sensor_type_t);
+
 int sensor_read(struct sensor *, sensor_type_t, sensor_data_func_t, void *,
         uint32_t);
 
+/**
+ * Read all buffered samples from a sensor whose driver supports batched
+ * reads.  Listeners with a batch handler get each batch as a whole; the
+ * others are called for every sample.
+ *
+ * @param The sensor to read from
+ * @param The type(s) of sensor values to read
+ * @param The function to call with each batch, or NULL to only call
+ *        the listeners
+ * @param The argument to pass to the batch function
+ * @param Timeout before aborting sensor read
+ *
+ * @return 0 on success, SYS_ENOTSUP if the driver doesn't support batched
+ *         reads, other non-zero error code on failure.
+ */
+int sensor_read_batch(struct sensor *, sensor_type_t, sensor_batch_func_t,
+        void *, uint32_t);
+
+/**
+ * Have the sensor read whenever the device signals new data, instead of
+ * polling it.  Enabling this stops polling; setting a poll rate disables
+ * it again.
+ *
+ * @param The sensor
+ * @param 1 to enable, 0 to disable
+ *
+ * @return 0 on success, SYS_ENOTSUP if the driver can't signal new data,
+ *         other non-zero error code on failure.
+ */
+int sensor_set_data_ready(struct sensor *, int);
+
 /**
  * Set the driver functions for this sensor, along with the type of sensor
  * data available for the given sensor.
@@ -411,18 +621,20 @@ sensor_get_config(struct sensor *sensor, sensor_type_t type,
  */
 
 
-/* Default number of ticks to wakeup the sensor task.  If sensor
- * polling has been configured more frequently than this, it will
- * be triggered instead.
- */
-#define SENSOR_MGR_WAKEUP_TICKS (MYNEWT_VAL(SENSOR_MGR_WAKEUP_RATE) * \
-    OS_TICKS_PER_SEC) / 1000
-
 int sensor_mgr_lock(void);
 void sensor_mgr_unlock(void);
 int sensor_mgr_register(struct sensor *);
 struct os_eventq *sensor_mgr_evq_get(void);
 
+/**
+ * Notify the sensor manager that a sensor has new data.  The sensor is
+ * read, and its listeners called, from the event queue polling it.  This
+ * can be called from interrupt context.
+ *
+ * @param The sensor
+ */
+void sensor_mgr_data_ready(struct sensor *);
+
 
 typedef int (*sensor_mgr_compare_func_t)(struct sensor *, void *);
 
@@ -433,8 +645,8 @@ typedef int (*sensor_mgr_compare_func_t)(struct sensor *, void *);
  * in the sensor list.
  *
  * @warn This function MUST be locked by sensor_mgr_lock/unlock() if the goal is
- * to iterate through sensors (as opposed to just finding one.)  As the
- * "prev_cursor" may be resorted in the sensor list, in between calls.
+ * to iterate through sensors (as opposed to just finding one.)  As sensors
+ * may be registered in between calls.
  *
  * @param The comparison function to use against sensors in the list.
  * @param The argument to provide to that comparison function
@@ -485,21 +697,67 @@ struct sensor *sensor_mgr_find_next_bydevname(char *, struct sensor *);
 int sensor_mgr_match_bytype(struct sensor *, void *);
 
 /**
- * Set the sensor poll rate
+ * Set the sensor poll rate.  A non-zero rate disables the data ready
+ * notification of the sensor.
  *
  * @param The devname
- * @param The poll rate in milli seconds
+ * @param The poll rate in milli seconds, 0 to stop polling
  */
 int
 sensor_set_poll_rate_ms(char *, uint32_t);
 
+#if MYNEWT_VAL(SENSOR_POLL_STATS)
+/**
+ * Get the polling statistics of a sensor
+ *
+ * @param The sensor
+ * @param Filled with the statistics
+ * @param 1 to clear the statistics after reading them
+ *
+ * @return 0 on success, non-zero error code on failure.
+ */
+int sensor_get_poll_stats(struct sensor *, struct sensor_poll_stats *, int);
+#endif
+
 #if MYNEWT_VAL(SENSOR_CLI)
 char*
 sensor_ftostr(float, char *, int);
+
+/**
+ * Format a sensor value, without floating point when the value is fixed
+ * point
+ *
+ * @param The value
+ * @param The fractional bits of the value's type, SENSOR_<TYPE>_Q
+ * @param The buffer to format into
+ * @param Length of the buffer
+ *
+ * @return The buffer
+ */
+char *
+sensor_vtostr(sensor_val_t, int, char *, int);
 #endif
 
 #if MYNEWT_VAL(SENSOR_OIC)
 void sensor_oic_init(void);
+
+/**
+ * Set when observers of a sensor resource are notified.  A notification
+ * is sent when a value moved by more than the deadband since the last
+ * one, and no sooner than the minimum period after it.  Changes are
+ * picked up when the sensor is read, so the sensor should be polled or
+ * have data ready notification enabled.
+ *
+ * @param The sensor
+ * @param The sensor type of the resource
+ * @param Minimum period between notifications, in ms
+ * @param The deadband, in the units of the sensor value
+ *
+ * @return 0 on success, SYS_ENOENT if the resource is not observed on
+ *         change.
+ */
+int sensor_oic_set_obs_threshold(struct sensor *, sensor_type_t, uint32_t,
+        float);
 #endif
 
 /**
@@ -0,0 +1,149 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef __SENSOR_BUS_H__
+#define __SENSOR_BUS_H__
+
+#include "os/os.h"
+#include "syscfg/syscfg.h"
+#include "hal/hal_spi.h"
+#include "sensor/sensor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The sensor bus manager runs the I2C and SPI transfers of sensor drivers
+ * on one task per bus.  Transactions on a bus are queued and run in order;
+ * transactions on different buses run concurrently.  Sensors are polled on
+ * the task of their bus, so a slow device only holds up its own bus.
+ */
+
+/* Transaction writes sbt_buf to the device, instead of reading into it */
+#define SENSOR_BUS_F_WRITE      (0x01)
+/* Transaction starts with sbt_reg written to the device */
+#define SENSOR_BUS_F_REG        (0x02)
+
+struct sensor_bus_txn;
+
+/**
+ * Called on the bus task when a transaction is done.
+ *
+ * @param The transaction
+ * @param 0 on success, non-zero error code on failure
+ */
+typedef void (*sensor_bus_done_func_t)(struct sensor_bus_txn *, int);
+
+struct sensor_bus_txn {
+    /* The device; its interface type and number pick the bus */
+    struct sensor_itf *sbt_itf;
+
+    /* SENSOR_BUS_F_[...] */
+    uint8_t sbt_flags;
+
+    /* Register address, as sent on the bus, including any read or
+     * auto-increment bits the device wants
+     */
+    uint8_t sbt_reg;
+
+    uint16_t sbt_len;
+    uint8_t *sbt_buf;
+
+    /* SPI settings applied before the transfer, NULL to leave the bus
+     * configuration as it is.  Unused on I2C.
+     */
+    struct hal_spi_settings *sbt_spi_settings;
+
+    sensor_bus_done_func_t sbt_done;
+    void *sbt_arg;
+
+    /* Internal */
+    struct os_event sbt_ev;
+};
+
+/**
+ * Queue a transaction on its bus.  The transaction must stay valid until
+ * its done function is called.
+ *
+ * @param The transaction
+ *
+ * @return 0 on success, SYS_EINVAL if the bus is not managed.
+ */
+int sensor_bus_submit(struct sensor_bus_txn *);
+
+/**
+ * Run a transaction on its bus and wait for it to complete.  When called
+ * on the bus task, e.g. from a sensor poll, or before the OS is started,
+ * it runs right away.  Otherwise the caller waits, with no timeout, for
+ * the bus task to run it; the bus task must never block on a lock the
+ * caller may hold, such as the sensor's.
+ *
+ * @param The transaction; its done function is not used
+ *
+ * @return 0 on success, non-zero error code on failure.
+ */
+int sensor_bus_run(struct sensor_bus_txn *);
+
+/**
+ * Read registers of a device: writes the register address, then reads len
+ * bytes, in one queued transaction.
+ *
+ * @param The sensor interface
+ * @param The register address, as sent on the bus
+ * @param The buffer to read into
+ * @param Number of bytes to read
+ * @param SPI settings of the device, or NULL
+ *
+ * @return 0 on success, non-zero error code on failure.
+ */
+int sensor_bus_read_reg(struct sensor_itf *, uint8_t, uint8_t *, uint16_t,
+        struct hal_spi_settings *);
+
+/**
+ * Write registers of a device: writes the register address followed by
+ * len bytes, in one queued transaction.
+ *
+ * @param The sensor interface
+ * @param The register address, as sent on the bus
+ * @param The data to write
+ * @param Number of bytes to write
+ * @param SPI settings of the device, or NULL
+ *
+ * @return 0 on success, non-zero error code on failure.
+ */
+int sensor_bus_write_reg(struct sensor_itf *, uint8_t, uint8_t *, uint16_t,
+        struct hal_spi_settings *);
+
+/**
+ * Get the event queue of the task running a device's bus.
+ *
+ * @param The sensor interface
+ *
+ * @return The event queue, or NULL if the bus is not managed.
+ */
+struct os_eventq *sensor_bus_evq_get(struct sensor_itf *);
+
+void sensor_bus_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SENSOR_BUS_H__ */
@@ -0,0 +1,155 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef __SENSOR_RING_H__
+#define __SENSOR_RING_H__
+
+#include "os/os.h"
+#include "sensor/sensor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * A sensor ring keeps the most recent samples of a sensor, each with a
+ * sequence number and timestamp.  The sensor's reads write to it through a
+ * listener, which only copies the sample; it never waits for consumers.
+ * Any number of consumers read from it at their own pace, on any task.  A
+ * consumer that falls behind by more than the ring size loses the oldest
+ * samples, which it sees as a gap in the sequence numbers.
+ */
+
+struct sensor_ring_entry {
+    /* Sequence number of the sample in this entry.  Set before the sample
+     * is written, so a reader of the previous sample sees it is gone.
+     */
+    volatile uint32_t sre_seq;
+    sensor_type_t sre_type;
+    struct sensor_timestamp sre_sts;
+    /* Sample data follows */
+};
+
+/* Entries hold 64-bit timestamps; the ring buffer is aligned to this */
+#define SENSOR_RING_ALIGN       (8)
+
+/* Size of one ring entry, for samples of up to data_size bytes */
+#define SENSOR_RING_ENTRY_SIZE(data_size)                                   \
+    OS_ALIGN(sizeof(struct sensor_ring_entry) + (data_size),                \
+             SENSOR_RING_ALIGN)
+
+/* Size of the buffer of a ring with num entries */
+#define SENSOR_RING_BUF_SIZE(data_size, num)                                \
+    (SENSOR_RING_ENTRY_SIZE(data_size) * (num))
+
+struct sensor_ring {
+    struct sensor *sr_sensor;
+    struct sensor_listener sr_listener;
+
+    uint8_t *sr_buf;
+    uint16_t sr_entry_size;
+    uint16_t sr_data_size;
+    /* Number of entries; a power of two */
+    uint16_t sr_num;
+
+    /* Sequence number of the newest sample, 0 if there is none */
+    volatile uint32_t sr_seq;
+};
+
+/**
+ * Initialize a sample ring and start filling it from the sensor's reads.
+ *
+ * @param The ring
+ * @param The sensor
+ * @param The sensor types to keep samples of
+ * @param The buffer, SENSOR_RING_BUF_SIZE(data_size, num) bytes, aligned
+ *        to SENSOR_RING_ALIGN
+ * @param The largest sample size of the types, see sensor_data_size()
+ * @param Number of entries, a power of two
+ *
+ * @return 0 on success, non-zero error code on failure.
+ */
+int sensor_ring_init(struct sensor_ring *, struct sensor *, sensor_type_t,
+        void *, uint16_t, uint16_t);
+
+/**
+ * Stop filling a sample ring.  Samples in it can still be read.
+ *
+ * @param The ring
+ *
+ * @return 0 on success, non-zero error code on failure.
+ */
+int sensor_ring_stop(struct sensor_ring *);
+
+/**
+ * Get the sequence number of the newest sample in a ring.
+ *
+ * @param The ring
+ *
+ * @return The sequence number, 0 if the ring is empty.
+ */
+static inline uint32_t
+sensor_ring_seq(struct sensor_ring *ring)
+{
+    return (ring->sr_seq);
+}
+
+/**
+ * Get the sequence number of the oldest sample that is still in a ring.
+ *
+ * @param The ring
+ *
+ * @return The sequence number, 0 if the ring is empty.
+ */
+uint32_t sensor_ring_oldest_seq(struct sensor_ring *);
+
+/**
+ * Read a sample from a ring, by sequence number.  Does not block.
+ *
+ * @param The ring
+ * @param Sequence number of the sample
+ * @param Buffer of sr_data_size bytes for the sample
+ * @param The sample's type, or NULL
+ * @param The sample's timestamp, or NULL
+ *
+ * @return 0 on success, SYS_EAGAIN if the sample is not there yet,
+ *         SYS_ENOENT if it was overwritten.
+ */
+int sensor_ring_read(struct sensor_ring *, uint32_t, void *, sensor_type_t *,
+        struct sensor_timestamp *);
+
+/**
+ * Read the newest sample from a ring.  Does not block.
+ *
+ * @param The ring
+ * @param Set to the sequence number of the sample
+ * @param Buffer of sr_data_size bytes for the sample
+ * @param The sample's type, or NULL
+ * @param The sample's timestamp, or NULL
+ *
+ * @return 0 on success, SYS_ENOENT if the ring is empty.
+ */
+int sensor_ring_read_latest(struct sensor_ring *, uint32_t *, void *,
+        sensor_type_t *, struct sensor_timestamp *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SENSOR_RING_H__ */
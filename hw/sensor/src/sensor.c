@@ -25,6 +25,17 @@
 #include "sysinit/sysinit.h"
 
 #include "sensor/sensor.h"
+#include "sensor/sensor_bus.h"
+#include "sensor/accel.h"
+#include "sensor/mag.h"
+#include "sensor/gyro.h"
+#include "sensor/light.h"
+#include "sensor/temperature.h"
+#include "sensor/pressure.h"
+#include "sensor/humidity.h"
+#include "sensor/quat.h"
+#include "sensor/euler.h"
+#include "sensor/color.h"
 
 #include "sensor_priv.h"
 #include "os/os_time.h"
@@ -36,20 +47,39 @@
 struct {
     struct os_mutex mgr_lock;
 
-    struct os_callout mgr_wakeup_callout;
     struct os_eventq *mgr_eventq;
 
     SLIST_HEAD(, sensor) mgr_sensor_list;
 } sensor_mgr;
 
+#if MYNEWT_VAL(SENSOR_MGR_POLL_TASKS) > 0
+#define SENSOR_MGR_POLL_TASKS       MYNEWT_VAL(SENSOR_MGR_POLL_TASKS)
+#define SENSOR_MGR_POLL_STACK_SIZE  \
+    OS_STACK_ALIGN(MYNEWT_VAL(SENSOR_MGR_POLL_STACK_SIZE))
+
+/* Sensors on the same bus are always polled by the same task */
+static struct os_task sensor_poll_task[SENSOR_MGR_POLL_TASKS];
+static struct os_eventq sensor_poll_evq[SENSOR_MGR_POLL_TASKS];
+static os_stack_t
+    sensor_poll_stack[SENSOR_MGR_POLL_TASKS][SENSOR_MGR_POLL_STACK_SIZE];
+#endif
+
 struct sensor_read_ctx {
     sensor_data_func_t user_func;
     void *user_arg;
 };
 
+struct sensor_read_batch_ctx {
+    sensor_batch_func_t user_func;
+    void *user_arg;
+};
+
 struct sensor_timestamp sensor_base_ts;
 struct os_callout st_up_osco;
 
+static void sensor_mgr_poll_event(struct os_event *ev);
+static void sensor_mgr_data_ready_event(struct os_event *ev);
+
 /**
  * Lock sensor manager to access the list of sensors
  */
@@ -74,27 +104,17 @@ sensor_mgr_unlock(void)
     (void) os_mutex_release(&sensor_mgr.mgr_lock);
 }
 
-static void
-sensor_mgr_remove(struct sensor *sensor)
-{
-    SLIST_REMOVE(&sensor_mgr.mgr_sensor_list, sensor, sensor, s_next);
-}
-
+/**
+ * Add a sensor at the end of the sensor list, so that the list stays in
+ * order of registration.
+ */
 static void
 sensor_mgr_insert(struct sensor *sensor)
 {
     struct sensor *cursor, *prev;
 
-    prev = cursor = NULL;
+    prev = NULL;
     SLIST_FOREACH(cursor, &sensor_mgr.mgr_sensor_list, s_next) {
-        if (cursor->s_next_run == OS_TIMEOUT_NEVER) {
-            break;
-        }
-
-        if (OS_TIME_TICK_LT(sensor->s_next_run, cursor->s_next_run)) {
-            break;
-        }
-
         prev = cursor;
     }
 
@@ -105,11 +125,99 @@ sensor_mgr_insert(struct sensor *sensor)
     }
 }
 
+/**
+ * Get the event queue that polls a sensor.  A sensor on a bus run by the
+ * bus manager is polled by the bus task, so its transfers need no hand
+ * over.  With poll tasks, the sensor's bus picks the task, so that sensors
+ * on independent buses are read in parallel while reads on one bus stay
+ * serialized.
+ */
+static struct os_eventq *
+sensor_mgr_poll_evq_get(struct sensor *sensor)
+{
+    struct os_eventq *evq;
+#if MYNEWT_VAL(SENSOR_MGR_POLL_TASKS) > 0
+    int idx;
+#endif
+
+    evq = sensor_bus_evq_get(&sensor->s_itf);
+    if (evq != NULL) {
+        return (evq);
+    }
+
+#if MYNEWT_VAL(SENSOR_MGR_POLL_TASKS) > 0
+    idx = (sensor->s_itf.si_type * 8 + sensor->s_itf.si_num) %
+          SENSOR_MGR_POLL_TASKS;
+    return (&sensor_poll_evq[idx]);
+#else
+    return (sensor_mgr_evq_get());
+#endif
+}
+
+/**
+ * Move a sensor's deadline on by one poll period, or by as many periods as
+ * needed to get past now if the sensor fell behind.  The deadlines stay on
+ * the grid set when polling started.  Must be called with the sensor
+ * locked.
+ *
+ * @return The number of deadlines skipped.
+ */
+static uint32_t
+sensor_mgr_next_deadline(struct sensor *sensor, os_time_t now)
+{
+    uint32_t periods;
+    uint32_t frac;
+
+    periods = 1;
+    if (OS_TIME_TICK_GEQ(now, sensor->s_next_run + sensor->s_poll_ticks)) {
+        periods = (now - sensor->s_next_run) / sensor->s_poll_ticks + 1;
+    }
+
+    frac = sensor->s_poll_frac + periods * sensor->s_poll_frac_step;
+    sensor->s_next_run += periods * sensor->s_poll_ticks + frac / 1000;
+    sensor->s_poll_frac = frac % 1000;
+
+    return (periods - 1);
+}
+
+/**
+ * Start polling a sensor at its poll rate, with the first poll right away,
+ * or stop polling it if the poll rate is 0.  Must be called with the
+ * sensor locked.
+ */
+static void
+sensor_mgr_poll_start(struct sensor *sensor)
+{
+    uint64_t period;
+
+    if (sensor->s_poll_rate == 0) {
+        os_callout_stop(&sensor->s_poll_callout);
+        return;
+    }
+
+    period = (uint64_t)sensor->s_poll_rate * OS_TICKS_PER_SEC;
+    sensor->s_poll_ticks = period / 1000;
+    sensor->s_poll_frac_step = period % 1000;
+    if (sensor->s_poll_ticks == 0) {
+        /* Faster than the tick rate; poll every tick */
+        sensor->s_poll_ticks = 1;
+        sensor->s_poll_frac_step = 0;
+    }
+    sensor->s_poll_frac = 0;
+
+#if MYNEWT_VAL(SENSOR_POLL_STATS)
+    memset(&sensor->s_poll_stats, 0, sizeof(sensor->s_poll_stats));
+#endif
+
+    sensor->s_next_run = os_time_get();
+    os_callout_reset(&sensor->s_poll_callout, 0);
+}
+
 /**
  * Set the sensor poll rate based on teh device name
  *
  * @param The devname
- * @param The poll rate in milli seconds
+ * @param The poll rate in milli seconds, 0 to stop polling
  */
 int
 sensor_set_poll_rate_ms(char *devname, uint32_t poll_rate)
@@ -124,9 +232,22 @@ sensor_set_poll_rate_ms(char *devname, uint32_t poll_rate)
         goto err;
     }
 
-    sensor_lock(sensor);
+    rc = sensor_lock(sensor);
+    if (rc != 0) {
+        goto err;
+    }
+
+    if (poll_rate != 0 && sensor->s_dr_enabled) {
+        rc = sensor->s_funcs->sd_set_data_ready(sensor, sensor->s_mask, 0);
+        if (rc != 0) {
+            sensor_unlock(sensor);
+            goto err;
+        }
+        sensor->s_dr_enabled = 0;
+    }
 
     sensor->s_poll_rate = poll_rate;
+    sensor_mgr_poll_start(sensor);
 
     sensor_unlock(sensor);
 
@@ -135,6 +256,88 @@ err:
     return rc;
 }
 
+/**
+ * Have the sensor read whenever the device signals new data, instead of
+ * polling it.  Enabling this stops polling; setting a poll rate disables
+ * it again.
+ *
+ * @param The sensor
+ * @param 1 to enable, 0 to disable
+ *
+ * @return 0 on success, SYS_ENOTSUP if the driver can't signal new data,
+ *         other non-zero error code on failure.
+ */
+int
+sensor_set_data_ready(struct sensor *sensor, int enable)
+{
+    int rc;
+
+    if (sensor->s_funcs->sd_set_data_ready == NULL) {
+        rc = SYS_ENOTSUP;
+        goto err;
+    }
+
+    rc = sensor_lock(sensor);
+    if (rc != 0) {
+        goto err;
+    }
+
+    rc = sensor->s_funcs->sd_set_data_ready(sensor, sensor->s_mask, enable);
+    if (rc == 0) {
+        /* Only stop polling once the device signals new data */
+        if (enable) {
+            sensor->s_poll_rate = 0;
+            sensor_mgr_poll_start(sensor);
+        }
+        sensor->s_dr_enabled = !!enable;
+#if MYNEWT_VAL(SENSOR_POLL_STATS)
+        memset(&sensor->s_poll_stats, 0, sizeof(sensor->s_poll_stats));
+#endif
+        /* Pick up data which is already there; an edge triggered
+         * interrupt would not fire until it is read.
+         */
+        if (enable) {
+            sensor_mgr_data_ready(sensor);
+        }
+    }
+
+    sensor_unlock(sensor);
+err:
+    return rc;
+}
+
+#if MYNEWT_VAL(SENSOR_POLL_STATS)
+/**
+ * Get the polling statistics of a sensor
+ *
+ * @param The sensor
+ * @param Filled with the statistics
+ * @param 1 to clear the statistics after reading them
+ *
+ * @return 0 on success, non-zero error code on failure.
+ */
+int
+sensor_get_poll_stats(struct sensor *sensor, struct sensor_poll_stats *sps,
+                      int clear)
+{
+    int rc;
+
+    rc = sensor_lock(sensor);
+    if (rc != 0) {
+        return (rc);
+    }
+
+    *sps = sensor->s_poll_stats;
+    if (clear) {
+        memset(&sensor->s_poll_stats, 0, sizeof(sensor->s_poll_stats));
+    }
+
+    sensor_unlock(sensor);
+
+    return (0);
+}
+#endif
+
 /**
  * Register the sensor with the global sensor list. This makes the sensor
  * searchable by other packages, who may want to look it up by type.
@@ -155,11 +358,20 @@ sensor_mgr_register(struct sensor *sensor)
 
     rc = sensor_lock(sensor);
     if (rc != 0) {
+        sensor_mgr_unlock();
         goto err;
     }
 
     sensor_mgr_insert(sensor);
 
+    os_callout_init(&sensor->s_poll_callout, sensor_mgr_poll_evq_get(sensor),
+                    sensor_mgr_poll_event, sensor);
+    sensor->s_dr_event.ev_cb = sensor_mgr_data_ready_event;
+    sensor->s_dr_event.ev_arg = sensor;
+    if (sensor->s_poll_rate != 0) {
+        sensor_mgr_poll_start(sensor);
+    }
+
     sensor_unlock(sensor);
 
     sensor_mgr_unlock();
@@ -170,103 +382,225 @@ err:
 }
 
 
-static os_time_t
-sensor_mgr_poll_one(struct sensor *sensor, os_time_t now)
+#if MYNEWT_VAL(SENSOR_POLL_STATS)
+static void
+sensor_mgr_read_stats_update(struct sensor *sensor, uint32_t start, int rc)
 {
-    uint32_t sensor_ticks;
-    int rc;
+    struct sensor_poll_stats *sps;
+    uint32_t usecs;
 
-    rc = sensor_lock(sensor);
+    sps = &sensor->s_poll_stats;
+
+    usecs = os_cputime_ticks_to_usecs(os_cputime_get32() - start);
+    sps->sps_read_total += usecs;
+    if (usecs > sps->sps_read_max) {
+        sps->sps_read_max = usecs;
+    }
+
+    sps->sps_polls++;
     if (rc != 0) {
-        goto err;
+        sps->sps_errors++;
     }
+}
 
-    /* Sensor read results.  Every time a sensor is read, all of its
-     * listeners are called by default.  Specify NULL as a callback,
-     * because we just want to run all the listeners.
-     */
-    sensor_read(sensor, sensor->s_mask, NULL, NULL, OS_TIMEOUT_NEVER);
+static void
+sensor_mgr_poll_stats_update(struct sensor *sensor, os_time_t now,
+                             uint32_t start, int rc)
+{
+    struct sensor_poll_stats *sps;
+    uint32_t period;
+    uint32_t usecs;
+    int32_t jitter;
+
+    sps = &sensor->s_poll_stats;
+
+    /* Latency has tick resolution; the deadlines are in ticks */
+    usecs = (uint64_t)(now - sensor->s_next_run) * 1000000 / OS_TICKS_PER_SEC;
+    sps->sps_lat_total += usecs;
+    if (usecs > sps->sps_lat_max) {
+        sps->sps_lat_max = usecs;
+    }
 
-    /* Remove the sensor from the sensor list for insert. */
-    sensor_mgr_remove(sensor);
+    if (sps->sps_polls != 0) {
+        period = sensor->s_poll_rate * 1000;
+        jitter = os_cputime_ticks_to_usecs(start - sensor->s_poll_cputime) -
+                 period;
+        if (jitter < 0) {
+            jitter = -jitter;
+        }
+        sps->sps_jitter_total += jitter;
+        if (jitter > sps->sps_jitter_max) {
+            sps->sps_jitter_max = jitter;
+        }
+    }
+    sensor->s_poll_cputime = start;
 
-    /* Set next wakeup, and insert the sensor back into the
-     * list.
-     */
-    os_time_ms_to_ticks(sensor->s_poll_rate, &sensor_ticks);
-    sensor->s_next_run = sensor_ticks + now;
+    sensor_mgr_read_stats_update(sensor, start, rc);
+}
+#endif
 
-    /* Re-insert the sensor manager, with the new wakeup time. */
-    sensor_mgr_insert(sensor);
+/**
+ * Read a sensor on behalf of the sensor manager; all of its listeners are
+ * called.  Must be called with the sensor locked.
+ */
+static int
+sensor_mgr_read(struct sensor *sensor)
+{
+    /* Specify NULL as a callback, because we just want to run all the
+     * listeners.  Drivers that buffer samples are emptied in one batched
+     * read.
+     */
+    if (sensor->s_funcs->sd_read_batch != NULL) {
+        return (sensor_read_batch(sensor, sensor->s_mask, NULL, NULL,
+                                  OS_TIMEOUT_NEVER));
+    } else {
+        return (sensor_read(sensor, sensor->s_mask, NULL, NULL,
+                            OS_TIMEOUT_NEVER));
+    }
+}
 
-    /* Unlock the sensor to allow other access */
-    sensor_unlock(sensor);
+/**
+ * Lock a sensor for the sensor manager's events, without waiting.  These
+ * events can run on the task of the sensor's bus, while a task holding
+ * the lock waits for that bus task to run its transfer.
+ *
+ * @param The sensor to lock
+ *
+ * @return 0 on success, non-zero if the sensor is locked.
+ */
+static int
+sensor_mgr_sensor_trylock(struct sensor *sensor)
+{
+    int rc;
 
-    return (sensor_ticks);
-err:
-    /* Couldn't lock it.  Re-run task and spin until we get result. */
-    return (0);
+    rc = os_mutex_pend(&sensor->s_lock, 0);
+    if (rc == 0 || rc == OS_NOT_STARTED) {
+        return (0);
+    }
+    return (rc);
 }
 
 /**
- * Event that wakes up the sensor manager, this goes through the sensor
- * list and polls any active sensors.
+ * Poll event of a sensor; its callout fires at the sensor's deadline.
+ * Only the sensor is locked while it is read, so lookups through the
+ * sensor manager are not held up by slow reads.  The callout also retries
+ * data ready reads, as it is idle while data ready is enabled.
  *
- * @param OS event
+ * @param OS event, its argument is the sensor
  */
 static void
-sensor_mgr_wakeup_event(struct os_event *ev)
+sensor_mgr_poll_event(struct os_event *ev)
 {
-    struct sensor *cursor;
+    struct sensor *sensor;
     os_time_t now;
-    os_time_t task_next_wakeup;
-    os_time_t next_wakeup;
+    uint32_t missed;
+    uint32_t start;
     int rc;
 
-    now = os_time_get();
+    sensor = ev->ev_arg;
 
-    task_next_wakeup = SENSOR_MGR_WAKEUP_TICKS;
-
-    rc = sensor_mgr_lock();
+    rc = sensor_mgr_sensor_trylock(sensor);
     if (rc != 0) {
-        /* Schedule again in 1 tick, see if we can reacquire the lock */
-        task_next_wakeup = 1;
-        goto done;
+        /* Try again in 1 tick, see if we can acquire the lock */
+        os_callout_reset(&sensor->s_poll_callout, 1);
+        return;
     }
 
-    SLIST_FOREACH(cursor, &sensor_mgr.mgr_sensor_list, s_next) {
-        /* Sensors that are not periodic are inserted at the end of the sensor
-         * list.
-         */
-        if (cursor->s_next_run == OS_TIMEOUT_NEVER) {
-            break;
+    /* Polling was stopped while this event was queued, or a data ready
+     * read found the sensor locked.
+     */
+    if (sensor->s_poll_rate == 0) {
+        if (sensor->s_dr_enabled) {
+            sensor_mgr_data_ready(sensor);
         }
+        goto done;
+    }
 
-        /* List is sorted by what runs first.  If we reached the first element that
-         * doesn't run, break out.
-         */
-        if (OS_TIME_TICK_LT(now, cursor->s_next_run)) {
-            break;
-        }
+    now = os_time_get();
+    start = os_cputime_get32();
 
-        /* Sensor poll one completes the poll, updates the sensor's "next run,"
-         * and re-inserts it into the list.  It returns the next wakeup time in ticks
-         * from now ticks for this sensor.
-         */
-        next_wakeup = sensor_mgr_poll_one(cursor, now);
+    rc = sensor_mgr_read(sensor);
 
-        /* If the next wakeup time for this sensor is before the task's next
-         * scheduled wakeup, move that forward, so we can collect data from that
-         * sensor
-         */
-        if (task_next_wakeup > next_wakeup) {
-            task_next_wakeup = next_wakeup;
-        }
+#if MYNEWT_VAL(SENSOR_POLL_STATS)
+    sensor_mgr_poll_stats_update(sensor, now, start, rc);
+#else
+    (void)start;
+#endif
 
+    missed = sensor_mgr_next_deadline(sensor, now);
+#if MYNEWT_VAL(SENSOR_POLL_STATS)
+    sensor->s_poll_stats.sps_missed += missed;
+#else
+    (void)missed;
+#endif
+
+    /* The read took some time; aim at the deadline, not a delay from now. */
+    now = os_time_get();
+    if (OS_TIME_TICK_GT(sensor->s_next_run, now)) {
+        os_callout_reset(&sensor->s_poll_callout, sensor->s_next_run - now);
+    } else {
+        os_callout_reset(&sensor->s_poll_callout, 0);
     }
 
 done:
-    os_callout_reset(&sensor_mgr.mgr_wakeup_callout, task_next_wakeup);
+    sensor_unlock(sensor);
+}
+
+/**
+ * Data ready event of a sensor; queued by sensor_mgr_data_ready() when the
+ * device has new data.
+ *
+ * @param OS event, its argument is the sensor
+ */
+static void
+sensor_mgr_data_ready_event(struct os_event *ev)
+{
+    struct sensor *sensor;
+    uint32_t start;
+    int rc;
+
+    sensor = ev->ev_arg;
+
+    rc = sensor_mgr_sensor_trylock(sensor);
+    if (rc != 0) {
+        /* The device holds on to the data; try again in 1 tick */
+        os_callout_reset(&sensor->s_poll_callout, 1);
+        return;
+    }
+
+    /* Notification was disabled while this event was queued */
+    if (!sensor->s_dr_enabled) {
+        goto done;
+    }
+
+    start = os_cputime_get32();
+
+    rc = sensor_mgr_read(sensor);
+
+#if MYNEWT_VAL(SENSOR_POLL_STATS)
+    sensor_mgr_read_stats_update(sensor, start, rc);
+#else
+    (void)start;
+#endif
+
+done:
+    sensor_unlock(sensor);
+}
+
+/**
+ * Notify the sensor manager that a sensor has new data.  The sensor is
+ * read, and its listeners called, from the event queue polling it.  This
+ * can be called from interrupt context.
+ *
+ * @param The sensor
+ */
+void
+sensor_mgr_data_ready(struct sensor *sensor)
+{
+    /* Several notifications before the read collapse into one, as the
+     * event is only queued once.
+     */
+    os_eventq_put(sensor_mgr_poll_evq_get(sensor), &sensor->s_dr_event);
 }
 
 /**
@@ -328,6 +662,36 @@ sensor_mgr_evq_set(struct os_eventq *evq)
     sensor_mgr.mgr_eventq = evq;
 }
 
+#if MYNEWT_VAL(SENSOR_MGR_POLL_TASKS) > 0
+static void
+sensor_mgr_poll_task_handler(void *arg)
+{
+    struct os_eventq *evq;
+
+    evq = arg;
+    while (1) {
+        os_eventq_run(evq);
+    }
+}
+
+static void
+sensor_mgr_poll_tasks_init(void)
+{
+    int rc;
+    int i;
+
+    for (i = 0; i < SENSOR_MGR_POLL_TASKS; i++) {
+        os_eventq_init(&sensor_poll_evq[i]);
+        rc = os_task_init(&sensor_poll_task[i], "sensor_poll",
+                          sensor_mgr_poll_task_handler, &sensor_poll_evq[i],
+                          MYNEWT_VAL(SENSOR_MGR_POLL_TASK_PRIO) + i,
+                          OS_WAIT_FOREVER, sensor_poll_stack[i],
+                          SENSOR_MGR_POLL_STACK_SIZE);
+        SYSINIT_PANIC_ASSERT(rc == 0);
+    }
+}
+#endif
+
 static void
 sensor_mgr_init(void)
 {
@@ -340,12 +704,11 @@ sensor_mgr_init(void)
     sensor_mgr_evq_set(os_eventq_dflt_get());
 #endif
 
-    /**
-     * Initialize sensor polling callout and set it to fire on boot.
-     */
-    os_callout_init(&sensor_mgr.mgr_wakeup_callout, sensor_mgr_evq_get(),
-            sensor_mgr_wakeup_event, NULL);
-    os_callout_reset(&sensor_mgr.mgr_wakeup_callout, 0);
+#if MYNEWT_VAL(SENSOR_MGR_POLL_TASKS) > 0
+    sensor_mgr_poll_tasks_init();
+#endif
+
+    sensor_bus_init();
 
     /* Initialize sensor cputime update callout and set it to fire after an
      * hour, CPU time gets wrapped in 4295 seconds,
@@ -372,8 +735,8 @@ sensor_mgr_init(void)
  * in the sensor list.
  *
  * @warn This function MUST be locked by sensor_mgr_lock/unlock() if the goal is
- * to iterate through sensors (as opposed to just finding one.)  As the
- * "prev_cursor" may be resorted in the sensor list, in between calls.
+ * to iterate through sensors (as opposed to just finding one.)  As sensors
+ * may be registered in between calls.
  *
  * @param The comparison function to use against sensors in the list.
  * @param The argument to provide to that comparison function
@@ -631,6 +994,38 @@ err:
     return (rc);
 }
 
+size_t
+sensor_data_size(sensor_type_t type)
+{
+    switch (type) {
+    case SENSOR_TYPE_ACCELEROMETER:
+    case SENSOR_TYPE_LINEAR_ACCEL:
+    case SENSOR_TYPE_GRAVITY:
+        return sizeof(struct sensor_accel_data);
+    case SENSOR_TYPE_MAGNETIC_FIELD:
+        return sizeof(struct sensor_mag_data);
+    case SENSOR_TYPE_GYROSCOPE:
+        return sizeof(struct sensor_gyro_data);
+    case SENSOR_TYPE_ROTATION_VECTOR:
+        return sizeof(struct sensor_quat_data);
+    case SENSOR_TYPE_EULER:
+        return sizeof(struct sensor_euler_data);
+    case SENSOR_TYPE_LIGHT:
+        return sizeof(struct sensor_light_data);
+    case SENSOR_TYPE_TEMPERATURE:
+    case SENSOR_TYPE_AMBIENT_TEMPERATURE:
+        return sizeof(struct sensor_temp_data);
+    case SENSOR_TYPE_PRESSURE:
+        return sizeof(struct sensor_press_data);
+    case SENSOR_TYPE_RELATIVE_HUMIDITY:
+        return sizeof(struct sensor_humid_data);
+    case SENSOR_TYPE_COLOR:
+        return sizeof(struct sensor_color_data);
+    default:
+        return 0;
+    }
+}
+
 static int
 sensor_read_data_func(struct sensor *sensor, void *arg, void *data,
                       sensor_type_t type)
@@ -659,6 +1054,10 @@ sensor_up_timestamp(struct sensor *sensor)
 {
     uint32_t curr_ts_ticks;
     uint32_t ts;
+    os_sr_t sr;
+
+    /* Sensors may be read from several poll tasks at once */
+    OS_ENTER_CRITICAL(sr);
 
     curr_ts_ticks = os_cputime_get32();
 
@@ -678,6 +1077,7 @@ sensor_up_timestamp(struct sensor *sensor)
         (sensor_base_ts.st_ostv.tv_usec + ts)%1000000;
     sensor->s_sts.st_ostv.tv_usec = sensor_base_ts.st_ostv.tv_usec;
 
+    OS_EXIT_CRITICAL(sr);
 }
 
 /**
@@ -709,19 +1109,102 @@ sensor_read(struct sensor *sensor, sensor_type_t type,
 
     if (!sensor_mgr_match_bytype(sensor, (void *)&type)) {
         rc = SYS_ENOENT;
-        goto err;
+        goto done;
     }
 
     sensor_up_timestamp(sensor);
 
     rc = sensor->s_funcs->sd_read(sensor, type, sensor_read_data_func, &src,
                                   timeout);
+
+done:
+    sensor_unlock(sensor);
+err:
+    return (rc);
+}
+
+static int
+sensor_read_batch_func(struct sensor *sensor, void *arg,
+                       struct sensor_batch *sb)
+{
+    struct sensor_listener *listener;
+    struct sensor_read_batch_ctx *ctx;
+    int i;
+
+    /* Notify all listeners first; those without a batch handler get the
+     * samples one by one.
+     */
+    SLIST_FOREACH(listener, &sensor->s_listener_list, sl_next) {
+        if (!(listener->sl_sensor_type & sb->sb_type)) {
+            continue;
+        }
+
+        if (listener->sl_batch_func != NULL) {
+            listener->sl_batch_func(sensor, listener->sl_arg, sb);
+        } else {
+            for (i = 0; i < sb->sb_count; i++) {
+                listener->sl_func(sensor, listener->sl_arg,
+                                  SENSOR_BATCH_SAMPLE(sb, i), sb->sb_type);
+            }
+        }
+    }
+
+    /* Call batch function */
+    ctx = (struct sensor_read_batch_ctx *) arg;
+    if (ctx->user_func != NULL) {
+        return (ctx->user_func(sensor, ctx->user_arg, sb));
+    } else {
+        return (0);
+    }
+}
+
+/**
+ * Read all buffered samples from a sensor whose driver supports batched
+ * reads.  Listeners with a batch handler get each batch as a whole; the
+ * others are called for every sample.
+ *
+ * @param The sensor to read from
+ * @param The type(s) of sensor values to read
+ * @param The function to call with each batch, or NULL to only call
+ *        the listeners
+ * @param The argument to pass to the batch function
+ * @param Timeout before aborting sensor read
+ *
+ * @return 0 on success, SYS_ENOTSUP if the driver doesn't support batched
+ *         reads, other non-zero error code on failure.
+ */
+int
+sensor_read_batch(struct sensor *sensor, sensor_type_t type,
+        sensor_batch_func_t batch_func, void *arg, uint32_t timeout)
+{
+    struct sensor_read_batch_ctx src;
+    int rc;
+
+    if (sensor->s_funcs->sd_read_batch == NULL) {
+        rc = SYS_ENOTSUP;
+        goto err;
+    }
+
+    rc = sensor_lock(sensor);
     if (rc) {
         goto err;
     }
 
-    sensor_unlock(sensor);
+    src.user_func = batch_func;
+    src.user_arg = arg;
 
+    if (!sensor_mgr_match_bytype(sensor, (void *)&type)) {
+        rc = SYS_ENOENT;
+        goto done;
+    }
+
+    sensor_up_timestamp(sensor);
+
+    rc = sensor->s_funcs->sd_read_batch(sensor, type, sensor_read_batch_func,
+                                        &src, timeout);
+
+done:
+    sensor_unlock(sensor);
 err:
     return (rc);
 }
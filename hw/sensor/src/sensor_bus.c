@@ -0,0 +1,386 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+
+#include "defs/error.h"
+#include "os/os.h"
+#include "sysinit/sysinit.h"
+#include "hal/hal_i2c.h"
+#include "hal/hal_spi.h"
+#include "hal/hal_gpio.h"
+#include "sensor/sensor.h"
+#include "sensor/sensor_bus.h"
+
+#define SENSOR_BUS_I2C_NUM      MYNEWT_VAL(SENSOR_BUS_I2C_NUM)
+#define SENSOR_BUS_SPI_NUM      MYNEWT_VAL(SENSOR_BUS_SPI_NUM)
+#define SENSOR_BUS_NUM          (SENSOR_BUS_I2C_NUM + SENSOR_BUS_SPI_NUM)
+
+#if SENSOR_BUS_NUM > 0
+
+#define SENSOR_BUS_STACK_SIZE   \
+    OS_STACK_ALIGN(MYNEWT_VAL(SENSOR_BUS_STACK_SIZE))
+#define SENSOR_BUS_TIMEOUT      \
+    (MYNEWT_VAL(SENSOR_BUS_TIMEOUT_MS) * OS_TICKS_PER_SEC / 1000 + 1)
+
+struct sensor_bus {
+    struct os_eventq sb_evq;
+    struct os_task sb_task;
+    /* Register address and data of an I2C write go out in one transfer */
+    uint8_t sb_i2c_buf[MYNEWT_VAL(SENSOR_BUS_I2C_WRITE_MAX) + 1];
+};
+
+static struct sensor_bus sensor_buses[SENSOR_BUS_NUM];
+static os_stack_t sensor_bus_stacks[SENSOR_BUS_NUM][SENSOR_BUS_STACK_SIZE];
+
+/**
+ * Get the bus of a device; I2C buses come first, then SPI buses.
+ *
+ * @return The bus, or NULL if the bus is not managed.
+ */
+static struct sensor_bus *
+sensor_bus_get(struct sensor_itf *itf)
+{
+    switch (itf->si_type) {
+    case SENSOR_ITF_I2C:
+        if (itf->si_num < SENSOR_BUS_I2C_NUM) {
+            return (&sensor_buses[itf->si_num]);
+        }
+        break;
+    case SENSOR_ITF_SPI:
+        if (itf->si_num < SENSOR_BUS_SPI_NUM) {
+            return (&sensor_buses[SENSOR_BUS_I2C_NUM + itf->si_num]);
+        }
+        break;
+    }
+
+    return (NULL);
+}
+
+static int
+sensor_bus_i2c_xfer(struct sensor_bus *bus, struct sensor_bus_txn *txn)
+{
+    struct hal_i2c_master_data data;
+    struct sensor_itf *itf;
+    int rc;
+
+    itf = txn->sbt_itf;
+    data.address = itf->si_addr;
+
+    if (txn->sbt_flags & SENSOR_BUS_F_WRITE) {
+        if (!(txn->sbt_flags & SENSOR_BUS_F_REG)) {
+            data.buffer = txn->sbt_buf;
+            data.len = txn->sbt_len;
+        } else {
+            if (txn->sbt_len > MYNEWT_VAL(SENSOR_BUS_I2C_WRITE_MAX)) {
+                return (SYS_EINVAL);
+            }
+            bus->sb_i2c_buf[0] = txn->sbt_reg;
+            memcpy(&bus->sb_i2c_buf[1], txn->sbt_buf, txn->sbt_len);
+            data.buffer = bus->sb_i2c_buf;
+            data.len = txn->sbt_len + 1;
+        }
+        return (hal_i2c_master_write(itf->si_num, &data, SENSOR_BUS_TIMEOUT,
+                                     1));
+    }
+
+    if (txn->sbt_flags & SENSOR_BUS_F_REG) {
+        /* No stop condition; the read follows with a repeated start */
+        data.buffer = &txn->sbt_reg;
+        data.len = 1;
+        rc = hal_i2c_master_write(itf->si_num, &data, SENSOR_BUS_TIMEOUT, 0);
+        if (rc) {
+            return (rc);
+        }
+    }
+
+    data.buffer = txn->sbt_buf;
+    data.len = txn->sbt_len;
+    return (hal_i2c_master_read(itf->si_num, &data, SENSOR_BUS_TIMEOUT, 1));
+}
+
+static int
+sensor_bus_spi_xfer(struct sensor_bus_txn *txn)
+{
+    struct sensor_itf *itf;
+    uint16_t val;
+    int rc;
+    int i;
+
+    itf = txn->sbt_itf;
+
+    if (txn->sbt_spi_settings != NULL) {
+        hal_spi_disable(itf->si_num);
+        rc = hal_spi_config(itf->si_num, txn->sbt_spi_settings);
+        if (rc == EINVAL) {
+            return (SYS_EINVAL);
+        }
+        rc = hal_spi_enable(itf->si_num);
+        if (rc) {
+            return (rc);
+        }
+    }
+
+    rc = 0;
+
+    /* Select the device */
+    hal_gpio_write(itf->si_cs_pin, 0);
+
+    if (txn->sbt_flags & SENSOR_BUS_F_REG) {
+        if (hal_spi_tx_val(itf->si_num, txn->sbt_reg) == 0xFFFF) {
+            rc = SYS_EIO;
+            goto done;
+        }
+    }
+
+    for (i = 0; i < txn->sbt_len; i++) {
+        if (txn->sbt_flags & SENSOR_BUS_F_WRITE) {
+            val = hal_spi_tx_val(itf->si_num, txn->sbt_buf[i]);
+        } else {
+            val = hal_spi_tx_val(itf->si_num, 0);
+            txn->sbt_buf[i] = val;
+        }
+        if (val == 0xFFFF) {
+            rc = SYS_EIO;
+            goto done;
+        }
+    }
+
+done:
+    /* De-select the device */
+    hal_gpio_write(itf->si_cs_pin, 1);
+
+    return (rc);
+}
+
+static int
+sensor_bus_xfer(struct sensor_bus *bus, struct sensor_bus_txn *txn)
+{
+    if (txn->sbt_itf->si_type == SENSOR_ITF_I2C) {
+        return (sensor_bus_i2c_xfer(bus, txn));
+    } else {
+        return (sensor_bus_spi_xfer(txn));
+    }
+}
+
+/**
+ * Transaction event; runs on the bus task.
+ */
+static void
+sensor_bus_txn_event(struct os_event *ev)
+{
+    struct sensor_bus_txn *txn;
+    int rc;
+
+    txn = ev->ev_arg;
+
+    rc = sensor_bus_xfer(sensor_bus_get(txn->sbt_itf), txn);
+    if (txn->sbt_done != NULL) {
+        txn->sbt_done(txn, rc);
+    }
+}
+
+static void
+sensor_bus_task_handler(void *arg)
+{
+    struct sensor_bus *bus;
+
+    bus = arg;
+    while (1) {
+        os_eventq_run(&bus->sb_evq);
+    }
+}
+
+int
+sensor_bus_submit(struct sensor_bus_txn *txn)
+{
+    struct sensor_bus *bus;
+
+    bus = sensor_bus_get(txn->sbt_itf);
+    if (bus == NULL) {
+        return (SYS_EINVAL);
+    }
+
+    txn->sbt_ev.ev_cb = sensor_bus_txn_event;
+    txn->sbt_ev.ev_arg = txn;
+    os_eventq_put(&bus->sb_evq, &txn->sbt_ev);
+
+    return (0);
+}
+
+struct sensor_bus_wait {
+    struct os_sem sbw_sem;
+    int sbw_rc;
+};
+
+static void
+sensor_bus_wait_done(struct sensor_bus_txn *txn, int rc)
+{
+    struct sensor_bus_wait *wait;
+
+    wait = txn->sbt_arg;
+    wait->sbw_rc = rc;
+    os_sem_release(&wait->sbw_sem);
+}
+
+int
+sensor_bus_run(struct sensor_bus_txn *txn)
+{
+    struct sensor_bus_wait wait;
+    struct sensor_bus *bus;
+    int rc;
+
+    bus = sensor_bus_get(txn->sbt_itf);
+    if (bus == NULL) {
+        return (SYS_EINVAL);
+    }
+
+    /* Before the OS starts (sysinit, device config) nothing would run the
+     * bus task; on the bus task itself queueing would deadlock.
+     */
+    if (!os_started() || os_sched_get_current_task() == &bus->sb_task) {
+        return (sensor_bus_xfer(bus, txn));
+    }
+
+    rc = os_sem_init(&wait.sbw_sem, 0);
+    if (rc) {
+        return (rc);
+    }
+
+    txn->sbt_done = sensor_bus_wait_done;
+    txn->sbt_arg = &wait;
+
+    rc = sensor_bus_submit(txn);
+    if (rc) {
+        return (rc);
+    }
+
+    /* The transaction lives on this stack; it can't be abandoned while it
+     * is queued, and with the OS started this wait does not fail.
+     */
+    rc = os_sem_pend(&wait.sbw_sem, OS_TIMEOUT_NEVER);
+    assert(rc == OS_OK);
+
+    return (wait.sbw_rc);
+}
+
+int
+sensor_bus_read_reg(struct sensor_itf *itf, uint8_t reg, uint8_t *buf,
+        uint16_t len, struct hal_spi_settings *spi_settings)
+{
+    struct sensor_bus_txn txn = {
+        .sbt_itf = itf,
+        .sbt_flags = SENSOR_BUS_F_REG,
+        .sbt_reg = reg,
+        .sbt_len = len,
+        .sbt_buf = buf,
+        .sbt_spi_settings = spi_settings,
+    };
+
+    return (sensor_bus_run(&txn));
+}
+
+int
+sensor_bus_write_reg(struct sensor_itf *itf, uint8_t reg, uint8_t *buf,
+        uint16_t len, struct hal_spi_settings *spi_settings)
+{
+    struct sensor_bus_txn txn = {
+        .sbt_itf = itf,
+        .sbt_flags = SENSOR_BUS_F_REG | SENSOR_BUS_F_WRITE,
+        .sbt_reg = reg,
+        .sbt_len = len,
+        .sbt_buf = buf,
+        .sbt_spi_settings = spi_settings,
+    };
+
+    return (sensor_bus_run(&txn));
+}
+
+struct os_eventq *
+sensor_bus_evq_get(struct sensor_itf *itf)
+{
+    struct sensor_bus *bus;
+
+    bus = sensor_bus_get(itf);
+    if (bus == NULL) {
+        return (NULL);
+    }
+
+    return (&bus->sb_evq);
+}
+
+void
+sensor_bus_init(void)
+{
+    int rc;
+    int i;
+
+    for (i = 0; i < SENSOR_BUS_NUM; i++) {
+        os_eventq_init(&sensor_buses[i].sb_evq);
+        rc = os_task_init(&sensor_buses[i].sb_task, "sensor_bus",
+                          sensor_bus_task_handler, &sensor_buses[i],
+                          MYNEWT_VAL(SENSOR_BUS_TASK_PRIO) + i,
+                          OS_WAIT_FOREVER, sensor_bus_stacks[i],
+                          SENSOR_BUS_STACK_SIZE);
+        SYSINIT_PANIC_ASSERT(rc == 0);
+    }
+}
+
+#else
+
+int
+sensor_bus_submit(struct sensor_bus_txn *txn)
+{
+    return (SYS_EINVAL);
+}
+
+int
+sensor_bus_run(struct sensor_bus_txn *txn)
+{
+    return (SYS_EINVAL);
+}
+
+int
+sensor_bus_read_reg(struct sensor_itf *itf, uint8_t reg, uint8_t *buf,
+        uint16_t len, struct hal_spi_settings *spi_settings)
+{
+    return (SYS_EINVAL);
+}
+
+int
+sensor_bus_write_reg(struct sensor_itf *itf, uint8_t reg, uint8_t *buf,
+        uint16_t len, struct hal_spi_settings *spi_settings)
+{
+    return (SYS_EINVAL);
+}
+
+struct os_eventq *
+sensor_bus_evq_get(struct sensor_itf *itf)
+{
+    return (NULL);
+}
+
+void
+sensor_bus_init(void)
+{
+}
+
+#endif
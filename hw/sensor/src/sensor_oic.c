@@ -49,9 +49,59 @@
 
 static const char g_s_oic_dn[] = "x.mynewt.snsr.";
 
+#define SENSOR_OIC_OBS_VALS     (4)
+
+/* Samples younger than this are served without reading the sensor */
+#define SENSOR_OIC_OBS_FRESH    \
+    (MYNEWT_VAL(SENSOR_OIC_OBS_RATE) * OS_TICKS_PER_SEC / 1000)
+
+union sensor_oic_data {
+    struct sensor_accel_data sod_accel;
+    struct sensor_mag_data sod_mag;
+    struct sensor_gyro_data sod_gyro;
+    struct sensor_light_data sod_light;
+    struct sensor_temp_data sod_temp;
+    struct sensor_press_data sod_press;
+    struct sensor_humid_data sod_humid;
+    struct sensor_quat_data sod_quat;
+    struct sensor_euler_data sod_euler;
+    struct sensor_color_data sod_color;
+};
+
+/*
+ * Observe state of a sensor resource.  A listener keeps the newest sample
+ * of the sensor, so observers are notified from the sensor's own polls or
+ * data ready reads.  A notification is only sent when a value moved by
+ * more than the deadband, and no sooner than the minimum period after the
+ * previous one.
+ */
+struct sensor_oic_obs {
+    oc_resource_t *soo_res;
+    struct sensor *soo_sensor;
+    struct sensor_listener soo_listener;
+    struct os_event soo_notify_ev;
+
+    /* Newest sample; written by the listener */
+    union sensor_oic_data soo_data;
+    struct sensor_timestamp soo_sts;
+    os_time_t soo_data_time;
+    uint8_t soo_data_valid;
+
+    /* Values of the last notification */
+    uint8_t soo_sent_valid;
+    float soo_sent[SENSOR_OIC_OBS_VALS];
+    os_time_t soo_sent_time;
+
+    os_time_t soo_min_period;
+    float soo_deadband;
+};
+
+static struct sensor_oic_obs sensor_oic_obs[MYNEWT_VAL(SENSOR_OIC_OBS_MAX)];
+static int sensor_oic_obs_num;
+
 static int
-sensor_oic_encode(struct sensor* sensor, void *arg, void *databuf,
-                  sensor_type_t type)
+sensor_oic_encode_data(void *databuf, sensor_type_t type,
+                       struct sensor_timestamp *sts)
 {
 
     switch(type) {
@@ -60,19 +110,25 @@ sensor_oic_encode(struct sensor* sensor, void *arg, void *databuf,
 
             if (((struct sensor_gyro_data *)(databuf))->sgd_x_is_valid) {
                 oc_rep_set_double(root, x,
-                    ((struct sensor_gyro_data *)(databuf))->sgd_x);
+                    SENSOR_VAL_TO_FLOAT(
+                        ((struct sensor_gyro_data *)(databuf))->sgd_x,
+                        SENSOR_GYRO_Q));
             } else {
                 goto err;
             }
             if (((struct sensor_gyro_data *)(databuf))->sgd_y_is_valid) {
                 oc_rep_set_double(root, y,
-                    ((struct sensor_gyro_data *)(databuf))->sgd_y);
+                    SENSOR_VAL_TO_FLOAT(
+                        ((struct sensor_gyro_data *)(databuf))->sgd_y,
+                        SENSOR_GYRO_Q));
             } else {
                 goto err;
             }
             if (((struct sensor_gyro_data *)(databuf))->sgd_z_is_valid) {
                 oc_rep_set_double(root, z,
-                    ((struct sensor_gyro_data *)(databuf))->sgd_z);
+                    SENSOR_VAL_TO_FLOAT(
+                        ((struct sensor_gyro_data *)(databuf))->sgd_z,
+                        SENSOR_GYRO_Q));
             } else {
                 goto err;
             }
@@ -87,19 +143,25 @@ sensor_oic_encode(struct sensor* sensor, void *arg, void *databuf,
 
             if (((struct sensor_accel_data *)(databuf))->sad_x_is_valid) {
                 oc_rep_set_double(root, x,
-                    ((struct sensor_accel_data *)(databuf))->sad_x);
+                    SENSOR_VAL_TO_FLOAT(
+                        ((struct sensor_accel_data *)(databuf))->sad_x,
+                        SENSOR_ACCEL_Q));
             } else {
                 goto err;
             }
             if (((struct sensor_accel_data *)(databuf))->sad_y_is_valid) {
                 oc_rep_set_double(root, y,
-                    ((struct sensor_accel_data *)(databuf))->sad_y);
+                    SENSOR_VAL_TO_FLOAT(
+                        ((struct sensor_accel_data *)(databuf))->sad_y,
+                        SENSOR_ACCEL_Q));
             } else {
                 goto err;
             }
             if (((struct sensor_accel_data *)(databuf))->sad_z_is_valid) {
                 oc_rep_set_double(root, z,
-                    ((struct sensor_accel_data *)(databuf))->sad_z);
+                    SENSOR_VAL_TO_FLOAT(
+                        ((struct sensor_accel_data *)(databuf))->sad_z,
+                        SENSOR_ACCEL_Q));
             } else {
                 goto err;
             }
@@ -109,19 +171,25 @@ sensor_oic_encode(struct sensor* sensor, void *arg, void *databuf,
         case SENSOR_TYPE_MAGNETIC_FIELD:
             if (((struct sensor_mag_data *)(databuf))->smd_x_is_valid) {
                 oc_rep_set_double(root, x,
-                    ((struct sensor_mag_data *)(databuf))->smd_x);
+                    SENSOR_VAL_TO_FLOAT(
+                        ((struct sensor_mag_data *)(databuf))->smd_x,
+                        SENSOR_MAG_Q));
             } else {
                 goto err;
             }
             if (((struct sensor_mag_data *)(databuf))->smd_y_is_valid) {
                 oc_rep_set_double(root, y,
-                    ((struct sensor_mag_data *)(databuf))->smd_y);
+                    SENSOR_VAL_TO_FLOAT(
+                        ((struct sensor_mag_data *)(databuf))->smd_y,
+                        SENSOR_MAG_Q));
             } else {
                 goto err;
             }
             if (((struct sensor_mag_data *)(databuf))->smd_z_is_valid) {
                 oc_rep_set_double(root, z,
-                    ((struct sensor_mag_data *)(databuf))->smd_z);
+                    SENSOR_VAL_TO_FLOAT(
+                        ((struct sensor_mag_data *)(databuf))->smd_z,
+                        SENSOR_MAG_Q));
             } else {
                 goto err;
             }
@@ -184,25 +252,33 @@ sensor_oic_encode(struct sensor* sensor, void *arg, void *databuf,
         case SENSOR_TYPE_ROTATION_VECTOR:
             if (((struct sensor_quat_data *)(databuf))->sqd_x_is_valid) {
                 oc_rep_set_double(root, x,
-                    ((struct sensor_quat_data *)(databuf))->sqd_x);
+                    SENSOR_VAL_TO_FLOAT(
+                        ((struct sensor_quat_data *)(databuf))->sqd_x,
+                        SENSOR_QUAT_Q));
             } else {
                 goto err;
             }
             if (((struct sensor_quat_data *)(databuf))->sqd_y_is_valid) {
                 oc_rep_set_double(root, y,
-                    ((struct sensor_quat_data *)(databuf))->sqd_y);
+                    SENSOR_VAL_TO_FLOAT(
+                        ((struct sensor_quat_data *)(databuf))->sqd_y,
+                        SENSOR_QUAT_Q));
             } else {
                 goto err;
             }
             if (((struct sensor_quat_data *)(databuf))->sqd_z_is_valid) {
                 oc_rep_set_double(root, z,
-                    ((struct sensor_quat_data *)(databuf))->sqd_z);
+                    SENSOR_VAL_TO_FLOAT(
+                        ((struct sensor_quat_data *)(databuf))->sqd_z,
+                        SENSOR_QUAT_Q));
             } else {
                 goto err;
             }
             if (((struct sensor_quat_data *)(databuf))->sqd_w_is_valid) {
                 oc_rep_set_double(root, w,
-                    ((struct sensor_quat_data *)(databuf))->sqd_w);
+                    SENSOR_VAL_TO_FLOAT(
+                        ((struct sensor_quat_data *)(databuf))->sqd_w,
+                        SENSOR_QUAT_Q));
             } else {
                 goto err;
             }
@@ -212,19 +288,25 @@ sensor_oic_encode(struct sensor* sensor, void *arg, void *databuf,
         case SENSOR_TYPE_EULER:
             if (((struct sensor_euler_data *)(databuf))->sed_h_is_valid) {
                 oc_rep_set_double(root, h,
-                    ((struct sensor_euler_data *)(databuf))->sed_h);
+                    SENSOR_VAL_TO_FLOAT(
+                        ((struct sensor_euler_data *)(databuf))->sed_h,
+                        SENSOR_EULER_Q));
             } else {
                 goto err;
             }
             if (((struct sensor_euler_data *)(databuf))->sed_r_is_valid) {
                 oc_rep_set_double(root, r,
-                    ((struct sensor_euler_data *)(databuf))->sed_r);
+                    SENSOR_VAL_TO_FLOAT(
+                        ((struct sensor_euler_data *)(databuf))->sed_r,
+                        SENSOR_EULER_Q));
             } else {
                 goto err;
             }
             if (((struct sensor_euler_data *)(databuf))->sed_p_is_valid) {
                 oc_rep_set_double(root, p,
-                    ((struct sensor_euler_data *)(databuf))->sed_p);
+                    SENSOR_VAL_TO_FLOAT(
+                        ((struct sensor_euler_data *)(databuf))->sed_p,
+                        SENSOR_EULER_Q));
             } else {
                 goto err;
             }
@@ -329,15 +411,263 @@ sensor_oic_encode(struct sensor* sensor, void *arg, void *databuf,
             goto err;
     }
 
-    oc_rep_set_uint(root, ts_secs, (long int)sensor->s_sts.st_ostv.tv_sec);
-    oc_rep_set_int(root, ts_usecs, (int)sensor->s_sts.st_ostv.tv_usec);
-    oc_rep_set_uint(root, ts_cputime, (unsigned int)sensor->s_sts.st_cputime);
+    oc_rep_set_uint(root, ts_secs, (long int)sts->st_ostv.tv_sec);
+    oc_rep_set_int(root, ts_usecs, (int)sts->st_ostv.tv_usec);
+    oc_rep_set_uint(root, ts_cputime, (unsigned int)sts->st_cputime);
 
     return 0;
 err:
     return SYS_EINVAL;
 }
 
+static int
+sensor_oic_encode(struct sensor* sensor, void *arg, void *databuf,
+                  sensor_type_t type)
+{
+    return sensor_oic_encode_data(databuf, type, &sensor->s_sts);
+}
+
+/**
+ * Get the values of a sample that are compared against the deadband.
+ *
+ * @return The number of values
+ */
+static int
+sensor_oic_obs_vals(union sensor_oic_data *data, sensor_type_t type,
+                    float *vals)
+{
+    switch (type) {
+    case SENSOR_TYPE_ACCELEROMETER:
+    case SENSOR_TYPE_LINEAR_ACCEL:
+    case SENSOR_TYPE_GRAVITY:
+        vals[0] = SENSOR_VAL_TO_FLOAT(data->sod_accel.sad_x, SENSOR_ACCEL_Q);
+        vals[1] = SENSOR_VAL_TO_FLOAT(data->sod_accel.sad_y, SENSOR_ACCEL_Q);
+        vals[2] = SENSOR_VAL_TO_FLOAT(data->sod_accel.sad_z, SENSOR_ACCEL_Q);
+        return 3;
+    case SENSOR_TYPE_MAGNETIC_FIELD:
+        vals[0] = SENSOR_VAL_TO_FLOAT(data->sod_mag.smd_x, SENSOR_MAG_Q);
+        vals[1] = SENSOR_VAL_TO_FLOAT(data->sod_mag.smd_y, SENSOR_MAG_Q);
+        vals[2] = SENSOR_VAL_TO_FLOAT(data->sod_mag.smd_z, SENSOR_MAG_Q);
+        return 3;
+    case SENSOR_TYPE_GYROSCOPE:
+        vals[0] = SENSOR_VAL_TO_FLOAT(data->sod_gyro.sgd_x, SENSOR_GYRO_Q);
+        vals[1] = SENSOR_VAL_TO_FLOAT(data->sod_gyro.sgd_y, SENSOR_GYRO_Q);
+        vals[2] = SENSOR_VAL_TO_FLOAT(data->sod_gyro.sgd_z, SENSOR_GYRO_Q);
+        return 3;
+    case SENSOR_TYPE_ROTATION_VECTOR:
+        vals[0] = SENSOR_VAL_TO_FLOAT(data->sod_quat.sqd_x, SENSOR_QUAT_Q);
+        vals[1] = SENSOR_VAL_TO_FLOAT(data->sod_quat.sqd_y, SENSOR_QUAT_Q);
+        vals[2] = SENSOR_VAL_TO_FLOAT(data->sod_quat.sqd_z, SENSOR_QUAT_Q);
+        vals[3] = SENSOR_VAL_TO_FLOAT(data->sod_quat.sqd_w, SENSOR_QUAT_Q);
+        return 4;
+    case SENSOR_TYPE_EULER:
+        vals[0] = SENSOR_VAL_TO_FLOAT(data->sod_euler.sed_h, SENSOR_EULER_Q);
+        vals[1] = SENSOR_VAL_TO_FLOAT(data->sod_euler.sed_r, SENSOR_EULER_Q);
+        vals[2] = SENSOR_VAL_TO_FLOAT(data->sod_euler.sed_p, SENSOR_EULER_Q);
+        return 3;
+    case SENSOR_TYPE_LIGHT:
+        vals[0] = data->sod_light.sld_full;
+        vals[1] = data->sod_light.sld_ir;
+        vals[2] = data->sod_light.sld_lux;
+        return 3;
+    case SENSOR_TYPE_TEMPERATURE:
+    case SENSOR_TYPE_AMBIENT_TEMPERATURE:
+        vals[0] = data->sod_temp.std_temp;
+        return 1;
+    case SENSOR_TYPE_PRESSURE:
+        vals[0] = data->sod_press.spd_press;
+        return 1;
+    case SENSOR_TYPE_RELATIVE_HUMIDITY:
+        vals[0] = data->sod_humid.shd_humid;
+        return 1;
+    case SENSOR_TYPE_COLOR:
+        vals[0] = data->sod_color.scd_r;
+        vals[1] = data->sod_color.scd_g;
+        vals[2] = data->sod_color.scd_b;
+        vals[3] = data->sod_color.scd_lux;
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+static struct sensor_oic_obs *
+sensor_oic_obs_find(oc_resource_t *res)
+{
+    int i;
+
+    for (i = 0; i < sensor_oic_obs_num; i++) {
+        if (sensor_oic_obs[i].soo_res == res) {
+            return &sensor_oic_obs[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Keeps the newest sample of an observed resource.  Runs on the task that
+ * read the sensor.
+ */
+static int
+sensor_oic_obs_listener(struct sensor *sensor, void *arg, void *databuf,
+                        sensor_type_t type)
+{
+    struct sensor_oic_obs *obs;
+    os_sr_t sr;
+
+    obs = arg;
+
+    OS_ENTER_CRITICAL(sr);
+    memcpy(&obs->soo_data, databuf, sensor_data_size(type));
+    obs->soo_sts = sensor->s_sts;
+    obs->soo_data_time = os_time_get();
+    obs->soo_data_valid = 1;
+    OS_EXIT_CRITICAL(sr);
+
+    if (obs->soo_res->num_observers) {
+        os_eventq_put(oc_evq_get(), &obs->soo_notify_ev);
+    }
+
+    return 0;
+}
+
+static void
+sensor_oic_obs_notify_event(struct os_event *ev)
+{
+    struct sensor_oic_obs *obs;
+
+    obs = ev->ev_arg;
+
+    oc_notify_observers(obs->soo_res);
+}
+
+/**
+ * Take a copy of the newest sample, if it is fresh enough to be served
+ * without reading the sensor.
+ *
+ * @return 1 if the sample was copied, 0 if the sensor needs reading
+ */
+static int
+sensor_oic_obs_snapshot(struct sensor_oic_obs *obs,
+                        union sensor_oic_data *data,
+                        struct sensor_timestamp *sts)
+{
+    os_sr_t sr;
+    int fresh;
+
+    OS_ENTER_CRITICAL(sr);
+    fresh = obs->soo_data_valid &&
+            (os_time_t)(os_time_get() - obs->soo_data_time) <
+            SENSOR_OIC_OBS_FRESH;
+    if (fresh) {
+        *data = obs->soo_data;
+        *sts = obs->soo_sts;
+    }
+    OS_EXIT_CRITICAL(sr);
+
+    return fresh;
+}
+
+/**
+ * Check a sample against the last notification, and record it as sent if
+ * it is to be sent.
+ *
+ * @return 1 if observers are to be notified of the sample, 0 if not
+ */
+static int
+sensor_oic_obs_due(struct sensor_oic_obs *obs, union sensor_oic_data *data)
+{
+    float vals[SENSOR_OIC_OBS_VALS];
+    os_time_t now;
+    float diff;
+    int changed;
+    int num;
+    int i;
+
+    num = sensor_oic_obs_vals(data, obs->soo_listener.sl_sensor_type, vals);
+    now = os_time_get();
+
+    if (obs->soo_sent_valid) {
+        if ((os_time_t)(now - obs->soo_sent_time) < obs->soo_min_period) {
+            return 0;
+        }
+
+        changed = 0;
+        for (i = 0; i < num; i++) {
+            diff = vals[i] - obs->soo_sent[i];
+            if (diff > obs->soo_deadband || -diff > obs->soo_deadband) {
+                changed = 1;
+                break;
+            }
+        }
+        if (!changed) {
+            return 0;
+        }
+    }
+
+    memcpy(obs->soo_sent, vals, num * sizeof(vals[0]));
+    obs->soo_sent_time = now;
+    obs->soo_sent_valid = 1;
+
+    return 1;
+}
+
+static void
+sensor_oic_obs_add(oc_resource_t *res, struct sensor *sensor,
+                   sensor_type_t type)
+{
+    struct sensor_oic_obs *obs;
+    int rc;
+
+    if (sensor_oic_obs_num >= MYNEWT_VAL(SENSOR_OIC_OBS_MAX)) {
+        /* Observers get a notification every observation period */
+        return;
+    }
+
+    obs = &sensor_oic_obs[sensor_oic_obs_num];
+    memset(obs, 0, sizeof(*obs));
+
+    obs->soo_res = res;
+    obs->soo_sensor = sensor;
+    obs->soo_notify_ev.ev_cb = sensor_oic_obs_notify_event;
+    obs->soo_notify_ev.ev_arg = obs;
+    obs->soo_min_period = MYNEWT_VAL(SENSOR_OIC_OBS_MIN_PERIOD_MS) *
+                          OS_TICKS_PER_SEC / 1000;
+    obs->soo_deadband = MYNEWT_VAL(SENSOR_OIC_OBS_DEADBAND);
+
+    obs->soo_listener.sl_sensor_type = type;
+    obs->soo_listener.sl_func = sensor_oic_obs_listener;
+    obs->soo_listener.sl_arg = obs;
+
+    rc = sensor_register_listener(sensor, &obs->soo_listener);
+    if (rc) {
+        return;
+    }
+
+    sensor_oic_obs_num++;
+}
+
+int
+sensor_oic_set_obs_threshold(struct sensor *sensor, sensor_type_t type,
+                             uint32_t min_period_ms, float deadband)
+{
+    struct sensor_oic_obs *obs;
+    int i;
+
+    for (i = 0; i < sensor_oic_obs_num; i++) {
+        obs = &sensor_oic_obs[i];
+        if (obs->soo_sensor == sensor &&
+            obs->soo_listener.sl_sensor_type == type) {
+            obs->soo_min_period = min_period_ms * OS_TICKS_PER_SEC / 1000;
+            obs->soo_deadband = deadband;
+            return 0;
+        }
+    }
+
+    return SYS_ENOENT;
+}
+
 static int
 sensor_typename_to_type(char *typename, sensor_type_t *type,
                         struct sensor *sensor)
@@ -533,9 +863,15 @@ sensor_oic_get_data(oc_request_t *request, oc_interface_mask_t interface)
     char *devname;
     char *typename;
     sensor_type_t type;
+    struct sensor_oic_obs *obs;
+    union sensor_oic_data data;
+    struct sensor_timestamp sts;
+    int cached;
     char tmpstr[COAP_MAX_URI] = {0};
     const char s[2] = "/";
 
+    memset(&listener, 0, sizeof(listener));
+
     memcpy(tmpstr, (char *)&(request->resource->uri.os_str[1]),
            request->resource->uri.os_sz - 1);
 
@@ -556,15 +892,36 @@ sensor_oic_get_data(oc_request_t *request, oc_interface_mask_t interface)
         goto err;
     }
 
+    obs = sensor_oic_obs_find(request->resource);
+    cached = obs != NULL && sensor_oic_obs_snapshot(obs, &data, &sts);
+
+    /* A notification to observers has no request packet */
+    if (obs != NULL && request->packet == NULL) {
+        if (!cached) {
+            /* Sensor is not polled; read it, the listener keeps the sample */
+            rc = sensor_read(sensor, obs->soo_listener.sl_sensor_type, NULL,
+                             NULL, OS_TIMEOUT_NEVER);
+            if (rc) {
+                goto err;
+            }
+            cached = sensor_oic_obs_snapshot(obs, &data, &sts);
+            if (!cached) {
+                goto err;
+            }
+        }
+
+        if (!sensor_oic_obs_due(obs, &data)) {
+            oc_ignore_request(request);
+            return;
+        }
+    }
+
     oc_rep_start_root_object();
 
     switch (interface) {
     case OC_IF_BASELINE:
         oc_process_baseline_interface(request->resource);
     case OC_IF_R:
-        /* Register a listener and then trigger/read a bunch of samples */
-        memset(&listener, 0, sizeof(listener));
-
         typename =
             &(request->resource->types.oa_arr.s[sizeof(g_s_oic_dn) - 1]);
         rc = sensor_typename_to_type(typename, &type, sensor);
@@ -573,11 +930,22 @@ sensor_oic_get_data(oc_request_t *request, oc_interface_mask_t interface)
             goto err;
         }
 
+        if (cached) {
+            /* Recent sample from a poll; no need to read the sensor */
+            rc = sensor_oic_encode_data(&data, type, &sts);
+            if (rc) {
+                goto err;
+            }
+            break;
+        }
+
+        /* Register a listener and then trigger/read a bunch of samples */
         listener.sl_sensor_type = type;
         listener.sl_func = sensor_oic_encode;
 
         rc = sensor_register_listener(sensor, &listener);
         if (rc) {
+            listener.sl_func = NULL;
             goto err;
         }
 
@@ -596,12 +964,16 @@ sensor_oic_get_data(oc_request_t *request, oc_interface_mask_t interface)
         break;
     }
 
-    sensor_unregister_listener(sensor, &listener);
+    if (listener.sl_func != NULL) {
+        sensor_unregister_listener(sensor, &listener);
+    }
     oc_rep_end_root_object();
     oc_send_response(request, OC_STATUS_OK);
     return;
 err:
-    sensor_unregister_listener(sensor, &listener);
+    if (listener.sl_func != NULL) {
+        sensor_unregister_listener(sensor, &listener);
+    }
     oc_send_response(request, OC_STATUS_NOT_FOUND);
 }
 
@@ -659,6 +1031,8 @@ sensor_oic_init(void)
                 oc_resource_set_request_handler(res, OC_GET,
                                                 sensor_oic_get_data);
                 oc_add_resource(res);
+
+                sensor_oic_obs_add(res, sensor, type);
             }
             i++;
         }
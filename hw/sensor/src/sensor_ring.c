@@ -0,0 +1,200 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+#include <assert.h>
+
+#include "defs/error.h"
+#include "os/os.h"
+#include "sensor/sensor.h"
+#include "sensor/sensor_ring.h"
+
+/*
+ * Orders the accesses to an entry against its sequence number.  Readers
+ * and the writer only run on the same core, so keeping the compiler from
+ * reordering them is enough.
+ */
+#define SENSOR_RING_BARRIER()   __asm__ volatile("" ::: "memory")
+
+static struct sensor_ring_entry *
+sensor_ring_entry_get(struct sensor_ring *ring, uint32_t seq)
+{
+    return ((struct sensor_ring_entry *)
+            (ring->sr_buf + (seq & (ring->sr_num - 1)) * ring->sr_entry_size));
+}
+
+/**
+ * Adds a sample to the ring.  Called by the sensor read, with the sensor
+ * locked, so there is only ever one writer.
+ */
+static int
+sensor_ring_listener(struct sensor *sensor, void *arg, void *data,
+                     sensor_type_t type)
+{
+    struct sensor_ring_entry *entry;
+    struct sensor_ring *ring;
+    size_t size;
+    uint32_t seq;
+
+    ring = arg;
+
+    size = sensor_data_size(type);
+    if (size == 0 || size > ring->sr_data_size) {
+        return (SYS_EINVAL);
+    }
+
+    seq = ring->sr_seq + 1;
+    if (seq == 0) {
+        /* 0 means no sample */
+        seq = 1;
+    }
+
+    entry = sensor_ring_entry_get(ring, seq);
+
+    entry->sre_seq = seq;
+    SENSOR_RING_BARRIER();
+
+    entry->sre_type = type;
+    entry->sre_sts = sensor->s_sts;
+    memcpy(entry + 1, data, size);
+
+    SENSOR_RING_BARRIER();
+    ring->sr_seq = seq;
+
+    return (0);
+}
+
+int
+sensor_ring_init(struct sensor_ring *ring, struct sensor *sensor,
+                 sensor_type_t type, void *buf, uint16_t data_size,
+                 uint16_t num)
+{
+    if (num == 0 || (num & (num - 1)) != 0 ||
+        ((uintptr_t)buf & (SENSOR_RING_ALIGN - 1)) != 0) {
+        return (SYS_EINVAL);
+    }
+
+    memset(ring, 0, sizeof(*ring));
+    memset(buf, 0, SENSOR_RING_BUF_SIZE(data_size, num));
+
+    ring->sr_sensor = sensor;
+    ring->sr_buf = buf;
+    ring->sr_entry_size = SENSOR_RING_ENTRY_SIZE(data_size);
+    ring->sr_data_size = data_size;
+    ring->sr_num = num;
+
+    ring->sr_listener.sl_sensor_type = type;
+    ring->sr_listener.sl_func = sensor_ring_listener;
+    ring->sr_listener.sl_arg = ring;
+
+    return (sensor_register_listener(sensor, &ring->sr_listener));
+}
+
+int
+sensor_ring_stop(struct sensor_ring *ring)
+{
+    return (sensor_unregister_listener(ring->sr_sensor, &ring->sr_listener));
+}
+
+uint32_t
+sensor_ring_oldest_seq(struct sensor_ring *ring)
+{
+    uint32_t oldest;
+    uint32_t seq;
+
+    seq = ring->sr_seq;
+    if (seq == 0) {
+        return (0);
+    }
+
+    oldest = seq - ring->sr_num + 1;
+    if (seq < ring->sr_num) {
+        /* Samples before 1 are only there once the sequence numbers have
+         * wrapped; they skip 0, so one fewer of them is left.
+         */
+        if (oldest == 0 ||
+            sensor_ring_entry_get(ring, oldest)->sre_seq != oldest) {
+            return (1);
+        }
+    }
+
+    return (oldest);
+}
+
+int
+sensor_ring_read(struct sensor_ring *ring, uint32_t seq, void *data,
+                 sensor_type_t *type, struct sensor_timestamp *sts)
+{
+    struct sensor_ring_entry *entry;
+    struct sensor_timestamp entry_sts;
+    sensor_type_t entry_type;
+
+    if (seq == 0 || ring->sr_seq == 0 || (int32_t)(seq - ring->sr_seq) > 0) {
+        return (SYS_EAGAIN);
+    }
+    SENSOR_RING_BARRIER();
+
+    entry = sensor_ring_entry_get(ring, seq);
+    if (entry->sre_seq != seq) {
+        return (SYS_ENOENT);
+    }
+    SENSOR_RING_BARRIER();
+
+    entry_type = entry->sre_type;
+    entry_sts = entry->sre_sts;
+    memcpy(data, entry + 1, ring->sr_data_size);
+
+    /* The writer may have reused the entry while it was copied */
+    SENSOR_RING_BARRIER();
+    if (entry->sre_seq != seq) {
+        return (SYS_ENOENT);
+    }
+
+    if (type != NULL) {
+        *type = entry_type;
+    }
+    if (sts != NULL) {
+        *sts = entry_sts;
+    }
+
+    return (0);
+}
+
+int
+sensor_ring_read_latest(struct sensor_ring *ring, uint32_t *seq, void *data,
+                        sensor_type_t *type, struct sensor_timestamp *sts)
+{
+    uint32_t latest;
+    int rc;
+
+    /* Only fails if the writer overtook the copy; then there is a newer
+     * sample to read.
+     */
+    do {
+        latest = ring->sr_seq;
+        if (latest == 0) {
+            return (SYS_ENOENT);
+        }
+        rc = sensor_ring_read(ring, latest, data, type, sts);
+    } while (rc != 0);
+
+    *seq = latest;
+
+    return (0);
+}
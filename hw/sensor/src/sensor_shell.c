@@ -79,6 +79,14 @@ sensor_display_help(void)
     console_printf("      at <poll_interval> rate for <poll_duration>\n");
     console_printf("  type <sensor_name>\n");
     console_printf("      types supported by registered sensor\n");
+    console_printf("  bench [-n nsamples]\n");
+    console_printf("      per-sample cost of converting and formatting sensor values\n");
+    console_printf("  notify <sensor_name> <on|off>\n");
+    console_printf("      read sensor whenever it signals new data, instead of polling\n");
+#if MYNEWT_VAL(SENSOR_POLL_STATS)
+    console_printf("  stats <sensor_name> [-c]\n");
+    console_printf("      polling statistics of sensor, -c clears them\n");
+#endif
 }
 
 static void
@@ -204,6 +212,69 @@ err:
     return rc;
 }
 
+static int
+sensor_cmd_notify(char **argv)
+{
+    struct sensor *sensor;
+    int rc;
+
+    sensor = sensor_mgr_find_next_bydevname(argv[2], NULL);
+    if (!sensor) {
+        console_printf("Sensor %s not found!\n", argv[2]);
+        return SYS_EINVAL;
+    }
+
+    rc = sensor_set_data_ready(sensor, !strcmp(argv[3], "on"));
+    if (rc == SYS_ENOTSUP) {
+        console_printf("Sensor %s can't signal new data\n", argv[2]);
+    }
+
+    return rc;
+}
+
+#if MYNEWT_VAL(SENSOR_POLL_STATS)
+static int
+sensor_cmd_display_stats(int argc, char **argv)
+{
+    struct sensor_poll_stats sps;
+    struct sensor *sensor;
+    uint32_t polls;
+    int clear;
+    int rc;
+
+    sensor = sensor_mgr_find_next_bydevname(argv[2], NULL);
+    if (!sensor) {
+        console_printf("Sensor %s not found!\n", argv[2]);
+        return SYS_EINVAL;
+    }
+
+    clear = argc > 3 && !strcmp(argv[3], "-c");
+    rc = sensor_get_poll_stats(sensor, &sps, clear);
+    if (rc) {
+        return rc;
+    }
+
+    polls = sps.sps_polls ? sps.sps_polls : 1;
+    console_printf("sensor dev = %s, poll rate = %lu ms\n", argv[2],
+                   (unsigned long)sensor->s_poll_rate);
+    console_printf("polls: %lu errors: %lu missed deadlines: %lu\n",
+                   (unsigned long)sps.sps_polls,
+                   (unsigned long)sps.sps_errors,
+                   (unsigned long)sps.sps_missed);
+    console_printf("latency (us): avg %lu max %lu\n",
+                   (unsigned long)(sps.sps_lat_total / polls),
+                   (unsigned long)sps.sps_lat_max);
+    console_printf("jitter (us): avg %lu max %lu\n",
+                   (unsigned long)(sps.sps_jitter_total / polls),
+                   (unsigned long)sps.sps_jitter_max);
+    console_printf("read time (us): avg %lu max %lu\n",
+                   (unsigned long)(sps.sps_read_total / polls),
+                   (unsigned long)sps.sps_read_max);
+
+    return 0;
+}
+#endif
+
 static void
 sensor_cmd_list_sensors(void)
 {
@@ -235,6 +306,83 @@ sensor_ftostr(float num, char *fltstr, int len)
     return fltstr;
 }
 
+char *
+sensor_vtostr(sensor_val_t val, int q, char *str, int len)
+{
+#if MYNEWT_VAL(SENSOR_FIXED_POINT)
+    uint32_t mag;
+    uint32_t frac;
+
+    mag = val < 0 ? -(uint32_t)val : (uint32_t)val;
+    frac = ((uint64_t)(mag & ((1UL << q) - 1)) * 1000000) >> q;
+
+    memset(str, 0, len);
+
+    snprintf(str, len, "%s%lu.%06lu", val < 0 ? "-" : "",
+             (unsigned long)(mag >> q), (unsigned long)frac);
+    return str;
+#else
+    return sensor_ftostr(val, str, len);
+#endif
+}
+
+/**
+ * Measures the per-sample cost of the sensor value path: converting a raw
+ * acceleration sample the way drivers do, and formatting it.  Build with
+ * and without SENSOR_FIXED_POINT to compare.
+ */
+static int
+sensor_cmd_bench(int argc, char **argv)
+{
+    volatile sensor_val_t sink;
+    sensor_val_t val;
+    char tmpstr[16];
+    uint32_t conv_usecs;
+    uint32_t fmt_usecs;
+    uint32_t start;
+    long long n;
+    int16_t raw;
+    int rc;
+    int i;
+
+    n = 1000;
+    if (argc > 3 && !strcmp(argv[2], "-n")) {
+        n = parse_ll_bounds(argv[3], 1, 1000000, &rc);
+        if (rc) {
+            console_printf("Invalid sample count %s\n", argv[3]);
+            return rc;
+        }
+    }
+
+    start = os_cputime_get32();
+    for (i = 0; i < n; i++) {
+        raw = (int16_t)(i * 37 - 16000);
+        sink = SENSOR_VAL_SCALE(raw, STANDARD_ACCEL_GRAVITY / 1000,
+                                SENSOR_ACCEL_Q);
+    }
+    conv_usecs = os_cputime_ticks_to_usecs(os_cputime_get32() - start);
+
+    start = os_cputime_get32();
+    for (i = 0; i < n; i++) {
+        raw = (int16_t)(i * 37 - 16000);
+        val = SENSOR_VAL_SCALE(raw, STANDARD_ACCEL_GRAVITY / 1000,
+                               SENSOR_ACCEL_Q);
+        sensor_vtostr(val, SENSOR_ACCEL_Q, tmpstr, sizeof(tmpstr));
+    }
+    fmt_usecs = os_cputime_ticks_to_usecs(os_cputime_get32() - start);
+    (void)sink;
+
+    console_printf("%s point, %lu samples\n",
+                   MYNEWT_VAL(SENSOR_FIXED_POINT) ? "fixed" : "floating",
+                   (unsigned long)n);
+    console_printf("convert: %lu ns/sample\n",
+                   (unsigned long)((uint64_t)conv_usecs * 1000 / n));
+    console_printf("convert and format: %lu ns/sample\n",
+                   (unsigned long)((uint64_t)fmt_usecs * 1000 / n));
+
+    return 0;
+}
+
 static int
 sensor_shell_read_listener(struct sensor *sensor, void *arg, void *data,
                            sensor_type_t type)
@@ -267,13 +415,13 @@ sensor_shell_read_listener(struct sensor *sensor, void *arg, void *data,
 
         sad = (struct sensor_accel_data *) data;
         if (sad->sad_x_is_valid) {
-            console_printf("x = %s ", sensor_ftostr(sad->sad_x, tmpstr, 13));
+            console_printf("x = %s ", sensor_vtostr(sad->sad_x, SENSOR_ACCEL_Q, tmpstr, 13));
         }
         if (sad->sad_y_is_valid) {
-            console_printf("y = %s ", sensor_ftostr(sad->sad_y, tmpstr, 13));
+            console_printf("y = %s ", sensor_vtostr(sad->sad_y, SENSOR_ACCEL_Q, tmpstr, 13));
         }
         if (sad->sad_z_is_valid) {
-            console_printf("z = %s", sensor_ftostr(sad->sad_z, tmpstr, 13));
+            console_printf("z = %s", sensor_vtostr(sad->sad_z, SENSOR_ACCEL_Q, tmpstr, 13));
         }
         console_printf("\n");
     }
@@ -281,13 +429,13 @@ sensor_shell_read_listener(struct sensor *sensor, void *arg, void *data,
     if (type == SENSOR_TYPE_MAGNETIC_FIELD) {
         smd = (struct sensor_mag_data *) data;
         if (smd->smd_x_is_valid) {
-            console_printf("x = %s ", sensor_ftostr(smd->smd_x, tmpstr, 13));
+            console_printf("x = %s ", sensor_vtostr(smd->smd_x, SENSOR_MAG_Q, tmpstr, 13));
         }
         if (smd->smd_y_is_valid) {
-            console_printf("y = %s ", sensor_ftostr(smd->smd_y, tmpstr, 13));
+            console_printf("y = %s ", sensor_vtostr(smd->smd_y, SENSOR_MAG_Q, tmpstr, 13));
         }
         if (smd->smd_z_is_valid) {
-            console_printf("z = %s ", sensor_ftostr(smd->smd_z, tmpstr, 13));
+            console_printf("z = %s ", sensor_vtostr(smd->smd_z, SENSOR_MAG_Q, tmpstr, 13));
         }
         console_printf("\n");
     }
@@ -295,13 +443,13 @@ sensor_shell_read_listener(struct sensor *sensor, void *arg, void *data,
     if (type == SENSOR_TYPE_GYROSCOPE) {
         sgd = (struct sensor_gyro_data *) data;
         if (sgd->sgd_x_is_valid) {
-            console_printf("x = %s ", sensor_ftostr(sgd->sgd_x, tmpstr, 13));
+            console_printf("x = %s ", sensor_vtostr(sgd->sgd_x, SENSOR_GYRO_Q, tmpstr, 13));
         }
         if (sgd->sgd_y_is_valid) {
-            console_printf("y = %s ", sensor_ftostr(sgd->sgd_y, tmpstr, 13));
+            console_printf("y = %s ", sensor_vtostr(sgd->sgd_y, SENSOR_GYRO_Q, tmpstr, 13));
         }
         if (sgd->sgd_z_is_valid) {
-            console_printf("z = %s ", sensor_ftostr(sgd->sgd_z, tmpstr, 13));
+            console_printf("z = %s ", sensor_vtostr(sgd->sgd_z, SENSOR_GYRO_Q, tmpstr, 13));
         }
         console_printf("\n");
     }
@@ -333,13 +481,13 @@ sensor_shell_read_listener(struct sensor *sensor, void *arg, void *data,
     if (type == SENSOR_TYPE_EULER) {
         sed = (struct sensor_euler_data *) data;
         if (sed->sed_h_is_valid) {
-            console_printf("h = %s", sensor_ftostr(sed->sed_h, tmpstr, 13));
+            console_printf("h = %s", sensor_vtostr(sed->sed_h, SENSOR_EULER_Q, tmpstr, 13));
         }
         if (sed->sed_r_is_valid) {
-            console_printf("r = %s", sensor_ftostr(sed->sed_r, tmpstr, 13));
+            console_printf("r = %s", sensor_vtostr(sed->sed_r, SENSOR_EULER_Q, tmpstr, 13));
         }
         if (sed->sed_p_is_valid) {
-            console_printf("p = %s", sensor_ftostr(sed->sed_p, tmpstr, 13));
+            console_printf("p = %s", sensor_vtostr(sed->sed_p, SENSOR_EULER_Q, tmpstr, 13));
         }
         console_printf("\n");
     }
@@ -347,16 +495,16 @@ sensor_shell_read_listener(struct sensor *sensor, void *arg, void *data,
     if (type == SENSOR_TYPE_ROTATION_VECTOR) {
         sqd = (struct sensor_quat_data *) data;
         if (sqd->sqd_x_is_valid) {
-            console_printf("x = %s ", sensor_ftostr(sqd->sqd_x, tmpstr, 13));
+            console_printf("x = %s ", sensor_vtostr(sqd->sqd_x, SENSOR_QUAT_Q, tmpstr, 13));
         }
         if (sqd->sqd_y_is_valid) {
-            console_printf("y = %s ", sensor_ftostr(sqd->sqd_y, tmpstr, 13));
+            console_printf("y = %s ", sensor_vtostr(sqd->sqd_y, SENSOR_QUAT_Q, tmpstr, 13));
         }
         if (sqd->sqd_z_is_valid) {
-            console_printf("z = %s ", sensor_ftostr(sqd->sqd_z, tmpstr, 13));
+            console_printf("z = %s ", sensor_vtostr(sqd->sqd_z, SENSOR_QUAT_Q, tmpstr, 13));
         }
         if (sqd->sqd_w_is_valid) {
-            console_printf("w = %s ", sensor_ftostr(sqd->sqd_w, tmpstr, 13));
+            console_printf("w = %s ", sensor_vtostr(sqd->sqd_w, SENSOR_QUAT_Q, tmpstr, 13));
         }
         console_printf("\n");
     }
@@ -538,6 +686,7 @@ sensor_cmd_read(char *name, sensor_type_t type, struct sensor_poll_data *spd)
         return rc;
     }
 
+    memset(&listener, 0, sizeof(listener));
     listener.sl_sensor_type = type;
     listener.sl_func = sensor_shell_read_listener;
     listener.sl_arg = &ctx;
@@ -647,6 +796,33 @@ sensor_cmd_exec(int argc, char **argv)
         if (rc) {
             goto err;
         }
+    } else if (!strcmp(argv[1], "bench")) {
+        rc = sensor_cmd_bench(argc, argv);
+        if (rc) {
+            goto err;
+        }
+    } else if (!strcmp(argv[1], "notify")) {
+        if (argc < 4) {
+            console_printf("Usage: sensor notify <sensor_name> <on|off>\n");
+            rc = SYS_EINVAL;
+            goto err;
+        }
+        rc = sensor_cmd_notify(argv);
+        if (rc) {
+            goto err;
+        }
+#if MYNEWT_VAL(SENSOR_POLL_STATS)
+    } else if (!strcmp(argv[1], "stats")) {
+        if (argc < 3) {
+            console_printf("Usage: sensor stats <sensor_name> [-c]\n");
+            rc = SYS_EINVAL;
+            goto err;
+        }
+        rc = sensor_cmd_display_stats(argc, argv);
+        if (rc) {
+            goto err;
+        }
+#endif
     } else {
         console_printf("Unknown sensor command %s\n", subcmd);
         rc = SYS_EINVAL;
@@ -0,0 +1,188 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "sysinit/sysinit.h"
+#include "hal/hal_i2c.h"
+#include "hal/hal_spi.h"
+#include "sensor_test.h"
+
+/*
+ * The simulator has no I2C or SPI; the managed I2C bus reads back
+ * SENSOR_TEST_BUS_VAL, and the SPI buses fail.
+ */
+int
+hal_i2c_master_write(uint8_t i2c_num, struct hal_i2c_master_data *pdata,
+                     uint32_t timeout, uint8_t last_op)
+{
+    return (0);
+}
+
+int
+hal_i2c_master_read(uint8_t i2c_num, struct hal_i2c_master_data *pdata,
+                    uint32_t timeout, uint8_t last_op)
+{
+    memset(pdata->buffer, SENSOR_TEST_BUS_VAL, pdata->len);
+
+    return (0);
+}
+
+int
+hal_spi_config(int spi_num, struct hal_spi_settings *psettings)
+{
+    return (SYS_EINVAL);
+}
+
+int
+hal_spi_enable(int spi_num)
+{
+    return (SYS_EINVAL);
+}
+
+int
+hal_spi_disable(int spi_num)
+{
+    return (SYS_EINVAL);
+}
+
+uint16_t
+hal_spi_tx_val(int spi_num, uint16_t val)
+{
+    return (0xFFFF);
+}
+
+/* A stub accelerometer; every read produces one sample */
+static struct os_dev sensor_test_dev;
+struct sensor sensor_test_sensor;
+static int sensor_test_val;
+
+static int
+sensor_test_sensor_read(struct sensor *sensor, sensor_type_t type,
+        sensor_data_func_t data_func, void *data_arg, uint32_t timeout)
+{
+    struct sensor_accel_data sad;
+
+    memset(&sad, 0, sizeof(sad));
+    sad.sad_x = sensor_test_val;
+    sad.sad_x_is_valid = 1;
+
+    return (data_func(sensor, data_arg, &sad, SENSOR_TYPE_ACCELEROMETER));
+}
+
+static int
+sensor_test_sensor_get_config(struct sensor *sensor, sensor_type_t type,
+        struct sensor_cfg *cfg)
+{
+    cfg->sc_valtype = SENSOR_VALUE_TYPE_FLOAT_TRIPLET;
+
+    return (0);
+}
+
+static struct sensor_driver sensor_test_driver = {
+    .sd_read = sensor_test_sensor_read,
+    .sd_get_config = sensor_test_sensor_get_config,
+};
+
+void
+sensor_test_init(void)
+{
+    int rc;
+
+    rc = sensor_init(&sensor_test_sensor, &sensor_test_dev);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    sensor_set_driver(&sensor_test_sensor, SENSOR_TYPE_ACCELEROMETER,
+                      &sensor_test_driver);
+    sensor_set_type_mask(&sensor_test_sensor, SENSOR_TYPE_ACCELEROMETER);
+}
+
+/**
+ * Reads the stub sensor once, producing a sample with the given value.
+ */
+int
+sensor_test_read(int val)
+{
+    sensor_test_val = val;
+
+    return (sensor_read(&sensor_test_sensor, SENSOR_TYPE_ACCELEROMETER, NULL,
+                        NULL, OS_TIMEOUT_NEVER));
+}
+
+int
+sensor_test_ring_init(struct sensor_ring *ring, void *buf, uint16_t num)
+{
+    sensor_test_init();
+
+    return (sensor_ring_init(ring, &sensor_test_sensor,
+                             SENSOR_TYPE_ACCELEROMETER, buf,
+                             sizeof(struct sensor_accel_data), num));
+}
+
+/**
+ * Reads a sample from the ring and checks it is the one read with the
+ * given value.
+ */
+void
+sensor_test_verify(struct sensor_ring *ring, uint32_t seq, int val)
+{
+    struct sensor_accel_data sad;
+    sensor_type_t type;
+    int rc;
+
+    rc = sensor_ring_read(ring, seq, &sad, &type, NULL);
+    TEST_ASSERT_FATAL(rc == 0, "seq %lu: rc = %d", (unsigned long)seq, rc);
+    TEST_ASSERT(type == SENSOR_TYPE_ACCELEROMETER);
+    TEST_ASSERT(sad.sad_x_is_valid);
+    TEST_ASSERT(sad.sad_x == val);
+}
+
+TEST_CASE_DECL(sensor_ring_test_empty)
+TEST_CASE_DECL(sensor_ring_test_read)
+TEST_CASE_DECL(sensor_ring_test_overwrite)
+TEST_CASE_DECL(sensor_ring_test_wrap)
+TEST_CASE_DECL(sensor_ring_test_single)
+TEST_CASE_DECL(sensor_bus_test_poll_read)
+
+TEST_SUITE(sensor_ring_test_suite)
+{
+    sensor_ring_test_empty();
+    sensor_ring_test_read();
+    sensor_ring_test_overwrite();
+    sensor_ring_test_wrap();
+    sensor_ring_test_single();
+}
+
+/* Starts the OS, so it has to run last */
+TEST_SUITE(sensor_bus_test_suite)
+{
+    sensor_bus_test_poll_read();
+}
+
+#if MYNEWT_VAL(SELFTEST)
+
+int
+main(int argc, char **argv)
+{
+    sysinit();
+
+    sensor_ring_test_suite();
+    sensor_bus_test_suite();
+
+    return tu_any_failed;
+}
+
+#endif
@@ -0,0 +1,54 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef __SENSOR_TEST_H
+#define __SENSOR_TEST_H
+
+#include <string.h>
+#include "syscfg/syscfg.h"
+#include "testutil/testutil.h"
+#include "defs/error.h"
+#include "os/os.h"
+#include "sensor/sensor.h"
+#include "sensor/accel.h"
+#include "sensor/sensor_ring.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SENSOR_TEST_RING_NUM    (4)
+#define SENSOR_TEST_RING_SIZE                                               \
+    SENSOR_RING_BUF_SIZE(sizeof(struct sensor_accel_data),                  \
+                         SENSOR_TEST_RING_NUM)
+
+/* Every byte read from the stub I2C bus */
+#define SENSOR_TEST_BUS_VAL     (0x5a)
+
+extern struct sensor sensor_test_sensor;
+
+void sensor_test_init(void);
+int sensor_test_read(int);
+int sensor_test_ring_init(struct sensor_ring *, void *, uint16_t);
+void sensor_test_verify(struct sensor_ring *, uint32_t, int);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SENSOR_TEST_H */
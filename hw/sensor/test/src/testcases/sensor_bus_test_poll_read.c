@@ -0,0 +1,197 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "sensor/sensor_bus.h"
+#include "sensor_test.h"
+
+/*
+ * A sensor on a managed bus is polled on the bus task while another task
+ * reads it.  The reader holds the sensor lock while it waits for the bus
+ * task to run its transfer, so polls coming due meanwhile must not wait
+ * for the lock.
+ */
+
+#if MYNEWT_VAL(SELFTEST)
+
+#define SENSOR_BUS_TEST_READS       (10)
+#define SENSOR_BUS_TEST_TIMEOUT     (OS_TICKS_PER_SEC * 2)
+#define SENSOR_BUS_TEST_STACK_SIZE  OS_STACK_ALIGN(1024)
+#define SENSOR_BUS_TEST_MAIN_PRIO   (MYNEWT_VAL(SENSOR_BUS_TASK_PRIO) - 10)
+#define SENSOR_BUS_TEST_READER_PRIO (MYNEWT_VAL(SENSOR_BUS_TASK_PRIO) + 10)
+
+static char sensor_bus_test_name[] = "bus_test";
+static struct os_dev sensor_bus_test_dev;
+static struct sensor sensor_bus_test_sensor;
+static struct sensor_listener sensor_bus_test_listener;
+
+static struct os_task sensor_bus_test_main;
+static struct os_task sensor_bus_test_reader;
+static os_stack_t sensor_bus_test_main_stack[SENSOR_BUS_TEST_STACK_SIZE];
+static os_stack_t sensor_bus_test_reader_stack[SENSOR_BUS_TEST_STACK_SIZE];
+
+static volatile int sensor_bus_test_polls;
+static volatile int sensor_bus_test_reads;
+
+static int
+sensor_bus_test_sensor_read(struct sensor *sensor, sensor_type_t type,
+        sensor_data_func_t data_func, void *data_arg, uint32_t timeout)
+{
+    struct sensor_accel_data sad;
+    uint8_t val;
+    int rc;
+
+    /* Keep the sensor locked until a poll comes due on the bus task */
+    if (os_sched_get_current_task() == &sensor_bus_test_reader) {
+        os_time_delay(2);
+    }
+
+    rc = sensor_bus_read_reg(SENSOR_GET_ITF(sensor), 0, &val, 1, NULL);
+    if (rc != 0) {
+        return (rc);
+    }
+
+    memset(&sad, 0, sizeof(sad));
+    sad.sad_x = val;
+    sad.sad_x_is_valid = 1;
+
+    return (data_func(sensor, data_arg, &sad, SENSOR_TYPE_ACCELEROMETER));
+}
+
+static int
+sensor_bus_test_sensor_get_config(struct sensor *sensor, sensor_type_t type,
+        struct sensor_cfg *cfg)
+{
+    cfg->sc_valtype = SENSOR_VALUE_TYPE_FLOAT_TRIPLET;
+
+    return (0);
+}
+
+static struct sensor_driver sensor_bus_test_driver = {
+    .sd_read = sensor_bus_test_sensor_read,
+    .sd_get_config = sensor_bus_test_sensor_get_config,
+};
+
+static int
+sensor_bus_test_poll_cb(struct sensor *sensor, void *arg, void *data,
+        sensor_type_t type)
+{
+    if (os_sched_get_current_task() != &sensor_bus_test_reader) {
+        sensor_bus_test_polls++;
+    }
+
+    return (0);
+}
+
+static int
+sensor_bus_test_read_cb(struct sensor *sensor, void *arg, void *data,
+        sensor_type_t type)
+{
+    struct sensor_accel_data *sad;
+
+    sad = data;
+    TEST_ASSERT(sad->sad_x == SENSOR_TEST_BUS_VAL);
+    sensor_bus_test_reads++;
+
+    return (0);
+}
+
+static void
+sensor_bus_test_reader_handler(void *arg)
+{
+    int rc;
+    int i;
+
+    for (i = 0; i < SENSOR_BUS_TEST_READS; i++) {
+        rc = sensor_read(&sensor_bus_test_sensor, SENSOR_TYPE_ACCELEROMETER,
+                         sensor_bus_test_read_cb, NULL, OS_TIMEOUT_NEVER);
+        TEST_ASSERT(rc == 0);
+    }
+
+    while (1) {
+        os_time_delay(OS_TICKS_PER_SEC);
+    }
+}
+
+static void
+sensor_bus_test_main_handler(void *arg)
+{
+    os_time_t start;
+    int polls;
+    int rc;
+
+    /* Poll every tick */
+    rc = sensor_set_poll_rate_ms(sensor_bus_test_name, 1);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    os_task_init(&sensor_bus_test_reader, "reader",
+                 sensor_bus_test_reader_handler, NULL,
+                 SENSOR_BUS_TEST_READER_PRIO, OS_WAIT_FOREVER,
+                 sensor_bus_test_reader_stack, SENSOR_BUS_TEST_STACK_SIZE);
+
+    /* A poll waiting for the lock would never let the reader finish */
+    start = os_time_get();
+    while (sensor_bus_test_reads < SENSOR_BUS_TEST_READS &&
+           os_time_get() - start < SENSOR_BUS_TEST_TIMEOUT) {
+        os_time_delay(1);
+    }
+    TEST_ASSERT(sensor_bus_test_reads == SENSOR_BUS_TEST_READS);
+
+    /* Polling goes on */
+    polls = sensor_bus_test_polls;
+    os_time_delay(5);
+    TEST_ASSERT(sensor_bus_test_polls > polls);
+
+    tu_restart();
+}
+#endif
+
+TEST_CASE(sensor_bus_test_poll_read)
+{
+#if MYNEWT_VAL(SELFTEST)
+    struct sensor_itf itf;
+    int rc;
+
+    sensor_bus_test_dev.od_name = sensor_bus_test_name;
+    rc = sensor_init(&sensor_bus_test_sensor, &sensor_bus_test_dev);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    sensor_set_driver(&sensor_bus_test_sensor, SENSOR_TYPE_ACCELEROMETER,
+                      &sensor_bus_test_driver);
+    sensor_set_type_mask(&sensor_bus_test_sensor, SENSOR_TYPE_ACCELEROMETER);
+
+    memset(&itf, 0, sizeof(itf));
+    itf.si_type = SENSOR_ITF_I2C;
+    itf.si_num = 0;
+    sensor_set_interface(&sensor_bus_test_sensor, &itf);
+
+    sensor_bus_test_listener.sl_sensor_type = SENSOR_TYPE_ACCELEROMETER;
+    sensor_bus_test_listener.sl_func = sensor_bus_test_poll_cb;
+    rc = sensor_register_listener(&sensor_bus_test_sensor,
+                                  &sensor_bus_test_listener);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    rc = sensor_mgr_register(&sensor_bus_test_sensor);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    os_task_init(&sensor_bus_test_main, "main", sensor_bus_test_main_handler,
+                 NULL, SENSOR_BUS_TEST_MAIN_PRIO, OS_WAIT_FOREVER,
+                 sensor_bus_test_main_stack, SENSOR_BUS_TEST_STACK_SIZE);
+
+    os_start();
+#endif
+}
@@ -0,0 +1,48 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "sensor_test.h"
+
+TEST_CASE(sensor_ring_test_empty)
+{
+    static uint64_t buf[SENSOR_TEST_RING_SIZE / sizeof(uint64_t)];
+    struct sensor_accel_data sad;
+    struct sensor_ring ring;
+    uint32_t seq;
+    int rc;
+
+    /* The entry count must be a power of two */
+    sensor_test_init();
+    rc = sensor_ring_init(&ring, &sensor_test_sensor,
+                          SENSOR_TYPE_ACCELEROMETER, buf,
+                          sizeof(struct sensor_accel_data), 3);
+    TEST_ASSERT(rc == SYS_EINVAL);
+
+    rc = sensor_test_ring_init(&ring, buf, SENSOR_TEST_RING_NUM);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    TEST_ASSERT(sensor_ring_seq(&ring) == 0);
+    TEST_ASSERT(sensor_ring_oldest_seq(&ring) == 0);
+
+    TEST_ASSERT(sensor_ring_read(&ring, 0, &sad, NULL, NULL) == SYS_EAGAIN);
+    TEST_ASSERT(sensor_ring_read(&ring, 1, &sad, NULL, NULL) == SYS_EAGAIN);
+    TEST_ASSERT(sensor_ring_read_latest(&ring, &seq, &sad, NULL, NULL) ==
+                SYS_ENOENT);
+
+    TEST_ASSERT(sensor_ring_stop(&ring) == 0);
+}
@@ -0,0 +1,47 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "sensor_test.h"
+
+TEST_CASE(sensor_ring_test_overwrite)
+{
+    static uint64_t buf[SENSOR_TEST_RING_SIZE / sizeof(uint64_t)];
+    struct sensor_accel_data sad;
+    struct sensor_ring ring;
+    int rc;
+    int i;
+
+    rc = sensor_test_ring_init(&ring, buf, SENSOR_TEST_RING_NUM);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    for (i = 1; i <= SENSOR_TEST_RING_NUM + 2; i++) {
+        TEST_ASSERT_FATAL(sensor_test_read(i) == 0);
+    }
+
+    /* The two oldest samples are gone */
+    TEST_ASSERT(sensor_ring_seq(&ring) == SENSOR_TEST_RING_NUM + 2);
+    TEST_ASSERT(sensor_ring_oldest_seq(&ring) == 3);
+    TEST_ASSERT(sensor_ring_read(&ring, 1, &sad, NULL, NULL) == SYS_ENOENT);
+    TEST_ASSERT(sensor_ring_read(&ring, 2, &sad, NULL, NULL) == SYS_ENOENT);
+
+    for (i = 3; i <= SENSOR_TEST_RING_NUM + 2; i++) {
+        sensor_test_verify(&ring, i, i);
+    }
+
+    TEST_ASSERT(sensor_ring_stop(&ring) == 0);
+}
@@ -0,0 +1,53 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "sensor_test.h"
+
+TEST_CASE(sensor_ring_test_single)
+{
+    static uint64_t buf[SENSOR_RING_BUF_SIZE(sizeof(struct sensor_accel_data),
+                                             1) / sizeof(uint64_t)];
+    struct sensor_accel_data sad;
+    struct sensor_ring ring;
+    uint32_t seq;
+    int rc;
+
+    rc = sensor_test_ring_init(&ring, buf, 1);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    TEST_ASSERT(sensor_ring_oldest_seq(&ring) == 0);
+
+    TEST_ASSERT_FATAL(sensor_test_read(1) == 0);
+    TEST_ASSERT(sensor_ring_oldest_seq(&ring) == 1);
+    sensor_test_verify(&ring, 1, 1);
+
+    /* Each sample replaces the previous one */
+    TEST_ASSERT_FATAL(sensor_test_read(2) == 0);
+    TEST_ASSERT(sensor_ring_seq(&ring) == 2);
+    TEST_ASSERT(sensor_ring_oldest_seq(&ring) == 2);
+    TEST_ASSERT(sensor_ring_read(&ring, 1, &sad, NULL, NULL) == SYS_ENOENT);
+    TEST_ASSERT(sensor_ring_read(&ring, 3, &sad, NULL, NULL) == SYS_EAGAIN);
+    sensor_test_verify(&ring, 2, 2);
+
+    rc = sensor_ring_read_latest(&ring, &seq, &sad, NULL, NULL);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(seq == 2);
+    TEST_ASSERT(sad.sad_x == 2);
+
+    TEST_ASSERT(sensor_ring_stop(&ring) == 0);
+}
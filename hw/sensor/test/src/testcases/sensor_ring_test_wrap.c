@@ -0,0 +1,69 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "sensor_test.h"
+
+TEST_CASE(sensor_ring_test_wrap)
+{
+    static uint64_t buf[SENSOR_TEST_RING_SIZE / sizeof(uint64_t)];
+    struct sensor_accel_data sad;
+    struct sensor_ring ring;
+    int rc;
+
+    rc = sensor_test_ring_init(&ring, buf, SENSOR_TEST_RING_NUM);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    /* Start just short of the end of the sequence numbers */
+    ring.sr_seq = UINT32_MAX - SENSOR_TEST_RING_NUM;
+    TEST_ASSERT_FATAL(sensor_test_read(1) == 0);
+    TEST_ASSERT_FATAL(sensor_test_read(2) == 0);
+    TEST_ASSERT_FATAL(sensor_test_read(3) == 0);
+    TEST_ASSERT_FATAL(sensor_test_read(4) == 0);
+    TEST_ASSERT(sensor_ring_seq(&ring) == UINT32_MAX);
+    TEST_ASSERT(sensor_ring_oldest_seq(&ring) ==
+                UINT32_MAX - SENSOR_TEST_RING_NUM + 1);
+
+    /* 0 is skipped */
+    TEST_ASSERT_FATAL(sensor_test_read(5) == 0);
+    TEST_ASSERT(sensor_ring_seq(&ring) == 1);
+    TEST_ASSERT(sensor_ring_oldest_seq(&ring) == UINT32_MAX - 1);
+    sensor_test_verify(&ring, UINT32_MAX - 1, 3);
+    sensor_test_verify(&ring, UINT32_MAX, 4);
+    sensor_test_verify(&ring, 1, 5);
+    TEST_ASSERT(sensor_ring_read(&ring, UINT32_MAX - 2, &sad, NULL, NULL) ==
+                SYS_ENOENT);
+    TEST_ASSERT(sensor_ring_read(&ring, 2, &sad, NULL, NULL) == SYS_EAGAIN);
+
+    TEST_ASSERT_FATAL(sensor_test_read(6) == 0);
+    TEST_ASSERT(sensor_ring_oldest_seq(&ring) == UINT32_MAX);
+    sensor_test_verify(&ring, UINT32_MAX, 4);
+
+    /* The samples from before the wrap are all gone */
+    TEST_ASSERT_FATAL(sensor_test_read(7) == 0);
+    TEST_ASSERT(sensor_ring_oldest_seq(&ring) == 1);
+    TEST_ASSERT(sensor_ring_read(&ring, UINT32_MAX, &sad, NULL, NULL) ==
+                SYS_ENOENT);
+
+    TEST_ASSERT_FATAL(sensor_test_read(8) == 0);
+    TEST_ASSERT(sensor_ring_seq(&ring) == SENSOR_TEST_RING_NUM);
+    TEST_ASSERT(sensor_ring_oldest_seq(&ring) == 1);
+    sensor_test_verify(&ring, 1, 5);
+    sensor_test_verify(&ring, SENSOR_TEST_RING_NUM, 8);
+
+    TEST_ASSERT(sensor_ring_stop(&ring) == 0);
+}
@@ -86,6 +86,7 @@ void os_init_idle_task(void);
 #include "os/os_mbuf.h"
 #include "os/os_mempool.h"
 #include "os/os_mutex.h"
+#include "os/os_profile.h"
 #include "os/os_sanity.h"
 #include "os/os_sched.h"
 #include "os/os_sem.h"
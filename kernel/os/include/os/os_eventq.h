@@ -21,6 +21,7 @@
 #define _OS_EVENTQ_H
 
 #include <inttypes.h>
+#include "syscfg/syscfg.h"
 #include "os/os_time.h"
 #include "os/queue.h"
 
@@ -36,10 +37,20 @@ struct os_event {
     os_event_fn *ev_cb;
     void *ev_arg;
     STAILQ_ENTRY(os_event) ev_next;
+#if MYNEWT_VAL(OS_PROFILE)
+    uint8_t ev_stamped;
+    uint32_t ev_put_time;       /* cputime at os_eventq_put() */
+#endif
 };
 
 #define OS_EVENT_QUEUED(__ev) ((__ev)->ev_queued)
 
+/*
+ * ev_queued of an event taken off its queue by os_eventq_run_batch() whose
+ * callback has not run yet.  Such an event still counts as queued.
+ */
+#define OS_EVENT_BATCHED        (2)
+
 struct os_eventq {
     struct os_task *evq_owner;  /* owner task */
     struct os_task *evq_task;   /* sleeper; must be either NULL, or the owner */
@@ -52,6 +63,8 @@ void os_eventq_put(struct os_eventq *, struct os_event *);
 struct os_event *os_eventq_get_no_wait(struct os_eventq *evq);
 struct os_event *os_eventq_get(struct os_eventq *);
 void os_eventq_run(struct os_eventq *evq);
+int os_eventq_get_batch(struct os_eventq *evq, struct os_event **evs, int max);
+int os_eventq_run_batch(struct os_eventq *evq, int max);
 struct os_event *os_eventq_poll(struct os_eventq **, int, os_time_t);
 void os_eventq_remove(struct os_eventq *, struct os_event *);
 struct os_eventq *os_eventq_dflt_get(void);
@@ -49,6 +49,29 @@ struct os_mbuf_pool {
      */
     struct os_mempool *omp_pool;
 
+    /**
+     * Number of free blocks under which an msys pool is reported as low to
+     * the msys pressure listeners.
+     */
+    uint16_t omp_low_wm;
+    /**
+     * Set while the pool is registered with msys.
+     */
+    uint8_t omp_msys;
+    /**
+     * Last pressure level reported for the pool; OS_MSYS_PRESSURE_[...].
+     */
+    uint8_t omp_pressure;
+    /**
+     * Number of msys allocations that failed in this pool, their best fit.
+     */
+    uint32_t omp_fail_cnt;
+    /**
+     * Number of msys allocations served from this pool because the best
+     * fitting pool was empty.
+     */
+    uint32_t omp_fallback_cnt;
+
     /**
      * Link to the next mbuf pool for system memory pools.
      */
@@ -252,6 +275,28 @@ struct os_mbuf *os_msys_get_pkthdr(uint16_t dsize, uint16_t user_hdr_len);
 int os_msys_count(void);
 int os_msys_num_free(void);
 
+/* Pressure levels of msys pools */
+#define OS_MSYS_PRESSURE_NONE   (0)     /* at or above the low watermark */
+#define OS_MSYS_PRESSURE_LOW    (1)     /* below the low watermark */
+#define OS_MSYS_PRESSURE_EMPTY  (2)     /* no free blocks */
+
+/*
+ * Called when the pressure level of an msys pool changes, from the context
+ * that allocated or freed the mbuf; possibly an interrupt.  Must not block.
+ */
+typedef void os_msys_pressure_fn(struct os_mbuf_pool *omp, int level,
+                                 void *arg);
+
+struct os_msys_pressure_listener {
+    os_msys_pressure_fn *ompl_cb;
+    void *ompl_arg;
+    SLIST_ENTRY(os_msys_pressure_listener) ompl_next;
+};
+
+/* Get notified of pressure level changes of the msys pools */
+int os_msys_pressure_register(struct os_msys_pressure_listener *listener);
+int os_msys_pressure_unregister(struct os_msys_pressure_listener *listener);
+
 /* Initialize a mbuf pool */
 int os_mbuf_pool_init(struct os_mbuf_pool *, struct os_mempool *mp, 
         uint16_t, uint16_t);
@@ -272,6 +317,9 @@ struct os_mbuf *os_mbuf_off(const struct os_mbuf *om, int off,
 /* Copy data from an mbuf to a flat buffer. */
 int os_mbuf_copydata(const struct os_mbuf *m, int off, int len, void *dst);
 
+/* Get len contiguous bytes of a chain, copying them only if needed */
+void *os_mbuf_view(const struct os_mbuf *om, int off, int len, void *scratch);
+
 /* Append data onto a mbuf */
 int os_mbuf_append(struct os_mbuf *m, const void *, uint16_t);
 
@@ -20,6 +20,7 @@
 #ifndef _OS_MEMPOOL_H_
 #define _OS_MEMPOOL_H_
 
+#include "syscfg/syscfg.h"
 #include "os/os.h"
 #include "os/queue.h"
 
@@ -52,8 +53,14 @@ struct os_mempool {
     STAILQ_ENTRY(os_mempool) mp_list;
     SLIST_HEAD(,os_memblock);   /* Pointer to list of free blocks */
     char *name;                 /* Name for memory block */
+#if MYNEWT_VAL(OS_MEMPOOL_GUARD)
+    uint8_t mp_flags;           /* OS_MEMPOOL_F_[...] */
+#endif
 };
 
+/* Pool is checked for overruns, writes after free and double frees. */
+#define OS_MEMPOOL_F_GUARD          (0x01)
+
 #define OS_MEMPOOL_INFO_NAME_LEN (32)
 
 struct os_mempool_info {
@@ -72,11 +79,20 @@ struct os_mempool *os_mempool_info_get_next(struct os_mempool *,
  * is NOT in bytes! The size is the number of os_membuf_t elements required for
  * the memory pool.
  */
+#if MYNEWT_VAL(OS_MEMPOOL_GUARD)
+/* Every block is followed by one guard element. */
+#define OS_MEMPOOL_GUARD_ELEMS          (1)
+#else
+#define OS_MEMPOOL_GUARD_ELEMS          (0)
+#endif
+
 #if (OS_CFG_ALIGNMENT == OS_CFG_ALIGN_4)
-#define OS_MEMPOOL_SIZE(n,blksize)      ((((blksize) + 3) / 4) * (n))
+#define OS_MEMPOOL_SIZE(n,blksize)      \
+    (((((blksize) + 3) / 4) + OS_MEMPOOL_GUARD_ELEMS) * (n))
 typedef uint32_t os_membuf_t;
 #else
-#define OS_MEMPOOL_SIZE(n,blksize)      ((((blksize) + 7) / 8) * (n))
+#define OS_MEMPOOL_SIZE(n,blksize)      \
+    (((((blksize) + 7) / 8) + OS_MEMPOOL_GUARD_ELEMS) * (n))
 typedef uint64_t os_membuf_t;
 #endif
 
@@ -97,6 +113,17 @@ void *os_memblock_get(struct os_mempool *mp);
 /* Put the memory block back into the pool */
 os_error_t os_memblock_put(struct os_mempool *mp, void *block_addr);
 
+/* Get up to max blocks from the pool at once */
+int os_memblock_get_n(struct os_mempool *mp, void **blocks, int max);
+
+/* Put a number of blocks back into the pool at once */
+os_error_t os_memblock_put_n(struct os_mempool *mp, void **blocks, int num);
+
+#if MYNEWT_VAL(OS_MEMPOOL_GUARD)
+/* Turn guard and poison checking of a pool on or off */
+void os_mempool_guard_set(struct os_mempool *mp, int on);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
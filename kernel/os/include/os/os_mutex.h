@@ -22,6 +22,7 @@
 
 #include "os/os.h"
 #include "os/queue.h"
+#include "os/os_waitq.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -30,6 +31,9 @@ extern "C" {
 struct os_mutex
 {
     SLIST_HEAD(, os_task) mu_head;  /* chain of waiting tasks */
+#if MYNEWT_VAL(OS_WAITQ_BUCKETS)
+    struct os_waitq mu_wq;
+#endif
     uint8_t     _pad;
     uint8_t     mu_prio;            /* owner's default priority*/
     uint16_t    mu_level;           /* call nesting level */
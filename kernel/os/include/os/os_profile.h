@@ -0,0 +1,85 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _OS_PROFILE_H
+#define _OS_PROFILE_H
+
+#include <inttypes.h>
+#include "syscfg/syscfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if MYNEWT_VAL(OS_PROFILE)
+
+struct os_task;
+struct os_event;
+
+/*
+ * System wide profiling results.  Per-task results are reported through
+ * os_task_info.
+ */
+struct os_profile_info {
+    /* Time covered by the profile, i.e. since start or the last reset. */
+    uint64_t opi_elapsed_usecs;
+
+    /* Sections with interrupts disabled through OS_ENTER_CRITICAL(). */
+    uint64_t opi_crit_total_usecs;
+    uint32_t opi_crit_cnt;
+    uint32_t opi_crit_max_usecs;
+    void *opi_crit_max_addr;    /* where the longest section was entered */
+};
+
+void os_profile_crit_enter(void);
+void os_profile_crit_exit(void);
+void os_profile_idle_enter(void);
+void os_profile_idle_exit(void);
+void os_profile_ctx_sw(struct os_task *next_t);
+void os_profile_evq_put(struct os_event *ev);
+void os_profile_evq_get(struct os_event *ev);
+
+void os_profile_info_get(struct os_profile_info *opi);
+void os_profile_reset(void);
+uint64_t os_profile_ticks_to_usecs(uint64_t ticks);
+
+/*
+ * Time every critical section.  The hooks run with interrupts disabled:
+ * after they are disabled on entry, and before they are enabled on exit.
+ */
+#undef OS_ENTER_CRITICAL
+#undef OS_EXIT_CRITICAL
+
+#define OS_ENTER_CRITICAL(__os_sr) do {                                 \
+    (__os_sr) = os_arch_save_sr();                                      \
+    os_profile_crit_enter();                                            \
+} while (0)
+
+#define OS_EXIT_CRITICAL(__os_sr) do {                                  \
+    os_profile_crit_exit();                                             \
+    os_arch_restore_sr(__os_sr);                                        \
+} while (0)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OS_PROFILE_H */
@@ -45,6 +45,8 @@ int os_sched_sleep(struct os_task *, os_time_t nticks);
 int os_sched_wakeup(struct os_task *);
 int os_sched_remove(struct os_task *);
 void os_sched_resort(struct os_task *);
+void os_sched_obj_insert(struct os_task_obj *, struct os_task *);
+void os_sched_obj_remove(struct os_task_obj *, struct os_task *);
 os_time_t os_sched_wakeup_ticks(os_time_t now);
 
 #ifdef __cplusplus
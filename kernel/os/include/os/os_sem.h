@@ -21,6 +21,7 @@
 #define _OS_SEM_H_
 
 #include "os/queue.h"
+#include "os/os_waitq.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -29,6 +30,9 @@ extern "C" {
 struct os_sem
 {
     SLIST_HEAD(, os_task) sem_head;     /* chain of waiting tasks */
+#if MYNEWT_VAL(OS_WAITQ_BUCKETS)
+    struct os_waitq sem_wq;
+#endif
     uint16_t    _pad;
     uint16_t    sem_tokens;             /* # of tokens */
 };
@@ -23,6 +23,7 @@
 #include "os/os.h"
 #include "os/os_sanity.h" 
 #include "os/queue.h"
+#include "os/os_waitq.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -36,11 +37,15 @@ extern "C" {
  * Generic "object" structure. All objects that a task can wait on must
  * have a SLIST_HEAD(, os_task) head_name as the first element in the object 
  * structure. The element 'head_name' can be any name. See os_mutex.h or
- * os_sem.h for an example.
+ * os_sem.h for an example.  With OS_WAITQ_BUCKETS, the head is followed by
+ * a struct os_waitq.
  */
 struct os_task_obj
 {
     SLIST_HEAD(, os_task) obj_head;     /* chain of waiting tasks */
+#if MYNEWT_VAL(OS_WAITQ_BUCKETS)
+    struct os_waitq obj_wq;
+#endif
 };
 
 /* Task states */
@@ -71,7 +76,7 @@ struct os_task {
     uint8_t t_state;
     uint8_t t_flags;
     uint8_t t_lockcnt;
-    uint8_t t_pad;
+    uint8_t t_obj_prio;     /* priority when queued on t_obj */
 
     const char *t_name;
     os_task_func_t t_func;
@@ -85,6 +90,15 @@ struct os_task {
     os_time_t t_run_time;
     uint32_t t_ctx_sw_cnt;
 
+#if MYNEWT_VAL(OS_PROFILE)
+    /* In cputime ticks; see os_profile.c */
+    uint64_t t_cpu_ticks;
+    uint32_t t_cpu_burst_max;
+    uint64_t t_evq_lat_total;
+    uint32_t t_evq_lat_max;
+    uint32_t t_evq_cnt;
+#endif
+
     /* Global list of all tasks, irrespective of run or sleep lists */
     STAILQ_ENTRY(os_task) t_os_task_list;
 
@@ -117,6 +131,12 @@ struct os_task_info {
     uint32_t oti_runtime;
     os_time_t oti_last_checkin;
     os_time_t oti_next_checkin;
+#if MYNEWT_VAL(OS_PROFILE)
+    uint64_t oti_cpu_usecs;
+    uint32_t oti_cpu_burst_max_usecs;
+    uint32_t oti_evq_lat_max_usecs;
+    uint32_t oti_evq_lat_avg_usecs;
+#endif
 
     char oti_name[OS_TASK_MAX_NAME_LEN];
 };
@@ -32,8 +32,16 @@
 #define OS_TRACE_ID_MUTEX_INIT                (3u + OS_TRACE_ID_OFFSET)
 #define OS_TRACE_ID_MUTEX_RELEASE             (4u + OS_TRACE_ID_OFFSET)
 #define OS_TRACE_ID_MUTEX_PEND                (5u + OS_TRACE_ID_OFFSET)
+#define OS_TRACE_ID_SEM_RELEASE               (6u + OS_TRACE_ID_OFFSET)
+#define OS_TRACE_ID_SEM_PEND                  (7u + OS_TRACE_ID_OFFSET)
+#define OS_TRACE_ID_MBUF_GET                  (8u + OS_TRACE_ID_OFFSET)
+#define OS_TRACE_ID_MBUF_FREE                 (9u + OS_TRACE_ID_OFFSET)
 
-#if MYNEWT_VAL(OS_SYSVIEW)
+#if MYNEWT_VAL(OS_SYSVIEW) && MYNEWT_VAL(OS_TRACEBUF)
+#error "OS_SYSVIEW and OS_TRACEBUF are mutually exclusive"
+#endif
+
+#if MYNEWT_VAL(OS_SYSVIEW) || MYNEWT_VAL(OS_TRACEBUF)
 void os_trace_enter_isr(void);
 void os_trace_exit_isr(void);
 void os_trace_exit_isr_to_scheduler(void);
@@ -0,0 +1,55 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ * 
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _OS_WAITQ_H
+#define _OS_WAITQ_H
+
+#include <inttypes.h>
+#include "syscfg/syscfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if MYNEWT_VAL(OS_WAITQ_BUCKETS)
+
+struct os_task;
+
+/*
+ * Task priorities are split into OS_WAITQ_GROUPS groups of consecutive
+ * priorities.  A waiter list still holds its tasks in priority order; this
+ * index remembers the last waiter of every group, so that a task can be
+ * inserted or removed by walking only the waiters of its own group.
+ */
+#define OS_WAITQ_GROUPS         (32)
+#define OS_WAITQ_GROUP(prio)    ((prio) >> 3)
+
+struct os_waitq {
+    /* Bit n set when group n has waiters */
+    uint32_t wq_map;
+    struct os_task *wq_tail[OS_WAITQ_GROUPS];
+};
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OS_WAITQ_H */
@@ -114,7 +114,13 @@ os_idle_task(void *arg)
          */
 
         os_trace_idle();
+#if MYNEWT_VAL(OS_PROFILE)
+        os_profile_idle_enter();
+#endif
         os_tick_idle(iticks);
+#if MYNEWT_VAL(OS_PROFILE)
+        os_profile_idle_exit();
+#endif
         OS_EXIT_CRITICAL(sr);
     }
 }
@@ -75,6 +75,9 @@ os_eventq_put(struct os_eventq *evq, struct os_event *ev)
     /* Queue the event */
     ev->ev_queued = 1;
     STAILQ_INSERT_TAIL(&evq->evq_list, ev, ev_next);
+#if MYNEWT_VAL(OS_PROFILE)
+    os_profile_evq_put(ev);
+#endif
 
     resched = 0;
     if (evq->evq_task) {
@@ -109,25 +112,27 @@ os_eventq_get_no_wait(struct os_eventq *evq)
     if (ev) {
         STAILQ_REMOVE(&evq->evq_list, ev, os_event, ev_next);
         ev->ev_queued = 0;
+#if MYNEWT_VAL(OS_PROFILE)
+        os_profile_evq_get(ev);
+#endif
     }
 
     return ev;
 }
 
-/**
- * Pull a single item from an event queue.  This function blocks until there
- * is an item on the event queue to read.
- *
- * @param evq The event queue to pull an event from
- *
- * @return The event from the queue
+/*
+ * Takes up to max events off the queue, in one critical section, sleeping
+ * until at least one is there.  Dequeued events get their ev_queued set to
+ * the given value.
  */
-struct os_event *
-os_eventq_get(struct os_eventq *evq)
+static int
+os_eventq_get_n(struct os_eventq *evq, struct os_event **evs, int max,
+                uint8_t queued)
 {
     struct os_event *ev;
     os_sr_t sr;
     struct os_task *t;
+    int n;
 
     t = os_sched_get_current_task();
     if (evq->evq_owner != t) {
@@ -143,13 +148,7 @@ os_eventq_get(struct os_eventq *evq)
     }
     OS_ENTER_CRITICAL(sr);
     os_trace_void(OS_TRACE_ID_EVQ_GET);
-pull_one:
-    ev = STAILQ_FIRST(&evq->evq_list);
-    if (ev) {
-        STAILQ_REMOVE(&evq->evq_list, ev, os_event, ev_next);
-        ev->ev_queued = 0;
-        t->t_flags &= ~OS_TASK_FLAG_EVQ_WAIT;
-    } else {
+    while (STAILQ_EMPTY(&evq->evq_list)) {
         evq->evq_task = t;
         os_sched_sleep(evq->evq_task, OS_TIMEOUT_NEVER);
         t->t_flags |= OS_TASK_FLAG_EVQ_WAIT;
@@ -159,14 +158,66 @@ pull_one:
 
         OS_ENTER_CRITICAL(sr);
         evq->evq_task = NULL;
-        goto pull_one;
+    }
+    t->t_flags &= ~OS_TASK_FLAG_EVQ_WAIT;
+
+    for (n = 0; n < max; n++) {
+        ev = STAILQ_FIRST(&evq->evq_list);
+        if (!ev) {
+            break;
+        }
+        STAILQ_REMOVE_HEAD(&evq->evq_list, ev_next);
+        ev->ev_queued = queued;
+#if MYNEWT_VAL(OS_PROFILE)
+        os_profile_evq_get(ev);
+#endif
+        evs[n] = ev;
     }
     os_trace_end_call(OS_TRACE_ID_EVQ_GET);
     OS_EXIT_CRITICAL(sr);
 
+    return n;
+}
+
+/**
+ * Pull a single item from an event queue.  This function blocks until there
+ * is an item on the event queue to read.
+ *
+ * @param evq The event queue to pull an event from
+ *
+ * @return The event from the queue
+ */
+struct os_event *
+os_eventq_get(struct os_eventq *evq)
+{
+    struct os_event *ev;
+
+    os_eventq_get_n(evq, &ev, 1, 0);
+
     return (ev);
 }
 
+/**
+ * Pull up to max items from an event queue in one go.  This function blocks
+ * until there is at least one item on the event queue to read.
+ *
+ * The events are off the queue once this returns; removing one of them with
+ * os_eventq_remove() before the caller has handled it has no effect.
+ *
+ * @param evq The event queue to pull events from
+ * @param evs Array the events are returned in
+ * @param max Size of evs
+ *
+ * @return The number of events returned, at least 1
+ */
+int
+os_eventq_get_batch(struct os_eventq *evq, struct os_event **evs, int max)
+{
+    assert(max > 0);
+
+    return os_eventq_get_n(evq, evs, max, 0);
+}
+
 void
 os_eventq_run(struct os_eventq *evq)
 {
@@ -178,6 +229,59 @@ os_eventq_run(struct os_eventq *evq)
     ev->ev_cb(ev);
 }
 
+/**
+ * Runs the callbacks of up to max events, blocking until there is at least
+ * one event on the queue.  All the events are dequeued at once; meant for
+ * task loops serving queues that get events in bursts.
+ *
+ * Until its callback runs, an event of the batch behaves as if it was still
+ * queued: os_eventq_put() leaves it alone and os_eventq_remove() cancels it.
+ *
+ * @param evq The event queue to process
+ * @param max Largest number of events to process; capped to
+ *            OS_EVENTQ_BATCH_MAX
+ *
+ * @return The number of callbacks run
+ */
+int
+os_eventq_run_batch(struct os_eventq *evq, int max)
+{
+    struct os_event *evs[MYNEWT_VAL(OS_EVENTQ_BATCH_MAX)];
+    struct os_event *ev;
+    int run;
+    int cnt;
+    int i;
+
+    assert(max > 0);
+    if (max > MYNEWT_VAL(OS_EVENTQ_BATCH_MAX)) {
+        max = MYNEWT_VAL(OS_EVENTQ_BATCH_MAX);
+    }
+
+    cnt = os_eventq_get_n(evq, evs, max, OS_EVENT_BATCHED);
+
+    run = 0;
+    for (i = 0; i < cnt; i++) {
+        ev = evs[i];
+
+        /*
+         * No critical section needed: an interrupt removing the event right
+         * after the check is no different from one removing it just after
+         * os_eventq_get() returned it.
+         */
+        if (ev->ev_queued != OS_EVENT_BATCHED) {
+            /* Removed by an earlier callback */
+            continue;
+        }
+        ev->ev_queued = 0;
+
+        assert(ev->ev_cb != NULL);
+        ev->ev_cb(ev);
+        run++;
+    }
+
+    return run;
+}
+
 static struct os_event *
 os_eventq_poll_0timo(struct os_eventq **evq, int nevqs)
 {
@@ -193,6 +297,9 @@ os_eventq_poll_0timo(struct os_eventq **evq, int nevqs)
         if (ev) {
             STAILQ_REMOVE(&evq[i]->evq_list, ev, os_event, ev_next);
             ev->ev_queued = 0;
+#if MYNEWT_VAL(OS_PROFILE)
+            os_profile_evq_get(ev);
+#endif
             break;
         }
     }
@@ -238,6 +345,9 @@ os_eventq_poll(struct os_eventq **evq, int nevqs, os_time_t timo)
         if (ev) {
             STAILQ_REMOVE(&evq[i]->evq_list, ev, os_event, ev_next);
             ev->ev_queued = 0;
+#if MYNEWT_VAL(OS_PROFILE)
+            os_profile_evq_get(ev);
+#endif
             /* Reset the items that already have an evq task set. */
             for (j = 0; j < i; j++) {
                 evq[j]->evq_task = NULL;
@@ -269,6 +379,9 @@ os_eventq_poll(struct os_eventq **evq, int nevqs, os_time_t timo)
             if (ev) {
                 STAILQ_REMOVE(&evq[i]->evq_list, ev, os_event, ev_next);
                 ev->ev_queued = 0;
+#if MYNEWT_VAL(OS_PROFILE)
+                os_profile_evq_get(ev);
+#endif
             }
         }
         evq[i]->evq_task = NULL;
@@ -291,7 +404,7 @@ os_eventq_remove(struct os_eventq *evq, struct os_event *ev)
     os_sr_t sr;
 
     OS_ENTER_CRITICAL(sr);
-    if (OS_EVENT_QUEUED(ev)) {
+    if (OS_EVENT_QUEUED(ev) && ev->ev_queued != OS_EVENT_BATCHED) {
         STAILQ_REMOVE(&evq->evq_list, ev, os_event, ev_next);
     }
     ev->ev_queued = 0;
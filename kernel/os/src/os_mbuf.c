@@ -34,6 +34,7 @@
  */
 
 #include "os/os.h"
+#include "os/os_trace_api.h"
 
 #include <assert.h>
 #include <string.h>
@@ -49,6 +50,9 @@
 STAILQ_HEAD(, os_mbuf_pool) g_msys_pool_list =
     STAILQ_HEAD_INITIALIZER(g_msys_pool_list);
 
+static SLIST_HEAD(, os_msys_pressure_listener) os_msys_pressure_listeners =
+    SLIST_HEAD_INITIALIZER(os_msys_pressure_listeners);
+
 /**
  * Initializes an mqueue.  An mqueue is a queue of mbufs that ties to a
  * particular task's event queue.  Mqueues form a helper API around a common
@@ -170,20 +174,28 @@ int
 os_msys_register(struct os_mbuf_pool *new_pool)
 {
     struct os_mbuf_pool *pool;
+    struct os_mbuf_pool *prev;
 
-    pool = NULL;
+    /* Keep the list sorted by increasing block size */
+    prev = NULL;
     STAILQ_FOREACH(pool, &g_msys_pool_list, omp_next) {
-        if (new_pool->omp_databuf_len > pool->omp_databuf_len) {
+        if (new_pool->omp_databuf_len < pool->omp_databuf_len) {
             break;
         }
+        prev = pool;
     }
 
-    if (pool) {
-        STAILQ_INSERT_AFTER(&g_msys_pool_list, pool, new_pool, omp_next);
+    if (prev) {
+        STAILQ_INSERT_AFTER(&g_msys_pool_list, prev, new_pool, omp_next);
     } else {
-        STAILQ_INSERT_TAIL(&g_msys_pool_list, new_pool, omp_next);
+        STAILQ_INSERT_HEAD(&g_msys_pool_list, new_pool, omp_next);
     }
 
+    new_pool->omp_low_wm = (uint32_t)new_pool->omp_pool->mp_num_blocks *
+                           MYNEWT_VAL(MSYS_LOW_WATERMARK_PCT) / 100;
+    new_pool->omp_msys = 1;
+    new_pool->omp_pressure = OS_MSYS_PRESSURE_NONE;
+
     return (0);
 }
 
@@ -193,9 +205,111 @@ os_msys_register(struct os_mbuf_pool *new_pool)
 void
 os_msys_reset(void)
 {
+    struct os_mbuf_pool *pool;
+
+    STAILQ_FOREACH(pool, &g_msys_pool_list, omp_next) {
+        pool->omp_msys = 0;
+    }
     STAILQ_INIT(&g_msys_pool_list);
 }
 
+/**
+ * Registers a listener for the pressure level of the msys pools.  The
+ * listener is called every time a pool gets below its low watermark
+ * (MSYS_LOW_WATERMARK_PCT of its blocks), runs out of blocks, or gets back
+ * to its low watermark, so that subsystems can shed load before packets
+ * have to be dropped.
+ *
+ * @param listener The listener to register; must stay valid until
+ *                 unregistered.
+ *
+ * @return 0 on success, non-zero on failure.
+ */
+int
+os_msys_pressure_register(struct os_msys_pressure_listener *listener)
+{
+    struct os_msys_pressure_listener *cur;
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    SLIST_FOREACH(cur, &os_msys_pressure_listeners, ompl_next) {
+        if (cur == listener) {
+            OS_EXIT_CRITICAL(sr);
+            return OS_EINVAL;
+        }
+    }
+    SLIST_INSERT_HEAD(&os_msys_pressure_listeners, listener, ompl_next);
+    OS_EXIT_CRITICAL(sr);
+
+    return (0);
+}
+
+/**
+ * Unregisters an msys pressure listener.
+ *
+ * @param listener The listener to unregister
+ *
+ * @return 0 on success, OS_ENOENT if the listener was not registered.
+ */
+int
+os_msys_pressure_unregister(struct os_msys_pressure_listener *listener)
+{
+    struct os_msys_pressure_listener *cur;
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    SLIST_FOREACH(cur, &os_msys_pressure_listeners, ompl_next) {
+        if (cur == listener) {
+            SLIST_REMOVE(&os_msys_pressure_listeners, listener,
+                         os_msys_pressure_listener, ompl_next);
+            OS_EXIT_CRITICAL(sr);
+            return (0);
+        }
+    }
+    OS_EXIT_CRITICAL(sr);
+
+    return OS_ENOENT;
+}
+
+/*
+ * Works out the pressure level of an msys pool after an allocation or a
+ * free, and tells the listeners if it changed.  Allocations are checked in
+ * os_mbuf_get(), so that mbufs added to a chain count too.
+ */
+static void
+os_msys_pressure_update(struct os_mbuf_pool *pool)
+{
+    struct os_msys_pressure_listener *listener;
+    os_sr_t sr;
+    int level;
+    int num_free;
+
+    num_free = pool->omp_pool->mp_num_free;
+    if (num_free == 0) {
+        level = OS_MSYS_PRESSURE_EMPTY;
+    } else if (num_free < pool->omp_low_wm) {
+        level = OS_MSYS_PRESSURE_LOW;
+    } else {
+        level = OS_MSYS_PRESSURE_NONE;
+    }
+
+    if (level == pool->omp_pressure) {
+        return;
+    }
+
+    OS_ENTER_CRITICAL(sr);
+    if (level == pool->omp_pressure) {
+        OS_EXIT_CRITICAL(sr);
+        return;
+    }
+    pool->omp_pressure = level;
+    OS_EXIT_CRITICAL(sr);
+
+    SLIST_FOREACH(listener, &os_msys_pressure_listeners, ompl_next) {
+        listener->ompl_cb(pool, level, listener->ompl_arg);
+    }
+}
+
 static struct os_mbuf_pool *
 _os_msys_find_pool(uint16_t dsize)
 {
@@ -215,9 +329,80 @@ _os_msys_find_pool(uint16_t dsize)
     return (pool);
 }
 
+static struct os_mbuf *
+_os_msys_pool_get(struct os_mbuf_pool *pool, int pkthdr, uint16_t len)
+{
+    if (pkthdr) {
+        return os_mbuf_get_pkthdr(pool, len);
+    } else {
+        return os_mbuf_get(pool, len);
+    }
+}
+
+/*
+ * Allocates from the best fitting pool for dsize, falling back to other
+ * pools as configured with MSYS_FALLBACK.
+ */
+static struct os_mbuf *
+_os_msys_get(uint16_t dsize, int pkthdr, uint16_t len)
+{
+    struct os_mbuf_pool *best;
+    struct os_mbuf_pool *pool;
+    struct os_mbuf *m;
+
+    best = _os_msys_find_pool(dsize);
+    if (!best) {
+        return (NULL);
+    }
+
+    pool = best;
+    m = _os_msys_pool_get(pool, pkthdr, len);
+    if (!m) {
+        best->omp_fail_cnt++;
+
+#if MYNEWT_VAL(MSYS_FALLBACK) >= 1
+        for (pool = STAILQ_NEXT(best, omp_next); pool != NULL;
+             pool = STAILQ_NEXT(pool, omp_next)) {
+
+            m = _os_msys_pool_get(pool, pkthdr, len);
+            if (m) {
+                break;
+            }
+        }
+#endif
+
+#if MYNEWT_VAL(MSYS_FALLBACK) >= 2
+        if (!m) {
+            /* Largest smaller pool with a free block */
+            best = NULL;
+            STAILQ_FOREACH(pool, &g_msys_pool_list, omp_next) {
+                if (pool->omp_databuf_len >= dsize) {
+                    break;
+                }
+                if (pool->omp_pool->mp_num_free != 0) {
+                    best = pool;
+                }
+            }
+            pool = best;
+            if (pool) {
+                m = _os_msys_pool_get(pool, pkthdr, len);
+            }
+        }
+#endif
+
+        if (!m) {
+            return (NULL);
+        }
+        pool->omp_fallback_cnt++;
+    }
+
+    return (m);
+}
+
 /**
  * Allocate a mbuf from msys.  Based upon the data size requested,
- * os_msys_get() will choose the mbuf pool that has the best fit.
+ * os_msys_get() will choose the mbuf pool that has the best fit.  If that
+ * pool is empty, another pool may be used; see MSYS_FALLBACK.
  *
  * @param dsize The estimated size of the data being stored in the mbuf
  * @param leadingspace The amount of leadingspace to allocate in the mbuf
@@ -228,18 +413,7 @@ _os_msys_find_pool(uint16_t dsize)
 struct os_mbuf *
 os_msys_get(uint16_t dsize, uint16_t leadingspace)
 {
-    struct os_mbuf *m;
-    struct os_mbuf_pool *pool;
-
-    pool = _os_msys_find_pool(dsize);
-    if (!pool) {
-        goto err;
-    }
-
-    m = os_mbuf_get(pool, leadingspace);
-    return (m);
-err:
-    return (NULL);
+    return _os_msys_get(dsize, 0, leadingspace);
 }
 
 /**
@@ -255,19 +429,9 @@ struct os_mbuf *
 os_msys_get_pkthdr(uint16_t dsize, uint16_t user_hdr_len)
 {
     uint16_t total_pkthdr_len;
-    struct os_mbuf *m;
-    struct os_mbuf_pool *pool;
 
     total_pkthdr_len =  user_hdr_len + sizeof(struct os_mbuf_pkthdr);
-    pool = _os_msys_find_pool(dsize + total_pkthdr_len);
-    if (!pool) {
-        goto err;
-    }
-
-    m = os_mbuf_get_pkthdr(pool, user_hdr_len);
-    return (m);
-err:
-    return (NULL);
+    return _os_msys_get(dsize + total_pkthdr_len, 1, user_hdr_len);
 }
 
 int
@@ -315,6 +479,11 @@ os_mbuf_pool_init(struct os_mbuf_pool *omp, struct os_mempool *mp,
     omp->omp_databuf_len = buf_len - sizeof(struct os_mbuf);
     omp->omp_mbuf_count = nbufs;
     omp->omp_pool = mp;
+    omp->omp_low_wm = 0;
+    omp->omp_msys = 0;
+    omp->omp_pressure = OS_MSYS_PRESSURE_NONE;
+    omp->omp_fail_cnt = 0;
+    omp->omp_fallback_cnt = 0;
 
     return (0);
 }
@@ -339,6 +508,9 @@ os_mbuf_get(struct os_mbuf_pool *omp, uint16_t leadingspace)
     }
 
     om = os_memblock_get(omp->omp_pool);
+    if (omp->omp_msys) {
+        os_msys_pressure_update(omp);
+    }
     if (!om) {
         goto err;
     }
@@ -350,6 +522,9 @@ os_mbuf_get(struct os_mbuf_pool *omp, uint16_t leadingspace)
     om->om_data = (&om->om_databuf[0] + leadingspace);
     om->om_omp = omp;
 
+    os_trace_u32x2(OS_TRACE_ID_MBUF_GET, (uint32_t)(uintptr_t)om,
+                   (uint32_t)(uintptr_t)omp);
+
     return (om);
 err:
     return (NULL);
@@ -401,13 +576,20 @@ os_mbuf_get_pkthdr(struct os_mbuf_pool *omp, uint8_t user_pkthdr_len)
 int
 os_mbuf_free(struct os_mbuf *om)
 {
+    struct os_mbuf_pool *omp;
     int rc;
 
-    if (om->om_omp != NULL) {
-        rc = os_memblock_put(om->om_omp->omp_pool, om);
+    os_trace_u32(OS_TRACE_ID_MBUF_FREE, (uint32_t)(uintptr_t)om);
+
+    omp = om->om_omp;
+    if (omp != NULL) {
+        rc = os_memblock_put(omp->omp_pool, om);
         if (rc != 0) {
             goto err;
         }
+        if (omp->omp_msys && omp->omp_pressure != OS_MSYS_PRESSURE_NONE) {
+            os_msys_pressure_update(omp);
+        }
     }
 
     return (0);
@@ -729,6 +911,47 @@ os_mbuf_copydata(const struct os_mbuf *m, int off, int len, void *dst)
     return (len > 0 ? -1 : 0);
 }
 
+/**
+ * Gives access to len contiguous bytes of an mbuf chain, starting "off"
+ * bytes from the beginning, without modifying the chain.  If the bytes are
+ * all in one mbuf, a pointer into that mbuf is returned; otherwise they are
+ * copied into the scratch buffer, which must hold len bytes.  Unlike
+ * os_mbuf_pullup(), this never allocates an mbuf.
+ *
+ * The returned pointer is only valid as long as the chain is not modified,
+ * and may not be aligned.
+ *
+ * @param om                    The mbuf chain to read from
+ * @param off                   The offset of the first byte
+ * @param len                   The number of bytes needed
+ * @param scratch               Buffer to copy the bytes into if they are
+ *                                  not contiguous.
+ *
+ * @return                      A pointer to the bytes on success;
+ *                              NULL if the chain is too short.
+ */
+void *
+os_mbuf_view(const struct os_mbuf *om, int off, int len, void *scratch)
+{
+    struct os_mbuf *cur;
+    uint16_t cur_off;
+
+    cur = os_mbuf_off(om, off, &cur_off);
+    if (cur == NULL) {
+        return NULL;
+    }
+
+    if (cur->om_len - cur_off >= len) {
+        return cur->om_data + cur_off;
+    }
+
+    if (os_mbuf_copydata(cur, cur_off, len, scratch) != 0) {
+        return NULL;
+    }
+
+    return scratch;
+}
+
 /**
  * Adjust the length of a mbuf, trimming either from the head or the tail
  * of the mbuf.
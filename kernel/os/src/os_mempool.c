@@ -28,11 +28,15 @@
  *   @defgroup OSMempool Memory Pools
  *   @{
  */
-/*
-#define OS_CHECK_DUP_FREE 1
-*/
 
-#define OS_MEMPOOL_TRUE_BLOCK_SIZE(bsize)   OS_ALIGN(bsize, OS_ALIGNMENT)
+#define OS_MEMPOOL_TRUE_BLOCK_SIZE(bsize)   \
+    (OS_ALIGN(bsize, OS_ALIGNMENT) +        \
+     OS_MEMPOOL_GUARD_ELEMS * sizeof (os_membuf_t))
+
+#if MYNEWT_VAL(OS_MEMPOOL_GUARD)
+#define OS_MEMPOOL_GUARD_WORD               ((os_membuf_t)0xbaff1ed1)
+#define OS_MEMPOOL_POISON                   (0xde)
+#endif
 
 STAILQ_HEAD(, os_mempool) g_os_mempool_list =
     STAILQ_HEAD_INITIALIZER(g_os_mempool_list);
@@ -84,6 +88,9 @@ os_mempool_init(struct os_mempool *mp, int blocks, int block_size,
     mp->mp_num_blocks = blocks;
     mp->mp_membuf_addr = (uint32_t)membuf;
     mp->name = name;
+#if MYNEWT_VAL(OS_MEMPOOL_GUARD)
+    mp->mp_flags = 0;
+#endif
     SLIST_FIRST(mp) = membuf;
 
     /* Chain the memory blocks to the free list */
@@ -140,6 +147,125 @@ os_memblock_from(struct os_mempool *mp, void *block_addr)
     return 1;
 }
 
+#if MYNEWT_VAL(OS_MEMPOOL_GUARD)
+static os_membuf_t *
+os_mempool_guard_ptr(const struct os_mempool *mp, void *block)
+{
+    return (os_membuf_t *)((uint8_t *)block +
+                           OS_ALIGN(mp->mp_block_size, OS_ALIGNMENT));
+}
+
+/**
+ * Fills a free block with the poison pattern.  The free list link at the
+ * start of the block is left alone.
+ */
+static void
+os_mempool_poison(const struct os_mempool *mp, void *block)
+{
+    int len;
+
+    len = OS_ALIGN(mp->mp_block_size, OS_ALIGNMENT) -
+          sizeof (struct os_memblock);
+    if (len > 0) {
+        memset((uint8_t *)block + sizeof (struct os_memblock),
+               OS_MEMPOOL_POISON, len);
+    }
+}
+
+/**
+ * Checks a block that was just taken off the free list: it must not have
+ * been written since it was freed, nor its guard overwritten.
+ */
+static void
+os_mempool_guard_get(const struct os_mempool *mp, void *block)
+{
+    uint8_t *p;
+    uint8_t *end;
+
+    assert(*os_mempool_guard_ptr(mp, block) == OS_MEMPOOL_GUARD_WORD);
+
+    end = (uint8_t *)os_mempool_guard_ptr(mp, block);
+    for (p = (uint8_t *)block + sizeof (struct os_memblock); p < end; p++) {
+        assert(*p == OS_MEMPOOL_POISON);
+    }
+}
+
+/**
+ * Checks the guard of a block that is being freed and poisons it.
+ */
+static void
+os_mempool_guard_put(const struct os_mempool *mp, void *block)
+{
+    assert(*os_mempool_guard_ptr(mp, block) == OS_MEMPOOL_GUARD_WORD);
+    os_mempool_poison(mp, block);
+}
+
+/**
+ * Asserts that a block being freed is not on the free list already.  Must
+ * be called in a critical section.
+ */
+static void
+os_mempool_guard_dup_check(struct os_mempool *mp, void *block)
+{
+    struct os_memblock *cur;
+
+    SLIST_FOREACH(cur, mp, mb_next) {
+        assert(cur != (struct os_memblock *)block);
+    }
+}
+
+/**
+ * Asserts that a block being freed is not among the first num blocks of
+ * the same batch.
+ */
+static void
+os_mempool_guard_dup_check_n(void **blocks, int num, void *block)
+{
+    int i;
+
+    for (i = 0; i < num; i++) {
+        assert(blocks[i] != block);
+    }
+}
+
+/**
+ * Turns guard checking of a pool on or off.  While it is on, every block
+ * ends with a guard word which is checked when the block is freed, free
+ * blocks are filled with a poison pattern which is checked when the block
+ * is allocated, and freeing a block that is already free asserts.  The
+ * free list is walked on every free, so this is for debugging only.
+ *
+ * @param mp                    The mempool to change.
+ * @param on                    1 to turn checking on; 0 to turn it off.
+ */
+void
+os_mempool_guard_set(struct os_mempool *mp, int on)
+{
+    struct os_memblock *block;
+    uint8_t *block_addr;
+    os_sr_t sr;
+    int i;
+
+    OS_ENTER_CRITICAL(sr);
+
+    if (on && !(mp->mp_flags & OS_MEMPOOL_F_GUARD)) {
+        block_addr = (uint8_t *)mp->mp_membuf_addr;
+        for (i = 0; i < mp->mp_num_blocks; i++) {
+            *os_mempool_guard_ptr(mp, block_addr) = OS_MEMPOOL_GUARD_WORD;
+            block_addr += OS_MEMPOOL_TRUE_BLOCK_SIZE(mp->mp_block_size);
+        }
+        SLIST_FOREACH(block, mp, mb_next) {
+            os_mempool_poison(mp, block);
+        }
+        mp->mp_flags |= OS_MEMPOOL_F_GUARD;
+    } else if (!on) {
+        mp->mp_flags &= ~OS_MEMPOOL_F_GUARD;
+    }
+
+    OS_EXIT_CRITICAL(sr);
+}
+#endif
+
 /**
  * os memblock get
  *
@@ -174,11 +300,68 @@ os_memblock_get(struct os_mempool *mp)
             }
         }
         OS_EXIT_CRITICAL(sr);
+
+#if MYNEWT_VAL(OS_MEMPOOL_GUARD)
+        if (block != NULL && (mp->mp_flags & OS_MEMPOOL_F_GUARD)) {
+            os_mempool_guard_get(mp, block);
+        }
+#endif
     }
 
     return (void *)block;
 }
 
+/**
+ * Gets up to max blocks from a memory pool, taking the critical section
+ * only once.
+ *
+ * @param mp                    The mempool to allocate from.
+ * @param blocks                Filled with pointers to the blocks.
+ * @param max                   The size of the blocks array.
+ *
+ * @return                      The number of blocks obtained; fewer than
+ *                                  max if the pool ran out.
+ */
+int
+os_memblock_get_n(struct os_mempool *mp, void **blocks, int max)
+{
+    struct os_memblock *block;
+    os_sr_t sr;
+    int cnt;
+    int i;
+
+    if ((mp == NULL) || (blocks == NULL) || (max <= 0)) {
+        return 0;
+    }
+
+    OS_ENTER_CRITICAL(sr);
+
+    cnt = min(max, mp->mp_num_free);
+    block = SLIST_FIRST(mp);
+    for (i = 0; i < cnt; i++) {
+        blocks[i] = block;
+        block = SLIST_NEXT(block, mb_next);
+    }
+    SLIST_FIRST(mp) = block;
+
+    mp->mp_num_free -= cnt;
+    if (mp->mp_min_free > mp->mp_num_free) {
+        mp->mp_min_free = mp->mp_num_free;
+    }
+
+    OS_EXIT_CRITICAL(sr);
+
+#if MYNEWT_VAL(OS_MEMPOOL_GUARD)
+    if (mp->mp_flags & OS_MEMPOOL_F_GUARD) {
+        for (i = 0; i < cnt; i++) {
+            os_mempool_guard_get(mp, blocks[i]);
+        }
+    }
+#endif
+
+    return cnt;
+}
+
 /**
  * os memblock put
  *
@@ -205,14 +388,21 @@ os_memblock_put(struct os_mempool *mp, void *block_addr)
         return OS_INVALID_PARM;
     }
 
-#ifdef OS_CHECK_DUP_FREE
-    SLIST_FOREACH(block, mp, mb_next) {
-        assert(block != (struct os_memblock *)block_addr);
+#if MYNEWT_VAL(OS_MEMPOOL_GUARD)
+    if (mp->mp_flags & OS_MEMPOOL_F_GUARD) {
+        os_mempool_guard_put(mp, block_addr);
     }
 #endif
+
     block = (struct os_memblock *)block_addr;
     OS_ENTER_CRITICAL(sr);
 
+#if MYNEWT_VAL(OS_MEMPOOL_GUARD)
+    if (mp->mp_flags & OS_MEMPOOL_F_GUARD) {
+        os_mempool_guard_dup_check(mp, block);
+    }
+#endif
+
     /* Chain current free list pointer to this block; make this block head */
     SLIST_NEXT(block, mb_next) = SLIST_FIRST(mp);
     SLIST_FIRST(mp) = block;
@@ -226,6 +416,74 @@ os_memblock_put(struct os_mempool *mp, void *block_addr)
     return OS_OK;
 }
 
+/**
+ * Puts a number of blocks back into a memory pool.  The blocks are
+ * checked and chained together first; the critical section only splices
+ * the chain onto the free list.  If any of the blocks does not belong to
+ * the pool, none of them are put back.
+ *
+ * @param mp                    The mempool the blocks belong to.
+ * @param blocks                Pointers to the blocks to free.
+ * @param num                   The number of blocks.
+ *
+ * @return                      OS_OK on success;
+ *                              OS_INVALID_PARM on bad arguments.
+ */
+os_error_t
+os_memblock_put_n(struct os_mempool *mp, void **blocks, int num)
+{
+    struct os_memblock *first;
+    struct os_memblock *last;
+    os_sr_t sr;
+    int i;
+
+    if ((mp == NULL) || (blocks == NULL) || (num < 0)) {
+        return OS_INVALID_PARM;
+    }
+
+    if (num == 0) {
+        return OS_OK;
+    }
+
+    for (i = 0; i < num; i++) {
+        if ((blocks[i] == NULL) || !os_memblock_from(mp, blocks[i])) {
+            return OS_INVALID_PARM;
+        }
+    }
+
+#if MYNEWT_VAL(OS_MEMPOOL_GUARD)
+    if (mp->mp_flags & OS_MEMPOOL_F_GUARD) {
+        /* Check before linking, so a duplicate can't corrupt the free list */
+        for (i = 0; i < num; i++) {
+            os_mempool_guard_dup_check_n(blocks, i, blocks[i]);
+            os_mempool_guard_put(mp, blocks[i]);
+        }
+
+        OS_ENTER_CRITICAL(sr);
+        for (i = 0; i < num; i++) {
+            os_mempool_guard_dup_check(mp, blocks[i]);
+        }
+        OS_EXIT_CRITICAL(sr);
+    }
+#endif
+
+    for (i = 1; i < num; i++) {
+        SLIST_NEXT((struct os_memblock *)blocks[i - 1], mb_next) = blocks[i];
+    }
+    first = blocks[0];
+    last = blocks[num - 1];
+
+    OS_ENTER_CRITICAL(sr);
+
+    SLIST_NEXT(last, mb_next) = SLIST_FIRST(mp);
+    SLIST_FIRST(mp) = first;
+    mp->mp_num_free += num;
+
+    OS_EXIT_CRITICAL(sr);
+
+    return OS_OK;
+}
+
 
 struct os_mempool *
 os_mempool_info_get_next(struct os_mempool *mp, struct os_mempool_info *omi)
@@ -53,6 +53,9 @@ os_mutex_init(struct os_mutex *mu)
     mu->mu_level = 0;
     mu->mu_owner = NULL;
     SLIST_FIRST(&mu->mu_head) = NULL;
+#if MYNEWT_VAL(OS_WAITQ_BUCKETS)
+    mu->mu_wq.wq_map = 0;
+#endif
     os_trace_end_call(OS_TRACE_ID_MUTEX_INIT);
 
     return OS_OK;
@@ -170,8 +173,6 @@ os_mutex_pend(struct os_mutex *mu, uint32_t timeout)
     os_sr_t sr;
     os_error_t rc;
     struct os_task *current;
-    struct os_task *entry;
-    struct os_task *last;
 
     /* OS must be started when calling this function */
     if (!g_os_started) {
@@ -219,22 +220,7 @@ os_mutex_pend(struct os_mutex *mu, uint32_t timeout)
     }
 
     /* Link current task to tasks waiting for mutex */
-    last = NULL;
-    if (!SLIST_EMPTY(&mu->mu_head)) {
-        /* Insert in priority order */
-        SLIST_FOREACH(entry, &mu->mu_head, t_obj_list) {
-            if (current->t_prio < entry->t_prio) {
-                break;
-            }
-            last = entry;
-        }
-    }
-
-    if (last) {
-        SLIST_INSERT_AFTER(last, current, t_obj_list);
-    } else {
-        SLIST_INSERT_HEAD(&mu->mu_head, current, t_obj_list);
-    }
+    os_sched_obj_insert((struct os_task_obj *)mu, current);
 
     /* Set mutex pointer in task */
     current->t_obj = mu;
@@ -0,0 +1,249 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+#include "os/os.h"
+
+#if MYNEWT_VAL(OS_PROFILE)
+
+/**
+ * @addtogroup OSKernel
+ * @{
+ *   @defgroup OSProfile Run-time profiling
+ *   @{
+ */
+
+static struct {
+    /* Critical sections */
+    uint64_t crit_total;
+    uint32_t crit_cnt;
+    uint32_t crit_max;
+    void *crit_max_addr;
+    uint32_t crit_start;
+    void *crit_addr;
+    uint8_t crit_depth;
+    uint8_t crit_timed;
+
+    /* Task run time */
+    uint8_t sw_valid;
+    uint32_t last_sw;
+    uint64_t elapsed;
+} os_profile;
+
+static void
+os_profile_crit_end(uint32_t now)
+{
+    uint32_t dur;
+
+    dur = now - os_profile.crit_start;
+    os_profile.crit_total += dur;
+    os_profile.crit_cnt++;
+    if (dur > os_profile.crit_max) {
+        os_profile.crit_max = dur;
+        os_profile.crit_max_addr = os_profile.crit_addr;
+    }
+    os_profile.crit_timed = 0;
+}
+
+/*
+ * Called by OS_ENTER_CRITICAL() with interrupts disabled.  Only the outermost
+ * section is timed; reading cputime may nest another one.
+ */
+void
+os_profile_crit_enter(void)
+{
+    if (os_profile.crit_depth++ != 0 || !g_os_started) {
+        return;
+    }
+
+    os_profile.crit_addr = __builtin_return_address(0);
+    os_profile.crit_start = os_cputime_get32();
+    os_profile.crit_timed = 1;
+}
+
+/*
+ * Called by OS_EXIT_CRITICAL() before interrupts are enabled again.
+ */
+void
+os_profile_crit_exit(void)
+{
+    if (os_profile.crit_depth == 0) {
+        return;
+    }
+
+    if (os_profile.crit_depth == 1 && os_profile.crit_timed) {
+        os_profile_crit_end(os_cputime_get32());
+    }
+    os_profile.crit_depth--;
+}
+
+/*
+ * The idle task sleeps with interrupts disabled; that time is not counted
+ * against the critical section it sleeps in.
+ */
+void
+os_profile_idle_enter(void)
+{
+    if (os_profile.crit_timed) {
+        os_profile_crit_end(os_cputime_get32());
+    }
+}
+
+void
+os_profile_idle_exit(void)
+{
+    if (os_profile.crit_depth == 0 || !g_os_started) {
+        return;
+    }
+
+    os_profile.crit_addr = __builtin_return_address(0);
+    os_profile.crit_start = os_cputime_get32();
+    os_profile.crit_timed = 1;
+}
+
+/*
+ * Charges the time since the last context switch to the task being switched
+ * out.
+ */
+void
+os_profile_ctx_sw(struct os_task *next_t)
+{
+    struct os_task *t;
+    uint32_t burst;
+    uint32_t now;
+
+    now = os_cputime_get32();
+    t = os_sched_get_current_task();
+    if (os_profile.sw_valid && t != NULL) {
+        burst = now - os_profile.last_sw;
+        t->t_cpu_ticks += burst;
+        if (burst > t->t_cpu_burst_max) {
+            t->t_cpu_burst_max = burst;
+        }
+        os_profile.elapsed += burst;
+    }
+    os_profile.last_sw = now;
+    os_profile.sw_valid = 1;
+}
+
+void
+os_profile_evq_put(struct os_event *ev)
+{
+    if (g_os_started) {
+        ev->ev_put_time = os_cputime_get32();
+        ev->ev_stamped = 1;
+    }
+}
+
+/*
+ * Charges the time the event spent on its queue to the task that dequeued
+ * it.
+ */
+void
+os_profile_evq_get(struct os_event *ev)
+{
+    struct os_task *t;
+    uint32_t lat;
+
+    t = os_sched_get_current_task();
+    if (!ev->ev_stamped || t == NULL) {
+        return;
+    }
+    ev->ev_stamped = 0;
+
+    lat = os_cputime_get32() - ev->ev_put_time;
+    t->t_evq_lat_total += lat;
+    t->t_evq_cnt++;
+    if (lat > t->t_evq_lat_max) {
+        t->t_evq_lat_max = lat;
+    }
+}
+
+/**
+ * Converts a cputime tick count, e.g. a cumulative run time, to usecs.
+ */
+uint64_t
+os_profile_ticks_to_usecs(uint64_t ticks)
+{
+    uint32_t freq;
+
+    freq = MYNEWT_VAL(OS_CPUTIME_FREQ);
+    return (ticks / freq) * 1000000 + (ticks % freq) * 1000000 / freq;
+}
+
+/**
+ * Reads the system wide profiling results.
+ *
+ * @param opi                   Filled with the results.
+ */
+void
+os_profile_info_get(struct os_profile_info *opi)
+{
+    uint64_t elapsed;
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    elapsed = os_profile.elapsed;
+    if (os_profile.sw_valid) {
+        elapsed += os_cputime_get32() - os_profile.last_sw;
+    }
+    opi->opi_elapsed_usecs = os_profile_ticks_to_usecs(elapsed);
+    opi->opi_crit_total_usecs = os_profile_ticks_to_usecs(
+        os_profile.crit_total);
+    opi->opi_crit_cnt = os_profile.crit_cnt;
+    opi->opi_crit_max_usecs = os_profile_ticks_to_usecs(os_profile.crit_max);
+    opi->opi_crit_max_addr = os_profile.crit_max_addr;
+    OS_EXIT_CRITICAL(sr);
+}
+
+/**
+ * Clears all profiling results, system wide and per task, e.g. at the start
+ * of a benchmark.
+ */
+void
+os_profile_reset(void)
+{
+    struct os_task *t;
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    STAILQ_FOREACH(t, &g_os_task_list, t_os_task_list) {
+        t->t_cpu_ticks = 0;
+        t->t_cpu_burst_max = 0;
+        t->t_evq_lat_total = 0;
+        t->t_evq_lat_max = 0;
+        t->t_evq_cnt = 0;
+    }
+    os_profile.crit_total = 0;
+    os_profile.crit_cnt = 0;
+    os_profile.crit_max = 0;
+    os_profile.crit_max_addr = NULL;
+    os_profile.elapsed = 0;
+    if (os_profile.sw_valid) {
+        os_profile.last_sw = os_cputime_get32();
+    }
+    OS_EXIT_CRITICAL(sr);
+}
+
+/**
+ *   @} OSProfile
+ * @} OSKernel
+ */
+
+#endif
@@ -85,6 +85,9 @@ void
 os_sched_ctx_sw_hook(struct os_task *next_t)
 {
     os_trace_task_start_exec(next_t->t_taskid);
+#if MYNEWT_VAL(OS_PROFILE)
+    os_profile_ctx_sw(next_t);
+#endif
     next_t->t_ctx_sw_cnt++;
     g_current_task->t_run_time += g_os_time - g_os_last_ctx_sw_time;
     g_os_last_ctx_sw_time = g_os_time;
@@ -220,6 +223,140 @@ os_sched_remove(struct os_task *t)
     return OS_OK;
 }
 
+#if MYNEWT_VAL(OS_WAITQ_BUCKETS)
+/*
+ * Returns the last waiter queued ahead of group 'grp', i.e. the tail of the
+ * closest non-empty group with higher priority, or NULL if there is none.
+ */
+static struct os_task *
+os_sched_obj_group_prev(struct os_task_obj *obj, int grp)
+{
+    uint32_t mask;
+
+    mask = obj->obj_wq.wq_map & (((uint32_t)1 << grp) - 1);
+    if (mask == 0) {
+        return NULL;
+    }
+    return obj->obj_wq.wq_tail[31 - __builtin_clz(mask)];
+}
+#endif
+
+/**
+ * os sched obj insert
+ *
+ * Queue a task on the waiter list of an object (semaphore or mutex), after
+ * all waiters of higher or equal priority.
+ *
+ * @param obj   Object the task is going to wait on
+ * @param t     Task to queue
+ *
+ * NOTE: This function must be called with interrupts disabled.
+ */
+void
+os_sched_obj_insert(struct os_task_obj *obj, struct os_task *t)
+{
+    struct os_task *entry;
+    struct os_task *last;
+#if MYNEWT_VAL(OS_WAITQ_BUCKETS)
+    int grp;
+#endif
+
+    /*
+     * The task's priority can change while it waits (inheritance of a mutex
+     * it owns); the list stays ordered by the priority it was queued with.
+     */
+    t->t_obj_prio = t->t_prio;
+
+#if MYNEWT_VAL(OS_WAITQ_BUCKETS)
+    grp = OS_WAITQ_GROUP(t->t_obj_prio);
+    last = os_sched_obj_group_prev(obj, grp);
+    if (obj->obj_wq.wq_map & ((uint32_t)1 << grp)) {
+        /* Skip over waiters of the same group with higher or equal prio */
+        if (last) {
+            entry = SLIST_NEXT(last, t_obj_list);
+        } else {
+            entry = SLIST_FIRST(&obj->obj_head);
+        }
+        while (entry && entry->t_obj_prio <= t->t_obj_prio) {
+            last = entry;
+            entry = SLIST_NEXT(entry, t_obj_list);
+        }
+    }
+#else
+    last = NULL;
+    SLIST_FOREACH(entry, &obj->obj_head, t_obj_list) {
+        if (t->t_obj_prio < entry->t_obj_prio) {
+            break;
+        }
+        last = entry;
+    }
+#endif
+
+    if (last) {
+        SLIST_INSERT_AFTER(last, t, t_obj_list);
+    } else {
+        SLIST_INSERT_HEAD(&obj->obj_head, t, t_obj_list);
+    }
+
+#if MYNEWT_VAL(OS_WAITQ_BUCKETS)
+    entry = SLIST_NEXT(t, t_obj_list);
+    if (!entry || OS_WAITQ_GROUP(entry->t_obj_prio) != grp) {
+        obj->obj_wq.wq_tail[grp] = t;
+    }
+    obj->obj_wq.wq_map |= (uint32_t)1 << grp;
+#endif
+}
+
+/**
+ * os sched obj remove
+ *
+ * Remove a task from the waiter list of an object.
+ *
+ * @param obj   Object the task is waiting on
+ * @param t     Task to remove
+ *
+ * NOTE: This function must be called with interrupts disabled.
+ */
+void
+os_sched_obj_remove(struct os_task_obj *obj, struct os_task *t)
+{
+#if MYNEWT_VAL(OS_WAITQ_BUCKETS)
+    struct os_task *prev;
+    int grp;
+
+    grp = OS_WAITQ_GROUP(t->t_obj_prio);
+    if (SLIST_FIRST(&obj->obj_head) == t) {
+        prev = NULL;
+    } else {
+        prev = os_sched_obj_group_prev(obj, grp);
+        if (!prev) {
+            prev = SLIST_FIRST(&obj->obj_head);
+        }
+        while (SLIST_NEXT(prev, t_obj_list) != t) {
+            prev = SLIST_NEXT(prev, t_obj_list);
+            assert(prev != NULL);
+        }
+    }
+
+    if (prev) {
+        SLIST_NEXT(prev, t_obj_list) = SLIST_NEXT(t, t_obj_list);
+    } else {
+        SLIST_REMOVE_HEAD(&obj->obj_head, t_obj_list);
+    }
+
+    if (obj->obj_wq.wq_tail[grp] == t) {
+        if (prev && OS_WAITQ_GROUP(prev->t_obj_prio) == grp) {
+            obj->obj_wq.wq_tail[grp] = prev;
+        } else {
+            obj->obj_wq.wq_map &= ~((uint32_t)1 << grp);
+        }
+    }
+#else
+    SLIST_REMOVE(&obj->obj_head, t, os_task, t_obj_list);
+#endif
+    SLIST_NEXT(t, t_obj_list) = NULL;
+}
+
 /**
  * os sched wakeup
  *
@@ -243,8 +380,7 @@ os_sched_wakeup(struct os_task *t)
     if (t->t_obj) {
         os_obj = (struct os_task_obj *)t->t_obj;
         assert(!SLIST_EMPTY(&os_obj->obj_head));
-        SLIST_REMOVE(&os_obj->obj_head, t, os_task, t_obj_list);
-        SLIST_NEXT(t, t_obj_list) = NULL;
+        os_sched_obj_remove(os_obj, t);
         t->t_obj = NULL;
     }
 
@@ -18,6 +18,7 @@
  */
 
 #include "os/os.h"
+#include "os/os_trace_api.h"
 #include <assert.h>
 
 
@@ -55,6 +56,9 @@ os_sem_init(struct os_sem *sem, uint16_t tokens)
 
     sem->sem_tokens = tokens;
     SLIST_FIRST(&sem->sem_head) = NULL;
+#if MYNEWT_VAL(OS_WAITQ_BUCKETS)
+    sem->sem_wq.wq_map = 0;
+#endif
 
     return OS_OK;
 }
@@ -93,6 +97,7 @@ os_sem_release(struct os_sem *sem)
     current = os_sched_get_current_task();
 
     OS_ENTER_CRITICAL(sr);
+    os_trace_u32(OS_TRACE_ID_SEM_RELEASE, (uint32_t)(uintptr_t)sem);
 
     /* Check if tasks are waiting for the semaphore */
     rdy = SLIST_FIRST(&sem->sem_head);
@@ -149,8 +154,6 @@ os_sem_pend(struct os_sem *sem, uint32_t timeout)
     os_error_t rc;
     int sched;
     struct os_task *current;
-    struct os_task *entry;
-    struct os_task *last;
 
     /* Check if OS is started */
     if (!g_os_started) {
@@ -167,6 +170,7 @@ os_sem_pend(struct os_sem *sem, uint32_t timeout)
     current = os_sched_get_current_task();
 
     OS_ENTER_CRITICAL(sr);
+    os_trace_u32(OS_TRACE_ID_SEM_PEND, (uint32_t)(uintptr_t)sem);
 
     /*
      * If there is a token available, take it. If no token, either return
@@ -186,22 +190,7 @@ os_sem_pend(struct os_sem *sem, uint32_t timeout)
         /* Link current task to tasks waiting for semaphore */
         current->t_obj = sem;
         current->t_flags |= OS_TASK_FLAG_SEM_WAIT;
-        last = NULL;
-        if (!SLIST_EMPTY(&sem->sem_head)) {
-            /* Insert in priority order */
-            SLIST_FOREACH(entry, &sem->sem_head, t_obj_list) {
-                if (current->t_prio < entry->t_prio) {
-                    break;
-                }
-                last = entry;
-            }
-        }
-
-        if (last) {
-            SLIST_INSERT_AFTER(last, current, t_obj_list);
-        } else {
-            SLIST_INSERT_HEAD(&sem->sem_head, current, t_obj_list);
-        }
+        os_sched_obj_insert((struct os_task_obj *)sem, current);
 
         /* We will put this task to sleep */
         sched = 1;
@@ -222,6 +211,7 @@ os_sem_pend(struct os_sem *sem, uint32_t timeout)
             rc = OS_OK;
         }
     }
+    os_trace_end_call_return_value(OS_TRACE_ID_SEM_PEND, rc);
 
     return rc;
 }
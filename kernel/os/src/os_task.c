@@ -279,6 +279,19 @@ os_task_info_get_next(const struct os_task *prev, struct os_task_info *oti)
     oti->oti_last_checkin = next->t_sanity_check.sc_checkin_last;
     oti->oti_next_checkin = next->t_sanity_check.sc_checkin_last +
         next->t_sanity_check.sc_checkin_itvl;
+#if MYNEWT_VAL(OS_PROFILE)
+    oti->oti_cpu_usecs = os_profile_ticks_to_usecs(next->t_cpu_ticks);
+    oti->oti_cpu_burst_max_usecs =
+        os_profile_ticks_to_usecs(next->t_cpu_burst_max);
+    oti->oti_evq_lat_max_usecs =
+        os_profile_ticks_to_usecs(next->t_evq_lat_max);
+    if (next->t_evq_cnt != 0) {
+        oti->oti_evq_lat_avg_usecs = os_profile_ticks_to_usecs(
+            next->t_evq_lat_total / next->t_evq_cnt);
+    } else {
+        oti->oti_evq_lat_avg_usecs = 0;
+    }
+#endif
     strncpy(oti->oti_name, next->t_name, sizeof(oti->oti_name));
 
     return (next);
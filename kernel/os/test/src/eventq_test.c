@@ -23,6 +23,7 @@
 #include "os/os.h"
 #include "os_test_priv.h"
 #include "os/os_eventq.h"
+#include "console/console.h"
 
 /* Task 1 sending task */
 /* Define task stack and task object */
@@ -73,11 +74,22 @@ os_stack_t eventq_task_stack_poll_single_s[POLL_STACK_SIZE];
 struct os_task eventq_task_poll_single_r;
 os_stack_t eventq_task_stack_poll_single_r[POLL_STACK_SIZE];
 
+/* Task for the batch dequeue test */
+struct os_task eventq_task_b;
+os_stack_t eventq_task_stack_b[MY_STACK_SIZE];
+
+#define BATCH_EVENTS            (64)
+#define BATCH_ROUNDS            (100)
+
+static struct os_event batch_events[BATCH_EVENTS];
+static int batch_runs[BATCH_EVENTS];
+
 TEST_CASE_DECL(event_test_sr)
 TEST_CASE_DECL(event_test_poll_sr)
 TEST_CASE_DECL(event_test_poll_timeout_sr)
 TEST_CASE_DECL(event_test_poll_single_sr)
 TEST_CASE_DECL(event_test_poll_0timo)
+TEST_CASE_DECL(event_test_batch_sr)
 
 /* This is the task function  to send data */
 void
@@ -254,6 +266,115 @@ eventq_task_poll_single_receive(void *arg)
     os_test_restart();
 }
 
+static void
+batch_event_cb(struct os_event *ev)
+{
+    batch_runs[ev - batch_events]++;
+}
+
+/* Removes the next event, which is in the same batch */
+static void
+batch_event_remove_cb(struct os_event *ev)
+{
+    batch_event_cb(ev);
+    os_eventq_remove(&my_eventq, ev + 1);
+}
+
+/* Puts the next event again, while it waits in the same batch */
+static void
+batch_event_put_cb(struct os_event *ev)
+{
+    batch_event_cb(ev);
+    os_eventq_put(&my_eventq, ev + 1);
+}
+
+static void
+batch_events_put(int cnt, os_event_fn *cb)
+{
+    int i;
+
+    memset(batch_runs, 0, sizeof batch_runs);
+    for (i = 0; i < cnt; i++) {
+        batch_events[i].ev_cb = cb;
+        os_eventq_put(&my_eventq, batch_events + i);
+    }
+}
+
+/*
+ * Times BATCH_ROUNDS bursts of BATCH_EVENTS events, handled one at a time
+ * with os_eventq_run() and in batches with os_eventq_run_batch().
+ */
+void
+eventq_task_batch(void *arg)
+{
+    uint32_t single_usecs;
+    uint32_t batch_usecs;
+    uint32_t start;
+    int round;
+    int run;
+    int i;
+
+    /* Callbacks changing events of their batch */
+    batch_events_put(3, batch_event_cb);
+    batch_events[0].ev_cb = batch_event_remove_cb;
+    run = os_eventq_run_batch(&my_eventq, 3);
+    TEST_ASSERT(run == 2);
+    TEST_ASSERT(batch_runs[0] == 1 && batch_runs[1] == 0 &&
+                batch_runs[2] == 1);
+    TEST_ASSERT(!OS_EVENT_QUEUED(&batch_events[1]));
+
+    batch_events_put(2, batch_event_cb);
+    batch_events[0].ev_cb = batch_event_put_cb;
+    run = os_eventq_run_batch(&my_eventq, 2);
+    TEST_ASSERT(run == 2);
+    TEST_ASSERT(batch_runs[0] == 1 && batch_runs[1] == 1);
+    TEST_ASSERT(STAILQ_EMPTY(&my_eventq.evq_list));
+
+    /* Never more than asked for, in queue order */
+    batch_events_put(BATCH_EVENTS, batch_event_cb);
+    run = 0;
+    while (run < BATCH_EVENTS) {
+        i = os_eventq_run_batch(&my_eventq, 5);
+        TEST_ASSERT(i > 0 && i <= 5);
+        TEST_ASSERT(batch_runs[run + i - 1] == 1);
+        if (run + i < BATCH_EVENTS) {
+            TEST_ASSERT(batch_runs[run + i] == 0);
+        }
+        run += i;
+    }
+    TEST_ASSERT(run == BATCH_EVENTS);
+
+    single_usecs = 0;
+    batch_usecs = 0;
+    for (round = 0; round < BATCH_ROUNDS; round++) {
+        batch_events_put(BATCH_EVENTS, batch_event_cb);
+        start = tu_time_usecs();
+        for (i = 0; i < BATCH_EVENTS; i++) {
+            os_eventq_run(&my_eventq);
+        }
+        single_usecs += tu_time_usecs() - start;
+
+        batch_events_put(BATCH_EVENTS, batch_event_cb);
+        start = tu_time_usecs();
+        for (run = 0; run < BATCH_EVENTS; ) {
+            run += os_eventq_run_batch(&my_eventq, BATCH_EVENTS);
+        }
+        batch_usecs += tu_time_usecs() - start;
+
+        for (i = 0; i < BATCH_EVENTS; i++) {
+            TEST_ASSERT_FATAL(batch_runs[i] == 1);
+        }
+    }
+
+    console_printf("eventq: %d events: os_eventq_run %lu us, "
+                   "os_eventq_run_batch %lu us\n",
+                   BATCH_ROUNDS * BATCH_EVENTS,
+                   (unsigned long)single_usecs, (unsigned long)batch_usecs);
+
+    /* Finishes the test when OS has been started */
+    os_test_restart();
+}
+
 TEST_SUITE(os_eventq_test_suite)
 {
     event_test_sr();
@@ -261,4 +382,5 @@ TEST_SUITE(os_eventq_test_suite)
     event_test_poll_timeout_sr();
     event_test_poll_single_sr();
     event_test_poll_0timo();
+    event_test_batch_sr();
 }
@@ -96,6 +96,11 @@ extern os_stack_t eventq_task_stack_poll_single_s[POLL_STACK_SIZE];
 extern struct os_task eventq_task_poll_single_r;
 extern os_stack_t eventq_task_stack_poll_single_r[POLL_STACK_SIZE];
 
+/* Batch dequeue and its benchmark */
+#define BATCH_TASK_PRIO                 (INITIAL_EVENTQ_TASK_PRIO + 9)
+extern struct os_task eventq_task_b;
+extern os_stack_t eventq_task_stack_b[MY_STACK_SIZE];
+
 void eventq_task_send(void *arg);
 void eventq_task_receive(void *arg);
 void eventq_task_poll_send(void *arg);
@@ -104,6 +109,7 @@ void eventq_task_poll_timeout_send(void *arg);
 void eventq_task_poll_timeout_receive(void *arg);
 void eventq_task_poll_single_send(void *arg);
 void eventq_task_poll_single_receive(void *arg);
+void eventq_task_batch(void *arg);
 
 #ifdef __cplusplus
 }
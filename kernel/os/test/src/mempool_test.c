@@ -53,6 +53,7 @@ mempool_test_get_pool_size(int num_blocks, int block_size)
 #else
     mem_pool_size = (num_blocks * ((block_size + 7)/8) * sizeof(os_membuf_t));
 #endif
+    mem_pool_size += num_blocks * OS_MEMPOOL_GUARD_ELEMS * sizeof(os_membuf_t);
 
     return mem_pool_size;
 }
@@ -82,8 +83,10 @@ os_mempool_test_init(void *arg)
 }
 
 TEST_CASE_DECL(os_mempool_test_case)
+TEST_CASE_DECL(os_mempool_test_bulk)
 
 TEST_SUITE(os_mempool_test_suite)
 {
     os_mempool_test_case();
+    os_mempool_test_bulk();
 }
@@ -322,6 +322,7 @@ TEST_CASE_DECL(os_sem_test_case_1)
 TEST_CASE_DECL(os_sem_test_case_2)
 TEST_CASE_DECL(os_sem_test_case_3)
 TEST_CASE_DECL(os_sem_test_case_4)
+TEST_CASE_DECL(os_sem_test_waitq)
 
 TEST_SUITE(os_sem_test_suite)
 {
@@ -344,4 +345,8 @@ TEST_SUITE(os_sem_test_suite)
     tu_case_set_pre_cb(os_sem_tc_pretest, NULL);
     tu_case_set_post_cb(os_sem_tc_posttest, NULL);
     os_sem_test_case_4();
+
+    tu_case_set_pre_cb(os_sem_tc_pretest, NULL);
+    tu_case_set_post_cb(os_sem_tc_posttest, NULL);
+    os_sem_test_waitq();
 }
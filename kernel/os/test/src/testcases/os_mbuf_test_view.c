@@ -0,0 +1,71 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ * 
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+TEST_CASE(os_mbuf_test_view)
+{
+    struct os_mbuf *om;
+    struct os_mbuf *om2;
+    uint8_t scratch[64];
+    uint8_t *data;
+    int num_free;
+    int rc;
+
+    os_mbuf_test_setup();
+
+    /*** Empty chain. */
+    om = os_mbuf_get_pkthdr(&os_mbuf_pool, 10);
+    TEST_ASSERT_FATAL(om != NULL);
+
+    TEST_ASSERT(os_mbuf_view(om, 0, 1, scratch) == NULL);
+
+    /*** Two mbufs of 20 bytes each. */
+    rc = os_mbuf_append(om, os_mbuf_test_data, 20);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    om2 = os_mbuf_get(&os_mbuf_pool, 0);
+    TEST_ASSERT_FATAL(om2 != NULL);
+    rc = os_mbuf_append(om2, os_mbuf_test_data + 20, 20);
+    TEST_ASSERT_FATAL(rc == 0);
+    os_mbuf_concat(om, om2);
+
+    num_free = os_mbuf_mempool.mp_num_free;
+
+    /* Within one mbuf; points into it. */
+    data = os_mbuf_view(om, 4, 16, scratch);
+    TEST_ASSERT(data == om->om_data + 4);
+    data = os_mbuf_view(om, 25, 15, scratch);
+    TEST_ASSERT(data == om2->om_data + 5);
+
+    /* Across the two; copied. */
+    memset(scratch, 0, sizeof scratch);
+    data = os_mbuf_view(om, 10, 20, scratch);
+    TEST_ASSERT(data == scratch);
+    TEST_ASSERT(memcmp(data, os_mbuf_test_data + 10, 20) == 0);
+
+    /* Past the end. */
+    TEST_ASSERT(os_mbuf_view(om, 30, 11, scratch) == NULL);
+    TEST_ASSERT(os_mbuf_view(om, 41, 1, scratch) == NULL);
+
+    /* Nothing allocated or changed. */
+    TEST_ASSERT(os_mbuf_mempool.mp_num_free == num_free);
+    os_mbuf_test_misc_assert_sane(om, os_mbuf_test_data, 20, 40, 18);
+
+    os_mbuf_free_chain(om);
+}
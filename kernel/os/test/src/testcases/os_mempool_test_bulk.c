@@ -0,0 +1,183 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ * 
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "console/console.h"
+#include "os_test_priv.h"
+
+#define MEMPOOL_BULK_BLOCKS     (64)
+#define MEMPOOL_BULK_BATCH      (16)
+#define MEMPOOL_BULK_ROUNDS     (500)
+
+static struct os_mempool mempool_bulk_pool;
+static os_membuf_t
+    mempool_bulk_mem[OS_MEMPOOL_SIZE(MEMPOOL_BULK_BLOCKS, MEM_BLOCK_SIZE)];
+static void *mempool_bulk_blocks[MEMPOOL_BULK_BLOCKS];
+
+/*
+ * Takes and frees MEMPOOL_BULK_BATCH blocks at a time, either one by one or
+ * with the bulk calls, and returns the time it took, in usecs.
+ */
+static uint32_t
+mempool_bulk_run(int bulk)
+{
+    uint32_t start;
+    int round;
+    int rc;
+    int i;
+
+    start = tu_time_usecs();
+    for (round = 0; round < MEMPOOL_BULK_ROUNDS; round++) {
+        if (bulk) {
+            rc = os_memblock_get_n(&mempool_bulk_pool, mempool_bulk_blocks,
+                                   MEMPOOL_BULK_BATCH);
+            TEST_ASSERT_FATAL(rc == MEMPOOL_BULK_BATCH);
+            rc = os_memblock_put_n(&mempool_bulk_pool, mempool_bulk_blocks,
+                                   MEMPOOL_BULK_BATCH);
+            TEST_ASSERT_FATAL(rc == 0);
+        } else {
+            for (i = 0; i < MEMPOOL_BULK_BATCH; i++) {
+                mempool_bulk_blocks[i] = os_memblock_get(&mempool_bulk_pool);
+                TEST_ASSERT_FATAL(mempool_bulk_blocks[i] != NULL);
+            }
+            for (i = 0; i < MEMPOOL_BULK_BATCH; i++) {
+                rc = os_memblock_put(&mempool_bulk_pool,
+                                     mempool_bulk_blocks[i]);
+                TEST_ASSERT_FATAL(rc == 0);
+            }
+        }
+    }
+
+    return tu_time_usecs() - start;
+}
+
+static void
+mempool_bulk_bench(const char *name, int bulk)
+{
+    uint32_t usecs;
+#if MYNEWT_VAL(OS_PROFILE)
+    struct os_profile_info opi;
+
+    os_profile_reset();
+#endif
+
+    usecs = mempool_bulk_run(bulk);
+    TEST_ASSERT(mempool_bulk_pool.mp_num_free == MEMPOOL_BULK_BLOCKS);
+
+    console_printf("mempool %s: %d blocks in %lu us\n", name,
+                   2 * MEMPOOL_BULK_ROUNDS * MEMPOOL_BULK_BATCH,
+                   (unsigned long)usecs);
+
+#if MYNEWT_VAL(OS_PROFILE)
+    /*
+     * Only the count: the profiler times sections with os_cputime, which
+     * cannot resolve them in the simulator.
+     */
+    os_profile_info_get(&opi);
+    console_printf("mempool %s: %lu critical sections\n", name,
+                   (unsigned long)opi.opi_crit_cnt);
+#endif
+}
+
+TEST_CASE(os_mempool_test_bulk)
+{
+    void *bad[2];
+    int cnt;
+    int rc;
+    int i;
+
+    rc = os_mempool_init(&mempool_bulk_pool, MEMPOOL_BULK_BLOCKS,
+                         MEM_BLOCK_SIZE, mempool_bulk_mem, "BulkPool");
+    TEST_ASSERT_FATAL(rc == 0);
+
+    /* Bad arguments */
+    TEST_ASSERT(os_memblock_get_n(NULL, mempool_bulk_blocks, 1) == 0);
+    TEST_ASSERT(os_memblock_get_n(&mempool_bulk_pool, NULL, 1) == 0);
+    TEST_ASSERT(os_memblock_get_n(&mempool_bulk_pool,
+                                  mempool_bulk_blocks, 0) == 0);
+    TEST_ASSERT(os_memblock_put_n(NULL, mempool_bulk_blocks, 1) ==
+                OS_INVALID_PARM);
+    TEST_ASSERT(os_memblock_put_n(&mempool_bulk_pool,
+                                  mempool_bulk_blocks, 0) == 0);
+
+    /* Blocks come off the free list in order */
+    cnt = os_memblock_get_n(&mempool_bulk_pool, mempool_bulk_blocks, 4);
+    TEST_ASSERT_FATAL(cnt == 4);
+    TEST_ASSERT(mempool_bulk_pool.mp_num_free == MEMPOOL_BULK_BLOCKS - 4);
+    TEST_ASSERT(mempool_bulk_pool.mp_min_free == MEMPOOL_BULK_BLOCKS - 4);
+    for (i = 0; i < cnt; i++) {
+        TEST_ASSERT(os_memblock_from(&mempool_bulk_pool,
+                                     mempool_bulk_blocks[i]));
+        TEST_ASSERT(i == 0 ||
+                    mempool_bulk_blocks[i] != mempool_bulk_blocks[i - 1]);
+    }
+
+    /* Asking for more than is left gets the rest */
+    cnt = os_memblock_get_n(&mempool_bulk_pool, mempool_bulk_blocks + 4,
+                            MEMPOOL_BULK_BLOCKS);
+    TEST_ASSERT_FATAL(cnt == MEMPOOL_BULK_BLOCKS - 4);
+    TEST_ASSERT(mempool_bulk_pool.mp_num_free == 0);
+    TEST_ASSERT(SLIST_FIRST(&mempool_bulk_pool) == NULL);
+    TEST_ASSERT(os_memblock_get_n(&mempool_bulk_pool, bad, 2) == 0);
+    TEST_ASSERT(os_memblock_get(&mempool_bulk_pool) == NULL);
+
+    /* A block from elsewhere fails the whole put */
+    bad[0] = mempool_bulk_blocks[0];
+    bad[1] = (uint8_t *)mempool_bulk_blocks[1] + 1;
+    TEST_ASSERT(os_memblock_put_n(&mempool_bulk_pool, bad, 2) ==
+                OS_INVALID_PARM);
+    TEST_ASSERT(mempool_bulk_pool.mp_num_free == 0);
+
+    /* Put back in two batches; all of them can be taken again */
+    rc = os_memblock_put_n(&mempool_bulk_pool, mempool_bulk_blocks, 10);
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = os_memblock_put_n(&mempool_bulk_pool, mempool_bulk_blocks + 10,
+                           MEMPOOL_BULK_BLOCKS - 10);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(mempool_bulk_pool.mp_num_free == MEMPOOL_BULK_BLOCKS);
+    TEST_ASSERT(mempool_bulk_pool.mp_min_free == 0);
+
+    cnt = os_memblock_get_n(&mempool_bulk_pool, mempool_bulk_blocks,
+                            MEMPOOL_BULK_BLOCKS);
+    TEST_ASSERT(cnt == MEMPOOL_BULK_BLOCKS);
+    rc = os_memblock_put_n(&mempool_bulk_pool, mempool_bulk_blocks, cnt);
+    TEST_ASSERT_FATAL(rc == 0);
+
+#if MYNEWT_VAL(OS_MEMPOOL_GUARD)
+    /* Blocks can be written in full; freed blocks are poisoned */
+    os_mempool_guard_set(&mempool_bulk_pool, 1);
+    cnt = os_memblock_get_n(&mempool_bulk_pool, mempool_bulk_blocks, 2);
+    TEST_ASSERT_FATAL(cnt == 2);
+    memset(mempool_bulk_blocks[0], 0, MEM_BLOCK_SIZE);
+    memset(mempool_bulk_blocks[1], 0, MEM_BLOCK_SIZE);
+    rc = os_memblock_put(&mempool_bulk_pool, mempool_bulk_blocks[0]);
+    TEST_ASSERT(rc == 0);
+    rc = os_memblock_put_n(&mempool_bulk_pool, mempool_bulk_blocks + 1, 1);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(((uint8_t *)mempool_bulk_blocks[0])[MEM_BLOCK_SIZE - 1] ==
+                0xde);
+    TEST_ASSERT(((uint8_t *)mempool_bulk_blocks[1])[MEM_BLOCK_SIZE - 1] ==
+                0xde);
+
+    mempool_bulk_bench("guarded single", 0);
+    mempool_bulk_bench("guarded bulk", 1);
+    os_mempool_guard_set(&mempool_bulk_pool, 0);
+#endif
+
+    mempool_bulk_bench("single", 0);
+    mempool_bulk_bench("bulk", 1);
+}
@@ -61,6 +61,7 @@ mempool_test(int num_blocks, int block_size)
 #else
     true_block_size = (g_TstMempool.mp_block_size + 7) & ~7;
 #endif
+    true_block_size += OS_MEMPOOL_GUARD_ELEMS * sizeof(os_membuf_t);
 
     /* Traverse free list. Better add up to number of blocks! */
     cnt = 0;
@@ -0,0 +1,139 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ * 
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+#define MSYS_TEST_SMALL_BUF_SIZE    (64 + sizeof(struct os_mbuf))
+#define MSYS_TEST_SMALL_BUF_COUNT   (8)
+#define MSYS_TEST_LARGE_BUF_SIZE    (256 + sizeof(struct os_mbuf))
+#define MSYS_TEST_LARGE_BUF_COUNT   (2)
+
+static os_membuf_t msys_test_small_membuf[
+    OS_MEMPOOL_SIZE(MSYS_TEST_SMALL_BUF_COUNT, MSYS_TEST_SMALL_BUF_SIZE)];
+static os_membuf_t msys_test_large_membuf[
+    OS_MEMPOOL_SIZE(MSYS_TEST_LARGE_BUF_COUNT, MSYS_TEST_LARGE_BUF_SIZE)];
+
+static struct os_mempool msys_test_small_mempool;
+static struct os_mempool msys_test_large_mempool;
+static struct os_mbuf_pool msys_test_small_pool;
+static struct os_mbuf_pool msys_test_large_pool;
+
+static struct os_mbuf_pool *msys_test_pressure_pool;
+static int msys_test_pressure_level;
+static int msys_test_pressure_cnt;
+
+static void
+msys_test_pressure_cb(struct os_mbuf_pool *omp, int level, void *arg)
+{
+    TEST_ASSERT(arg == &msys_test_pressure_cnt);
+
+    msys_test_pressure_pool = omp;
+    msys_test_pressure_level = level;
+    msys_test_pressure_cnt++;
+}
+
+TEST_CASE(os_msys_test_fallback)
+{
+    struct os_msys_pressure_listener listener;
+    struct os_mbuf *small[MSYS_TEST_SMALL_BUF_COUNT];
+    struct os_mbuf *m;
+    int low_wm;
+    int rc;
+    int i;
+
+    os_msys_reset();
+
+    rc = os_mempool_init(&msys_test_small_mempool, MSYS_TEST_SMALL_BUF_COUNT,
+                         MSYS_TEST_SMALL_BUF_SIZE, msys_test_small_membuf,
+                         "msys_test_small");
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = os_mbuf_pool_init(&msys_test_small_pool, &msys_test_small_mempool,
+                           MSYS_TEST_SMALL_BUF_SIZE, MSYS_TEST_SMALL_BUF_COUNT);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    rc = os_mempool_init(&msys_test_large_mempool, MSYS_TEST_LARGE_BUF_COUNT,
+                         MSYS_TEST_LARGE_BUF_SIZE, msys_test_large_membuf,
+                         "msys_test_large");
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = os_mbuf_pool_init(&msys_test_large_pool, &msys_test_large_mempool,
+                           MSYS_TEST_LARGE_BUF_SIZE, MSYS_TEST_LARGE_BUF_COUNT);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    /* Registration order does not matter; best fit is the smallest pool */
+    rc = os_msys_register(&msys_test_large_pool);
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = os_msys_register(&msys_test_small_pool);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    listener.ompl_cb = msys_test_pressure_cb;
+    listener.ompl_arg = &msys_test_pressure_cnt;
+    rc = os_msys_pressure_register(&listener);
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = os_msys_pressure_register(&listener);
+    TEST_ASSERT(rc == OS_EINVAL);
+
+    low_wm = MSYS_TEST_SMALL_BUF_COUNT *
+             MYNEWT_VAL(MSYS_LOW_WATERMARK_PCT) / 100;
+
+    /* Use up the small pool; low, then empty */
+    msys_test_pressure_cnt = 0;
+    for (i = 0; i < MSYS_TEST_SMALL_BUF_COUNT; i++) {
+        small[i] = os_msys_get(10, 0);
+        TEST_ASSERT_FATAL(small[i] != NULL);
+        TEST_ASSERT(small[i]->om_omp == &msys_test_small_pool);
+
+        if (MSYS_TEST_SMALL_BUF_COUNT - i - 1 == 0) {
+            TEST_ASSERT(msys_test_pressure_level == OS_MSYS_PRESSURE_EMPTY);
+        } else if (MSYS_TEST_SMALL_BUF_COUNT - i - 1 < low_wm) {
+            TEST_ASSERT(msys_test_pressure_level == OS_MSYS_PRESSURE_LOW);
+        } else {
+            TEST_ASSERT(msys_test_pressure_cnt == 0);
+        }
+    }
+    TEST_ASSERT(msys_test_pressure_pool == &msys_test_small_pool);
+    TEST_ASSERT(msys_test_pressure_cnt == (low_wm > 1 ? 2 : 1));
+
+    /* Best fit is empty */
+    m = os_msys_get_pkthdr(10, 0);
+    TEST_ASSERT(msys_test_small_pool.omp_fail_cnt == 1);
+#if MYNEWT_VAL(MSYS_FALLBACK) >= 1
+    TEST_ASSERT_FATAL(m != NULL);
+    TEST_ASSERT(m->om_omp == &msys_test_large_pool);
+    TEST_ASSERT(OS_MBUF_IS_PKTHDR(m));
+    TEST_ASSERT(msys_test_large_pool.omp_fallback_cnt == 1);
+    os_mbuf_free_chain(m);
+#else
+    TEST_ASSERT(m == NULL);
+#endif
+
+    /* Back to the low watermark */
+    msys_test_pressure_cnt = 0;
+    for (i = 0; i < MSYS_TEST_SMALL_BUF_COUNT; i++) {
+        rc = os_mbuf_free(small[i]);
+        TEST_ASSERT(rc == 0);
+    }
+    TEST_ASSERT(msys_test_pressure_level == OS_MSYS_PRESSURE_NONE);
+    TEST_ASSERT(msys_test_pressure_pool == &msys_test_small_pool);
+
+    rc = os_msys_pressure_unregister(&listener);
+    TEST_ASSERT(rc == 0);
+    rc = os_msys_pressure_unregister(&listener);
+    TEST_ASSERT(rc == OS_ENOENT);
+
+    os_msys_reset();
+}
@@ -0,0 +1,168 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ * 
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "console/console.h"
+#include "os_test_priv.h"
+
+/*
+ * Contention benchmark for the semaphore waiter list.  A set of tasks, with
+ * priorities spread over most of the priority range, wait on a semaphore.
+ * A lower priority driver task then repeatedly releases all of them at
+ * once.  The woken tasks run highest priority first and each pends again,
+ * queueing behind the ones that already did; a linear waiter list is walked
+ * to its end on every one of these pends.  After every round the waiter
+ * list must be back in priority order.
+ *
+ * kernel/os/test runs this with the linear list and kernel/os/test-waitq
+ * with OS_WAITQ_BUCKETS enabled; compare the times the two print.
+ */
+
+#if MYNEWT_VAL(SELFTEST)
+
+#define SEM_WAITQ_MAX_TASKS     (64)
+#define SEM_WAITQ_ROUNDS        (200)
+#define SEM_WAITQ_STACK_SIZE    OS_STACK_ALIGN(1024)
+#define SEM_WAITQ_DRIVER_PRIO   (250)
+
+static struct os_sem sem_waitq_sem;
+static struct os_task sem_waitq_tasks[SEM_WAITQ_MAX_TASKS];
+static os_stack_t *sem_waitq_stacks[SEM_WAITQ_MAX_TASKS];
+static struct os_task sem_waitq_driver;
+static os_stack_t *sem_waitq_driver_stack;
+
+/*
+ * Priorities 2, 5, ..., 191 in a scrambled order; none of them is the
+ * main task's.
+ */
+static uint8_t
+sem_waitq_prio(int i)
+{
+    return 2 + ((i * 37) % SEM_WAITQ_MAX_TASKS) * 3;
+}
+
+static void
+sem_waitq_task_handler(void *arg)
+{
+    os_error_t err;
+
+    while (1) {
+        err = os_sem_pend(&sem_waitq_sem, OS_TIMEOUT_NEVER);
+        TEST_ASSERT(err == OS_OK);
+    }
+}
+
+static void
+sem_waitq_verify(void)
+{
+    struct os_task *prev;
+    struct os_task *t;
+    int cnt;
+#if MYNEWT_VAL(OS_WAITQ_BUCKETS)
+    struct os_task *next;
+    uint32_t map;
+    int grp;
+#endif
+
+    cnt = 0;
+    prev = NULL;
+    SLIST_FOREACH(t, &sem_waitq_sem.sem_head, t_obj_list) {
+        TEST_ASSERT_FATAL(prev == NULL || prev->t_obj_prio < t->t_obj_prio);
+        prev = t;
+        cnt++;
+    }
+    TEST_ASSERT_FATAL(cnt == SEM_WAITQ_MAX_TASKS);
+
+#if MYNEWT_VAL(OS_WAITQ_BUCKETS)
+    /* Every group with waiters is marked, and its tail is its last one */
+    map = 0;
+    SLIST_FOREACH(t, &sem_waitq_sem.sem_head, t_obj_list) {
+        grp = OS_WAITQ_GROUP(t->t_obj_prio);
+        map |= (uint32_t)1 << grp;
+        next = SLIST_NEXT(t, t_obj_list);
+        if (!next || OS_WAITQ_GROUP(next->t_obj_prio) != grp) {
+            TEST_ASSERT_FATAL(sem_waitq_sem.sem_wq.wq_tail[grp] == t);
+        }
+    }
+    TEST_ASSERT_FATAL(sem_waitq_sem.sem_wq.wq_map == map);
+#endif
+}
+
+static void
+sem_waitq_driver_handler(void *arg)
+{
+    uint32_t usecs;
+    os_sr_t sr;
+    int i;
+    int j;
+
+    /* All waiters have higher priority, so they are all waiting by now */
+    sem_waitq_verify();
+
+    usecs = tu_time_usecs();
+    for (i = 0; i < SEM_WAITQ_ROUNDS; i++) {
+        /* Wake them all before any of them gets to run */
+        OS_ENTER_CRITICAL(sr);
+        for (j = 0; j < SEM_WAITQ_MAX_TASKS; j++) {
+            TEST_ASSERT_FATAL(os_sem_release(&sem_waitq_sem) == OS_OK);
+        }
+        OS_EXIT_CRITICAL(sr);
+
+        TEST_ASSERT_FATAL(sem_waitq_sem.sem_tokens == 0);
+        sem_waitq_verify();
+    }
+    usecs = tu_time_usecs() - usecs;
+
+    console_printf("sem waiters (%s): %d tasks, %d pends: %lu us\n",
+                   MYNEWT_VAL(OS_WAITQ_BUCKETS) ? "buckets" : "linear",
+                   SEM_WAITQ_MAX_TASKS,
+                   SEM_WAITQ_MAX_TASKS * SEM_WAITQ_ROUNDS,
+                   (unsigned long)usecs);
+
+    os_test_restart();
+}
+#endif
+
+TEST_CASE(os_sem_test_waitq)
+{
+#if MYNEWT_VAL(SELFTEST)
+    int i;
+
+    TEST_ASSERT_FATAL(os_sem_init(&sem_waitq_sem, 0) == OS_OK);
+
+    for (i = 0; i < SEM_WAITQ_MAX_TASKS; i++) {
+        if (sem_waitq_stacks[i] == NULL) {
+            sem_waitq_stacks[i] =
+                malloc(sizeof(os_stack_t) * SEM_WAITQ_STACK_SIZE);
+            TEST_ASSERT_FATAL(sem_waitq_stacks[i] != NULL);
+        }
+        os_task_init(&sem_waitq_tasks[i], "waiter", sem_waitq_task_handler,
+                     NULL, sem_waitq_prio(i), OS_WAIT_FOREVER,
+                     sem_waitq_stacks[i], SEM_WAITQ_STACK_SIZE);
+    }
+
+    if (sem_waitq_driver_stack == NULL) {
+        sem_waitq_driver_stack =
+            malloc(sizeof(os_stack_t) * SEM_WAITQ_STACK_SIZE);
+        TEST_ASSERT_FATAL(sem_waitq_driver_stack != NULL);
+    }
+    os_task_init(&sem_waitq_driver, "driver", sem_waitq_driver_handler, NULL,
+                 SEM_WAITQ_DRIVER_PRIO, OS_WAIT_FOREVER,
+                 sem_waitq_driver_stack, SEM_WAITQ_STACK_SIZE);
+#endif
+}
@@ -48,6 +48,19 @@ os_sr_t sim_save_sr(void);
 void sim_restore_sr(os_sr_t osr);
 int sim_in_critical(void);
 void sim_tick_idle(os_time_t ticks);
+/*
+ * Interrupts raised by host threads.  A handler registered with
+ * sim_intr_register() runs in interrupt context (i.e., in a critical
+ * section) soon after sim_intr_raise() is called with its number.
+ */
+#define SIM_INTR_MAX    32
+
+typedef void sim_intr_handler_t(void *arg);
+
+int sim_intr_register(sim_intr_handler_t *handler, void *arg);
+void sim_intr_raise(int irq);
+int sim_thread_create(void *(*func)(void *), void *arg);
+
 void sim_assert_fail(const char *file, int line, const char *func,
                      const char *e)
                      __attribute((noreturn));
@@ -20,6 +20,7 @@
 #ifndef H_SIM_PRIV_
 #define H_SIM_PRIV_
 
+#include <signal.h>
 #include <os/os.h>
 
 #ifdef __cplusplus
@@ -28,8 +29,13 @@ extern "C" {
 
 #define OS_USEC_PER_TICK    (1000000 / OS_TICKS_PER_SEC)
 
+/* Signal that host threads raise interrupts with. */
+#define SIM_INTR_SIGNAL     SIGIO
+
 void sim_switch_tasks(void);
 void sim_tick(void);
+int sim_intr_dispatch(void);
+int sim_virt_tick_idle(os_time_t ticks);
 void sim_signals_init(void);
 void sim_signals_cleanup(void);
 
@@ -37,6 +37,7 @@
 #include <signal.h>
 #include <sys/time.h>
 #include <assert.h>
+#include <pthread.h>
 #include "sim/sim.h"
 #include "sim_priv.h"
 
@@ -45,6 +46,15 @@
 
 pid_t sim_pid;
 
+static struct {
+    sim_intr_handler_t *handler;
+    void *arg;
+} sim_intrs[SIM_INTR_MAX];
+static int sim_intr_cnt;
+
+/* Raised interrupts not handled yet; set by host threads. */
+static uint32_t sim_intr_pending;
+
 void
 sim_switch_tasks(void)
 {
@@ -121,12 +131,147 @@ sim_tick(void)
     }
 }
 
+/**
+ * Registers a handler for an interrupt raised by a host thread.  Must be
+ * called from the OS, e.g. at init time.
+ *
+ * @return                      The interrupt number on success; -1 if all
+ *                                  interrupts are taken.
+ */
+int
+sim_intr_register(sim_intr_handler_t *handler, void *arg)
+{
+    os_sr_t sr;
+    int irq;
+
+    OS_ENTER_CRITICAL(sr);
+    if (sim_intr_cnt >= SIM_INTR_MAX) {
+        irq = -1;
+    } else {
+        irq = sim_intr_cnt++;
+        sim_intrs[irq].handler = handler;
+        sim_intrs[irq].arg = arg;
+    }
+    OS_EXIT_CRITICAL(sr);
+
+    return irq;
+}
+
+/**
+ * Raises an interrupt.  Safe to call from any host thread; the handler runs
+ * on the OS side as soon as interrupts are enabled (with the no-signals sim,
+ * when the OS next goes idle).
+ */
+void
+sim_intr_raise(int irq)
+{
+    assert(irq >= 0 && irq < SIM_INTR_MAX);
+
+    __atomic_fetch_or(&sim_intr_pending, (uint32_t)1 << irq,
+                      __ATOMIC_SEQ_CST);
+    kill(sim_pid, SIM_INTR_SIGNAL);
+}
+
+/*
+ * Runs the handlers of the raised interrupts.  Called from the signal
+ * handler, or after the idle task wakes up.
+ *
+ * Returns the number of handlers run.
+ */
+int
+sim_intr_dispatch(void)
+{
+    uint32_t pending;
+    int cnt;
+    int irq;
+
+    OS_ASSERT_CRITICAL();
+
+    cnt = 0;
+    pending = __atomic_exchange_n(&sim_intr_pending, 0, __ATOMIC_SEQ_CST);
+    while (pending != 0) {
+        irq = __builtin_ctz(pending);
+        pending &= pending - 1;
+        sim_intrs[irq].handler(sim_intrs[irq].arg);
+        cnt++;
+    }
+
+    return cnt;
+}
+
+#if MYNEWT_VAL(MCU_NATIVE_VIRTUAL_TIME)
+/*
+ * Idles in virtual time: rather than waiting for the timer, jump the OS
+ * clock straight to the next wakeup.  A wakeup closer than the minimum idle
+ * time (ticks == 0) is one tick away.  Interrupts raised by host threads are
+ * handled first, without advancing time, as they may make a task runnable.
+ *
+ * Returns 0 if the OS has something to do now; -1 if no task or callout is
+ * waiting for a time, in which case the caller waits for an interrupt with
+ * the clock stopped.
+ */
+int
+sim_virt_tick_idle(os_time_t ticks)
+{
+    os_time_t now;
+
+    OS_ASSERT_CRITICAL();
+
+    if (sim_intr_dispatch() != 0) {
+        return 0;
+    }
+
+    /* Only the sanity check would wake us; don't let time run for it. */
+    now = os_time_get();
+    if (os_sched_wakeup_ticks(now) == OS_TIMEOUT_NEVER &&
+        os_callout_wakeup_ticks(now) == OS_TIMEOUT_NEVER) {
+        return -1;
+    }
+
+    if (ticks == 0) {
+        ticks = 1;
+    }
+    os_time_advance(ticks);
+    return 0;
+}
+#endif
+
+/**
+ * Starts a detached host thread, e.g. one that waits for I/O and raises an
+ * interrupt when there is some.  The thread runs with all signals blocked,
+ * so that the tick, context switch and interrupt signals are only delivered
+ * to the OS.  The thread must not call into the OS other than with
+ * sim_intr_raise().
+ *
+ * @return                      0 on success; -1 on failure.
+ */
+int
+sim_thread_create(void *(*func)(void *), void *arg)
+{
+    sigset_t allsigs;
+    sigset_t omask;
+    pthread_t thread;
+    int rc;
+
+    sigfillset(&allsigs);
+    pthread_sigmask(SIG_SETMASK, &allsigs, &omask);
+    rc = pthread_create(&thread, NULL, func, arg);
+    pthread_sigmask(SIG_SETMASK, &omask, NULL);
+    if (rc != 0) {
+        return -1;
+    }
+
+    pthread_detach(thread);
+    return 0;
+}
+
 static void
 sim_start_timer(void)
 {
     struct itimerval it;
     int rc;
 
+#if !MYNEWT_VAL(MCU_NATIVE_VIRTUAL_TIME)
     memset(&it, 0, sizeof(it));
     it.it_value.tv_sec = 0;
     it.it_value.tv_usec = OS_USEC_PER_TICK;
@@ -135,6 +280,11 @@ sim_start_timer(void)
 
     rc = setitimer(ITIMER_REAL, &it, NULL);
     assert(rc == 0);
+#else
+    /* Time only advances when the OS is idle; see sim_virt_tick_idle(). */
+    (void)it;
+    (void)rc;
+#endif
 }
 
 static void
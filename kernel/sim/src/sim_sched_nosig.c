@@ -115,7 +115,8 @@ sim_in_critical(void)
 }
 
 /**
- * Unblocks the SIGALRM signal that is delivered by the OS tick timer.
+ * Unblocks the SIGALRM signal that is delivered by the OS tick timer, and
+ * the signal that host threads raise interrupts with.
  */
 static void
 unblock_timer(void)
@@ -125,13 +126,15 @@ unblock_timer(void)
 
     sigemptyset(&sigs);
     sigaddset(&sigs, SIGALRM);
+    sigaddset(&sigs, SIM_INTR_SIGNAL);
 
     rc = sigprocmask(SIG_UNBLOCK, &sigs, NULL);
     assert(rc == 0);
 }
 
 /**
- * Blocks the SIGALRM signal that is delivered by the OS tick timer.
+ * Blocks the SIGALRM signal that is delivered by the OS tick timer, and the
+ * signal that host threads raise interrupts with.
  */
 static void
 block_timer(void)
@@ -141,6 +144,7 @@ block_timer(void)
 
     sigemptyset(&sigs);
     sigaddset(&sigs, SIGALRM);
+    sigaddset(&sigs, SIM_INTR_SIGNAL);
 
     rc = sigprocmask(SIG_BLOCK, &sigs, NULL);
     assert(rc == 0);
@@ -153,6 +157,13 @@ sig_handler_alrm(int sig)
     sigaddset(&suspsigs, sig);
 }
 
+static void
+sig_handler_intr(int sig)
+{
+    /* Wake the idle task; the interrupts are handled once it runs. */
+    sigaddset(&suspsigs, sig);
+}
+
 void
 sim_tick_idle(os_time_t ticks)
 {
@@ -161,6 +172,14 @@ sim_tick_idle(os_time_t ticks)
 
     OS_ASSERT_CRITICAL();
 
+#if MYNEWT_VAL(MCU_NATIVE_VIRTUAL_TIME)
+    if (sim_virt_tick_idle(ticks) == 0) {
+        return;
+    }
+    /* Nothing is due; wait for host input without starting the timer. */
+    ticks = 0;
+#endif
+
     if (ticks > 0) {
         /*
          * Enter tickless regime and set the timer to fire after 'ticks'
@@ -189,6 +208,9 @@ sim_tick_idle(os_time_t ticks)
     if (sigismember(&suspsigs, SIGALRM)) {
         sim_tick();
     }
+    if (sigismember(&suspsigs, SIM_INTR_SIGNAL)) {
+        sim_intr_dispatch();
+    }
 
     if (ticks > 0) {
         /*
@@ -216,6 +238,7 @@ sim_signals_init(void)
 
     sigemptyset(&sigset_alrm);
     sigaddset(&sigset_alrm, SIGALRM);
+    sigaddset(&sigset_alrm, SIM_INTR_SIGNAL);
 
     memset(&sa, 0, sizeof sa);
     sa.sa_handler = sig_handler_alrm;
@@ -223,6 +246,13 @@ sim_signals_init(void)
     sa.sa_flags = SA_RESTART;
     error = sigaction(SIGALRM, &sa, NULL);
     assert(error == 0);
+
+    memset(&sa, 0, sizeof sa);
+    sa.sa_handler = sig_handler_intr;
+    sa.sa_mask = sigset_alrm;
+    sa.sa_flags = SA_RESTART;
+    error = sigaction(SIM_INTR_SIGNAL, &sa, NULL);
+    assert(error == 0);
 }
 
 void
@@ -235,6 +265,8 @@ sim_signals_cleanup(void)
     sa.sa_handler = SIG_DFL;
     error = sigaction(SIGALRM, &sa, NULL);
     assert(error == 0);
+    error = sigaction(SIM_INTR_SIGNAL, &sa, NULL);
+    assert(error == 0);
 }
 
 #endif /* !MYNEWT_VAL(MCU_NATIVE_USE_SIGNALS) */
@@ -153,12 +153,25 @@ timer_handler(int sig)
     }
 }
 
+static void
+intr_handler(int sig)
+{
+    OS_ASSERT_CRITICAL();
+
+    if (suspended) {
+        sigaddset(&suspsigs, sig);
+    } else {
+        sim_intr_dispatch();
+    }
+}
+
 static struct {
     int num;
     void (*handler)(int sig);
 } signals[] = {
     { SIGALRM, timer_handler },
     { SIGURG, ctxsw_handler },
+    { SIM_INTR_SIGNAL, intr_handler },
 };
 
 #define NUMSIGS     (sizeof(signals)/sizeof(signals[0]))
@@ -172,6 +185,14 @@ sim_tick_idle(os_time_t ticks)
 
     OS_ASSERT_CRITICAL();
 
+#if MYNEWT_VAL(MCU_NATIVE_VIRTUAL_TIME)
+    if (sim_virt_tick_idle(ticks) == 0) {
+        return;
+    }
+    /* Nothing is due; wait for host input without starting the timer. */
+    ticks = 0;
+#endif
+
     if (ticks > 0) {
         /*
          * Enter tickless regime and set the timer to fire after 'ticks'
@@ -81,6 +81,18 @@ static struct mgmt_group imgr_nmgr_group = {
 
 struct imgr_state imgr_state;
 
+/*
+ * Key lookup table for upload requests; built at init from the names and
+ * types of the attributes decoded by imgr_upload(), in the same order.
+ */
+static const struct cbor_attr_t imgr_upload_attr_names[4] = {
+    [0] = { .attribute = "data", .type = CborAttrByteStringType },
+    [1] = { .attribute = "len", .type = CborAttrUnsignedIntegerType },
+    [2] = { .attribute = "off", .type = CborAttrUnsignedIntegerType },
+    [3] = { 0 },
+};
+static struct cbor_attr_desc imgr_upload_desc;
+
 /*
  * Read version and build hash from image located slot "image_slot".  Note:
  * this is a slot index, not a flash area ID.
@@ -331,7 +343,7 @@ imgr_upload(struct mgmt_cbuf *cb)
     bool empty = false;
     CborError g_err = CborNoError;
 
-    rc = cbor_read_object(&cb->it, off_attr);
+    rc = cbor_read_object_desc(&cb->it, off_attr, &imgr_upload_desc);
     if (rc || off == UINT_MAX) {
         return MGMT_ERR_EINVAL;
     }
@@ -456,6 +468,9 @@ imgmgr_module_init(void)
     /* Ensure this function only gets called by sysinit. */
     SYSINIT_ASSERT_ACTIVE();
 
+    rc = cbor_attr_desc_init(&imgr_upload_desc, imgr_upload_attr_names);
+    SYSINIT_PANIC_ASSERT(rc == 0);
+
     rc = mgmt_group_register(&imgr_nmgr_group);
     SYSINIT_PANIC_ASSERT(rc == 0);
 
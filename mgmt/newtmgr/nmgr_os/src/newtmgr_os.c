@@ -143,6 +143,9 @@ nmgr_def_taskstat_read(struct mgmt_cbuf *cb)
 {
     struct os_task *prev_task;
     struct os_task_info oti;
+#if MYNEWT_VAL(OS_PROFILE)
+    struct os_profile_info opi;
+#endif
     CborError g_err = CborNoError;
     CborEncoder tasks;
     CborEncoder task;
@@ -180,10 +183,38 @@ nmgr_def_taskstat_read(struct mgmt_cbuf *cb)
         g_err |= cbor_encode_uint(&task, oti.oti_last_checkin);
         g_err |= cbor_encode_text_stringz(&task, "next_checkin");
         g_err |= cbor_encode_uint(&task, oti.oti_next_checkin);
+#if MYNEWT_VAL(OS_PROFILE)
+        g_err |= cbor_encode_text_stringz(&task, "cpu_us");
+        g_err |= cbor_encode_uint(&task, oti.oti_cpu_usecs);
+        g_err |= cbor_encode_text_stringz(&task, "burst_max_us");
+        g_err |= cbor_encode_uint(&task, oti.oti_cpu_burst_max_usecs);
+        g_err |= cbor_encode_text_stringz(&task, "evq_lat_max_us");
+        g_err |= cbor_encode_uint(&task, oti.oti_evq_lat_max_usecs);
+        g_err |= cbor_encode_text_stringz(&task, "evq_lat_avg_us");
+        g_err |= cbor_encode_uint(&task, oti.oti_evq_lat_avg_usecs);
+#endif
         g_err |= cbor_encoder_close_container(&tasks, &task);
     }
     g_err |= cbor_encoder_close_container(&cb->encoder, &tasks);
 
+#if MYNEWT_VAL(OS_PROFILE)
+    os_profile_info_get(&opi);
+    g_err |= cbor_encode_text_stringz(&cb->encoder, "profile");
+    g_err |= cbor_encoder_create_map(&cb->encoder, &task,
+                                     CborIndefiniteLength);
+    g_err |= cbor_encode_text_stringz(&task, "elapsed_us");
+    g_err |= cbor_encode_uint(&task, opi.opi_elapsed_usecs);
+    g_err |= cbor_encode_text_stringz(&task, "crit_cnt");
+    g_err |= cbor_encode_uint(&task, opi.opi_crit_cnt);
+    g_err |= cbor_encode_text_stringz(&task, "crit_total_us");
+    g_err |= cbor_encode_uint(&task, opi.opi_crit_total_usecs);
+    g_err |= cbor_encode_text_stringz(&task, "crit_max_us");
+    g_err |= cbor_encode_uint(&task, opi.opi_crit_max_usecs);
+    g_err |= cbor_encode_text_stringz(&task, "crit_max_addr");
+    g_err |= cbor_encode_uint(&task, (uintptr_t)opi.opi_crit_max_addr);
+    g_err |= cbor_encoder_close_container(&cb->encoder, &task);
+#endif
+
     if (g_err) {
         return MGMT_ERR_ENOMEM;
     }
@@ -33,6 +33,7 @@
 #include "nmgr_os/nmgr_os.h"
 
 #include "tinycbor/cbor.h"
+#include "tinycbor/cbor_cnt_writer.h"
 #include "tinycbor/cbor_mbuf_writer.h"
 #include "tinycbor/cbor_mbuf_reader.h"
 
@@ -183,6 +184,43 @@ nmgr_rsp_tx(struct nmgr_transport *nt, struct os_mbuf **rsp, uint16_t mtu)
     return MGMT_ERR_EOK;
 }
 
+#if MYNEWT_VAL(NEWTMGR_RSP_MEASURE)
+/**
+ * Runs a read handler against a counting encoder to learn the size of its
+ * response, and reserves that much room in the response mbuf.  The encoder
+ * and the request parser are then put back for the real run.  If the
+ * handler fails here, nothing is reserved; the real run reports the error.
+ * If the room cannot be reserved, the real run allocates mbufs as it
+ * encodes, as it does without a reservation.
+ */
+static void
+nmgr_rsp_reserve(const struct mgmt_handler *handler, struct os_mbuf *req)
+{
+    struct CborCntWriter cnt;
+    CborEncoder encoder;
+    int rc;
+
+    encoder = nmgr_task_cbuf.n_b.encoder;
+    cbor_cnt_writer_init(&cnt);
+    cbor_encoder_init(&nmgr_task_cbuf.n_b.encoder, &cnt.enc, 0);
+
+    rc = handler->mh_read(&nmgr_task_cbuf.n_b);
+
+    nmgr_task_cbuf.n_b.encoder = encoder;
+    cbor_mbuf_reader_init(&nmgr_task_cbuf.reader, req, sizeof(struct nmgr_hdr));
+    cbor_parser_init(&nmgr_task_cbuf.reader.r, 0,
+                     &nmgr_task_cbuf.n_b.parser, &nmgr_task_cbuf.n_b.it);
+
+    if (rc != 0) {
+        return;
+    }
+
+    /* The handler's output, and the break that closes the root map. */
+    cbor_mbuf_writer_reserve(&nmgr_task_cbuf.writer,
+                             cnt.enc.bytes_written + 1);
+}
+#endif
+
 static void
 nmgr_handle_req(struct nmgr_transport *nt, struct os_mbuf *req)
 {
@@ -261,7 +299,16 @@ nmgr_handle_req(struct nmgr_transport *nt, struct os_mbuf *req)
 
         if (hdr.nh_op == NMGR_OP_READ) {
             if (handler->mh_read) {
+#if MYNEWT_VAL(NEWTMGR_RSP_MEASURE)
+                nmgr_rsp_reserve(handler, req);
                 rc = handler->mh_read(&nmgr_task_cbuf.n_b);
+                if (rc != 0) {
+                    /* Keep the reserved room out of the error response. */
+                    cbor_mbuf_writer_release(&nmgr_task_cbuf.writer);
+                }
+#else
+                rc = handler->mh_read(&nmgr_task_cbuf.n_b);
+#endif
             } else {
                 rc = MGMT_ERR_ENOENT;
             }
@@ -286,6 +333,8 @@ nmgr_handle_req(struct nmgr_transport *nt, struct os_mbuf *req)
             goto err;
         }
 
+        cbor_mbuf_writer_release(&nmgr_task_cbuf.writer);
+
         rsp_hdr->nh_len +=
             cbor_encode_bytes_written(&nmgr_task_cbuf.n_b.encoder);
         rsp_hdr->nh_len = htons(rsp_hdr->nh_len);
@@ -35,6 +35,15 @@
 #include "mn_socket/mn_socket_ops.h"
 #include "native_sockets/native_sock.h"
 
+#if MYNEWT_VAL(NATIVE_SOCKETS_EPOLL)
+#include <sys/epoll.h>
+#include "sim/sim.h"
+
+#if MYNEWT_VAL(NATIVE_SOCKETS_MAX) > 32
+#error "NATIVE_SOCKETS_EPOLL supports at most 32 sockets"
+#endif
+#endif
+
 #include "native_sock_priv.h"
 
 static int native_sock_create(struct mn_socket **sp, uint8_t domain,
@@ -60,6 +69,9 @@ static struct native_sock {
     int ns_fd;
     unsigned int ns_poll:1;
     unsigned int ns_listen:1;
+    unsigned int ns_epoll:1;        /* in the epoll set */
+    unsigned int ns_rx_wait:1;      /* readable reported, not read yet */
+    unsigned int ns_accept_wait:1;  /* no free socket to accept into */
     uint8_t ns_type;
     uint8_t ns_pf;
     struct os_sem ns_sem;
@@ -68,8 +80,16 @@ static struct native_sock {
 } native_socks[MYNEWT_VAL(NATIVE_SOCKETS_MAX)];
 
 static struct native_sock_state {
+#if MYNEWT_VAL(NATIVE_SOCKETS_EPOLL)
+    int epoll_fd;
+    int irq;
+    struct os_sem ready_sem;
+    uint32_t rx_ready;              /* bitmaps of sockets, set by thread */
+    uint32_t tx_ready;
+#else
     struct pollfd poll_fds[MYNEWT_VAL(NATIVE_SOCKETS_MAX)];
     int poll_fd_cnt;
+#endif
     struct os_mutex mtx;
     struct os_task task;
 } native_sock_state;
@@ -106,6 +126,9 @@ native_get_sock(void)
             ns = &native_socks[i];
             ns->ns_poll = 0;
             ns->ns_listen = 0;
+            ns->ns_epoll = 0;
+            ns->ns_rx_wait = 0;
+            ns->ns_accept_wait = 0;
             return ns;
         }
     }
@@ -125,6 +148,43 @@ native_find_sock(int fd)
     return NULL;
 }
 
+#if MYNEWT_VAL(NATIVE_SOCKETS_EPOLL)
+/*
+ * Arms the socket in the epoll set for the events it waits for.  Events are
+ * one-shot: reading is armed again once the user has read from the socket,
+ * and writing when a stream socket still has data queued.
+ */
+static void
+native_sock_poll_update(struct native_sock_state *nss, struct native_sock *ns)
+{
+    struct epoll_event ev;
+    int rc;
+
+    if (ns->ns_fd < 0) {
+        return;
+    }
+
+    memset(&ev, 0, sizeof(ev));
+    ev.data.u32 = ns - native_socks;
+    if (ns->ns_poll && !ns->ns_rx_wait && !ns->ns_accept_wait) {
+        ev.events |= EPOLLIN;
+    }
+    if (ns->ns_type == SOCK_STREAM && ns->ns_tx) {
+        ev.events |= EPOLLOUT;
+    }
+    if (ev.events) {
+        ev.events |= EPOLLONESHOT;
+    }
+
+    if (!ns->ns_epoll) {
+        rc = epoll_ctl(nss->epoll_fd, EPOLL_CTL_ADD, ns->ns_fd, &ev);
+        ns->ns_epoll = 1;
+    } else {
+        rc = epoll_ctl(nss->epoll_fd, EPOLL_CTL_MOD, ns->ns_fd, &ev);
+    }
+    assert(rc == 0);
+}
+#else
 static void
 native_sock_poll_rebuild(struct native_sock_state *nss)
 {
@@ -138,7 +198,7 @@ native_sock_poll_rebuild(struct native_sock_state *nss)
         if (ns->ns_fd < 0) {
             continue;
         }
-        if (!ns->ns_poll) {
+        if (!ns->ns_poll || ns->ns_accept_wait) {
             continue;
         }
         nss->poll_fds[j].fd = ns->ns_fd;
@@ -150,6 +210,29 @@ native_sock_poll_rebuild(struct native_sock_state *nss)
     os_mutex_release(&nss->mtx);
 }
 
+/* The poll set is rebuilt from all sockets whichever one changed. */
+#define native_sock_poll_update(nss, ns)    native_sock_poll_rebuild(nss)
+#endif
+
+/*
+ * A socket was freed; listening sockets that ran out of sockets to accept
+ * into wait for their connections again.  Called with the state mutex held.
+ */
+static void
+native_sock_accept_resume(struct native_sock_state *nss)
+{
+    struct native_sock *ns;
+    int i;
+
+    for (i = 0; i < MYNEWT_VAL(NATIVE_SOCKETS_MAX); i++) {
+        ns = &native_socks[i];
+        if (ns->ns_fd >= 0 && ns->ns_accept_wait) {
+            ns->ns_accept_wait = 0;
+            native_sock_poll_update(nss, ns);
+        }
+    }
+}
+
 int
 native_sock_err_to_mn_err(int err)
 {
@@ -346,7 +429,8 @@ native_sock_close(struct mn_socket *s)
         os_mbuf_free_chain(OS_MBUF_PKTHDR_TO_MBUF(m));
     }
     os_mbuf_free_chain(ns->ns_tx);
-    native_sock_poll_rebuild(nss);
+    native_sock_poll_update(nss, ns);
+    native_sock_accept_resume(nss);
     os_mutex_release(&nss->mtx);
     return 0;
 }
@@ -372,7 +456,7 @@ native_sock_connect(struct mn_socket *s, struct mn_sockaddr *addr)
         return native_sock_err_to_mn_err(rc);
     }
     ns->ns_poll = 1;
-    native_sock_poll_rebuild(nss);
+    native_sock_poll_update(nss, ns);
     os_mutex_release(&nss->mtx);
     mn_socket_writable(s, 0);
     return 0;
@@ -411,7 +495,7 @@ native_sock_bind(struct mn_socket *s, struct mn_sockaddr *addr)
     }
     if (ns->ns_type == SOCK_DGRAM) {
         ns->ns_poll = 1;
-        native_sock_poll_rebuild(nss);
+        native_sock_poll_update(nss, ns);
     }
     os_mutex_release(&nss->mtx);
     return 0;
@@ -436,7 +520,7 @@ native_sock_listen(struct mn_socket *s, uint8_t qlen)
     }
     ns->ns_poll = 1;
     ns->ns_listen = 1;
-    native_sock_poll_rebuild(nss);
+    native_sock_poll_update(nss, ns);
     os_mutex_release(&nss->mtx);
     return 0;
 }
@@ -481,6 +565,12 @@ native_sock_stream_tx(struct native_sock *ns, int notify)
             break;
         }
     }
+#if MYNEWT_VAL(NATIVE_SOCKETS_EPOLL)
+    if (ns->ns_tx) {
+        /* Continue once the socket takes more data. */
+        native_sock_poll_update(nss, ns);
+    }
+#endif
     os_mutex_release(&nss->mtx);
     if (notify) {
         if (ns->ns_tx == NULL) {
@@ -556,13 +646,22 @@ native_sock_recvfrom(struct mn_socket *s, struct os_mbuf **mp,
             rc = read(ns->ns_fd, tmpbuf, sizeof(tmpbuf));
         }
     }
+#if MYNEWT_VAL(NATIVE_SOCKETS_EPOLL)
+    if (ns->ns_rx_wait) {
+        /* The user is reading; report the next data that arrives. */
+        os_mutex_pend(&native_sock_state.mtx, OS_WAIT_FOREVER);
+        ns->ns_rx_wait = 0;
+        native_sock_poll_update(&native_sock_state, ns);
+        os_mutex_release(&native_sock_state.mtx);
+    }
+#endif
     if (rc < 0) {
         return native_sock_err_to_mn_err(errno);
     }
     if (ns->ns_type == SOCK_STREAM && rc == 0) {
         mn_socket_readable(&ns->ns_sock, MN_ECONNABORTED);
         ns->ns_poll = 0;
-        native_sock_poll_rebuild(&native_sock_state);
+        native_sock_poll_update(&native_sock_state, ns);
         return MN_ECONNABORTED;
     }
 
@@ -707,6 +806,143 @@ native_sock_getpeername(struct mn_socket *s, struct mn_sockaddr *addr)
     return 0;
 }
 
+/*
+ * Accepts a connection on a listening socket and hands it to the user.
+ * Called with the state mutex held.
+ *
+ * The listening socket stays readable until the connection is accepted.  If
+ * there is no socket, or no host descriptor, to accept it into, the
+ * listening socket is left out of the poll set until a socket is closed;
+ * otherwise the task would be woken for it over and over.
+ */
+static void
+native_sock_accept(struct native_sock_state *nss, struct native_sock *ns)
+{
+    struct native_sock *new_ns;
+    struct sockaddr_storage ss;
+    struct sockaddr *sa = (struct sockaddr *)&ss;
+    socklen_t slen;
+
+    new_ns = native_get_sock();
+    if (!new_ns) {
+        ns->ns_accept_wait = 1;
+        native_sock_poll_update(nss, ns);
+        return;
+    }
+    slen = sizeof(ss);
+    new_ns->ns_fd = accept(ns->ns_fd, sa, &slen);
+    if (new_ns->ns_fd < 0) {
+        if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS ||
+            errno == ENOMEM) {
+            ns->ns_accept_wait = 1;
+        }
+        native_sock_poll_update(nss, ns);
+        return;
+    }
+    new_ns->ns_type = ns->ns_type;
+    new_ns->ns_sock.ms_ops = &native_sock_ops;
+    os_mutex_release(&nss->mtx);
+    if (mn_socket_newconn(&ns->ns_sock, &new_ns->ns_sock)) {
+        /*
+         * should close
+         */
+    }
+    os_mutex_pend(&nss->mtx, OS_WAIT_FOREVER);
+    new_ns->ns_poll = 1;
+    native_sock_poll_update(nss, new_ns);
+    native_sock_poll_update(nss, ns);
+}
+
+#if MYNEWT_VAL(NATIVE_SOCKETS_EPOLL)
+/*
+ * Host thread; waits for socket events and interrupts the OS when there are
+ * some.
+ */
+static void *
+native_sock_epoll_thread(void *arg)
+{
+    struct native_sock_state *nss = arg;
+    struct epoll_event evs[MYNEWT_VAL(NATIVE_SOCKETS_MAX)];
+    uint32_t rx_ready;
+    uint32_t tx_ready;
+    uint32_t bit;
+    int cnt;
+    int i;
+
+    while (1) {
+        cnt = epoll_wait(nss->epoll_fd, evs, MYNEWT_VAL(NATIVE_SOCKETS_MAX),
+                         -1);
+        rx_ready = 0;
+        tx_ready = 0;
+        for (i = 0; i < cnt; i++) {
+            bit = (uint32_t)1 << evs[i].data.u32;
+            if (evs[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+                rx_ready |= bit;
+            }
+            if (evs[i].events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) {
+                tx_ready |= bit;
+            }
+        }
+        if (rx_ready | tx_ready) {
+            __atomic_fetch_or(&nss->rx_ready, rx_ready, __ATOMIC_SEQ_CST);
+            __atomic_fetch_or(&nss->tx_ready, tx_ready, __ATOMIC_SEQ_CST);
+            sim_intr_raise(nss->irq);
+        }
+    }
+
+    return NULL;
+}
+
+static void
+native_sock_intr(void *arg)
+{
+    struct native_sock_state *nss = arg;
+
+    /* One token has the task look at every ready socket. */
+    if (nss->ready_sem.sem_tokens == 0) {
+        os_sem_release(&nss->ready_sem);
+    }
+}
+
+static void
+socket_task(void *arg)
+{
+    struct native_sock_state *nss = arg;
+    struct native_sock *ns;
+    uint32_t rx_ready;
+    uint32_t tx_ready;
+    uint32_t bit;
+    int i;
+
+    while (1) {
+        os_sem_pend(&nss->ready_sem, OS_TIMEOUT_NEVER);
+        rx_ready = __atomic_exchange_n(&nss->rx_ready, 0, __ATOMIC_SEQ_CST);
+        tx_ready = __atomic_exchange_n(&nss->tx_ready, 0, __ATOMIC_SEQ_CST);
+
+        os_mutex_pend(&nss->mtx, OS_WAIT_FOREVER);
+        for (i = 0; i < MYNEWT_VAL(NATIVE_SOCKETS_MAX); i++) {
+            ns = &native_socks[i];
+            bit = (uint32_t)1 << i;
+            if (ns->ns_fd < 0) {
+                continue;
+            }
+            if (rx_ready & bit) {
+                if (ns->ns_listen) {
+                    native_sock_accept(nss, ns);
+                } else if (ns->ns_poll) {
+                    ns->ns_rx_wait = 1;
+                    mn_socket_readable(&ns->ns_sock, 0);
+                }
+            }
+            if ((tx_ready & bit) && ns->ns_type == SOCK_STREAM &&
+                ns->ns_tx) {
+                native_sock_stream_tx(ns, 1);
+            }
+        }
+        os_mutex_release(&nss->mtx);
+    }
+}
+#else
 /*
  * XXX should do this task with SIGIO as well.
  */
@@ -714,11 +950,8 @@ static void
 socket_task(void *arg)
 {
     struct native_sock_state *nss = arg;
-    struct native_sock *ns, *new_ns;
-    struct sockaddr_storage ss;
-    struct sockaddr *sa = (struct sockaddr *)&ss;
+    struct native_sock *ns;
     int i;
-    socklen_t slen;
     int rc;
 
     os_mutex_pend(&nss->mtx, OS_WAIT_FOREVER);
@@ -742,26 +975,7 @@ socket_task(void *arg)
             ns = native_find_sock(nss->poll_fds[i].fd);
             assert(ns);
             if (ns->ns_listen) {
-                new_ns = native_get_sock();
-                if (!new_ns) {
-                    continue;
-                }
-                slen = sizeof(ss);
-                new_ns->ns_fd = accept(ns->ns_fd, sa, &slen);
-                if (new_ns->ns_fd < 0) {
-                    continue;
-                }
-                new_ns->ns_type = ns->ns_type;
-                new_ns->ns_sock.ms_ops = &native_sock_ops;
-                os_mutex_release(&nss->mtx);
-                if (mn_socket_newconn(&ns->ns_sock, &new_ns->ns_sock)) {
-                    /*
-                     * should close
-                     */
-                }
-                os_mutex_pend(&nss->mtx, OS_WAIT_FOREVER);
-                new_ns->ns_poll = 1;
-                native_sock_poll_rebuild(nss);
+                native_sock_accept(nss, ns);
             } else {
                 mn_socket_readable(&ns->ns_sock, 0);
             }
@@ -777,6 +991,7 @@ socket_task(void *arg)
         }
     }
 }
+#endif
 
 int
 native_sock_init(void)
@@ -797,6 +1012,20 @@ native_sock_init(void)
         return -1;
     }
     os_mutex_init(&nss->mtx);
+#if MYNEWT_VAL(NATIVE_SOCKETS_EPOLL)
+    os_sem_init(&nss->ready_sem, 0);
+    nss->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (nss->epoll_fd < 0) {
+        return -1;
+    }
+    nss->irq = sim_intr_register(native_sock_intr, nss);
+    if (nss->irq < 0) {
+        return -1;
+    }
+    if (sim_thread_create(native_sock_epoll_thread, nss)) {
+        return -1;
+    }
+#endif
     i = os_task_init(&nss->task, "socket", socket_task, &native_sock_state,
       MYNEWT_VAL(NATIVE_SOCKETS_PRIO), OS_WAIT_FOREVER, sp,
       MYNEWT_VAL(NATIVE_SOCKETS_STACK_SZ));
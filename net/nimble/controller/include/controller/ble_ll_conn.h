@@ -165,6 +165,20 @@ struct ble_ll_conn_phy_data
 #define CONN_CUR_TX_PHY_MASK(csm)   (1 << ((csm)->phy_data.cur_tx_phy - 1))
 #define CONN_CUR_RX_PHY_MASK(csm)   (1 << ((csm)->phy_data.cur_rx_phy - 1))
 
+/*
+ * Per-connection scheduling statistics. An event is counted as skipped when
+ * the scheduler could not find room for it, preempted when it was removed
+ * from the schedule to make room for something else, and late when it was
+ * started too late to transmit or receive.
+ */
+struct ble_ll_conn_sched_stats
+{
+    uint32_t events;
+    uint32_t skipped;
+    uint32_t preempted;
+    uint32_t late;
+};
+
 /* Connection state machine */
 struct ble_ll_conn_sm
 {
@@ -213,7 +227,10 @@ struct ble_ll_conn_sm
     uint8_t num_used_chans;
 
 #if MYNEWT_VAL(BLE_LL_STRICT_CONN_SCHEDULING)
-    uint8_t period_occ_mask;    /* mask: period 0 = 0x01, period 3 = 0x08 */
+    uint32_t period_occ_mask;   /* mask: period 0 = 0x01, period 3 = 0x08 */
+#endif
+#if MYNEWT_VAL(BLE_LL_SCHED_CONN_GRID)
+    uint8_t sch_grid_cell;      /* BLE_LL_SCHED_GRID_CELL_NONE if off grid */
 #endif
 
     /* Ack/Flow Control */
@@ -292,6 +309,7 @@ struct ble_ll_conn_sm
 
     /* For scheduling connections */
     struct ble_ll_sched_item conn_sch;
+    struct ble_ll_conn_sched_stats sched_stats;
 
 #if (MYNEWT_VAL(BLE_LL_CFG_FEAT_LE_PING) == 1)
     struct os_callout auth_pyld_timer;
@@ -356,6 +374,13 @@ struct ble_ll_conn_sm
  */
 struct ble_ll_conn_sm *ble_ll_conn_find_active_conn(uint16_t handle);
 
+/*
+ * Copies the scheduling statistics of the connection with the given handle.
+ * Returns 0 on success or BLE_ERR_UNK_CONN_ID.
+ */
+int ble_ll_conn_sched_stats_get(uint16_t handle,
+                                struct ble_ll_conn_sched_stats *stats);
+
 /* required for unit testing */
 uint8_t ble_ll_conn_calc_dci(struct ble_ll_conn_sm *conn, uint16_t latency);
 
@@ -132,6 +132,12 @@ struct ble_ll_scan_sm
     struct ble_ll_scan_params phy_data[BLE_LL_SCAN_PHY_NUMBER];
     uint8_t ext_scanning;
     struct ble_ll_aux_data *cur_aux_data;
+
+#if MYNEWT_VAL(BLE_LL_SCAN_RPT_BATCH_MAX) > 1
+    /* Advertising report event being filled; sent when full or flushed */
+    uint8_t *adv_rpt_evbuf;
+    struct os_event adv_rpt_flush_ev;
+#endif
 };
 
 /* Scan types */
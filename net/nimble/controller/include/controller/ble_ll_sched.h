@@ -97,6 +97,10 @@ typedef int (*sched_cb_func)(struct ble_ll_sched_item *sch);
 #define BLE_LL_SCHED_PERIODS    (MYNEWT_VAL(BLE_MAX_CONNECTIONS) + \
                                  MYNEWT_VAL(BLE_LL_ADD_STRICT_SCHED_PERIODS))
 
+#if BLE_LL_SCHED_PERIODS > 32
+#error "Strict scheduling supports no more than 32 periods"
+#endif
+
 struct ble_ll_sched_obj
 {
     uint8_t sch_num_occ_periods;
@@ -116,6 +120,60 @@ extern struct ble_ll_sched_obj g_ble_ll_sched_data;
  */
 #endif
 
+/*
+ * Grid connection scheduling (for the master) packs central links so that
+ * their connection events never overlap. Time is divided into "cells" of
+ * BLE_LL_CONN_INIT_SLOTS slots each; BLE_LL_SCHED_CONN_GRID_CELLS cells make
+ * up the grid, which repeats forever. A link whose connection interval is a
+ * multiple of the grid length is given one free cell and its connection
+ * events then always fall inside that cell. The grid has no fixed start time:
+ * it is derived from the anchor point of any link already on it, so it stays
+ * exact for as long as the connections do.
+ *
+ * Links whose interval is not a multiple of the grid length, slave links and
+ * links that could not be given a cell are scheduled as usual and may still
+ * collide with grid links.
+ */
+#if MYNEWT_VAL(BLE_LL_SCHED_CONN_GRID)
+#define BLE_LL_SCHED_GRID_CELLS     (MYNEWT_VAL(BLE_LL_SCHED_CONN_GRID_CELLS))
+#define BLE_LL_SCHED_GRID_CELL_USECS    \
+    (MYNEWT_VAL(BLE_LL_CONN_INIT_SLOTS) * BLE_LL_SCHED_USECS_PER_SLOT)
+#define BLE_LL_SCHED_GRID_USECS     \
+    (BLE_LL_SCHED_GRID_CELLS * BLE_LL_SCHED_GRID_CELL_USECS)
+
+/* Grid length in connection interval units (1.25 msecs) */
+#define BLE_LL_SCHED_GRID_ITVL      \
+    (BLE_LL_SCHED_GRID_CELLS * MYNEWT_VAL(BLE_LL_CONN_INIT_SLOTS))
+
+/* Ticks left unused at the end of each cell to absorb rounding */
+#define BLE_LL_SCHED_GRID_GUARD_TICKS   (2)
+
+#define BLE_LL_SCHED_GRID_CELL_NONE (0xff)
+
+#if BLE_LL_SCHED_GRID_CELLS > 32
+#error "BLE_LL_SCHED_CONN_GRID_CELLS must not be greater than 32"
+#endif
+
+struct ble_ll_sched_grid
+{
+    uint32_t occ_cell_mask;
+    uint32_t ticks_per_cell;
+};
+
+extern struct ble_ll_sched_grid g_ble_ll_sched_grid;
+
+/* Pick a connection interval in the given range that fits the grid */
+uint16_t ble_ll_sched_grid_itvl(uint16_t itvl_min, uint16_t itvl_max);
+
+/*
+ * Find the first cell not in occ_mask starting at or after pos_usecs, which
+ * is an offset into the grid. Returns the cell (or -1 if none is free) and
+ * the time until it starts.
+ */
+int ble_ll_sched_grid_cell_find(uint32_t occ_mask, uint32_t pos_usecs,
+                                uint32_t *delay_usecs);
+#endif
+
 /*
  * Schedule item
  *  sched_type: This is the type of the schedule item.
@@ -150,6 +208,11 @@ int ble_ll_sched_master_new(struct ble_ll_conn_sm *connsm,
 /* Schedule a new slave connection */
 int ble_ll_sched_slave_new(struct ble_ll_conn_sm *connsm);
 
+#if MYNEWT_VAL(BLE_LL_SCHED_CONN_GRID)
+/* Give up the grid cell held by a connection (if any) */
+void ble_ll_sched_grid_release(struct ble_ll_conn_sm *connsm);
+#endif
+
 struct ble_ll_adv_sm;
 typedef void ble_ll_sched_adv_new_cb(struct ble_ll_adv_sm *advsm, uint32_t sch_start);
 
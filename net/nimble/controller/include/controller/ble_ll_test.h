@@ -27,6 +27,7 @@ extern "C" {
 #endif
 
 int ble_ll_csa2_test_all(void);
+int ble_ll_sched_test_all(void);
 
 #ifdef __cplusplus
 }
@@ -413,6 +413,25 @@ ble_ll_conn_find_active_conn(uint16_t handle)
     return connsm;
 }
 
+int
+ble_ll_conn_sched_stats_get(uint16_t handle,
+                            struct ble_ll_conn_sched_stats *stats)
+{
+    struct ble_ll_conn_sm *connsm;
+    os_sr_t sr;
+
+    connsm = ble_ll_conn_find_active_conn(handle);
+    if (!connsm) {
+        return BLE_ERR_UNK_CONN_ID;
+    }
+
+    OS_ENTER_CRITICAL(sr);
+    *stats = connsm->sched_stats;
+    OS_EXIT_CRITICAL(sr);
+
+    return 0;
+}
+
 /**
  * Get a connection state machine.
  */
@@ -1065,7 +1084,7 @@ ble_ll_conn_tx_data_pdu(struct ble_ll_conn_sm *connsm)
     uint8_t end_transition;
     uint8_t cur_txlen;
     uint8_t next_txlen;
-    uint8_t cur_offset;
+    uint16_t cur_offset;
     uint16_t pktlen;
     uint32_t next_event_time;
     uint32_t ticks;
@@ -1205,7 +1224,12 @@ ble_ll_conn_tx_data_pdu(struct ble_ll_conn_sm *connsm)
          *  -> wait IFS, send next frame.
          */
         if ((cur_offset + cur_txlen) < pktlen) {
-            next_txlen = pktlen - (cur_offset + cur_txlen);
+            if ((pktlen - (cur_offset + cur_txlen)) >
+                                            connsm->eff_max_tx_octets) {
+                next_txlen = connsm->eff_max_tx_octets;
+            } else {
+                next_txlen = pktlen - (cur_offset + cur_txlen);
+            }
         } else {
             if (nextpkthdr->omp_len > connsm->eff_max_tx_octets) {
                 next_txlen = connsm->eff_max_tx_octets;
@@ -1251,7 +1275,6 @@ conn_tx_pdu:
         m->om_data = (uint8_t *)&empty_pdu;
         m->om_data += BLE_MBUF_MEMBLOCK_OVERHEAD;
         ble_hdr = &empty_pdu.ble_hdr;
-        ble_hdr->txinfo.flags = 0;
         ble_hdr->txinfo.offset = 0;
         ble_hdr->txinfo.pyld_len = 0;
     }
@@ -1384,12 +1407,13 @@ conn_tx_pdu:
     ble_phy_set_txend_cb(txend_func, connsm);
     rc = ble_phy_tx(m, end_transition);
     if (!rc) {
-        /* Log transmit on connection state */
+        /*
+         * Log transmit on connection state.  The offset is 16 bits wide, so
+         * it gets the 16-bit field and the payload length the 32-bit one.
+         */
         cur_txlen = ble_hdr->txinfo.pyld_len;
-        ble_ll_log(BLE_LL_LOG_ID_CONN_TX,
-                   hdr_byte,
-                   ((uint16_t)ble_hdr->txinfo.offset << 8) | cur_txlen,
-                   (uint32_t)m);
+        ble_ll_log(BLE_LL_LOG_ID_CONN_TX, hdr_byte, ble_hdr->txinfo.offset,
+                   cur_txlen);
 
         /* Set last transmitted MD bit */
         CONN_F_LAST_TXD_MD(connsm) = md;
@@ -1431,6 +1455,7 @@ ble_ll_conn_event_start_cb(struct ble_ll_sched_item *sch)
     connsm = (struct ble_ll_conn_sm *)sch->cb_arg;
     g_ble_ll_conn_cur_sm = connsm;
     assert(connsm);
+    ++connsm->sched_stats.events;
 
     /* Disable whitelisting as connections do not use it */
     ble_ll_whitelist_disable();
@@ -1474,6 +1499,7 @@ ble_ll_conn_event_start_cb(struct ble_ll_sched_item *sch)
             }
         } else {
             STATS_INC(ble_ll_conn_stats, conn_ev_late);
+            ++connsm->sched_stats.late;
             rc = BLE_LL_SCHED_STATE_DONE;
         }
     } else {
@@ -1499,6 +1525,7 @@ ble_ll_conn_event_start_cb(struct ble_ll_sched_item *sch)
         if (rc) {
             /* End the connection event as we have no more buffers */
             STATS_INC(ble_ll_conn_stats, slave_ce_failures);
+            ++connsm->sched_stats.late;
             rc = BLE_LL_SCHED_STATE_DONE;
         } else {
             /*
@@ -1568,7 +1595,7 @@ ble_ll_conn_can_send_next_pdu(struct ble_ll_conn_sm *connsm, uint32_t begtime,
                               uint32_t add_usecs)
 {
     int rc;
-    uint8_t rem_bytes;
+    uint16_t rem_bytes;
     uint32_t ticks;
     uint32_t usecs;
     uint32_t next_sched_time;
@@ -1737,8 +1764,13 @@ ble_ll_conn_master_init(struct ble_ll_conn_sm *connsm,
         connsm->peer_addr_type = hcc->peer_addr_type;
     }
 
+#if MYNEWT_VAL(BLE_LL_SCHED_CONN_GRID)
+    connsm->conn_itvl = ble_ll_sched_grid_itvl(hcc->conn_itvl_min,
+                                               hcc->conn_itvl_max);
+#else
     /* XXX: for now, just make connection interval equal to max */
     connsm->conn_itvl = hcc->conn_itvl_max;
+#endif
 
     /* Check the min/max CE lengths are less than connection interval */
     if (hcc->min_ce_len > (connsm->conn_itvl * 2)) {
@@ -1851,8 +1883,13 @@ ble_ll_conn_ext_set_params(struct ble_ll_conn_sm *connsm,
     connsm->slave_latency = hcc_params->conn_latency;
     connsm->supervision_tmo = hcc_params->supervision_timeout;
 
+#if MYNEWT_VAL(BLE_LL_SCHED_CONN_GRID)
+    connsm->conn_itvl = ble_ll_sched_grid_itvl(hcc_params->conn_itvl_min,
+                                               hcc_params->conn_itvl_max);
+#else
     /* XXX: for now, just make connection interval equal to max */
     connsm->conn_itvl = hcc_params->conn_itvl_max;
+#endif
 
 
     /* Check the min/max CE lengths are less than connection interval */
@@ -1956,6 +1993,11 @@ ble_ll_conn_sm_new(struct ble_ll_conn_sm *connsm)
     connsm->conn_ev_end.ev_queued = 0;
     connsm->conn_ev_end.ev_cb = ble_ll_conn_event_end;
 
+    memset(&connsm->sched_stats, 0, sizeof(connsm->sched_stats));
+#if MYNEWT_VAL(BLE_LL_SCHED_CONN_GRID)
+    connsm->sch_grid_cell = BLE_LL_SCHED_GRID_CELL_NONE;
+#endif
+
     /* Initialize transmit queue and ack/flow control elements */
     STAILQ_INIT(&connsm->conn_txq);
     connsm->cur_tx_pdu = NULL;
@@ -2120,6 +2162,10 @@ ble_ll_conn_end(struct ble_ll_conn_sm *connsm, uint8_t ble_err)
     OS_EXIT_CRITICAL(sr);
 #endif
 
+#if MYNEWT_VAL(BLE_LL_SCHED_CONN_GRID)
+    ble_ll_sched_grid_release(connsm);
+#endif
+
     /* Connection state machine is now idle */
     connsm->conn_state = BLE_LL_CONN_STATE_IDLE;
 
@@ -2266,6 +2312,16 @@ ble_ll_conn_next_event(struct ble_ll_conn_sm *connsm)
         connsm->tx_win_off = upd->winoffset;
         connsm->conn_itvl = upd->interval;
         ble_ll_conn_calc_itvl_ticks(connsm);
+#if MYNEWT_VAL(BLE_LL_SCHED_CONN_GRID)
+        /*
+         * The link keeps its cell only if the anchor stays where it was and
+         * the new interval is still a multiple of the grid length.
+         */
+        if ((upd->winoffset != 0) ||
+            (connsm->conn_itvl % BLE_LL_SCHED_GRID_ITVL)) {
+            ble_ll_sched_grid_release(connsm);
+        }
+#endif
         if (upd->winoffset != 0) {
             usecs = upd->winoffset * BLE_LL_CONN_ITVL_USECS;
             ticks = os_cputime_usecs_to_ticks(usecs);
@@ -2362,6 +2418,11 @@ ble_ll_conn_next_event(struct ble_ll_conn_sm *connsm)
     itvl = g_ble_ll_sched_data.sch_ticks_per_period;
 #else
     itvl = MYNEWT_VAL(BLE_LL_CONN_INIT_SLOTS) * BLE_LL_SCHED_32KHZ_TICKS_PER_SLOT;
+#endif
+#if MYNEWT_VAL(BLE_LL_SCHED_CONN_GRID)
+    if (connsm->sch_grid_cell != BLE_LL_SCHED_GRID_CELL_NONE) {
+        itvl = g_ble_ll_sched_grid.ticks_per_cell;
+    }
 #endif
     if (connsm->conn_role == BLE_LL_CONN_ROLE_SLAVE) {
         cur_ww = ble_ll_conn_calc_window_widening(connsm);
@@ -2484,6 +2545,7 @@ ble_ll_conn_created(struct ble_ll_conn_sm *connsm, struct ble_mbuf_hdr *rxhdr)
 
         /* Start the scheduler for the first connection event */
         while (ble_ll_sched_slave_new(connsm)) {
+            ++connsm->sched_stats.skipped;
             if (ble_ll_conn_next_event(connsm)) {
                 STATS_INC(ble_ll_conn_stats, cant_set_sched);
                 rc = 0;
@@ -2612,6 +2674,7 @@ ble_ll_conn_event_end(struct os_event *ev)
        we may want to force the first event to be scheduled. Not sure */
     /* Schedule the next connection event */
     while (ble_ll_sched_conn_reschedule(connsm)) {
+        ++connsm->sched_stats.skipped;
         if (ble_ll_conn_next_event(connsm)) {
             ble_ll_conn_end(connsm, BLE_ERR_CONN_TERM_LOCAL);
             return;
@@ -3559,7 +3622,7 @@ ble_ll_conn_rx_isr_end(uint8_t *rxbuf, struct ble_mbuf_hdr *rxhdr)
     uint8_t conn_sn;
     uint8_t conn_nesn;
     uint8_t reply;
-    uint8_t rem_bytes;
+    uint16_t rem_bytes;
     uint8_t opcode = 0;
     uint8_t rx_pyld_len;
     uint32_t endtime;
@@ -3833,7 +3896,6 @@ ble_ll_conn_enqueue_pkt(struct ble_ll_conn_sm *connsm, struct os_mbuf *om,
 
     /* Set BLE transmit header */
     ble_hdr = BLE_MBUF_HDR_PTR(om);
-    ble_hdr->txinfo.flags = 0;
     ble_hdr->txinfo.offset = 0;
     ble_hdr->txinfo.hdr_byte = hdr_byte;
 
@@ -1376,12 +1376,22 @@ ble_ll_ctrl_conn_upd_make(struct ble_ll_conn_sm *connsm, uint8_t *pyld,
         } else {
             req->winoffset = 0;
         }
+#if MYNEWT_VAL(BLE_LL_SCHED_CONN_GRID)
+        req->interval = ble_ll_sched_grid_itvl(cp->interval_min,
+                                               cp->interval_max);
+#else
         req->interval = cp->interval_max;
+#endif
         req->timeout = cp->timeout;
         req->latency = cp->latency;
         req->winsize = 1;
     } else {
+#if MYNEWT_VAL(BLE_LL_SCHED_CONN_GRID)
+        req->interval = ble_ll_sched_grid_itvl(hcu->conn_itvl_min,
+                                               hcu->conn_itvl_max);
+#else
         req->interval = hcu->conn_itvl_max;
+#endif
         req->timeout = hcu->supervision_timeout;
         req->latency = hcu->conn_latency;
         req->winoffset = 0;
@@ -59,6 +59,9 @@
 #if MYNEWT_VAL(BLE_LL_NUM_SCAN_RSP_ADVS) > 255
     #error "Cannot have more than 255 scan response entries!"
 #endif
+#if MYNEWT_VAL(BLE_LL_SCAN_RPT_BATCH_MAX) > BLE_HCI_LE_ADV_RPT_NUM_RPTS_MAX
+    #error "Too many advertising reports per event!"
+#endif
 
 #if MYNEWT_VAL(BLE_LL_CFG_FEAT_LL_EXT_ADV)
 static const uint8_t ble_ll_valid_scan_phy_mask = (BLE_HCI_LE_PHY_1M_PREF_MASK
@@ -620,6 +623,115 @@ ble_ll_hci_send_legacy_ext_adv_report(uint8_t evtype,
 }
 #endif
 
+#if MYNEWT_VAL(BLE_LL_SCAN_RPT_BATCH_MAX) > 1
+/**
+ * Sends the advertising report event currently being filled (if any) to the
+ * host.
+ */
+static void
+ble_ll_scan_adv_rpt_flush(struct ble_ll_scan_sm *scansm)
+{
+    uint8_t *evbuf;
+
+    evbuf = scansm->adv_rpt_evbuf;
+    if (evbuf) {
+        scansm->adv_rpt_evbuf = NULL;
+        ble_ll_hci_event_send(evbuf);
+    }
+}
+
+/**
+ * Called from the LL task once the receive work queued ahead of it has been
+ * processed. Any reports collected in the meantime go out in one event.
+ */
+static void
+ble_ll_scan_adv_rpt_flush_ev_cb(struct os_event *ev)
+{
+    ble_ll_scan_adv_rpt_flush((struct ble_ll_scan_sm *)ev->ev_arg);
+}
+
+/**
+ * Discards a partially filled advertising report event. Used on reset, when
+ * the host is no longer interested in anything we have queued.
+ */
+static void
+ble_ll_scan_adv_rpt_discard(struct ble_ll_scan_sm *scansm)
+{
+    os_eventq_remove(&g_ble_ll_data.ll_evq, &scansm->adv_rpt_flush_ev);
+    if (scansm->adv_rpt_evbuf) {
+        ble_hci_trans_buf_free(scansm->adv_rpt_evbuf);
+        scansm->adv_rpt_evbuf = NULL;
+    }
+}
+
+/**
+ * Appends a legacy advertising report to the pending LE Advertising Report
+ * event, allocating a new event if there is none or the pending one cannot
+ * hold the report. Reports are laid out one after another, which is the
+ * parameter ordering used for arrayed event parameters.
+ *
+ * @return int 0: report queued; -1 otherwise (no event buffer)
+ */
+static int
+ble_ll_scan_adv_rpt_batch_add(uint8_t evtype, uint8_t addr_type,
+                              uint8_t *addr, uint8_t rssi,
+                              uint8_t adv_data_len, uint8_t *adv_data)
+{
+    struct ble_ll_scan_sm *scansm;
+    uint8_t *evbuf;
+    uint8_t *tmp;
+    uint8_t rpt_len;
+
+    scansm = &g_ble_ll_scan_sm;
+
+    /* Size of this report (all fields except subevent and num reports) */
+    rpt_len = BLE_HCI_LE_ADV_RPT_MIN_LEN - 2 + adv_data_len;
+
+    /* Parameter length is a single byte; it also has to fit the buffer */
+    evbuf = scansm->adv_rpt_evbuf;
+    if (evbuf && (((evbuf[1] + rpt_len) > UINT8_MAX) ||
+                  ((evbuf[1] + rpt_len + BLE_HCI_EVENT_HDR_LEN) >
+                   MYNEWT_VAL(BLE_HCI_EVT_BUF_SIZE)))) {
+        ble_ll_scan_adv_rpt_flush(scansm);
+        evbuf = NULL;
+    }
+
+    if (!evbuf) {
+        evbuf = ble_hci_trans_buf_alloc(BLE_HCI_TRANS_BUF_EVT_LO);
+        if (!evbuf) {
+            return -1;
+        }
+
+        evbuf[0] = BLE_HCI_EVCODE_LE_META;
+        evbuf[1] = 2;       /* subevent and number of reports */
+        evbuf[2] = BLE_HCI_LE_SUBEV_ADV_RPT;
+        evbuf[3] = 0;
+        scansm->adv_rpt_evbuf = evbuf;
+
+        /* Send whatever we have once the LL task runs out of rx work */
+        ble_ll_event_send(&scansm->adv_rpt_flush_ev);
+    }
+
+    tmp = evbuf + BLE_HCI_EVENT_HDR_LEN + evbuf[1];
+    tmp[0] = evtype;
+    tmp[1] = addr_type;
+    memcpy(tmp + 2, addr, BLE_DEV_ADDR_LEN);
+    tmp[8] = adv_data_len;
+    memcpy(tmp + 9, adv_data, adv_data_len);
+    tmp[9 + adv_data_len] = rssi;
+
+    evbuf[1] += rpt_len;
+    ++evbuf[3];
+
+    if (evbuf[3] == MYNEWT_VAL(BLE_LL_SCAN_RPT_BATCH_MAX)) {
+        os_eventq_remove(&g_ble_ll_data.ll_evq, &scansm->adv_rpt_flush_ev);
+        ble_ll_scan_adv_rpt_flush(scansm);
+    }
+
+    return 0;
+}
+#endif
+
 static int
 ble_ll_hci_send_adv_report(uint8_t subev, uint8_t evtype,uint8_t event_len,
                            uint8_t addr_type, uint8_t *addr, uint8_t rssi,
@@ -632,6 +744,13 @@ ble_ll_hci_send_adv_report(uint8_t subev, uint8_t evtype,uint8_t event_len,
         return -1;
     }
 
+#if MYNEWT_VAL(BLE_LL_SCAN_RPT_BATCH_MAX) > 1
+    if (subev == BLE_HCI_LE_SUBEV_ADV_RPT) {
+        return ble_ll_scan_adv_rpt_batch_add(evtype, addr_type, addr, rssi,
+                                             adv_data_len, adv_data);
+    }
+#endif
+
     evbuf = ble_hci_trans_buf_alloc(BLE_HCI_TRANS_BUF_EVT_LO);
     if (!evbuf) {
         return -1;
@@ -667,8 +786,9 @@ ble_ll_hci_send_adv_report(uint8_t subev, uint8_t evtype,uint8_t event_len,
 /**
  * Send an advertising report to the host.
  *
- * NOTE: while we are allowed to send multiple devices in one report, we
- * will just send for one for now.
+ * NOTE: legacy (non-directed) reports are packed several per event when
+ * BLE_LL_SCAN_RPT_BATCH_MAX is greater than 1; all other reports are sent
+ * one per event.
  *
  * @param pdu_type
  * @param txadd
@@ -1059,6 +1179,12 @@ ble_ll_scan_sm_stop(int chk_disable)
     /* Disable scanning state machine */
     scansm->scan_enabled = 0;
 
+#if MYNEWT_VAL(BLE_LL_SCAN_RPT_BATCH_MAX) > 1
+    /* Do not hold on to reports; host expects them before scan stop */
+    os_eventq_remove(&g_ble_ll_data.ll_evq, &scansm->adv_rpt_flush_ev);
+    ble_ll_scan_adv_rpt_flush(scansm);
+#endif
+
 #if MYNEWT_VAL(BLE_LL_CFG_FEAT_LL_EXT_ADV)
     OS_ENTER_CRITICAL(sr);
     ble_ll_scan_clean_cur_aux_data();
@@ -2843,6 +2969,11 @@ ble_ll_scan_reset(void)
     /* Free the scan request pdu */
     os_mbuf_free_chain(scansm->scan_req_pdu);
 
+#if MYNEWT_VAL(BLE_LL_SCAN_RPT_BATCH_MAX) > 1
+    /* Drop any advertising reports not yet sent to the host */
+    ble_ll_scan_adv_rpt_discard(scansm);
+#endif
+
     /* Reset duplicate advertisers and those from which we rxd a response */
     g_ble_ll_scan_num_rsp_advs = 0;
     memset(&g_ble_ll_scan_rsp_advs[0], 0, sizeof(g_ble_ll_scan_rsp_advs));
@@ -2881,6 +3012,12 @@ ble_ll_scan_init(void)
     scansm->scan_sched_ev.ev_cb = ble_ll_scan_event_proc;
     scansm->scan_sched_ev.ev_arg = scansm;
 
+#if MYNEWT_VAL(BLE_LL_SCAN_RPT_BATCH_MAX) > 1
+    /* Initialize advertising report flush event */
+    scansm->adv_rpt_flush_ev.ev_cb = ble_ll_scan_adv_rpt_flush_ev_cb;
+    scansm->adv_rpt_flush_ev.ev_arg = scansm;
+#endif
+
     for (i = 0; i < BLE_LL_SCAN_PHY_NUMBER; i++) {
         /* Set all non-zero default parameters */
         scanp = &g_ble_ll_scan_params[i];
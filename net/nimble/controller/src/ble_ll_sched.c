@@ -69,6 +69,10 @@ TAILQ_HEAD(ll_sched_qhead, ble_ll_sched_item) g_ble_ll_sched_q;
 struct ble_ll_sched_obj g_ble_ll_sched_data;
 #endif
 
+#if MYNEWT_VAL(BLE_LL_SCHED_CONN_GRID)
+struct ble_ll_sched_grid g_ble_ll_sched_grid;
+#endif
+
 /**
  * Checks if two events in the schedule will overlap in time. NOTE: consecutive
  * schedule items can end and start at the same time.
@@ -129,6 +133,7 @@ ble_ll_sched_conn_overlap(struct ble_ll_sched_item *entry)
     /* Should only be advertising or a connection here */
     if (entry->sched_type == BLE_LL_SCHED_TYPE_CONN) {
         connsm = (struct ble_ll_conn_sm *)entry->cb_arg;
+        ++connsm->sched_stats.preempted;
         entry->enqueued = 0;
         TAILQ_REMOVE(&g_ble_ll_sched_q, entry, link);
         ble_ll_event_send(&connsm->conn_ev_end);
@@ -241,6 +246,7 @@ ble_ll_sched_conn_reschedule(struct ble_ll_conn_sm *connsm)
         switch (entry->sched_type) {
             case BLE_LL_SCHED_TYPE_CONN:
             tmp = (struct ble_ll_conn_sm *)entry->cb_arg;
+            ++tmp->sched_stats.preempted;
             ble_ll_event_send(&tmp->conn_ev_end);
             break;
             case BLE_LL_SCHED_TYPE_ADV:
@@ -288,6 +294,211 @@ ble_ll_sched_conn_reschedule(struct ble_ll_conn_sm *connsm)
     return rc;
 }
 
+#if MYNEWT_VAL(BLE_LL_SCHED_CONN_GRID)
+/**
+ * Picks the connection interval for a new master connection (or a master
+ * initiated update). This is the largest multiple of the grid length inside
+ * the allowed range; if there is none the maximum is used and the link will
+ * not be placed on the grid.
+ *
+ * @param itvl_min Minimum connection interval (1.25 msec units)
+ * @param itvl_max Maximum connection interval (1.25 msec units)
+ *
+ * @return uint16_t Connection interval to use
+ */
+uint16_t
+ble_ll_sched_grid_itvl(uint16_t itvl_min, uint16_t itvl_max)
+{
+    uint16_t itvl;
+
+    itvl = itvl_max - (itvl_max % BLE_LL_SCHED_GRID_ITVL);
+    if ((itvl == 0) || (itvl < itvl_min)) {
+        itvl = itvl_max;
+    }
+
+    return itvl;
+}
+
+/**
+ * Finds the first free cell starting at or after the given offset into the
+ * grid.
+ *
+ * @param occ_mask      Mask of cells that cannot be used
+ * @param pos_usecs     Offset into the grid (less than the grid length)
+ * @param delay_usecs   Time from pos_usecs until the cell starts
+ *
+ * @return int The cell or -1 if all cells are occupied
+ */
+int
+ble_ll_sched_grid_cell_find(uint32_t occ_mask, uint32_t pos_usecs,
+                            uint32_t *delay_usecs)
+{
+    uint32_t cell_start;
+    int cell;
+    int i;
+
+    cell = (pos_usecs + BLE_LL_SCHED_GRID_CELL_USECS - 1) /
+           BLE_LL_SCHED_GRID_CELL_USECS;
+    cell_start = cell * BLE_LL_SCHED_GRID_CELL_USECS;
+
+    for (i = 0; i < BLE_LL_SCHED_GRID_CELLS; ++i) {
+        if (cell == BLE_LL_SCHED_GRID_CELLS) {
+            cell = 0;
+        }
+        if (!(occ_mask & ((uint32_t)1 << cell))) {
+            *delay_usecs = cell_start - pos_usecs;
+            return cell;
+        }
+        ++cell;
+        cell_start += BLE_LL_SCHED_GRID_CELL_USECS;
+    }
+
+    return -1;
+}
+
+void
+ble_ll_sched_grid_release(struct ble_ll_conn_sm *connsm)
+{
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    if (connsm->sch_grid_cell != BLE_LL_SCHED_GRID_CELL_NONE) {
+        g_ble_ll_sched_grid.occ_cell_mask &=
+            ~((uint32_t)1 << connsm->sch_grid_cell);
+        connsm->sch_grid_cell = BLE_LL_SCHED_GRID_CELL_NONE;
+    }
+    OS_EXIT_CRITICAL(sr);
+}
+
+/**
+ * Returns the offset into the grid of a schedule start time. The grid is
+ * located using the anchor point of a link already on it; if there is no
+ * such link the grid starts at the given time.
+ */
+static uint32_t
+ble_ll_sched_grid_pos(struct ble_ll_conn_sm *connsm, uint32_t start_time)
+{
+    struct ble_ll_conn_sm *ref;
+    int32_t ticks;
+    int32_t usecs;
+
+    SLIST_FOREACH(ref, &g_ble_ll_conn_active_list, act_sle) {
+        if ((ref != connsm) &&
+            (ref->sch_grid_cell != BLE_LL_SCHED_GRID_CELL_NONE)) {
+            break;
+        }
+    }
+
+    if (!ref) {
+        return 0;
+    }
+
+    /* Time from the start of the reference link's cell to start_time */
+    ticks = (int32_t)(start_time + g_ble_ll_sched_offset_ticks -
+                      ref->anchor_point);
+    if (ticks >= 0) {
+        usecs = os_cputime_ticks_to_usecs(ticks);
+    } else {
+        usecs = -(int32_t)os_cputime_ticks_to_usecs(-ticks);
+    }
+    usecs -= ref->anchor_point_usecs;
+    usecs += ref->sch_grid_cell * BLE_LL_SCHED_GRID_CELL_USECS;
+
+    usecs %= (int32_t)BLE_LL_SCHED_GRID_USECS;
+    if (usecs < 0) {
+        usecs += BLE_LL_SCHED_GRID_USECS;
+    }
+
+    return usecs;
+}
+
+/**
+ * Tries to schedule the first connection event of a new master connection
+ * at the start of a free grid cell. A cell is skipped if something else is
+ * already scheduled there.
+ *
+ * Context: Interrupt, with interrupts disabled
+ *
+ * @param connsm
+ * @param earliest_start Earliest allowed start time of the event
+ *
+ * @return int 0: scheduled on the grid; -1: not scheduled
+ */
+static int
+ble_ll_sched_grid_master_new(struct ble_ll_conn_sm *connsm,
+                             uint32_t earliest_start)
+{
+    int cell;
+    uint32_t occ_mask;
+    uint32_t pos_usecs;
+    uint32_t delay_usecs;
+    uint32_t delay_ticks;
+    struct ble_ll_sched_item *entry;
+    struct ble_ll_sched_item *sch;
+
+    if (connsm->conn_itvl % BLE_LL_SCHED_GRID_ITVL) {
+        return -1;
+    }
+
+    sch = &connsm->conn_sch;
+    pos_usecs = ble_ll_sched_grid_pos(connsm, earliest_start);
+    occ_mask = g_ble_ll_sched_grid.occ_cell_mask;
+
+    while (1) {
+        cell = ble_ll_sched_grid_cell_find(occ_mask, pos_usecs, &delay_usecs);
+        if (cell < 0) {
+            return -1;
+        }
+
+        delay_ticks = os_cputime_usecs_to_ticks(delay_usecs);
+        sch->start_time = earliest_start + delay_ticks;
+        sch->end_time = sch->start_time + g_ble_ll_sched_grid.ticks_per_cell;
+
+        TAILQ_FOREACH(entry, &g_ble_ll_sched_q, link) {
+            if (((int32_t)(sch->end_time - entry->start_time) <= 0) ||
+                ble_ll_sched_is_overlap(sch, entry)) {
+                break;
+            }
+        }
+
+        if (!entry) {
+            TAILQ_INSERT_TAIL(&g_ble_ll_sched_q, sch, link);
+            break;
+        }
+        if (!ble_ll_sched_is_overlap(sch, entry)) {
+            TAILQ_INSERT_BEFORE(entry, sch, link);
+            break;
+        }
+
+        /* Busy right now; try the next free cell */
+        occ_mask |= (uint32_t)1 << cell;
+    }
+
+    sch->enqueued = 1;
+
+    /*
+     * Unlike the default placement, keep the sub-tick part of the start of
+     * the cell so that this link stays exactly on the grid.
+     */
+    connsm->anchor_point = sch->start_time + g_ble_ll_sched_offset_ticks;
+    connsm->anchor_point_usecs = delay_usecs -
+                                 os_cputime_ticks_to_usecs(delay_ticks);
+    if (connsm->anchor_point_usecs >= 31) {
+        ++connsm->anchor_point;
+        connsm->anchor_point_usecs -= 31;
+    }
+    sch->remainder = connsm->anchor_point_usecs;
+    connsm->ce_end_time = sch->end_time;
+    connsm->tx_win_off = os_cputime_ticks_to_usecs(delay_ticks) /
+                         BLE_LL_CONN_TX_OFF_USECS;
+
+    connsm->sch_grid_cell = cell;
+    g_ble_ll_sched_grid.occ_cell_mask |= (uint32_t)1 << cell;
+
+    return 0;
+}
+#endif
+
 /**
  * Called to schedule a connection when the current role is master.
  *
@@ -370,7 +581,7 @@ ble_ll_sched_master_new(struct ble_ll_conn_sm *connsm,
      * wont be listening. We could do better calculation if we wanted to use
      * a transmit window of 1 as opposed to 2, but for now we dont care.
      */
-    dur = os_cputime_usecs_to_ticks(g_ble_ll_sched_data.sch_ticks_per_period);
+    dur = g_ble_ll_sched_data.sch_ticks_per_period;
     adv_rxend = os_cputime_get32();
     if (ble_hdr->rxinfo.channel >= BLE_PHY_NUM_DATA_CHANS) {
         /*
@@ -434,7 +645,7 @@ ble_ll_sched_master_new(struct ble_ll_conn_sm *connsm,
 
         /* Now find first un-occupied period starting from cp */
         for (i = 0; i < BLE_LL_SCHED_PERIODS; ++i) {
-            if (g_ble_ll_sched_data.sch_occ_period_mask & (1 << cp)) {
+            if (g_ble_ll_sched_data.sch_occ_period_mask & ((uint32_t)1 << cp)) {
                 ++cp;
                 if (cp == BLE_LL_SCHED_PERIODS) {
                     cp = 0;
@@ -515,7 +726,7 @@ ble_ll_sched_master_new(struct ble_ll_conn_sm *connsm,
         connsm->anchor_point = earliest_start + g_ble_ll_sched_offset_ticks;
         connsm->anchor_point_usecs = 0;
         connsm->ce_end_time = earliest_end;
-        connsm->period_occ_mask = (1 << cp);
+        connsm->period_occ_mask = ((uint32_t)1 << cp);
         g_ble_ll_sched_data.sch_occ_period_mask |= connsm->period_occ_mask;
         ++g_ble_ll_sched_data.sch_num_occ_periods;
     }
@@ -636,6 +847,18 @@ ble_ll_sched_master_new(struct ble_ll_conn_sm *connsm,
     /* We have to find a place for this schedule */
     OS_ENTER_CRITICAL(sr);
 
+#if MYNEWT_VAL(BLE_LL_SCHED_CONN_GRID)
+    /* Place the link on the grid if possible; if not, schedule as usual */
+    ble_ll_sched_grid_release(connsm);
+    os_cputime_timer_stop(&g_ble_ll_sched_timer);
+    if (!ble_ll_sched_grid_master_new(connsm, earliest_start)) {
+        sch = TAILQ_FIRST(&g_ble_ll_sched_q);
+        OS_EXIT_CRITICAL(sr);
+        os_cputime_timer_start(&g_ble_ll_sched_timer, sch->start_time);
+        return 0;
+    }
+#endif
+
     /* The schedule item must occur after current running item (if any) */
     sch->start_time = earliest_start;
     initial_start = earliest_start;
@@ -1472,5 +1695,12 @@ ble_ll_sched_init(void)
         g_ble_ll_sched_data.sch_ticks_per_period;
 #endif
 
+#if MYNEWT_VAL(BLE_LL_SCHED_CONN_GRID)
+    memset(&g_ble_ll_sched_grid, 0, sizeof(struct ble_ll_sched_grid));
+    g_ble_ll_sched_grid.ticks_per_cell =
+        os_cputime_usecs_to_ticks(BLE_LL_SCHED_GRID_CELL_USECS) -
+        BLE_LL_SCHED_GRID_GUARD_TICKS;
+#endif
+
     return 0;
 }
@@ -0,0 +1,440 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "os/os.h"
+#include "testutil/testutil.h"
+#include "controller/ble_ll_test.h"
+#include "controller/ble_ll_conn.h"
+#include "controller/ble_ll_sched.h"
+#include "controller/ble_phy.h"
+#include "ble_ll_conn_priv.h"
+
+/*
+ * The simulation below runs on its own clock, in usecs. Links are created
+ * one after another at somewhat random times, each with a connection
+ * interval range picked by a "host", and placed by the real scheduler. Their
+ * events are then played out and every event that starts while another one
+ * is still running is counted as missed, as the real scheduler would have to
+ * drop one of them.
+ *
+ * The OS is not started, so cputime stands still. Before each link is
+ * created, the next event of every existing link is put in the schedule at
+ * its offset from the current simulation time; the new link's first event
+ * is read back from the schedule the same way.
+ */
+
+#define BLE_LL_SCHED_TEST_MAX_LINKS     (32)
+#define BLE_LL_SCHED_TEST_RUN_USECS     (30 * 1000000ULL)
+
+/* Connection event length; nearly a whole cell */
+#define BLE_LL_SCHED_TEST_CE_USECS      (BLE_LL_SCHED_GRID_CELL_USECS - 100)
+
+/* Shortest interval used by the test host */
+#define BLE_LL_SCHED_TEST_MIN_ITVL      (100)
+#define BLE_LL_SCHED_TEST_MAX_EVENTS    \
+    (BLE_LL_SCHED_TEST_MAX_LINKS *      \
+     (BLE_LL_SCHED_TEST_RUN_USECS /     \
+      (BLE_LL_SCHED_TEST_MIN_ITVL * BLE_LL_SCHED_USECS_PER_SLOT) + 1))
+
+struct ble_ll_sched_test_link {
+    uint64_t first_ce;
+    uint32_t itvl_usecs;
+    struct ble_ll_conn_sched_stats stats;
+};
+
+struct ble_ll_sched_test_event {
+    uint64_t start;
+    int link;
+};
+
+static struct ble_ll_sched_test_link
+    ble_ll_sched_test_links[BLE_LL_SCHED_TEST_MAX_LINKS];
+static struct ble_ll_conn_sm
+    ble_ll_sched_test_conns[BLE_LL_SCHED_TEST_MAX_LINKS];
+static struct ble_ll_sched_test_event
+    ble_ll_sched_test_events[BLE_LL_SCHED_TEST_MAX_EVENTS];
+
+static uint32_t ble_ll_sched_test_seed;
+
+static uint32_t
+ble_ll_sched_test_rand(void)
+{
+    ble_ll_sched_test_seed = ble_ll_sched_test_seed * 1103515245 + 12345;
+    return ble_ll_sched_test_seed >> 8;
+}
+
+static void
+ble_ll_sched_test_cputime_init(void)
+{
+    static int initialized;
+
+    /* The native BSP leaves cputime to the application */
+    if (!initialized) {
+        TEST_ASSERT_FATAL(os_cputime_init(MYNEWT_VAL(OS_CPUTIME_FREQ)) == 0);
+        initialized = 1;
+    }
+}
+
+/**
+ * Sets the anchor point of a link to the given number of usecs from now.
+ */
+static void
+ble_ll_sched_test_anchor_set(struct ble_ll_conn_sm *connsm, uint32_t now,
+                             uint32_t usecs)
+{
+    uint32_t ticks;
+
+    ticks = os_cputime_usecs_to_ticks(usecs);
+    while (os_cputime_ticks_to_usecs(ticks + 1) <= usecs) {
+        ++ticks;
+    }
+    while (os_cputime_ticks_to_usecs(ticks) > usecs) {
+        --ticks;
+    }
+
+    connsm->anchor_point = now + ticks + g_ble_ll_sched_offset_ticks;
+    connsm->anchor_point_usecs = usecs - os_cputime_ticks_to_usecs(ticks);
+}
+
+/**
+ * Returns the number of usecs from now to the anchor point of a link.
+ */
+static uint32_t
+ble_ll_sched_test_anchor_get(struct ble_ll_conn_sm *connsm, uint32_t now)
+{
+    return os_cputime_ticks_to_usecs(connsm->anchor_point -
+                                     g_ble_ll_sched_offset_ticks - now) +
+           connsm->anchor_point_usecs;
+}
+
+/**
+ * Puts the next event of each of the given links that starts at or after
+ * the given simulation time in the schedule. Two events that collide would
+ * make the scheduler preempt one of them, so a link whose next event
+ * collides with one already put in gets its following event put in instead.
+ */
+static void
+ble_ll_sched_test_resched(int num_links, uint64_t start, uint32_t now)
+{
+    struct ble_ll_sched_test_link *link;
+    struct ble_ll_conn_sm *connsm;
+    struct ble_ll_sched_item *other;
+    uint32_t start_time;
+    uint32_t end_time;
+    uint32_t ce_ticks;
+    uint64_t ce;
+    uint64_t n;
+    int rc;
+    int i;
+    int j;
+
+    for (i = 0; i < num_links; i++) {
+        link = ble_ll_sched_test_links + i;
+        connsm = ble_ll_sched_test_conns + i;
+
+        if (connsm->sch_grid_cell == BLE_LL_SCHED_GRID_CELL_NONE) {
+            ce_ticks = MYNEWT_VAL(BLE_LL_CONN_INIT_SLOTS) *
+                       BLE_LL_SCHED_32KHZ_TICKS_PER_SLOT;
+        } else {
+            ce_ticks = g_ble_ll_sched_grid.ticks_per_cell;
+        }
+
+        ce = link->first_ce;
+        if (ce < start) {
+            n = (start - ce + link->itvl_usecs - 1) / link->itvl_usecs;
+            ce += n * link->itvl_usecs;
+        }
+
+        while (1) {
+            ble_ll_sched_test_anchor_set(connsm, now, ce - start);
+            start_time = connsm->anchor_point - g_ble_ll_sched_offset_ticks;
+            end_time = start_time + ce_ticks;
+
+            for (j = 0; j < i; j++) {
+                other = &ble_ll_sched_test_conns[j].conn_sch;
+                if ((int32_t)(end_time - other->start_time) > 0 &&
+                    (int32_t)(other->end_time - start_time) > 0) {
+                    break;
+                }
+            }
+            if (j == i) {
+                break;
+            }
+
+            ce += link->itvl_usecs;
+        }
+        connsm->ce_end_time = end_time;
+
+        rc = ble_ll_sched_conn_reschedule(connsm);
+        TEST_ASSERT_FATAL(rc == 0);
+    }
+}
+
+static int
+ble_ll_sched_test_event_cmp(const void *a, const void *b)
+{
+    const struct ble_ll_sched_test_event *ea;
+    const struct ble_ll_sched_test_event *eb;
+
+    ea = a;
+    eb = b;
+    if (ea->start < eb->start) {
+        return -1;
+    }
+    if (ea->start > eb->start) {
+        return 1;
+    }
+    return ea->link - eb->link;
+}
+
+/**
+ * Plays out the events of all links and returns the number of events
+ * missed because of overlap.
+ */
+static int
+ble_ll_sched_test_run(int num_links)
+{
+    struct ble_ll_sched_test_link *link;
+    struct ble_ll_sched_test_event *ev;
+    uint64_t busy_until;
+    uint64_t ce;
+    int num_events;
+    int missed;
+    int i;
+
+    num_events = 0;
+    for (i = 0; i < num_links; i++) {
+        link = ble_ll_sched_test_links + i;
+        for (ce = link->first_ce; ce < BLE_LL_SCHED_TEST_RUN_USECS;
+             ce += link->itvl_usecs) {
+
+            TEST_ASSERT_FATAL(num_events < BLE_LL_SCHED_TEST_MAX_EVENTS);
+            ble_ll_sched_test_events[num_events].start = ce;
+            ble_ll_sched_test_events[num_events].link = i;
+            num_events++;
+        }
+    }
+
+    qsort(ble_ll_sched_test_events, num_events,
+          sizeof ble_ll_sched_test_events[0], ble_ll_sched_test_event_cmp);
+
+    busy_until = 0;
+    missed = 0;
+    for (i = 0; i < num_events; i++) {
+        ev = ble_ll_sched_test_events + i;
+        link = ble_ll_sched_test_links + ev->link;
+        if (ev->start < busy_until) {
+            ++link->stats.skipped;
+            ++missed;
+        } else {
+            ++link->stats.events;
+            busy_until = ev->start + BLE_LL_SCHED_TEST_CE_USECS;
+        }
+    }
+
+    return missed;
+}
+
+/**
+ * Creates the given number of links with ble_ll_sched_master_new() and
+ * returns the number of missed events. With grid set, the interval is
+ * picked as the connection code does and the links go on the grid;
+ * otherwise the largest interval of the range that is not a multiple of the
+ * grid length is used, and the links are placed at the earliest free time.
+ */
+static int
+ble_ll_sched_test_links_create(int num_links, int grid)
+{
+    struct ble_ll_sched_test_link *link;
+    struct ble_ll_conn_sm *connsm;
+    struct ble_mbuf_hdr ble_hdr;
+    uint32_t occ_mask;
+    uint32_t cputime;
+    uint64_t now;
+    uint16_t itvl_min;
+    uint16_t itvl_max;
+    uint16_t itvl;
+    int rc;
+    int i;
+    int j;
+
+    ble_ll_sched_test_cputime_init();
+
+    memset(ble_ll_sched_test_links, 0, sizeof ble_ll_sched_test_links);
+    memset(ble_ll_sched_test_conns, 0, sizeof ble_ll_sched_test_conns);
+    SLIST_INIT(&g_ble_ll_conn_active_list);
+    g_ble_ll_sched_grid.occ_cell_mask = 0;
+    ble_ll_sched_test_seed = 0x5eed + num_links;
+
+    /* Connect request received on an advertising channel */
+    memset(&ble_hdr, 0, sizeof ble_hdr);
+    ble_hdr.rxinfo.channel = BLE_PHY_NUM_DATA_CHANS;
+    ble_hdr.rxinfo.phy = BLE_PHY_1M;
+
+    cputime = os_cputime_get32();
+    now = 0;
+    for (i = 0; i < num_links; i++) {
+        link = ble_ll_sched_test_links + i;
+        connsm = ble_ll_sched_test_conns + i;
+
+        now += 250000 + ble_ll_sched_test_rand() % 100000;
+        itvl_min = BLE_LL_SCHED_TEST_MIN_ITVL +
+                   ble_ll_sched_test_rand() % BLE_LL_SCHED_GRID_ITVL;
+        itvl_max = itvl_min + BLE_LL_SCHED_GRID_ITVL +
+                   ble_ll_sched_test_rand() % 64;
+
+        if (grid) {
+            itvl = ble_ll_sched_grid_itvl(itvl_min, itvl_max);
+            TEST_ASSERT_FATAL(itvl >= itvl_min && itvl <= itvl_max);
+            TEST_ASSERT_FATAL(itvl % BLE_LL_SCHED_GRID_ITVL == 0);
+        } else {
+            itvl = itvl_max;
+            if (itvl % BLE_LL_SCHED_GRID_ITVL == 0) {
+                --itvl;
+            }
+        }
+
+        ble_ll_sched_test_resched(i, now, cputime);
+
+        connsm->conn_role = BLE_LL_CONN_ROLE_MASTER;
+        connsm->conn_itvl = itvl;
+        connsm->conn_itvl_ticks =
+            os_cputime_usecs_to_ticks(itvl * BLE_LL_SCHED_USECS_PER_SLOT);
+        connsm->sch_grid_cell = BLE_LL_SCHED_GRID_CELL_NONE;
+        connsm->conn_sch.sched_type = BLE_LL_SCHED_TYPE_CONN;
+        connsm->conn_sch.cb_arg = connsm;
+
+        occ_mask = g_ble_ll_sched_grid.occ_cell_mask;
+        rc = ble_ll_sched_master_new(connsm, &ble_hdr, 0);
+        TEST_ASSERT_FATAL(rc == 0);
+        SLIST_INSERT_HEAD(&g_ble_ll_conn_active_list, connsm, act_sle);
+
+        if (grid) {
+            /* Took a cell that was free */
+            TEST_ASSERT_FATAL(connsm->sch_grid_cell <
+                              BLE_LL_SCHED_GRID_CELLS);
+            TEST_ASSERT(!(occ_mask & ((uint32_t)1 << connsm->sch_grid_cell)));
+        } else {
+            TEST_ASSERT_FATAL(connsm->sch_grid_cell ==
+                              BLE_LL_SCHED_GRID_CELL_NONE);
+        }
+
+        link->first_ce = now + ble_ll_sched_test_anchor_get(connsm, cputime);
+        link->itvl_usecs = itvl * BLE_LL_SCHED_USECS_PER_SLOT;
+
+        for (j = 0; j <= i; j++) {
+            ble_ll_sched_rmv_elem(&ble_ll_sched_test_conns[j].conn_sch);
+        }
+    }
+
+    for (i = 0; i < num_links; i++) {
+        ble_ll_sched_grid_release(ble_ll_sched_test_conns + i);
+    }
+    SLIST_INIT(&g_ble_ll_conn_active_list);
+
+    return ble_ll_sched_test_run(num_links);
+}
+
+TEST_CASE(ble_ll_sched_test_grid_cell)
+{
+    uint32_t delay;
+    int cell;
+
+    /* Interval range without a multiple of the grid; use the maximum */
+    TEST_ASSERT(ble_ll_sched_grid_itvl(BLE_LL_SCHED_GRID_ITVL + 1,
+                                       BLE_LL_SCHED_GRID_ITVL + 2) ==
+                BLE_LL_SCHED_GRID_ITVL + 2);
+    TEST_ASSERT(ble_ll_sched_grid_itvl(6, BLE_LL_SCHED_GRID_ITVL - 1) ==
+                BLE_LL_SCHED_GRID_ITVL - 1);
+
+    /* Largest multiple in the range */
+    TEST_ASSERT(ble_ll_sched_grid_itvl(6, 3 * BLE_LL_SCHED_GRID_ITVL - 1) ==
+                2 * BLE_LL_SCHED_GRID_ITVL);
+
+    /* Empty grid; next cell boundary */
+    cell = ble_ll_sched_grid_cell_find(0, 0, &delay);
+    TEST_ASSERT(cell == 0 && delay == 0);
+    cell = ble_ll_sched_grid_cell_find(0, 1, &delay);
+    TEST_ASSERT(cell == 1 && delay == BLE_LL_SCHED_GRID_CELL_USECS - 1);
+
+    /* Occupied cells are skipped */
+    cell = ble_ll_sched_grid_cell_find(0x3, 0, &delay);
+    TEST_ASSERT(cell == 2 && delay == 2 * BLE_LL_SCHED_GRID_CELL_USECS);
+
+    /* Search wraps around the end of the grid */
+    cell = ble_ll_sched_grid_cell_find(
+        (uint32_t)1 << (BLE_LL_SCHED_GRID_CELLS - 1),
+        BLE_LL_SCHED_GRID_USECS - BLE_LL_SCHED_GRID_CELL_USECS + 1, &delay);
+    TEST_ASSERT(cell == 0 && delay == BLE_LL_SCHED_GRID_CELL_USECS - 1);
+
+    /* Full grid */
+    cell = ble_ll_sched_grid_cell_find(
+        (uint32_t)(((uint64_t)1 << BLE_LL_SCHED_GRID_CELLS) - 1), 0, &delay);
+    TEST_ASSERT(cell == -1);
+}
+
+TEST_CASE(ble_ll_sched_test_grid_links)
+{
+    int grid_missed;
+    int earliest_missed;
+    int num_links;
+    int i;
+
+    for (num_links = 16; num_links <= BLE_LL_SCHED_GRID_CELLS;
+         num_links += 8) {
+
+        /* Earliest-fit placement cannot keep links with different
+         * intervals apart
+         */
+        earliest_missed = ble_ll_sched_test_links_create(num_links, 0);
+        TEST_ASSERT(earliest_missed > 0,
+                    "%d links: no events missed without the grid",
+                    num_links);
+
+        grid_missed = ble_ll_sched_test_links_create(num_links, 1);
+        TEST_ASSERT(grid_missed == 0,
+                    "%d links: %d events missed on grid, %d without",
+                    num_links, grid_missed, earliest_missed);
+
+        for (i = 0; i < num_links; i++) {
+            TEST_ASSERT(ble_ll_sched_test_links[i].stats.skipped == 0,
+                        "%d links: link %d skipped %d events",
+                        num_links, i,
+                        (int)ble_ll_sched_test_links[i].stats.skipped);
+            TEST_ASSERT(ble_ll_sched_test_links[i].stats.events > 0);
+        }
+    }
+}
+
+TEST_SUITE(ble_ll_sched_test_suite)
+{
+    ble_ll_sched_test_grid_cell();
+    ble_ll_sched_test_grid_links();
+}
+
+int
+ble_ll_sched_test_all(void)
+{
+    ble_ll_sched_test_suite();
+
+    return tu_any_failed;
+}
@@ -114,6 +114,7 @@ struct hci_conn_update;
 #define BLE_GAP_EVENT_REPEAT_PAIRING        17
 #define BLE_GAP_EVENT_PHY_UPDATE_COMPLETE   18
 #define BLE_GAP_EVENT_EXT_DISC              19
+#define BLE_GAP_EVENT_DISC_BATCH            20
 
 /*** Reason codes for the subscribe GAP event. */
 
@@ -206,6 +207,13 @@ struct ble_gap_disc_params {
     uint8_t limited:1;
     uint8_t passive:1;
     uint8_t filter_duplicates:1;
+
+    /**
+     * Deliver advertising reports in BLE_GAP_EVENT_DISC_BATCH events rather
+     * than one BLE_GAP_EVENT_DISC per report.  Requires
+     * BLE_GAP_DISC_BATCH_MAX to be nonzero; ignored otherwise.
+     */
+    uint8_t batch:1;
 };
 
 struct ble_gap_upd_params {
@@ -336,6 +344,21 @@ struct ble_gap_event {
          */
         struct ble_gap_disc_desc disc;
 
+        /**
+         * Represents a group of advertising reports received during a
+         * discovery procedure started with the batch option.  The report
+         * array is only valid for the duration of the callback.  Valid for
+         * the following event types:
+         *     o BLE_GAP_EVENT_DISC_BATCH
+         */
+        struct {
+            /** The number of entries in the reports array. */
+            int num_reports;
+
+            /** The received advertising reports, in order of reception. */
+            const struct ble_gap_disc_desc *reports;
+        } disc_batch;
+
 #if MYNEWT_VAL(BLE_EXT_ADV)
         /**
          * Represents an extended advertising report received during a discovery
@@ -75,6 +75,8 @@ struct ble_hs_conn;
 #define BLE_L2CAP_EVENT_COC_DISCONNECTED              1
 #define BLE_L2CAP_EVENT_COC_ACCEPT                    2
 #define BLE_L2CAP_EVENT_COC_DATA_RECEIVED             3
+#define BLE_L2CAP_EVENT_COC_DATA_RX_FRAG              4
+#define BLE_L2CAP_EVENT_COC_TX_UNSTALLED              5
 
 typedef void ble_l2cap_sig_update_fn(uint16_t conn_handle, int status,
                                      void *arg);
@@ -173,6 +175,53 @@ struct ble_l2cap_event {
             /** The mbuf with received SDU. */
             struct os_mbuf *sdu_rx;
         } receive;
+
+        /**
+         * Represents part of an SDU received on a channel in streaming receive
+         * mode (see ble_l2cap_set_rx_stream()). Valid for the following event
+         * types:
+         *     o BLE_L2CAP_EVENT_COC_DATA_RX_FRAG
+         */
+        struct {
+            /** Connection handle of the relevant connection */
+            uint16_t conn_handle;
+
+            /** The L2CAP channel of the relevant L2CAP connection. */
+            struct ble_l2cap_chan *chan;
+
+            /**
+             * The mbuf with received K-frame payload. The application owns
+             * it and is responsible for freeing it.
+             */
+            struct os_mbuf *om;
+
+            /** Total length of the SDU this data belongs to. */
+            uint16_t sdu_len;
+
+            /** Offset of this data within the SDU. */
+            uint16_t sdu_off;
+        } receive_frag;
+
+        /**
+         * Represents a channel which can accept SDUs for transmission again,
+         * after ble_l2cap_send() returned BLE_HS_EBUSY. Valid for the
+         * following event types:
+         *     o BLE_L2CAP_EVENT_COC_TX_UNSTALLED
+         */
+        struct {
+            /** Connection handle of the relevant connection */
+            uint16_t conn_handle;
+
+            /** The L2CAP channel of the relevant L2CAP connection. */
+            struct ble_l2cap_chan *chan;
+
+            /**
+             * The status of the SDU transmission that was in progress;
+             *     o 0: SDU was sent.
+             *     o BLE host error code: SDU was dropped.
+             */
+            int status;
+        } tx_unstalled;
     };
 };
 
@@ -188,6 +237,7 @@ int ble_l2cap_connect(uint16_t conn_handle, uint16_t psm, uint16_t mtu,
 int ble_l2cap_disconnect(struct ble_l2cap_chan *chan);
 int ble_l2cap_send(struct ble_l2cap_chan *chan, struct os_mbuf *sdu_tx);
 void ble_l2cap_recv_ready(struct ble_l2cap_chan *chan, struct os_mbuf *sdu_rx);
+int ble_l2cap_set_rx_stream(struct ble_l2cap_chan *chan, int enable);
 
 #ifdef __cplusplus
 }
@@ -206,27 +206,6 @@ ble_att_svr_find_by_uuid(struct ble_att_svr_entry *prev, const ble_uuid_t *uuid,
     return NULL;
 }
 
-static int
-ble_att_svr_pullup_req_base(struct os_mbuf **om, int base_len,
-                            uint8_t *out_att_err)
-{
-    uint8_t att_err;
-    int rc;
-
-    rc = ble_hs_mbuf_pullup_base(om, base_len);
-    if (rc == BLE_HS_ENOMEM) {
-        att_err = BLE_ATT_ERR_INSUFFICIENT_RES;
-    } else {
-        att_err = 0;
-    }
-
-    if (out_att_err != NULL) {
-        *out_att_err = att_err;
-    }
-
-    return rc;
-}
-
 static void
 ble_att_svr_get_sec_state(uint16_t conn_handle,
                           struct ble_gap_sec_state *out_sec_state)
@@ -733,6 +712,7 @@ int
 ble_att_svr_rx_mtu(uint16_t conn_handle, struct os_mbuf **rxom)
 {
     struct ble_att_mtu_cmd *cmd;
+    struct ble_att_mtu_cmd cmd_buf;
     struct ble_l2cap_chan *chan;
     struct ble_hs_conn *conn;
     struct os_mbuf *txom;
@@ -742,13 +722,14 @@ ble_att_svr_rx_mtu(uint16_t conn_handle, struct os_mbuf **rxom)
 
     txom = NULL;
     mtu = 0;
+    att_err = 0;
 
-    rc = ble_att_svr_pullup_req_base(rxom, sizeof(*cmd), &att_err);
-    if (rc != 0) {
+    cmd = os_mbuf_view(*rxom, 0, sizeof(*cmd), &cmd_buf);
+    if (cmd == NULL) {
+        rc = BLE_HS_EBADDATA;
         goto done;
     }
 
-    cmd = (struct ble_att_mtu_cmd *)(*rxom)->om_data;
     BLE_ATT_LOG_CMD(0, "mtu req", conn_handle, ble_att_mtu_cmd_log, cmd);
 
     mtu = le16toh(cmd->bamc_mtu);
@@ -921,6 +902,7 @@ ble_att_svr_rx_find_info(uint16_t conn_handle, struct os_mbuf **rxom)
 #endif
 
     struct ble_att_find_info_req *req;
+    struct ble_att_find_info_req req_buf;
     struct os_mbuf *txom;
     uint16_t err_handle, start_handle, end_handle;
     uint8_t att_err;
@@ -931,13 +913,13 @@ ble_att_svr_rx_find_info(uint16_t conn_handle, struct os_mbuf **rxom)
     att_err = 0;
     err_handle = 0;
 
-    rc = ble_att_svr_pullup_req_base(rxom, sizeof(*req), &att_err);
-    if (rc != 0) {
+    req = os_mbuf_view(*rxom, 0, sizeof(*req), &req_buf);
+    if (req == NULL) {
+        rc = BLE_HS_EBADDATA;
         err_handle = 0;
         goto done;
     }
 
-    req = (struct ble_att_find_info_req *)(*rxom)->om_data;
     start_handle = le16toh(req->bafq_start_handle);
     end_handle = le16toh(req->bafq_end_handle);
 
@@ -1233,6 +1215,7 @@ ble_att_svr_rx_find_type_value(uint16_t conn_handle, struct os_mbuf **rxom)
 #endif
 
     struct ble_att_find_type_value_req *req;
+    struct ble_att_find_type_value_req req_buf;
     uint16_t start_handle, end_handle;
     ble_uuid16_t attr_type;
     struct os_mbuf *txom;
@@ -1245,12 +1228,12 @@ ble_att_svr_rx_find_type_value(uint16_t conn_handle, struct os_mbuf **rxom)
     att_err = 0;
     err_handle = 0;
 
-    rc = ble_att_svr_pullup_req_base(rxom, sizeof(*req), &att_err);
-    if (rc != 0) {
+    req = os_mbuf_view(*rxom, 0, sizeof(*req), &req_buf);
+    if (req == NULL) {
+        rc = BLE_HS_EBADDATA;
         goto done;
     }
 
-    req = (struct ble_att_find_type_value_req *)(*rxom)->om_data;
     start_handle = le16toh(req->bavq_start_handle);
     end_handle = le16toh(req->bavq_end_handle);
     attr_type = (ble_uuid16_t) BLE_UUID16_INIT(le16toh(req->bavq_attr_type));
@@ -1408,6 +1391,7 @@ ble_att_svr_rx_read_type(uint16_t conn_handle, struct os_mbuf **rxom)
 #endif
 
     struct ble_att_read_type_req *req;
+    struct ble_att_read_type_req req_buf;
     uint16_t start_handle, end_handle;
     struct os_mbuf *txom;
     uint16_t err_handle;
@@ -1428,13 +1412,12 @@ ble_att_svr_rx_read_type(uint16_t conn_handle, struct os_mbuf **rxom)
         goto done;
     }
 
-    rc = ble_att_svr_pullup_req_base(rxom, pktlen, &att_err);
-    if (rc != 0) {
+    req = os_mbuf_view(*rxom, 0, sizeof(*req), &req_buf);
+    if (req == NULL) {
+        rc = BLE_HS_EBADDATA;
         goto done;
     }
 
-    req = (struct ble_att_read_type_req *)(*rxom)->om_data;
-
     BLE_ATT_LOG_CMD(0, "read type req", conn_handle, ble_att_read_type_req_log,
                     req);
 
@@ -1479,6 +1462,7 @@ ble_att_svr_rx_read(uint16_t conn_handle, struct os_mbuf **rxom)
 #endif
 
     struct ble_att_read_req *req;
+    struct ble_att_read_req req_buf;
     struct os_mbuf *txom;
     uint16_t err_handle;
     uint8_t att_err;
@@ -1489,12 +1473,12 @@ ble_att_svr_rx_read(uint16_t conn_handle, struct os_mbuf **rxom)
     att_err = 0;
     err_handle = 0;
 
-    rc = ble_att_svr_pullup_req_base(rxom, sizeof(*req), &att_err);
-    if (rc != 0) {
+    req = os_mbuf_view(*rxom, 0, sizeof(*req), &req_buf);
+    if (req == NULL) {
+        rc = BLE_HS_EBADDATA;
         goto done;
     }
 
-    req = (struct ble_att_read_req *)(*rxom)->om_data;
     BLE_ATT_LOG_CMD(0, "read req", conn_handle, ble_att_read_req_log, req);
 
     err_handle = le16toh(req->barq_handle);
@@ -1529,6 +1513,7 @@ ble_att_svr_rx_read_blob(uint16_t conn_handle, struct os_mbuf **rxom)
 #endif
 
     struct ble_att_read_blob_req *req;
+    struct ble_att_read_blob_req req_buf;
     struct os_mbuf *txom;
     uint16_t err_handle, offset;
     uint8_t att_err;
@@ -1539,12 +1524,12 @@ ble_att_svr_rx_read_blob(uint16_t conn_handle, struct os_mbuf **rxom)
     att_err = 0;
     err_handle = 0;
 
-    rc = ble_att_svr_pullup_req_base(rxom, sizeof(*req), &att_err);
-    if (rc != 0) {
+    req = os_mbuf_view(*rxom, 0, sizeof(*req), &req_buf);
+    if (req == NULL) {
+        rc = BLE_HS_EBADDATA;
         goto done;
     }
 
-    req = (struct ble_att_read_blob_req *)(*rxom)->om_data;
     BLE_ATT_LOG_CMD(0, "read blob req", conn_handle, ble_att_read_blob_req_log,
                     req);
 
@@ -1586,6 +1571,8 @@ ble_att_svr_build_read_mult_rsp(uint16_t conn_handle,
                                 uint16_t *err_handle)
 {
     struct os_mbuf *txom;
+    uint8_t handle_bytes[2];
+    uint8_t *handle_buf;
     uint16_t handle;
     uint16_t mtu;
     int rc;
@@ -1610,19 +1597,16 @@ ble_att_svr_build_read_mult_rsp(uint16_t conn_handle,
      * response is full.
      */
     while (OS_MBUF_PKTLEN(*rxom) >= 2 && OS_MBUF_PKTLEN(txom) < mtu) {
-        /* Ensure the full 16-bit handle is contiguous at the start of the
+        /* Extract the 16-bit handle and strip it from the front of the
          * mbuf.
          */
-        rc = ble_att_svr_pullup_req_base(rxom, 2, att_err);
-        if (rc != 0) {
+        handle_buf = os_mbuf_view(*rxom, 0, 2, handle_bytes);
+        if (handle_buf == NULL) {
             *err_handle = 0;
+            rc = BLE_HS_EBADDATA;
             goto done;
         }
-
-        /* Extract the 16-bit handle and strip it from the front of the
-         * mbuf.
-         */
-        handle = get_le16((*rxom)->om_data);
+        handle = get_le16(handle_buf);
         os_mbuf_adj(*rxom, 2);
 
         rc = ble_att_svr_read_handle(conn_handle, handle, 0, txom, att_err);
@@ -1906,6 +1890,7 @@ ble_att_svr_rx_read_group_type(uint16_t conn_handle, struct os_mbuf **rxom)
 #endif
 
     struct ble_att_read_group_type_req *req;
+    struct ble_att_read_group_type_req req_buf;
     struct os_mbuf *txom;
     ble_uuid_any_t uuid;
     uint16_t err_handle, start_handle, end_handle;
@@ -1926,12 +1911,12 @@ ble_att_svr_rx_read_group_type(uint16_t conn_handle, struct os_mbuf **rxom)
         goto done;
     }
 
-    rc = ble_att_svr_pullup_req_base(rxom, pktlen, &att_err);
-    if (rc != 0) {
+    req = os_mbuf_view(*rxom, 0, sizeof(*req), &req_buf);
+    if (req == NULL) {
+        rc = BLE_HS_EBADDATA;
         goto done;
     }
 
-    req = (struct ble_att_read_group_type_req *)(*rxom)->om_data;
     BLE_ATT_LOG_CMD(0, "read group type req", conn_handle,
                     ble_att_read_group_type_req_log, req);
 
@@ -2015,6 +2000,7 @@ ble_att_svr_rx_write(uint16_t conn_handle, struct os_mbuf **rxom)
 #endif
 
     struct ble_att_write_req *req;
+    struct ble_att_write_req req_buf;
     struct os_mbuf *txom;
     uint16_t handle;
     uint8_t att_err;
@@ -2025,13 +2011,12 @@ ble_att_svr_rx_write(uint16_t conn_handle, struct os_mbuf **rxom)
     att_err = 0;
     handle = 0;
 
-    rc = ble_att_svr_pullup_req_base(rxom, sizeof(*req), &att_err);
-    if (rc != 0) {
+    req = os_mbuf_view(*rxom, 0, sizeof(*req), &req_buf);
+    if (req == NULL) {
+        rc = BLE_HS_EBADDATA;
         goto done;
     }
 
-    req = (struct ble_att_write_req *)(*rxom)->om_data;
-
     BLE_ATT_LOG_CMD(0, "write req", conn_handle,
                     ble_att_write_req_log, req);
 
@@ -2071,16 +2056,17 @@ ble_att_svr_rx_write_no_rsp(uint16_t conn_handle, struct os_mbuf **rxom)
 #endif
 
     struct ble_att_write_req *req;
+    struct ble_att_write_req req_buf;
     uint8_t att_err;
     uint16_t handle;
     int rc;
 
-    rc = ble_att_svr_pullup_req_base(rxom, sizeof(*req), &att_err);
-    if (rc != 0) {
+    req = os_mbuf_view(*rxom, 0, sizeof(*req), &req_buf);
+    if (req == NULL) {
+        rc = BLE_HS_EBADDATA;
         return rc;
     }
 
-    req = (struct ble_att_write_req *)(*rxom)->om_data;
     BLE_ATT_LOG_CMD(0, "write cmd", conn_handle,
                     ble_att_write_req_log, req);
 
@@ -2374,6 +2360,7 @@ ble_att_svr_rx_prep_write(uint16_t conn_handle, struct os_mbuf **rxom)
 #endif
 
     struct ble_att_prep_write_cmd *req;
+    struct ble_att_prep_write_cmd req_buf;
     struct ble_att_svr_entry *attr_entry;
     struct os_mbuf *txom;
     uint16_t err_handle;
@@ -2385,13 +2372,12 @@ ble_att_svr_rx_prep_write(uint16_t conn_handle, struct os_mbuf **rxom)
     att_err = 0;
     err_handle = 0;
 
-    rc = ble_att_svr_pullup_req_base(rxom, sizeof(*req), &att_err);
-    if (rc != 0) {
+    req = os_mbuf_view(*rxom, 0, sizeof(*req), &req_buf);
+    if (req == NULL) {
+        rc = BLE_HS_EBADDATA;
         goto done;
     }
 
-    req = (struct ble_att_prep_write_cmd *)(*rxom)->om_data;
-
     BLE_ATT_LOG_CMD(0, "prep write req", conn_handle,
                     ble_att_prep_write_cmd_log, req);
 
@@ -2462,6 +2448,7 @@ ble_att_svr_rx_exec_write(uint16_t conn_handle, struct os_mbuf **rxom)
 
     struct ble_att_prep_entry_list prep_list;
     struct ble_att_exec_write_req *req;
+    struct ble_att_exec_write_req req_buf;
     struct ble_hs_conn *conn;
     struct os_mbuf *txom;
     uint16_t err_handle;
@@ -2473,12 +2460,12 @@ ble_att_svr_rx_exec_write(uint16_t conn_handle, struct os_mbuf **rxom)
     txom = NULL;
     err_handle = 0;
 
-    rc = ble_att_svr_pullup_req_base(rxom, sizeof(*req), &att_err);
-    if (rc != 0) {
+    req = os_mbuf_view(*rxom, 0, sizeof(*req), &req_buf);
+    if (req == NULL) {
+        rc = BLE_HS_EBADDATA;
         goto done;
     }
 
-    req = (struct ble_att_exec_write_req *)(*rxom)->om_data;
     BLE_ATT_LOG_CMD(0, "exec write req", conn_handle,
                     ble_att_exec_write_req_log, req);
 
@@ -2537,16 +2524,14 @@ ble_att_svr_rx_notify(uint16_t conn_handle, struct os_mbuf **rxom)
 #endif
 
     struct ble_att_notify_req *req;
+    struct ble_att_notify_req req_buf;
     uint16_t handle;
-    int rc;
 
-    rc = ble_att_svr_pullup_req_base(rxom, sizeof(*req), NULL);
-    if (rc != 0) {
-        return BLE_HS_ENOMEM;
+    req = os_mbuf_view(*rxom, 0, sizeof(*req), &req_buf);
+    if (req == NULL) {
+        return BLE_HS_EBADDATA;
     }
 
-    req = (struct ble_att_notify_req *)(*rxom)->om_data;
-
     BLE_ATT_LOG_CMD(0, "notify req", conn_handle,
                     ble_att_notify_req_log, req);
 
@@ -2605,6 +2590,7 @@ ble_att_svr_rx_indicate(uint16_t conn_handle, struct os_mbuf **rxom)
 #endif
 
     struct ble_att_indicate_req *req;
+    struct ble_att_indicate_req req_buf;
     struct os_mbuf *txom;
     uint16_t handle;
     uint8_t att_err;
@@ -2615,12 +2601,12 @@ ble_att_svr_rx_indicate(uint16_t conn_handle, struct os_mbuf **rxom)
     att_err = 0;
     handle = 0;
 
-    rc = ble_att_svr_pullup_req_base(rxom, sizeof(*req), NULL);
-    if (rc != 0) {
+    req = os_mbuf_view(*rxom, 0, sizeof(*req), &req_buf);
+    if (req == NULL) {
+        rc = BLE_HS_EBADDATA;
         goto done;
     }
 
-    req = (struct ble_att_indicate_req *)(*rxom)->om_data;
     BLE_ATT_LOG_CMD(0, "indicate req", conn_handle,
                     ble_att_indicate_req_log, req);
 
@@ -111,6 +111,7 @@ struct ble_gap_master_state {
         struct {
             uint8_t limited:1;
             uint8_t extended:1;
+            uint8_t batch:1;
         } disc;
     };
 };
@@ -1182,6 +1183,68 @@ ble_gap_rx_adv_report(struct ble_gap_disc_desc *desc)
     ble_gap_disc_report(desc);
 }
 
+#if MYNEWT_VAL(BLE_GAP_DISC_BATCH_MAX) > 0
+/**
+ * Processes a group of advertising reports received in a single HCI event.
+ * Reports that do not pass the discovery filters are dropped; the remaining
+ * ones are delivered to the application either in one
+ * BLE_GAP_EVENT_DISC_BATCH event or, if the discovery procedure was not
+ * started in batch mode, as individual BLE_GAP_EVENT_DISC events.
+ *
+ * @param descs                 The received reports.
+ * @param num_descs             The number of entries in descs; at most
+ *                                  BLE_GAP_DISC_BATCH_MAX.
+ */
+void
+ble_gap_rx_adv_reports(const struct ble_gap_disc_desc *descs, int num_descs)
+{
+    struct ble_gap_disc_desc accepted[MYNEWT_VAL(BLE_GAP_DISC_BATCH_MAX)];
+    struct ble_gap_master_state state;
+    struct ble_gap_event event;
+    int num_accepted;
+    int i;
+
+#if !MYNEWT_VAL(BLE_ROLE_OBSERVER)
+    return;
+#endif
+
+    BLE_HS_DBG_ASSERT(num_descs <= MYNEWT_VAL(BLE_GAP_DISC_BATCH_MAX));
+
+    num_accepted = 0;
+    for (i = 0; i < num_descs; i++) {
+        if (ble_gap_rx_adv_report_sanity_check(descs[i].data,
+                                               descs[i].length_data)) {
+            continue;
+        }
+
+        accepted[num_accepted] = descs[i];
+        num_accepted++;
+    }
+
+    if (num_accepted == 0) {
+        return;
+    }
+
+    ble_gap_master_extract_state(&state, 0);
+
+    if (!state.disc.batch) {
+        for (i = 0; i < num_accepted; i++) {
+            ble_gap_disc_report(accepted + i);
+        }
+        return;
+    }
+
+    if (state.cb != NULL) {
+        memset(&event, 0, sizeof event);
+        event.type = BLE_GAP_EVENT_DISC_BATCH;
+        event.disc_batch.num_reports = num_accepted;
+        event.disc_batch.reports = accepted;
+
+        state.cb(&event, state.cb_arg);
+    }
+}
+#endif
+
 #if MYNEWT_VAL(BLE_EXT_ADV)
 void
 ble_gap_rx_ext_adv_report(struct ble_gap_ext_disc_desc *desc)
@@ -2866,6 +2929,8 @@ ble_gap_disc(uint8_t own_addr_type, int32_t duration_ms,
     ble_gap_master.disc.limited = params.limited;
     ble_gap_master.cb = cb;
     ble_gap_master.disc.extended = 0;
+    ble_gap_master.disc.batch = MYNEWT_VAL(BLE_GAP_DISC_BATCH_MAX) > 0 &&
+                                params.batch;
     ble_gap_master.cb_arg = cb_arg;
 
     BLE_HS_LOG(INFO, "GAP procedure initiated: discovery; ");
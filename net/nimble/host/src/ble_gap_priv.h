@@ -79,6 +79,10 @@ extern STATS_SECT_DECL(ble_gap_stats) ble_gap_stats;
 void ble_gap_rx_ext_adv_report(struct ble_gap_ext_disc_desc *desc);
 #endif
 void ble_gap_rx_adv_report(struct ble_gap_disc_desc *desc);
+#if MYNEWT_VAL(BLE_GAP_DISC_BATCH_MAX) > 0
+void ble_gap_rx_adv_reports(const struct ble_gap_disc_desc *descs,
+                            int num_descs);
+#endif
 void ble_gap_rx_rd_rem_sup_feat_complete(struct hci_le_rd_rem_supp_feat_complete *evt);
 int ble_gap_rx_conn_complete(struct hci_le_conn_complete *evt);
 void ble_gap_rx_disconn_complete(struct hci_disconn_complete *evt);
@@ -101,6 +101,8 @@ STATS_NAME_START(ble_hs_stats)
     STATS_NAME(ble_hs_stats, hci_invalid_ack)
     STATS_NAME(ble_hs_stats, hci_unknown_event)
     STATS_NAME(ble_hs_stats, hci_timeout)
+    STATS_NAME(ble_hs_stats, hci_acl_tx)
+    STATS_NAME(ble_hs_stats, hci_acl_tx_frag)
     STATS_NAME(ble_hs_stats, reset)
     STATS_NAME(ble_hs_stats, sync)
 STATS_NAME_END(ble_hs_stats)
@@ -415,6 +415,11 @@ ble_hs_hci_acl_hdr_prepend(struct os_mbuf *om, uint16_t handle,
  * Transmits an HCI ACL data packet.  This function consumes the supplied mbuf,
  * regardless of the outcome.
  *
+ * Packets that fit in the controller's ACL buffer are sent without copying.
+ * When the controller is built into the same image (RAM transport), raising
+ * BLE_ACL_BUF_SIZE lets whole L2CAP PDUs through unfragmented; the link
+ * layer then slices them into LL data PDUs by offset.
+ *
  * XXX: Ensure the controller has sufficient buffer capacity for the outgoing
  * fragments.
  */
@@ -435,6 +440,13 @@ ble_hs_hci_acl_tx(struct ble_hs_conn *connection, struct os_mbuf *txom)
     while (txom != NULL) {
         frag = mem_split_frag(&txom, ble_hs_hci_max_acl_payload_sz(),
                               ble_hs_hci_frag_alloc, NULL);
+        if (frag == NULL) {
+            rc = BLE_HS_ENOMEM;
+            goto err;
+        }
+        if (txom != NULL) {
+            STATS_INC(ble_hs_stats, hci_acl_tx_frag);
+        }
 
         frag = ble_hs_hci_acl_hdr_prepend(frag, connection->bhc_handle, pb);
         if (frag == NULL) {
@@ -455,6 +467,7 @@ ble_hs_hci_acl_tx(struct ble_hs_conn *connection, struct os_mbuf *txom)
         }
 
         connection->bhc_outstanding_pkts++;
+        STATS_INC(ble_hs_stats, hci_acl_tx);
     }
 
     return 0;
@@ -363,6 +363,10 @@ ble_hs_hci_evt_le_adv_rpt_first_pass(uint8_t *data, int len)
 static int
 ble_hs_hci_evt_le_adv_rpt(uint8_t subevent, uint8_t *data, int len)
 {
+#if MYNEWT_VAL(BLE_GAP_DISC_BATCH_MAX) > 0
+    struct ble_gap_disc_desc descs[MYNEWT_VAL(BLE_GAP_DISC_BATCH_MAX)];
+    int num_descs;
+#endif
     struct ble_gap_disc_desc desc = {0};
     uint8_t num_reports;
     int off;
@@ -377,6 +381,9 @@ ble_hs_hci_evt_le_adv_rpt(uint8_t subevent, uint8_t *data, int len)
 
     desc.direct_addr = *BLE_ADDR_ANY;
 
+#if MYNEWT_VAL(BLE_GAP_DISC_BATCH_MAX) > 0
+    num_descs = 0;
+#endif
     off = 2; /* skip sub-event and num reports */
     num_reports = data[1];
     for (i = 0; i < num_reports; i++) {
@@ -398,9 +405,24 @@ ble_hs_hci_evt_le_adv_rpt(uint8_t subevent, uint8_t *data, int len)
         desc.rssi = data[off];
         ++off;
 
+#if MYNEWT_VAL(BLE_GAP_DISC_BATCH_MAX) > 0
+        descs[num_descs] = desc;
+        num_descs++;
+        if (num_descs == MYNEWT_VAL(BLE_GAP_DISC_BATCH_MAX)) {
+            ble_gap_rx_adv_reports(descs, num_descs);
+            num_descs = 0;
+        }
+#else
         ble_gap_rx_adv_report(&desc);
+#endif
     }
 
+#if MYNEWT_VAL(BLE_GAP_DISC_BATCH_MAX) > 0
+    if (num_descs > 0) {
+        ble_gap_rx_adv_reports(descs, num_descs);
+    }
+#endif
+
     return 0;
 }
 
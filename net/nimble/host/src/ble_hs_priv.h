@@ -81,6 +81,8 @@ STATS_SECT_START(ble_hs_stats)
     STATS_SECT_ENTRY(hci_invalid_ack)
     STATS_SECT_ENTRY(hci_unknown_event)
     STATS_SECT_ENTRY(hci_timeout)
+    STATS_SECT_ENTRY(hci_acl_tx)
+    STATS_SECT_ENTRY(hci_acl_tx_frag)
     STATS_SECT_ENTRY(reset)
     STATS_SECT_ENTRY(sync)
 STATS_SECT_END
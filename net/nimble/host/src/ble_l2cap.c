@@ -172,6 +172,12 @@ ble_l2cap_recv_ready(struct ble_l2cap_chan *chan, struct os_mbuf *sdu_rx)
     ble_l2cap_coc_recv_ready(chan, sdu_rx);
 }
 
+int
+ble_l2cap_set_rx_stream(struct ble_l2cap_chan *chan, int enable)
+{
+    return ble_l2cap_coc_set_rx_stream(chan, enable);
+}
+
 void
 ble_l2cap_remove_rx(struct ble_hs_conn *conn, struct ble_l2cap_chan *chan)
 {
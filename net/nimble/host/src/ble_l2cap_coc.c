@@ -21,6 +21,7 @@
 #include <errno.h>
 #include "console/console.h"
 #include "nimble/ble.h"
+#include "mem/mem.h"
 #include "ble_hs_priv.h"
 #include "ble_l2cap_priv.h"
 #include "ble_l2cap_coc_priv.h"
@@ -30,6 +31,12 @@
 
 #define BLE_L2CAP_SDU_SIZE              2
 
+/* Number of msys blocks needed to receive one full K-frame. */
+#define BLE_L2CAP_COC_MSYS_PER_FRAME                                    \
+    ((BLE_L2CAP_COC_MTU + BLE_L2CAP_HDR_SZ + BLE_HCI_DATA_HDR_SZ +      \
+      sizeof(struct os_mbuf_pkthdr)) /                                  \
+     (MYNEWT_VAL(MSYS_1_BLOCK_SIZE) - sizeof(struct os_mbuf)) + 1)
+
 STAILQ_HEAD(ble_l2cap_coc_srv_list, ble_l2cap_coc_srv);
 
 static struct ble_l2cap_coc_srv_list ble_l2cap_coc_srvs;
@@ -131,6 +138,105 @@ ble_l2cap_event_coc_received_data(struct ble_l2cap_chan *chan,
     chan->cb(&event, chan->cb_arg);
 }
 
+static void
+ble_l2cap_coc_stream_credits(struct ble_l2cap_chan *chan)
+{
+    struct ble_l2cap_coc_endpoint *rx;
+    uint16_t credits;
+    int avail;
+
+    rx = &chan->coc_rx;
+
+    /* Give credits back in batches, once peer used up half of them */
+    if (rx->credits > chan->initial_credits / 2) {
+        return;
+    }
+
+    /* Only let the peer send as much as we have msys blocks for. If we are
+     * short now, application gets another chance with ble_l2cap_recv_ready()
+     * once it has freed received data.
+     */
+    avail = os_msys_num_free() - MYNEWT_VAL(BLE_L2CAP_COC_RX_MSYS_RESERVE);
+    if (avail <= 0) {
+        return;
+    }
+
+    credits = min(avail / BLE_L2CAP_COC_MSYS_PER_FRAME,
+                  chan->initial_credits - rx->credits);
+    if (credits == 0) {
+        return;
+    }
+
+    BLE_HS_LOG(DEBUG, "Stream credits update: %d, msys free=%d\n", credits,
+               os_msys_num_free());
+
+    rx->credits += credits;
+    ble_l2cap_sig_le_credits(chan->conn_handle, chan->scid, credits);
+}
+
+static int
+ble_l2cap_coc_rx_stream(struct ble_l2cap_chan *chan)
+{
+    struct ble_l2cap_coc_endpoint *rx;
+    struct ble_l2cap_event event;
+    struct os_mbuf *om;
+    uint16_t sdu_len;
+    int rc;
+
+    rx = &chan->coc_rx;
+    rx->credits--;
+
+    /* First LE frame. As in reassembly mode data_offset keeps SDU len */
+    if (rx->data_offset == 0) {
+        rc = ble_hs_mbuf_pullup_base(&chan->rx_buf, BLE_L2CAP_SDU_SIZE);
+        if (rc != 0) {
+            return rc;
+        }
+
+        sdu_len = get_le16(chan->rx_buf->om_data);
+        if (sdu_len > rx->mtu) {
+            BLE_HS_LOG(INFO, "error: sdu_len > rx->mtu (%d>%d)\n",
+                       sdu_len, rx->mtu);
+            return BLE_HS_EBADDATA;
+        }
+
+        os_mbuf_adj(chan->rx_buf, BLE_L2CAP_SDU_SIZE);
+        rx->data_offset = sdu_len;
+    }
+
+    om = chan->rx_buf;
+    if (rx->stream_off + OS_MBUF_PKTLEN(om) > rx->data_offset) {
+        BLE_HS_LOG(INFO, "error: LE frame beyond sdu_len (%d>%d)\n",
+                   rx->stream_off + OS_MBUF_PKTLEN(om), rx->data_offset);
+        rx->data_offset = 0;
+        rx->stream_off = 0;
+        return BLE_HS_EBADDATA;
+    }
+
+    /* The K-frame goes to application as is, no copy */
+    chan->rx_buf = NULL;
+
+    memset(&event, 0, sizeof event);
+    event.type = BLE_L2CAP_EVENT_COC_DATA_RX_FRAG;
+    event.receive_frag.conn_handle = chan->conn_handle;
+    event.receive_frag.chan = chan;
+    event.receive_frag.om = om;
+    event.receive_frag.sdu_len = rx->data_offset;
+    event.receive_frag.sdu_off = rx->stream_off;
+
+    rx->stream_off += OS_MBUF_PKTLEN(om);
+    if (rx->stream_off == rx->data_offset) {
+        rx->data_offset = 0;
+        rx->stream_off = 0;
+    }
+
+    chan->cb(&event, chan->cb_arg);
+
+    ble_l2cap_coc_stream_credits(chan);
+
+    return 0;
+}
+
 static int
 ble_l2cap_coc_rx_fn(struct ble_l2cap_chan *chan)
 {
@@ -146,6 +252,10 @@ ble_l2cap_coc_rx_fn(struct ble_l2cap_chan *chan)
     /* Create a shortcut to rx endpoint */
     rx = &chan->coc_rx;
 
+    if (rx->stream) {
+        return ble_l2cap_coc_rx_stream(chan);
+    }
+
     om_total = OS_MBUF_PKTLEN(*om);
     rc = ble_hs_mbuf_pullup_base(om, om_total);
     if (rc != 0) {
@@ -251,6 +361,7 @@ ble_l2cap_coc_chan_alloc(uint16_t conn_handle, uint16_t psm, uint16_t mtu,
     chan->rx_fn = ble_l2cap_coc_rx_fn;
     chan->coc_rx.mtu = mtu;
     chan->coc_rx.sdu = sdu_rx;
+    STAILQ_INIT(&chan->coc_tx.sdu_q);
 
     /* Number of credits should allow to send full SDU with on given
      * L2CAP MTU
@@ -299,6 +410,31 @@ ble_l2cap_event_coc_disconnected(struct ble_l2cap_chan *chan)
     chan->cb(&event, chan->cb_arg);
 }
 
+static void
+ble_l2cap_coc_free_sdu_q(struct ble_l2cap_coc_endpoint *tx)
+{
+    struct os_mbuf_pkthdr *omp;
+
+    while ((omp = STAILQ_FIRST(&tx->sdu_q)) != NULL) {
+        STAILQ_REMOVE_HEAD(&tx->sdu_q, omp_next);
+        os_mbuf_free_chain(OS_MBUF_PKTHDR_TO_MBUF(omp));
+    }
+    tx->sdu_q_len = 0;
+}
+
+static void
+ble_l2cap_event_coc_tx_unstalled(struct ble_l2cap_chan *chan, int status)
+{
+    struct ble_l2cap_event event = { };
+
+    event.type = BLE_L2CAP_EVENT_COC_TX_UNSTALLED;
+    event.tx_unstalled.conn_handle = chan->conn_handle;
+    event.tx_unstalled.chan = chan;
+    event.tx_unstalled.status = status;
+
+    chan->cb(&event, chan->cb_arg);
+}
+
 void
 ble_l2cap_coc_cleanup_chan(struct ble_l2cap_chan *chan)
 {
@@ -311,73 +447,69 @@ ble_l2cap_coc_cleanup_chan(struct ble_l2cap_chan *chan)
 
     os_mbuf_free_chain(chan->coc_rx.sdu);
     os_mbuf_free_chain(chan->coc_tx.sdu);
+    ble_l2cap_coc_free_sdu_q(&chan->coc_tx);
+}
+
+static struct os_mbuf *
+ble_l2cap_coc_frag_alloc(uint16_t frag_size, void *arg)
+{
+    return ble_hs_mbuf_l2cap_pkt();
 }
 
 static int
 ble_l2cap_coc_continue_tx(struct ble_l2cap_chan *chan)
 {
     struct ble_l2cap_coc_endpoint *tx;
-    uint16_t len;
-    uint16_t left_to_send;
+    struct os_mbuf_pkthdr *omp;
     struct os_mbuf *txom;
     struct ble_hs_conn *conn;
-    uint16_t sdu_size_offset;
+    uint16_t sdu_len;
+    uint16_t len;
     int rc;
 
-    /* If there is no data to send, just return success */
     tx = &chan->coc_tx;
-    if (!tx->sdu) {
-        return 0;
-    }
 
     while (tx->credits) {
-        sdu_size_offset = 0;
-
-        BLE_HS_LOG(DEBUG, "Available credits %d\n", tx->credits);
-
-        /* lets calculate data we are going to send */
-        left_to_send = OS_MBUF_PKTLEN(tx->sdu) - tx->data_offset;
+        if (!tx->sdu) {
+            /* Current SDU is done, take next one from the queue */
+            omp = STAILQ_FIRST(&tx->sdu_q);
+            if (!omp) {
+                break;
+            }
 
-        if (tx->data_offset == 0) {
-            sdu_size_offset = BLE_L2CAP_SDU_SIZE;
-            left_to_send += sdu_size_offset;
+            STAILQ_REMOVE_HEAD(&tx->sdu_q, omp_next);
+            tx->sdu_q_len--;
+            tx->sdu = OS_MBUF_PKTHDR_TO_MBUF(omp);
         }
 
-        /* Take into account peer MTU */
-        len = min(left_to_send, chan->peer_mtu);
-
-        /* Prepare packet */
-        txom = ble_hs_mbuf_l2cap_pkt();
-        if (!txom) {
-            BLE_HS_LOG(DEBUG, "Could not prepare l2cap packet len %d, err=%d",
-                                                                   len, rc);
-
-            rc = BLE_HS_ENOMEM;
-            goto failed;
-        }
+        BLE_HS_LOG(DEBUG, "Available credits %d\n", tx->credits);
 
         if (tx->data_offset == 0) {
-            /* First packet needs SDU len first. Left to send */
-            uint16_t l = htole16(OS_MBUF_PKTLEN(tx->sdu));
-
+            /* First packet needs SDU len first. It is put in front of the SDU
+             * so the first K-frame can be sliced off without copying.
+             */
             BLE_HS_LOG(DEBUG, "Sending SDU len=%d\n", OS_MBUF_PKTLEN(tx->sdu));
-            rc = os_mbuf_append(txom, &l, sizeof(uint16_t));
-            if (rc) {
-                BLE_HS_LOG(DEBUG, "Could not append data rc=%d", rc);
+
+            sdu_len = htole16(OS_MBUF_PKTLEN(tx->sdu));
+            tx->sdu = os_mbuf_prepend(tx->sdu, sizeof(sdu_len));
+            if (!tx->sdu) {
+                rc = BLE_HS_ENOMEM;
                 goto failed;
             }
+            memcpy(tx->sdu->om_data, &sdu_len, sizeof(sdu_len));
         }
 
-        /* In data_offset we keep track on what we already sent. Need to remember
-         * that for first packet we need to decrease data size by 2 bytes for sdu
-         * size
+        /* K-frame is cut from the front of the SDU; after this tx->sdu points
+         * to the data left to send, or is NULL if this is the last K-frame.
          */
-        rc = os_mbuf_appendfrom(txom, tx->sdu, tx->data_offset,
-                                len - sdu_size_offset);
-        if (rc) {
-            BLE_HS_LOG(DEBUG, "Could not append data rc=%d", rc);
-           goto failed;
+        txom = mem_split_frag(&tx->sdu, chan->peer_mtu,
+                              ble_l2cap_coc_frag_alloc, NULL);
+        if (!txom) {
+            BLE_HS_LOG(DEBUG, "Could not prepare l2cap packet\n");
+            rc = BLE_HS_ENOMEM;
+            goto failed;
         }
+        len = OS_MBUF_PKTLEN(txom);
 
         ble_hs_lock();
         conn = ble_hs_conn_find_assert(chan->conn_handle);
@@ -386,22 +518,24 @@ ble_l2cap_coc_continue_tx(struct ble_l2cap_chan *chan)
 
         if (rc) {
           /* txom is consumed by l2cap */
-          txom = NULL;
           goto failed;
-        } else {
-            tx->credits --;
-            tx->data_offset += len - sdu_size_offset;
         }
 
+        tx->credits--;
+        tx->data_offset += len;
+
         BLE_HS_LOG(DEBUG, "Sent %d bytes, credits=%d, to send %d bytes \n",
-                  len, tx->credits, OS_MBUF_PKTLEN(tx->sdu)- tx->data_offset );
+                   len, tx->credits,
+                   tx->sdu ? OS_MBUF_PKTLEN(tx->sdu) : 0);
 
-        if (tx->data_offset == OS_MBUF_PKTLEN(tx->sdu)) {
-                BLE_HS_LOG(DEBUG, "Complete package sent");
-                os_mbuf_free_chain(tx->sdu);
-                tx->sdu = 0;
-                tx->data_offset = 0;
-                break;
+        if (!tx->sdu) {
+            BLE_HS_LOG(DEBUG, "Complete package sent\n");
+            tx->data_offset = 0;
+
+            if (tx->stalled) {
+                tx->stalled = 0;
+                ble_l2cap_event_coc_tx_unstalled(chan, 0);
+            }
         }
     }
 
@@ -410,7 +544,12 @@ ble_l2cap_coc_continue_tx(struct ble_l2cap_chan *chan)
 failed:
     os_mbuf_free_chain(tx->sdu);
     tx->sdu = NULL;
-    os_mbuf_free_chain(txom);
+    tx->data_offset = 0;
+
+    if (tx->stalled) {
+        tx->stalled = 0;
+        ble_l2cap_event_coc_tx_unstalled(chan, rc);
+    }
 
     return rc;
 }
@@ -454,6 +593,15 @@ ble_l2cap_coc_recv_ready(struct ble_l2cap_chan *chan, struct os_mbuf *sdu_rx)
     struct ble_hs_conn *conn;
     struct ble_l2cap_chan *c;
 
+    if (chan->coc_rx.stream) {
+        /* No SDU buffer in stream mode; application calls us after it
+         * freed received data so we can check for more credits.
+         */
+        os_mbuf_free_chain(sdu_rx);
+        ble_l2cap_coc_stream_credits(chan);
+        return;
+    }
+
     chan->coc_rx.sdu = sdu_rx;
 
     ble_hs_lock();
@@ -485,19 +633,51 @@ ble_l2cap_coc_send(struct ble_l2cap_chan *chan, struct os_mbuf *sdu_tx)
 
     tx = &chan->coc_tx;
 
-    if (tx->sdu) {
-        return BLE_HS_EBUSY;
+    if (OS_MBUF_PKTLEN(sdu_tx) > tx->mtu) {
+        return BLE_HS_EBADDATA;
     }
 
-    tx->sdu = sdu_tx;
+    if (tx->sdu || !STAILQ_EMPTY(&tx->sdu_q)) {
+        if (tx->sdu_q_len + 1 >= MYNEWT_VAL(BLE_L2CAP_COC_TX_SDU_MAX)) {
+            tx->stalled = 1;
+            return BLE_HS_EBUSY;
+        }
 
-    if (OS_MBUF_PKTLEN(sdu_tx) > tx->mtu) {
-        return BLE_HS_EBADDATA;
+        /* Wait for credits, SDU is sent when current one is done */
+        STAILQ_INSERT_TAIL(&tx->sdu_q, OS_MBUF_PKTHDR(sdu_tx), omp_next);
+        tx->sdu_q_len++;
+        return 0;
     }
 
+    tx->sdu = sdu_tx;
+
     return ble_l2cap_coc_continue_tx(chan);
 }
 
+int
+ble_l2cap_coc_set_rx_stream(struct ble_l2cap_chan *chan, int enable)
+{
+    struct ble_l2cap_coc_endpoint *rx;
+
+    rx = &chan->coc_rx;
+
+    /* Do not switch in the middle of an SDU */
+    if (rx->data_offset != 0 || (rx->sdu && OS_MBUF_PKTLEN(rx->sdu) != 0)) {
+        return BLE_HS_EBUSY;
+    }
+
+    if (enable) {
+        /* Reassembly buffer is not used anymore */
+        os_mbuf_free_chain(rx->sdu);
+        rx->sdu = NULL;
+    }
+
+    rx->stream = !!enable;
+    rx->stream_off = 0;
+
+    return 0;
+}
+
 int
 ble_l2cap_coc_init(void)
 {
@@ -36,11 +36,24 @@ extern "C" {
 
 struct ble_l2cap_chan;
 
+STAILQ_HEAD(ble_l2cap_coc_sdu_list, os_mbuf_pkthdr);
+
 struct ble_l2cap_coc_endpoint {
     uint16_t mtu;
     uint16_t credits;
     uint16_t data_offset;
     struct os_mbuf *sdu;
+
+    /* TX: SDUs queued up behind the one currently being sent. */
+    struct ble_l2cap_coc_sdu_list sdu_q;
+    uint8_t sdu_q_len;
+    /* TX: application got BLE_HS_EBUSY and waits for TX_UNSTALLED event. */
+    uint8_t stalled:1;
+
+    /* RX: K-frames are passed to application as they arrive. */
+    uint8_t stream:1;
+    /* RX, stream mode: bytes of current SDU already given to application. */
+    uint16_t stream_off;
 };
 
 struct ble_l2cap_coc_srv {
@@ -68,12 +81,14 @@ void ble_l2cap_coc_le_credits_update(uint16_t conn_handle, uint16_t dcid,
 void ble_l2cap_coc_recv_ready(struct ble_l2cap_chan *chan,
                               struct os_mbuf *sdu_rx);
 int ble_l2cap_coc_send(struct ble_l2cap_chan *chan, struct os_mbuf *sdu_tx);
+int ble_l2cap_coc_set_rx_stream(struct ble_l2cap_chan *chan, int enable);
 #else
 #define ble_l2cap_coc_init()                                    0
 #define ble_l2cap_coc_create_server(psm, mtu, cb, cb_arg)       BLE_HS_ENOTSUP
 #define ble_l2cap_coc_recv_ready(chan, sdu_rx)
 #define ble_l2cap_coc_cleanup_chan(chan)
 #define ble_l2cap_coc_send(chan, sdu_tx)                        BLE_HS_ENOTSUP
+#define ble_l2cap_coc_set_rx_stream(chan, enable)               BLE_HS_ENOTSUP
 #endif
 
 #ifdef __cplusplus
@@ -344,6 +344,7 @@ ble_l2cap_sig_update_req_rx(uint16_t conn_handle,
                             struct os_mbuf **om)
 {
     struct ble_l2cap_sig_update_req *req;
+    struct ble_l2cap_sig_update_req req_buf;
     struct os_mbuf *txom;
     struct ble_l2cap_sig_update_rsp *rsp;
     struct ble_gap_upd_params params;
@@ -354,9 +355,9 @@ ble_l2cap_sig_update_req_rx(uint16_t conn_handle,
 
     l2cap_result = 0; /* Silence spurious gcc warning. */
 
-    rc = ble_hs_mbuf_pullup_base(om, BLE_L2CAP_SIG_UPDATE_REQ_SZ);
-    if (rc != 0) {
-        return rc;
+    req = os_mbuf_view(*om, 0, BLE_L2CAP_SIG_UPDATE_REQ_SZ, &req_buf);
+    if (req == NULL) {
+        return BLE_HS_EBADDATA;
     }
 
     rc = ble_hs_atomic_conn_flags(conn_handle, &conn_flags);
@@ -370,8 +371,6 @@ ble_l2cap_sig_update_req_rx(uint16_t conn_handle,
         return BLE_HS_EREJECT;
     }
 
-    req = (struct ble_l2cap_sig_update_req *)(*om)->om_data;
-
     params.itvl_min = le16toh(req->itvl_min);
     params.itvl_max = le16toh(req->itvl_max);
     params.latency = le16toh(req->slave_latency);
@@ -413,6 +412,7 @@ ble_l2cap_sig_update_rsp_rx(uint16_t conn_handle,
                             struct os_mbuf **om)
 {
     struct ble_l2cap_sig_update_rsp *rsp;
+    struct ble_l2cap_sig_update_rsp rsp_buf;
     struct ble_l2cap_sig_proc *proc;
     int cb_status;
     int rc;
@@ -424,14 +424,13 @@ ble_l2cap_sig_update_rsp_rx(uint16_t conn_handle,
         return 0;
     }
 
-    rc = ble_hs_mbuf_pullup_base(om, BLE_L2CAP_SIG_UPDATE_RSP_SZ);
-    if (rc != 0) {
+    rsp = os_mbuf_view(*om, 0, BLE_L2CAP_SIG_UPDATE_RSP_SZ, &rsp_buf);
+    if (rsp == NULL) {
+        rc = BLE_HS_EBADDATA;
         cb_status = rc;
         goto done;
     }
 
-    rsp = (struct ble_l2cap_sig_update_rsp *)(*om)->om_data;
-
     switch (le16toh(rsp->result)) {
     case BLE_L2CAP_SIG_UPDATE_RSP_RESULT_ACCEPT:
         cb_status = 0;
@@ -635,15 +634,16 @@ ble_l2cap_sig_coc_req_rx(uint16_t conn_handle, struct ble_l2cap_sig_hdr *hdr,
 {
     int rc;
     struct ble_l2cap_sig_le_con_req *req;
+    struct ble_l2cap_sig_le_con_req req_buf;
     struct os_mbuf *txom;
     struct ble_l2cap_sig_le_con_rsp *rsp;
     struct ble_l2cap_chan *chan = NULL;
     struct ble_hs_conn *conn;
     uint16_t scid;
 
-    rc = ble_hs_mbuf_pullup_base(om, sizeof(req));
-    if (rc != 0) {
-        return rc;
+    req = os_mbuf_view(*om, 0, sizeof(*req), &req_buf);
+    if (req == NULL) {
+        return BLE_HS_EBADDATA;
     }
 
     rsp = ble_l2cap_sig_cmd_get(BLE_L2CAP_SIG_OP_CREDIT_CONNECT_RSP,
@@ -657,8 +657,6 @@ ble_l2cap_sig_coc_req_rx(uint16_t conn_handle, struct ble_l2cap_sig_hdr *hdr,
 
     memset(rsp, 0, sizeof(*rsp));
 
-    req = (struct ble_l2cap_sig_le_con_req *)(*om)->om_data;
-
     ble_hs_lock();
     conn = ble_hs_conn_find_assert(conn_handle);
 
@@ -737,6 +735,7 @@ ble_l2cap_sig_coc_rsp_rx(uint16_t conn_handle, struct ble_l2cap_sig_hdr *hdr,
 {
     struct ble_l2cap_sig_proc *proc;
     struct ble_l2cap_sig_le_con_rsp *rsp;
+    struct ble_l2cap_sig_le_con_rsp rsp_buf;
     struct ble_l2cap_chan *chan;
     struct ble_hs_conn *conn;
     int rc;
@@ -752,13 +751,12 @@ ble_l2cap_sig_coc_rsp_rx(uint16_t conn_handle, struct ble_l2cap_sig_hdr *hdr,
         return 0;
     }
 
-    rc = ble_hs_mbuf_pullup_base(om, sizeof(*rsp));
-    if (rc != 0) {
+    rsp = os_mbuf_view(*om, 0, sizeof(*rsp), &rsp_buf);
+    if (rsp == NULL) {
+        rc = BLE_HS_EBADDATA;
         goto done;
     }
 
-    rsp = (struct ble_l2cap_sig_le_con_rsp *)(*om)->om_data;
-
     chan = proc->connect.chan;
 
     if (rsp->result) {
@@ -867,15 +865,16 @@ ble_l2cap_sig_disc_req_rx(uint16_t conn_handle, struct ble_l2cap_sig_hdr *hdr,
                           struct os_mbuf **om)
 {
     struct ble_l2cap_sig_disc_req *req;
+    struct ble_l2cap_sig_disc_req req_buf;
     struct os_mbuf *txom;
     struct ble_l2cap_sig_disc_rsp *rsp;
     struct ble_l2cap_chan *chan;
     struct ble_hs_conn *conn;
     int rc;
 
-    rc = ble_hs_mbuf_pullup_base(om, sizeof(*req));
-    if (rc != 0) {
-        return rc;
+    req = os_mbuf_view(*om, 0, sizeof(*req), &req_buf);
+    if (req == NULL) {
+        return BLE_HS_EBADDATA;
     }
 
     rsp = ble_l2cap_sig_cmd_get(BLE_L2CAP_SIG_OP_DISCONN_RSP, hdr->identifier,
@@ -890,8 +889,6 @@ ble_l2cap_sig_disc_req_rx(uint16_t conn_handle, struct ble_l2cap_sig_hdr *hdr,
     ble_hs_lock();
     conn = ble_hs_conn_find_assert(conn_handle);
 
-    req = (struct ble_l2cap_sig_disc_req *) (*om)->om_data;
-
     /* Let's find matching channel. Note that destination CID in the request
      * is from peer perspective. It is source CID from nimble perspective 
      */
@@ -953,9 +950,9 @@ ble_l2cap_sig_disc_rsp_rx(uint16_t conn_handle, struct ble_l2cap_sig_hdr *hdr,
                            struct os_mbuf **om)
 {
     struct ble_l2cap_sig_disc_rsp *rsp;
+    struct ble_l2cap_sig_disc_rsp rsp_buf;
     struct ble_l2cap_sig_proc *proc;
     struct ble_l2cap_chan *chan;
-    int rc;
 
     proc = ble_l2cap_sig_proc_extract(conn_handle,
                                       BLE_L2CAP_SIG_PROC_OP_DISCONNECT,
@@ -964,8 +961,8 @@ ble_l2cap_sig_disc_rsp_rx(uint16_t conn_handle, struct ble_l2cap_sig_hdr *hdr,
         return 0;
     }
 
-    rc = ble_hs_mbuf_pullup_base(om, sizeof(*rsp));
-    if (rc != 0) {
+    rsp = os_mbuf_view(*om, 0, sizeof(*rsp), &rsp_buf);
+    if (rsp == NULL) {
         goto done;
     }
 
@@ -974,14 +971,13 @@ ble_l2cap_sig_disc_rsp_rx(uint16_t conn_handle, struct ble_l2cap_sig_hdr *hdr,
         goto done;
     }
 
-    rsp = (struct ble_l2cap_sig_disc_rsp *)(*om)->om_data;
     if (chan->dcid != le16toh(rsp->dcid) || chan->scid != le16toh(rsp->scid)) {
         /* This response is incorrect, lets wait for timeout */
         ble_l2cap_sig_process_status(proc, 0);
         return 0;
     }
 
-    ble_l2cap_sig_coc_disconnect_cb(proc, rc);
+    ble_l2cap_sig_coc_disconnect_cb(proc, 0);
 
 done:
     ble_l2cap_sig_proc_free(proc);
@@ -1029,15 +1025,13 @@ ble_l2cap_sig_le_credits_rx(uint16_t conn_handle, struct ble_l2cap_sig_hdr *hdr,
                             struct os_mbuf **om)
 {
     struct ble_l2cap_sig_le_credits *req;
-    int rc;
+    struct ble_l2cap_sig_le_credits req_buf;
 
-    rc = ble_hs_mbuf_pullup_base(om, sizeof(*req));
-    if (rc != 0) {
+    req = os_mbuf_view(*om, 0, sizeof(*req), &req_buf);
+    if (req == NULL) {
         return 0;
     }
 
-    req = (struct ble_l2cap_sig_le_credits *) (*om)->om_data;
-
     /* Ignore when peer sends zero credits */
     if (req->credits == 0) {
             return 0;
@@ -1103,7 +1097,9 @@ static int
 ble_l2cap_sig_rx(struct ble_l2cap_chan *chan)
 {
     struct ble_l2cap_sig_hdr hdr;
+    uint8_t hdr_buf[BLE_L2CAP_SIG_HDR_SZ];
     ble_l2cap_sig_rx_fn *rx_cb;
+    void *hdr_data;
     uint16_t conn_handle;
     struct os_mbuf **om;
     int rc;
@@ -1119,12 +1115,12 @@ ble_l2cap_sig_rx(struct ble_l2cap_chan *chan)
     BLE_HS_LOG(DEBUG, "\n");
 #endif
 
-    rc = ble_hs_mbuf_pullup_base(om, BLE_L2CAP_SIG_HDR_SZ);
-    if (rc != 0) {
-        return rc;
+    hdr_data = os_mbuf_view(*om, 0, BLE_L2CAP_SIG_HDR_SZ, hdr_buf);
+    if (hdr_data == NULL) {
+        return BLE_HS_EBADDATA;
     }
 
-    ble_l2cap_sig_hdr_parse((*om)->om_data, (*om)->om_len, &hdr);
+    ble_l2cap_sig_hdr_parse(hdr_data, BLE_L2CAP_SIG_HDR_SZ, &hdr);
 
     /* Strip L2CAP sig header from the front of the mbuf. */
     os_mbuf_adj(*om, BLE_L2CAP_SIG_HDR_SZ);
@@ -40,6 +40,145 @@ struct ble_store_value_cccd
     ble_store_config_cccds[MYNEWT_VAL(BLE_STORE_MAX_CCCDS)];
 int ble_store_config_num_cccds;
 
+/*****************************************************************************
+ * $index                                                                    *
+ *****************************************************************************/
+
+/* Records are looked up through hash chains keyed by peer address and, for
+ * security material, by EDIV and Rand.  Each chain links record indices in
+ * ascending order, so walking a chain visits matching records in the same
+ * order as a scan of the whole array would; this keeps the meaning of the
+ * key's idx field unchanged.
+ */
+
+#define BLE_STORE_CONFIG_IDX_NONE       (-1)
+
+struct ble_store_config_sec_idx {
+    int16_t addr_head[MYNEWT_VAL(BLE_STORE_MAX_BONDS)];
+    int16_t addr_next[MYNEWT_VAL(BLE_STORE_MAX_BONDS)];
+    int16_t rand_head[MYNEWT_VAL(BLE_STORE_MAX_BONDS)];
+    int16_t rand_next[MYNEWT_VAL(BLE_STORE_MAX_BONDS)];
+};
+
+struct ble_store_config_cccd_idx {
+    int16_t addr_head[MYNEWT_VAL(BLE_STORE_MAX_CCCDS)];
+    int16_t addr_next[MYNEWT_VAL(BLE_STORE_MAX_CCCDS)];
+};
+
+static struct ble_store_config_sec_idx ble_store_config_our_sec_idx;
+static struct ble_store_config_sec_idx ble_store_config_peer_sec_idx;
+static struct ble_store_config_cccd_idx ble_store_config_cccd_idx;
+
+static unsigned int
+ble_store_config_hash_addr(const ble_addr_t *addr, int num_buckets)
+{
+    unsigned int hash;
+    int i;
+
+    hash = addr->type;
+    for (i = 0; i < sizeof addr->val; i++) {
+        hash = hash * 31 + addr->val[i];
+    }
+
+    return hash % num_buckets;
+}
+
+static unsigned int
+ble_store_config_hash_rand(uint16_t ediv, uint64_t rand_num, int num_buckets)
+{
+    uint32_t hash;
+
+    hash = ediv ^ (uint32_t)rand_num ^ (uint32_t)(rand_num >> 32);
+
+    return hash % num_buckets;
+}
+
+static void
+ble_store_config_idx_link(int16_t *head, int16_t *next, int idx)
+{
+    while (*head != BLE_STORE_CONFIG_IDX_NONE) {
+        head = &next[*head];
+    }
+
+    *head = idx;
+    next[idx] = BLE_STORE_CONFIG_IDX_NONE;
+}
+
+static void
+ble_store_config_sec_idx_add(struct ble_store_config_sec_idx *sec_idx,
+                             const struct ble_store_value_sec *value_sec,
+                             int idx)
+{
+    unsigned int bucket;
+
+    bucket = ble_store_config_hash_addr(&value_sec->peer_addr,
+                                        MYNEWT_VAL(BLE_STORE_MAX_BONDS));
+    ble_store_config_idx_link(&sec_idx->addr_head[bucket], sec_idx->addr_next,
+                              idx);
+
+    bucket = ble_store_config_hash_rand(value_sec->ediv, value_sec->rand_num,
+                                        MYNEWT_VAL(BLE_STORE_MAX_BONDS));
+    ble_store_config_idx_link(&sec_idx->rand_head[bucket], sec_idx->rand_next,
+                              idx);
+}
+
+static void
+ble_store_config_sec_idx_build(struct ble_store_config_sec_idx *sec_idx,
+                               const struct ble_store_value_sec *value_secs,
+                               int num_value_secs)
+{
+    int i;
+
+    memset(sec_idx->addr_head, 0xff, sizeof sec_idx->addr_head);
+    memset(sec_idx->rand_head, 0xff, sizeof sec_idx->rand_head);
+
+    for (i = 0; i < num_value_secs; i++) {
+        ble_store_config_sec_idx_add(sec_idx, value_secs + i, i);
+    }
+}
+
+static void
+ble_store_config_cccd_idx_add(const struct ble_store_value_cccd *value_cccd,
+                              int idx)
+{
+    unsigned int bucket;
+
+    bucket = ble_store_config_hash_addr(&value_cccd->peer_addr,
+                                        MYNEWT_VAL(BLE_STORE_MAX_CCCDS));
+    ble_store_config_idx_link(&ble_store_config_cccd_idx.addr_head[bucket],
+                              ble_store_config_cccd_idx.addr_next, idx);
+}
+
+static void
+ble_store_config_cccd_idx_build(void)
+{
+    int i;
+
+    memset(ble_store_config_cccd_idx.addr_head, 0xff,
+           sizeof ble_store_config_cccd_idx.addr_head);
+
+    for (i = 0; i < ble_store_config_num_cccds; i++) {
+        ble_store_config_cccd_idx_add(ble_store_config_cccds + i, i);
+    }
+}
+
+/**
+ * Rebuilds all lookup indices from the record arrays.  Called after the
+ * arrays have been filled or rearranged by something other than the
+ * read/write/delete functions below (e.g., loading from sys/config).
+ */
+void
+ble_store_config_idx_rebuild(void)
+{
+    ble_store_config_sec_idx_build(&ble_store_config_our_sec_idx,
+                                   ble_store_config_our_secs,
+                                   ble_store_config_num_our_secs);
+    ble_store_config_sec_idx_build(&ble_store_config_peer_sec_idx,
+                                   ble_store_config_peer_secs,
+                                   ble_store_config_num_peer_secs);
+    ble_store_config_cccd_idx_build();
+}
+
 /*****************************************************************************
  * $sec                                                                      *
  *****************************************************************************/
@@ -85,15 +224,40 @@ ble_store_config_print_key_sec(const struct ble_store_key_sec *key_sec)
 static int
 ble_store_config_find_sec(const struct ble_store_key_sec *key_sec,
                           const struct ble_store_value_sec *value_secs,
-                          int num_value_secs)
+                          int num_value_secs,
+                          const struct ble_store_config_sec_idx *sec_idx)
 {
     const struct ble_store_value_sec *cur;
+    const int16_t *next;
+    unsigned int bucket;
     int skipped;
     int i;
 
+    if (num_value_secs == 0) {
+        return -1;
+    }
+
+    if (ble_addr_cmp(&key_sec->peer_addr, BLE_ADDR_ANY)) {
+        bucket = ble_store_config_hash_addr(&key_sec->peer_addr,
+                                            MYNEWT_VAL(BLE_STORE_MAX_BONDS));
+        i = sec_idx->addr_head[bucket];
+        next = sec_idx->addr_next;
+    } else if (key_sec->ediv_rand_present) {
+        bucket = ble_store_config_hash_rand(key_sec->ediv, key_sec->rand_num,
+                                            MYNEWT_VAL(BLE_STORE_MAX_BONDS));
+        i = sec_idx->rand_head[bucket];
+        next = sec_idx->rand_next;
+    } else {
+        /* Wildcard key; every record matches. */
+        if (key_sec->idx < num_value_secs) {
+            return key_sec->idx;
+        }
+        return -1;
+    }
+
     skipped = 0;
 
-    for (i = 0; i < num_value_secs; i++) {
+    for (; i != BLE_STORE_CONFIG_IDX_NONE; i = next[i]) {
         cur = value_secs + i;
 
         if (ble_addr_cmp(&key_sec->peer_addr, BLE_ADDR_ANY)) {
@@ -130,7 +294,8 @@ ble_store_config_read_our_sec(const struct ble_store_key_sec *key_sec,
     int idx;
 
     idx = ble_store_config_find_sec(key_sec, ble_store_config_our_secs,
-                                    ble_store_config_num_our_secs);
+                                    ble_store_config_num_our_secs,
+                                    &ble_store_config_our_sec_idx);
     if (idx == -1) {
         return BLE_HS_ENOENT;
     }
@@ -152,7 +317,8 @@ ble_store_config_write_our_sec(const struct ble_store_value_sec *value_sec)
 
     ble_store_key_from_value_sec(&key_sec, value_sec);
     idx = ble_store_config_find_sec(&key_sec, ble_store_config_our_secs,
-                                    ble_store_config_num_our_secs);
+                                    ble_store_config_num_our_secs,
+                                    &ble_store_config_our_sec_idx);
     if (idx == -1) {
         if (ble_store_config_num_our_secs >= MYNEWT_VAL(BLE_STORE_MAX_BONDS)) {
             BLE_HS_LOG(DEBUG, "error persisting our sec; too many entries "
@@ -162,11 +328,13 @@ ble_store_config_write_our_sec(const struct ble_store_value_sec *value_sec)
 
         idx = ble_store_config_num_our_secs;
         ble_store_config_num_our_secs++;
+        ble_store_config_sec_idx_add(&ble_store_config_our_sec_idx,
+                                     value_sec, idx);
     }
 
     ble_store_config_our_secs[idx] = *value_sec;
 
-    rc = ble_store_config_persist_our_secs();
+    rc = ble_store_config_persist_our_sec(idx);
     if (rc != 0) {
         return rc;
     }
@@ -195,42 +363,53 @@ ble_store_config_delete_obj(void *values, int value_size, int idx,
     return 0;
 }
 
+/**
+ * Deletes the matching security record.  Later records move down one slot
+ * to keep the array in bonding order.
+ *
+ * @return                      The index of the deleted record on success;
+ *                              -1 if there is no matching record.
+ */
 static int
 ble_store_config_delete_sec(const struct ble_store_key_sec *key_sec,
                             struct ble_store_value_sec *value_secs,
-                            int *num_value_secs)
+                            int *num_value_secs,
+                            struct ble_store_config_sec_idx *sec_idx)
 {
     int idx;
-    int rc;
 
-    idx = ble_store_config_find_sec(key_sec, value_secs, *num_value_secs);
+    idx = ble_store_config_find_sec(key_sec, value_secs, *num_value_secs,
+                                    sec_idx);
     if (idx == -1) {
-        return BLE_HS_ENOENT;
+        return -1;
     }
 
-    rc = ble_store_config_delete_obj(value_secs, sizeof *value_secs, idx,
-                                  num_value_secs);
-    if (rc != 0) {
-        return rc;
-    }
+    ble_store_config_delete_obj(value_secs, sizeof *value_secs, idx,
+                                num_value_secs);
+    ble_store_config_sec_idx_build(sec_idx, value_secs, *num_value_secs);
 
-    return 0;
+    return idx;
 }
 
 static int
 ble_store_config_delete_our_sec(const struct ble_store_key_sec *key_sec)
 {
+    int idx;
     int rc;
 
-    rc = ble_store_config_delete_sec(key_sec, ble_store_config_our_secs,
-                                     &ble_store_config_num_our_secs);
-    if (rc != 0) {
-        return rc;
+    idx = ble_store_config_delete_sec(key_sec, ble_store_config_our_secs,
+                                      &ble_store_config_num_our_secs,
+                                      &ble_store_config_our_sec_idx);
+    if (idx == -1) {
+        return BLE_HS_ENOENT;
     }
 
-    rc = ble_store_config_persist_our_secs();
-    if (rc != 0) {
-        return rc;
+    /* Persist the records that moved and erase the one-past-last slot. */
+    for (; idx <= ble_store_config_num_our_secs; idx++) {
+        rc = ble_store_config_persist_our_sec(idx);
+        if (rc != 0) {
+            return rc;
+        }
     }
 
     return 0;
@@ -239,17 +418,21 @@ ble_store_config_delete_our_sec(const struct ble_store_key_sec *key_sec)
 static int
 ble_store_config_delete_peer_sec(const struct ble_store_key_sec *key_sec)
 {
+    int idx;
     int rc;
 
-    rc = ble_store_config_delete_sec(key_sec, ble_store_config_peer_secs,
-                                  &ble_store_config_num_peer_secs);
-    if (rc != 0) {
-        return rc;
+    idx = ble_store_config_delete_sec(key_sec, ble_store_config_peer_secs,
+                                      &ble_store_config_num_peer_secs,
+                                      &ble_store_config_peer_sec_idx);
+    if (idx == -1) {
+        return BLE_HS_ENOENT;
     }
 
-    rc = ble_store_config_persist_peer_secs();
-    if (rc != 0) {
-        return rc;
+    for (; idx <= ble_store_config_num_peer_secs; idx++) {
+        rc = ble_store_config_persist_peer_sec(idx);
+        if (rc != 0) {
+            return rc;
+        }
     }
 
     return 0;
@@ -262,7 +445,8 @@ ble_store_config_read_peer_sec(const struct ble_store_key_sec *key_sec,
     int idx;
 
     idx = ble_store_config_find_sec(key_sec, ble_store_config_peer_secs,
-                             ble_store_config_num_peer_secs);
+                                    ble_store_config_num_peer_secs,
+                                    &ble_store_config_peer_sec_idx);
     if (idx == -1) {
         return BLE_HS_ENOENT;
     }
@@ -283,7 +467,8 @@ ble_store_config_write_peer_sec(const struct ble_store_value_sec *value_sec)
 
     ble_store_key_from_value_sec(&key_sec, value_sec);
     idx = ble_store_config_find_sec(&key_sec, ble_store_config_peer_secs,
-                                 ble_store_config_num_peer_secs);
+                                    ble_store_config_num_peer_secs,
+                                    &ble_store_config_peer_sec_idx);
     if (idx == -1) {
         if (ble_store_config_num_peer_secs >= MYNEWT_VAL(BLE_STORE_MAX_BONDS)) {
             BLE_HS_LOG(DEBUG, "error persisting peer sec; too many entries "
@@ -293,11 +478,13 @@ ble_store_config_write_peer_sec(const struct ble_store_value_sec *value_sec)
 
         idx = ble_store_config_num_peer_secs;
         ble_store_config_num_peer_secs++;
+        ble_store_config_sec_idx_add(&ble_store_config_peer_sec_idx,
+                                     value_sec, idx);
     }
 
     ble_store_config_peer_secs[idx] = *value_sec;
 
-    rc = ble_store_config_persist_peer_secs();
+    rc = ble_store_config_persist_peer_sec(idx);
     if (rc != 0) {
         return rc;
     }
@@ -313,31 +500,50 @@ static int
 ble_store_config_find_cccd(const struct ble_store_key_cccd *key)
 {
     struct ble_store_value_cccd *cccd;
+    unsigned int bucket;
+    int by_addr;
     int skipped;
     int i;
 
+    if (ble_store_config_num_cccds == 0) {
+        return -1;
+    }
+
+    by_addr = ble_addr_cmp(&key->peer_addr, BLE_ADDR_ANY) != 0;
+    if (by_addr) {
+        bucket = ble_store_config_hash_addr(&key->peer_addr,
+                                            MYNEWT_VAL(BLE_STORE_MAX_CCCDS));
+        i = ble_store_config_cccd_idx.addr_head[bucket];
+    } else if (key->chr_val_handle == 0) {
+        /* Wildcard key; every record matches. */
+        if (key->idx < ble_store_config_num_cccds) {
+            return key->idx;
+        }
+        return -1;
+    } else {
+        /* Any peer, specific handle; not indexed, scan all records. */
+        i = 0;
+    }
+
     skipped = 0;
-    for (i = 0; i < ble_store_config_num_cccds; i++) {
+    while (i != BLE_STORE_CONFIG_IDX_NONE && i < ble_store_config_num_cccds) {
         cccd = ble_store_config_cccds + i;
 
-        if (ble_addr_cmp(&key->peer_addr, BLE_ADDR_ANY)) {
-            if (ble_addr_cmp(&cccd->peer_addr, &key->peer_addr)) {
-                continue;
-            }
-        }
+        if ((!by_addr || !ble_addr_cmp(&cccd->peer_addr, &key->peer_addr)) &&
+            (key->chr_val_handle == 0 ||
+             cccd->chr_val_handle == key->chr_val_handle)) {
 
-        if (key->chr_val_handle != 0) {
-            if (cccd->chr_val_handle != key->chr_val_handle) {
-                continue;
+            if (key->idx == skipped) {
+                return i;
             }
-        }
-
-        if (key->idx > skipped) {
             skipped++;
-            continue;
         }
 
-        return i;
+        if (by_addr) {
+            i = ble_store_config_cccd_idx.addr_next[i];
+        } else {
+            i++;
+        }
     }
 
     return -1;
@@ -354,17 +560,17 @@ ble_store_config_delete_cccd(const struct ble_store_key_cccd *key_cccd)
         return BLE_HS_ENOENT;
     }
 
-    rc = ble_store_config_delete_obj(ble_store_config_cccds,
-                                     sizeof *ble_store_config_cccds,
-                                     idx,
-                                     &ble_store_config_num_cccds);
-    if (rc != 0) {
-        return rc;
-    }
+    ble_store_config_delete_obj(ble_store_config_cccds,
+                                sizeof *ble_store_config_cccds,
+                                idx,
+                                &ble_store_config_num_cccds);
+    ble_store_config_cccd_idx_build();
 
-    rc = ble_store_config_persist_cccds();
-    if (rc != 0) {
-        return rc;
+    for (; idx <= ble_store_config_num_cccds; idx++) {
+        rc = ble_store_config_persist_cccd(idx);
+        if (rc != 0) {
+            return rc;
+        }
     }
 
     return 0;
@@ -403,11 +609,12 @@ ble_store_config_write_cccd(const struct ble_store_value_cccd *value_cccd)
 
         idx = ble_store_config_num_cccds;
         ble_store_config_num_cccds++;
+        ble_store_config_cccd_idx_add(value_cccd, idx);
     }
 
     ble_store_config_cccds[idx] = *value_cccd;
 
-    rc = ble_store_config_persist_cccds();
+    rc = ble_store_config_persist_cccd(idx);
     if (rc != 0) {
         return rc;
     }
@@ -528,6 +735,7 @@ ble_store_config_init(void)
     ble_store_config_num_our_secs = 0;
     ble_store_config_num_peer_secs = 0;
     ble_store_config_num_cccds = 0;
+    ble_store_config_idx_rebuild();
 
     ble_store_config_conf_init();
 }
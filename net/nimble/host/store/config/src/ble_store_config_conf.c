@@ -22,6 +22,8 @@
 #if MYNEWT_VAL(BLE_STORE_CONFIG_PERSIST)
 
 #include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "sysinit/sysinit.h"
@@ -34,6 +36,8 @@
 static int
 ble_store_config_conf_set(int argc, char **argv, char *val);
 static int
+ble_store_config_conf_commit(void);
+static int
 ble_store_config_conf_export(void (*func)(char *name, char *val),
                              enum conf_export_tgt tgt);
 
@@ -41,181 +45,360 @@ static struct conf_handler ble_store_config_conf_handler = {
     .ch_name = "ble_hs",
     .ch_get = NULL,
     .ch_set = ble_store_config_conf_set,
-    .ch_commit = NULL,
+    .ch_commit = ble_store_config_conf_commit,
     .ch_export = ble_store_config_conf_export
 };
 
 #define BLE_STORE_CONFIG_SEC_ENCODE_SZ      \
     BASE64_ENCODE_SIZE(sizeof (struct ble_store_value_sec))
 
-#define BLE_STORE_CONFIG_SEC_SET_ENCODE_SZ  \
-    (MYNEWT_VAL(BLE_STORE_MAX_BONDS) * BLE_STORE_CONFIG_SEC_ENCODE_SZ + 1)
-
 #define BLE_STORE_CONFIG_CCCD_ENCODE_SZ     \
     BASE64_ENCODE_SIZE(sizeof (struct ble_store_value_cccd))
 
-#define BLE_STORE_CONFIG_CCCD_SET_ENCODE_SZ \
-    (MYNEWT_VAL(BLE_STORE_MAX_CCCDS) * BLE_STORE_CONFIG_CCCD_ENCODE_SZ + 1)
+#define BLE_STORE_CONFIG_OBJ_ENCODE_SZ      \
+    (max(BLE_STORE_CONFIG_SEC_ENCODE_SZ, BLE_STORE_CONFIG_CCCD_ENCODE_SZ) + 1)
 
-static void
-ble_store_config_serialize_arr(const void *arr, int obj_sz, int num_objs,
-                               char *out_buf, int buf_sz)
+/* "ble_hs/" + table name + "/" + slot number. */
+#define BLE_STORE_CONFIG_NAME_SZ            32
+
+/**
+ * Each record is saved under its own setting, "ble_hs/<table>/<slot>", so
+ * a write only appends that one record to flash.  Older images saved each
+ * table as a single setting, "ble_hs/<table>"; these are still accepted on
+ * load and converted on commit.
+ */
+struct ble_store_config_tbl {
+    const char *name;
+    void *objs;
+    int obj_sz;
+    int max_objs;
+    int *num_objs;
+
+    /* State gathered while loading; consumed by the commit handler. */
+    uint8_t *loaded;
+    unsigned any_loaded:1;
+    unsigned legacy:1;
+};
+
+static uint8_t ble_store_config_our_sec_loaded[MYNEWT_VAL(BLE_STORE_MAX_BONDS)];
+static uint8_t
+    ble_store_config_peer_sec_loaded[MYNEWT_VAL(BLE_STORE_MAX_BONDS)];
+static uint8_t ble_store_config_cccd_loaded[MYNEWT_VAL(BLE_STORE_MAX_CCCDS)];
+
+#define BLE_STORE_CONFIG_TBL_OUR_SEC        0
+#define BLE_STORE_CONFIG_TBL_PEER_SEC       1
+#define BLE_STORE_CONFIG_TBL_CCCD           2
+#define BLE_STORE_CONFIG_NUM_TBLS           3
+
+static struct ble_store_config_tbl
+    ble_store_config_tbls[BLE_STORE_CONFIG_NUM_TBLS] = {
+    [BLE_STORE_CONFIG_TBL_OUR_SEC] = {
+        .name = "our_sec",
+        .objs = ble_store_config_our_secs,
+        .obj_sz = sizeof *ble_store_config_our_secs,
+        .max_objs = MYNEWT_VAL(BLE_STORE_MAX_BONDS),
+        .num_objs = &ble_store_config_num_our_secs,
+        .loaded = ble_store_config_our_sec_loaded,
+    },
+    [BLE_STORE_CONFIG_TBL_PEER_SEC] = {
+        .name = "peer_sec",
+        .objs = ble_store_config_peer_secs,
+        .obj_sz = sizeof *ble_store_config_peer_secs,
+        .max_objs = MYNEWT_VAL(BLE_STORE_MAX_BONDS),
+        .num_objs = &ble_store_config_num_peer_secs,
+        .loaded = ble_store_config_peer_sec_loaded,
+    },
+    [BLE_STORE_CONFIG_TBL_CCCD] = {
+        .name = "cccd",
+        .objs = ble_store_config_cccds,
+        .obj_sz = sizeof *ble_store_config_cccds,
+        .max_objs = MYNEWT_VAL(BLE_STORE_MAX_CCCDS),
+        .num_objs = &ble_store_config_num_cccds,
+        .loaded = ble_store_config_cccd_loaded,
+    },
+};
+
+static struct ble_store_config_tbl *
+ble_store_config_tbl_find(const char *name)
 {
-    int arr_size;
+    int i;
+
+    for (i = 0; i < BLE_STORE_CONFIG_NUM_TBLS; i++) {
+        if (strcmp(ble_store_config_tbls[i].name, name) == 0) {
+            return ble_store_config_tbls + i;
+        }
+    }
+
+    return NULL;
+}
 
-    arr_size = obj_sz * num_objs;
-    assert(arr_size <= buf_sz);
+static uint8_t *
+ble_store_config_tbl_obj(const struct ble_store_config_tbl *tbl, int idx)
+{
+    return (uint8_t *)tbl->objs + idx * tbl->obj_sz;
+}
+
+/**
+ * Writes a single slot of a table to sys/config.  Slots at or beyond the
+ * table's record count are erased.
+ */
+static int
+ble_store_config_persist_obj(const struct ble_store_config_tbl *tbl,
+                             int idx)
+{
+    char name[BLE_STORE_CONFIG_NAME_SZ];
+    char buf[BLE_STORE_CONFIG_OBJ_ENCODE_SZ];
+    char *val;
+    int rc;
+
+    snprintf(name, sizeof name, "ble_hs/%s/%d", tbl->name, idx);
+
+    if (idx < *tbl->num_objs) {
+        base64_encode(ble_store_config_tbl_obj(tbl, idx), tbl->obj_sz,
+                      buf, 1);
+        val = buf;
+    } else {
+        val = NULL;
+    }
+
+    rc = conf_save_one(name, val);
+    if (rc != 0) {
+        return BLE_HS_ESTORE_FAIL;
+    }
 
-    base64_encode(arr, arr_size, out_buf, 1);
+    return 0;
 }
 
 static int
-ble_store_config_deserialize_arr(const char *enc,
-                                 void *out_arr,
-                                 int obj_sz,
-                                 int *out_num_objs)
+ble_store_config_load_legacy(struct ble_store_config_tbl *tbl, char *val)
 {
+    int num_objs;
     int len;
+    int i;
 
-    len = base64_decode(enc, out_arr);
+    if (val == NULL) {
+        /* Erased by a previous conversion. */
+        return 0;
+    }
+
+    len = base64_decode_len(val);
+    if (len > tbl->max_objs * tbl->obj_sz) {
+        return OS_EINVAL;
+    }
+
+    len = base64_decode(val, tbl->objs);
     if (len < 0) {
         return OS_EINVAL;
     }
 
-    *out_num_objs = len / obj_sz;
+    num_objs = len / tbl->obj_sz;
+    for (i = 0; i < tbl->max_objs; i++) {
+        tbl->loaded[i] = i < num_objs;
+    }
+    tbl->any_loaded = 1;
+    tbl->legacy = 1;
+
     return 0;
 }
 
 static int
-ble_store_config_conf_set(int argc, char **argv, char *val)
+ble_store_config_load_obj(struct ble_store_config_tbl *tbl,
+                          const char *slot, char *val)
 {
-    int rc;
+    char *endptr;
+    long idx;
 
-    if (argc == 1) {
-        if (strcmp(argv[0], "our_sec") == 0) {
-            rc = ble_store_config_deserialize_arr(
-                    val,
-                    ble_store_config_our_secs,
-                    sizeof *ble_store_config_our_secs,
-                    &ble_store_config_num_our_secs);
-            return rc;
-        } else if (strcmp(argv[0], "peer_sec") == 0) {
-            rc = ble_store_config_deserialize_arr(
-                    val,
-                    ble_store_config_peer_secs,
-                    sizeof *ble_store_config_peer_secs,
-                    &ble_store_config_num_peer_secs);
-            return rc;
-        } else if (strcmp(argv[0], "cccd") == 0) {
-            rc = ble_store_config_deserialize_arr(
-                    val,
-                    ble_store_config_cccds,
-                    sizeof *ble_store_config_cccds,
-                    &ble_store_config_num_cccds);
-            return rc;
+    idx = strtol(slot, &endptr, 10);
+    if (*slot == '\0' || *endptr != '\0' ||
+        idx < 0 || idx >= tbl->max_objs) {
+
+        return OS_EINVAL;
+    }
+
+    if (val == NULL) {
+        tbl->loaded[idx] = 0;
+    } else {
+        if (base64_decode_len(val) != tbl->obj_sz) {
+            return OS_EINVAL;
+        }
+        if (base64_decode(val, ble_store_config_tbl_obj(tbl, idx)) < 0) {
+            return OS_EINVAL;
         }
+        tbl->loaded[idx] = 1;
     }
-    return OS_ENOENT;
+    tbl->any_loaded = 1;
+
+    return 0;
 }
 
 static int
-ble_store_config_conf_export(void (*func)(char *name, char *val),
-                             enum conf_export_tgt tgt)
+ble_store_config_conf_set(int argc, char **argv, char *val)
 {
-    union {
-        char sec[BLE_STORE_CONFIG_SEC_SET_ENCODE_SZ];
-        char cccd[BLE_STORE_CONFIG_CCCD_SET_ENCODE_SZ];
-    } buf;
-
-    ble_store_config_serialize_arr(ble_store_config_our_secs,
-                                   sizeof *ble_store_config_our_secs,
-                                   ble_store_config_num_our_secs,
-                                   buf.sec,
-                                   sizeof buf.sec);
-    func("ble_hs/our_sec", buf.sec);
-
-    ble_store_config_serialize_arr(ble_store_config_peer_secs,
-                                   sizeof *ble_store_config_peer_secs,
-                                   ble_store_config_num_peer_secs,
-                                   buf.sec,
-                                   sizeof buf.sec);
-    func("ble_hs/peer_sec", buf.sec);
-
-    ble_store_config_serialize_arr(ble_store_config_cccds,
-                                   sizeof *ble_store_config_cccds,
-                                   ble_store_config_num_cccds,
-                                   buf.cccd,
-                                   sizeof buf.cccd);
-    func("ble_hs/cccd", buf.cccd);
+    struct ble_store_config_tbl *tbl;
 
-    return 0;
+    if (argc < 1 || argc > 2) {
+        return OS_ENOENT;
+    }
+
+    tbl = ble_store_config_tbl_find(argv[0]);
+    if (tbl == NULL) {
+        return OS_ENOENT;
+    }
+
+    if (argc == 1) {
+        return ble_store_config_load_legacy(tbl, val);
+    } else {
+        return ble_store_config_load_obj(tbl, argv[1], val);
+    }
 }
 
+/**
+ * Packs the loaded slots of a table to the front of its array, preserving
+ * their order, and rewrites whatever slots this moved.
+ *
+ * A delete rewrites the slots after the deleted record one by one and then
+ * erases the old last slot.  If the device lost power partway through, the
+ * record last copied down is in two adjacent slots; the second copy is
+ * dropped here.  Records are unique by key, so two identical neighbours
+ * can only come from this.
+ */
 static int
-ble_store_config_persist_sec_set(const char *setting_name,
-                                 const struct ble_store_value_sec *secs,
-                                 int num_secs)
+ble_store_config_tbl_commit(struct ble_store_config_tbl *tbl)
 {
-    char buf[BLE_STORE_CONFIG_SEC_SET_ENCODE_SZ];
+    int first_moved;
+    int last_loaded;
+    int num_objs;
     int rc;
+    int i;
+
+    first_moved = -1;
+    last_loaded = -1;
+    num_objs = 0;
+    for (i = 0; i < tbl->max_objs; i++) {
+        if (!tbl->loaded[i]) {
+            continue;
+        }
+        last_loaded = i;
 
-    ble_store_config_serialize_arr(secs, sizeof *secs, num_secs,
-                                   buf, sizeof buf);
-    rc = conf_save_one(setting_name, buf);
-    if (rc != 0) {
-        return BLE_HS_ESTORE_FAIL;
+        if (num_objs > 0 &&
+            memcmp(ble_store_config_tbl_obj(tbl, num_objs - 1),
+                   ble_store_config_tbl_obj(tbl, i), tbl->obj_sz) == 0) {
+
+            /* Duplicate left by an interrupted delete. */
+            if (first_moved == -1) {
+                first_moved = num_objs;
+            }
+            continue;
+        }
+
+        if (i != num_objs) {
+            memcpy(ble_store_config_tbl_obj(tbl, num_objs),
+                   ble_store_config_tbl_obj(tbl, i), tbl->obj_sz);
+            if (first_moved == -1) {
+                first_moved = num_objs;
+            }
+        }
+        num_objs++;
     }
+    *tbl->num_objs = num_objs;
 
-    return 0;
+    if (tbl->legacy) {
+        /* Convert to per-record settings and erase the old one. */
+        first_moved = 0;
+        last_loaded = num_objs - 1;
+    }
+
+    /* Slots from num_objs up to last_loaded are erased. */
+    rc = 0;
+    if (first_moved != -1) {
+        for (i = first_moved; i <= last_loaded; i++) {
+            rc = ble_store_config_persist_obj(tbl, i);
+            if (rc != 0) {
+                break;
+            }
+        }
+    }
+
+    return rc;
 }
 
-int
-ble_store_config_persist_our_secs(void)
+static int
+ble_store_config_conf_commit(void)
 {
+    struct ble_store_config_tbl *tbl;
+    char name[BLE_STORE_CONFIG_NAME_SZ];
+    int rc2;
     int rc;
+    int i;
 
-    rc = ble_store_config_persist_sec_set("ble_hs/our_sec",
-                                          ble_store_config_our_secs,
-                                          ble_store_config_num_our_secs);
-    if (rc != 0) {
-        return rc;
+    rc = 0;
+    for (i = 0; i < BLE_STORE_CONFIG_NUM_TBLS; i++) {
+        tbl = ble_store_config_tbls + i;
+        if (!tbl->any_loaded) {
+            continue;
+        }
+
+        rc2 = ble_store_config_tbl_commit(tbl);
+        if (rc2 == 0 && tbl->legacy) {
+            snprintf(name, sizeof name, "ble_hs/%s", tbl->name);
+            rc2 = conf_save_one(name, NULL);
+        }
+        if (rc == 0) {
+            rc = rc2;
+        }
+
+        memset(tbl->loaded, 0, tbl->max_objs);
+        tbl->any_loaded = 0;
+        tbl->legacy = 0;
     }
 
-    return 0;
+    ble_store_config_idx_rebuild();
+
+    return rc;
 }
 
-int
-ble_store_config_persist_peer_secs(void)
+static int
+ble_store_config_conf_export(void (*func)(char *name, char *val),
+                             enum conf_export_tgt tgt)
 {
-    int rc;
-
-    rc = ble_store_config_persist_sec_set("ble_hs/peer_sec",
-                                          ble_store_config_peer_secs,
-                                          ble_store_config_num_peer_secs);
-    if (rc != 0) {
-        return rc;
+    const struct ble_store_config_tbl *tbl;
+    char name[BLE_STORE_CONFIG_NAME_SZ];
+    char buf[BLE_STORE_CONFIG_OBJ_ENCODE_SZ];
+    int i;
+    int j;
+
+    for (i = 0; i < BLE_STORE_CONFIG_NUM_TBLS; i++) {
+        tbl = ble_store_config_tbls + i;
+        for (j = 0; j < *tbl->num_objs; j++) {
+            snprintf(name, sizeof name, "ble_hs/%s/%d", tbl->name, j);
+            base64_encode(ble_store_config_tbl_obj(tbl, j), tbl->obj_sz,
+                          buf, 1);
+            func(name, buf);
+        }
     }
 
     return 0;
 }
 
 int
-ble_store_config_persist_cccds(void)
+ble_store_config_persist_our_sec(int idx)
 {
-    char buf[BLE_STORE_CONFIG_CCCD_SET_ENCODE_SZ];
-    int rc;
+    return ble_store_config_persist_obj(
+        ble_store_config_tbls + BLE_STORE_CONFIG_TBL_OUR_SEC, idx);
+}
 
-    ble_store_config_serialize_arr(ble_store_config_cccds,
-                                   sizeof *ble_store_config_cccds,
-                                   ble_store_config_num_cccds,
-                                   buf,
-                                   sizeof buf);
-    rc = conf_save_one("ble_hs/cccd", buf);
-    if (rc != 0) {
-        return BLE_HS_ESTORE_FAIL;
-    }
+int
+ble_store_config_persist_peer_sec(int idx)
+{
+    return ble_store_config_persist_obj(
+        ble_store_config_tbls + BLE_STORE_CONFIG_TBL_PEER_SEC, idx);
+}
 
-    return 0;
+int
+ble_store_config_persist_cccd(int idx)
+{
+    return ble_store_config_persist_obj(
+        ble_store_config_tbls + BLE_STORE_CONFIG_TBL_CCCD, idx);
 }
 
 void
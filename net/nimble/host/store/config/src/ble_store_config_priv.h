@@ -36,18 +36,20 @@ extern struct ble_store_value_cccd
     ble_store_config_cccds[MYNEWT_VAL(BLE_STORE_MAX_CCCDS)];
 extern int ble_store_config_num_cccds;
 
+void ble_store_config_idx_rebuild(void);
+
 #if MYNEWT_VAL(BLE_STORE_CONFIG_PERSIST)
 
-int ble_store_config_persist_our_secs(void);
-int ble_store_config_persist_peer_secs(void);
-int ble_store_config_persist_cccds(void);
+int ble_store_config_persist_our_sec(int idx);
+int ble_store_config_persist_peer_sec(int idx);
+int ble_store_config_persist_cccd(int idx);
 void ble_store_config_conf_init(void);
 
 #else
 
-static inline int ble_store_config_persist_our_secs(void)   { return 0; }
-static inline int ble_store_config_persist_peer_secs(void)  { return 0; }
-static inline int ble_store_config_persist_cccds(void)      { return 0; }
+static inline int ble_store_config_persist_our_sec(int idx)  { return 0; }
+static inline int ble_store_config_persist_peer_sec(int idx) { return 0; }
+static inline int ble_store_config_persist_cccd(int idx)     { return 0; }
 static inline void ble_store_config_conf_init(void)         { }
 
 #endif /* MYNEWT_VAL(BLE_STORE_CONFIG_PERSIST) */
@@ -36,6 +36,8 @@ static struct ble_gap_upd_params ble_gap_test_conn_self_params;
 static int ble_gap_test_disc_event_type;
 static struct ble_gap_disc_desc ble_gap_test_disc_desc;
 static void *ble_gap_test_disc_arg;
+static int ble_gap_test_disc_batch_cnt;
+static int ble_gap_test_disc_batch_num_reports;
 
 /*****************************************************************************
  * $misc                                                                     *
@@ -52,6 +54,8 @@ ble_gap_test_util_reset_cb_info(void)
     ble_gap_test_disc_event_type = -1;
     memset(&ble_gap_test_disc_desc, 0xff, sizeof ble_gap_test_disc_desc);
     ble_gap_test_disc_arg = (void *)-1;
+    ble_gap_test_disc_batch_cnt = 0;
+    ble_gap_test_disc_batch_num_reports = 0;
 }
 
 static void
@@ -68,8 +72,20 @@ ble_gap_test_util_disc_cb(struct ble_gap_event *event, void *arg)
     ble_gap_test_disc_event_type = event->type;
     ble_gap_test_disc_arg = arg;
 
-    if (event->type == BLE_GAP_EVENT_DISC) {
+    switch (event->type) {
+    case BLE_GAP_EVENT_DISC:
         ble_gap_test_disc_desc = event->disc;
+        break;
+
+    case BLE_GAP_EVENT_DISC_BATCH:
+        ble_gap_test_disc_batch_cnt++;
+        ble_gap_test_disc_batch_num_reports = event->disc_batch.num_reports;
+        ble_gap_test_disc_desc =
+            event->disc_batch.reports[event->disc_batch.num_reports - 1];
+        break;
+
+    default:
+        break;
     }
 
     return 0;
@@ -782,6 +798,77 @@ TEST_CASE(ble_gap_test_case_disc_busy)
     TEST_ASSERT(rc == BLE_HS_EBUSY);
 }
 
+TEST_CASE(ble_gap_test_case_disc_batch)
+{
+    struct ble_gap_disc_desc descs[3];
+    int rc;
+    int i;
+
+    uint8_t ltd_data[] = { 2, BLE_HS_ADV_TYPE_FLAGS, BLE_HS_ADV_F_DISC_LTD };
+    uint8_t gen_data[] = { 2, BLE_HS_ADV_TYPE_FLAGS, BLE_HS_ADV_F_DISC_GEN };
+    struct ble_gap_disc_params disc_params = {
+        .itvl = BLE_GAP_SCAN_SLOW_INTERVAL1,
+        .window = BLE_GAP_SCAN_SLOW_WINDOW1,
+        .filter_policy = BLE_HCI_CONN_FILT_NO_WL,
+        .limited = 1,
+        .passive = 0,
+        .filter_duplicates = 0,
+        .batch = 1,
+    };
+
+    memset(descs, 0, sizeof descs);
+    for (i = 0; i < 3; i++) {
+        descs[i].event_type = BLE_HCI_ADV_TYPE_ADV_IND;
+        descs[i].addr.type = BLE_ADDR_PUBLIC;
+        memset(descs[i].addr.val, i + 1, 6);
+        descs[i].length_data = 3;
+        descs[i].rssi = -i;
+    }
+
+    /* Middle report lacks the LTD flag and must be filtered out. */
+    descs[0].data = ltd_data;
+    descs[1].data = gen_data;
+    descs[2].data = ltd_data;
+
+    ble_gap_test_util_init();
+
+    rc = ble_hs_test_util_disc(BLE_OWN_ADDR_PUBLIC, BLE_HS_FOREVER,
+                               &disc_params, ble_gap_test_util_disc_cb, NULL,
+                               -1, 0);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    ble_gap_rx_adv_reports(descs, 3);
+
+    /* Both remaining reports delivered in a single event. */
+    TEST_ASSERT(ble_gap_test_disc_event_type == BLE_GAP_EVENT_DISC_BATCH);
+    TEST_ASSERT(ble_gap_test_disc_batch_cnt == 1);
+    TEST_ASSERT(ble_gap_test_disc_batch_num_reports == 2);
+    TEST_ASSERT(ble_gap_test_disc_desc.addr.val[0] == 3);
+    TEST_ASSERT(ble_gap_test_disc_desc.rssi == -2);
+
+    /* The caller's reports are left as they were. */
+    for (i = 0; i < 3; i++) {
+        TEST_ASSERT(descs[i].addr.val[0] == i + 1);
+    }
+    TEST_ASSERT(descs[1].data == gen_data);
+
+    /* Without the batch option, reports are delivered one by one. */
+    rc = ble_hs_test_util_disc_cancel(0);
+    TEST_ASSERT(rc == 0);
+
+    ble_gap_test_util_reset_cb_info();
+    disc_params.batch = 0;
+    rc = ble_hs_test_util_disc(BLE_OWN_ADDR_PUBLIC, BLE_HS_FOREVER,
+                               &disc_params, ble_gap_test_util_disc_cb, NULL,
+                               -1, 0);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    ble_gap_rx_adv_reports(descs, 3);
+    TEST_ASSERT(ble_gap_test_disc_event_type == BLE_GAP_EVENT_DISC);
+    TEST_ASSERT(ble_gap_test_disc_batch_cnt == 0);
+    TEST_ASSERT(ble_gap_test_disc_desc.addr.val[0] == 3);
+}
+
 TEST_SUITE(ble_gap_test_suite_disc)
 {
     tu_suite_set_post_test_cb(ble_hs_test_util_post_test, NULL);
@@ -793,6 +880,7 @@ TEST_SUITE(ble_gap_test_suite_disc)
     ble_gap_test_case_disc_dflts();
     ble_gap_test_case_disc_already();
     ble_gap_test_case_disc_busy();
+    ble_gap_test_case_disc_batch();
 }
 
 /*****************************************************************************
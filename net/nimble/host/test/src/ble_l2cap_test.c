@@ -655,7 +655,7 @@ TEST_CASE(ble_l2cap_test_case_sig_update_init_fail_bad_id)
     TEST_ASSERT(ble_l2cap_test_update_arg == NULL);
 }
 
-/* Test enum but first four events matches to events which L2CAP sends to
+/* Test enum but first six events matches to events which L2CAP sends to
  * application. We need this in order to add additional SEND_DATA event for
  * testing
  */
@@ -665,6 +665,8 @@ enum {
     BLE_L2CAP_TEST_EVENT_COC_DISCONNECT,
     BLE_L2CAP_TEST_EVENT_COC_ACCEPT,
     BLE_L2CAP_TEST_EVENT_COC_RECV_DATA,
+    BLE_L2CAP_TEST_EVENT_COC_RECV_FRAG,
+    BLE_L2CAP_TEST_EVENT_COC_TX_UNSTALLED,
     BLE_L2CAP_TEST_EVENT_COC_SEND_DATA,
 };
 
@@ -679,7 +681,7 @@ struct event {
 };
 
 struct test_data {
-    struct event event[3];
+    struct event event[4];
     uint16_t expected_num_of_ev;
     /* This we use to track number of events sent to application*/
     uint16_t event_cnt;
@@ -722,6 +724,17 @@ ble_l2cap_test_event(struct ble_l2cap_event *event, void *arg)
                                     OS_MBUF_PKTLEN(event->receive.sdu_rx));
         TEST_ASSERT(memcmp(sdu_rx->om_data, ev->data, ev->data_len) == 0);
         return 0;
+
+    case BLE_L2CAP_EVENT_COC_DATA_RX_FRAG:
+        TEST_ASSERT(OS_MBUF_PKTLEN(event->receive_frag.om) == ev->data_len);
+        TEST_ASSERT(os_mbuf_cmpf(event->receive_frag.om, 0, ev->data,
+                                 ev->data_len) == 0);
+        os_mbuf_free_chain(event->receive_frag.om);
+        return 0;
+
+    case BLE_L2CAP_EVENT_COC_TX_UNSTALLED:
+        TEST_ASSERT(ev->app_status == event->tx_unstalled.status);
+        return 0;
     default:
         return 0;
     }
@@ -963,7 +976,7 @@ ble_l2cap_test_coc_send_data(struct test_data *t)
     assert(sdu_copy != NULL);
     put_le16(sdu_copy->om_data, ev->data_len);
 
-    ble_hs_test_util_verify_tx_l2cap(sdu);
+    ble_hs_test_util_verify_tx_l2cap(sdu_copy);
 
     os_mbuf_free_chain(sdu_copy);
 }
@@ -991,6 +1004,58 @@ ble_l2cap_test_coc_recv_data(struct test_data *t)
     ble_hs_test_util_inject_rx_l2cap(2, t->chan->scid, sdu);
 }
 
+static struct os_mbuf *
+ble_l2cap_test_coc_kframe(uint16_t sdu_len, uint8_t *data, uint16_t data_len)
+{
+    struct os_mbuf *om;
+    int rc;
+
+    om = os_msys_get_pkthdr(0, 0);
+    assert(om != NULL);
+
+    rc = os_mbuf_append(om, data, data_len);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    /* First K-frame of SDU starts with SDU len */
+    if (sdu_len != 0) {
+        om = os_mbuf_prepend_pullup(om, 2);
+        assert(om != NULL);
+        put_le16(om->om_data, sdu_len);
+    }
+
+    return om;
+}
+
+static void
+ble_l2cap_test_coc_recv_stream(struct test_data *t)
+{
+    struct ble_l2cap_sig_le_credits credits;
+    struct event *ev1 = &t->event[t->event_iter++];
+    struct event *ev2 = &t->event[t->event_iter++];
+    struct os_mbuf *om;
+    int rc;
+
+    rc = ble_l2cap_set_rx_stream(t->chan, 1);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    /* Each K-frame is given to application as soon as it arrives */
+    om = ble_l2cap_test_coc_kframe(ev1->data_len + ev2->data_len,
+                                   ev1->data, ev1->data_len);
+    ble_hs_test_util_inject_rx_l2cap(2, t->chan->scid, om);
+    TEST_ASSERT(ev1->handled);
+    TEST_ASSERT(!ev2->handled);
+
+    om = ble_l2cap_test_coc_kframe(0, ev2->data, ev2->data_len);
+    ble_hs_test_util_inject_rx_l2cap(2, t->chan->scid, om);
+    TEST_ASSERT(ev2->handled);
+
+    /* Peer used up half of its credits; ensure we gave them back */
+    credits.scid = htole16(t->chan->scid);
+    credits.credits = htole16(2);
+    ble_hs_test_util_verify_tx_l2cap_sig(BLE_L2CAP_SIG_OP_FLOW_CTRL_CREDIT,
+                                         &credits, sizeof(credits));
+}
+
 static void
 ble_l2cap_test_set_chan_test_conf(uint16_t psm, uint16_t mtu,
                                   struct test_data *t)
@@ -1191,6 +1256,63 @@ TEST_CASE(ble_l2cap_test_case_sig_coc_disconnect_succeed)
     TEST_ASSERT(t.expected_num_of_ev == t.event_iter);
 }
 
+TEST_CASE(ble_l2cap_test_case_sig_coc_disconnect_rsp_bad_cid)
+{
+    struct ble_l2cap_sig_disc_req req;
+    struct test_data t;
+    uint8_t id;
+    int rc;
+
+    ble_l2cap_test_util_init();
+
+    ble_l2cap_test_set_chan_test_conf(BLE_L2CAP_TEST_PSM,
+                                      BLE_L2CAP_TEST_COC_MTU, &t);
+    t.expected_num_of_ev = 2;
+
+    t.event[0].type = BLE_L2CAP_EVENT_COC_CONNECTED;
+    t.event[0].app_status = 0;
+    t.event[0].l2cap_status = BLE_L2CAP_COC_ERR_CONNECTION_SUCCESS;
+    t.event[1].type = BLE_L2CAP_EVENT_COC_DISCONNECTED;
+
+    ble_l2cap_test_coc_connect(&t);
+
+    rc = ble_l2cap_sig_disconnect(t.chan);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    ble_hs_test_util_tx_all();
+
+    req.dcid = htole16(t.chan->dcid);
+    req.scid = htole16(t.chan->scid);
+
+    id = ble_hs_test_util_verify_tx_l2cap_sig(BLE_L2CAP_SIG_OP_DISCONN_REQ,
+                                              &req, sizeof(req));
+
+    /* Receive response from peer with the channel IDs swapped. */
+    req.dcid = htole16(t.chan->scid);
+    req.scid = htole16(t.chan->dcid);
+    rc = ble_hs_test_util_inject_rx_l2cap_sig(2, BLE_L2CAP_SIG_OP_DISCONN_RSP,
+                                              id, &req, sizeof(req));
+    TEST_ASSERT(rc == 0);
+
+    /* Ensure the procedure is still pending and callback did not get
+     * called.
+     */
+    TEST_ASSERT(!t.event[1].handled);
+
+    /* Receive correct response from peer. */
+    req.dcid = htole16(t.chan->dcid);
+    req.scid = htole16(t.chan->scid);
+    rc = ble_hs_test_util_inject_rx_l2cap_sig(2, BLE_L2CAP_SIG_OP_DISCONN_RSP,
+                                              id, &req, sizeof(req));
+    TEST_ASSERT(rc == 0);
+
+    /* Ensure the disconnect completed successfully and callback got
+     * called.
+     */
+    TEST_ASSERT(t.event[1].handled);
+    TEST_ASSERT(t.event_cnt == t.expected_num_of_ev);
+}
+
 TEST_CASE(ble_l2cap_test_case_sig_coc_incoming_disconnect_succeed)
 {
     struct test_data t;
@@ -1307,6 +1429,96 @@ TEST_CASE(ble_l2cap_test_case_coc_recv_data_succeed)
     TEST_ASSERT(t.expected_num_of_ev == t.event_iter);
 }
 
+TEST_CASE(ble_l2cap_test_case_coc_send_data_queued)
+{
+    struct ble_l2cap_sig_le_credits credits;
+    struct test_data t = {};
+    struct os_mbuf *sdu[3];
+    struct os_mbuf *exp;
+    uint8_t buf[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+    int rc;
+    int i;
+
+    ble_l2cap_test_util_init();
+
+    ble_l2cap_test_set_chan_test_conf(BLE_L2CAP_TEST_PSM,
+                                      BLE_L2CAP_TEST_COC_MTU, &t);
+    t.expected_num_of_ev = 3;
+
+    t.event[0].type = BLE_L2CAP_EVENT_COC_CONNECTED;
+    t.event[1].type = BLE_L2CAP_EVENT_COC_TX_UNSTALLED;
+    t.event[2].type = BLE_L2CAP_EVENT_COC_DISCONNECTED;
+
+    ble_l2cap_test_coc_connect(&t);
+
+    /* Pretend peer has not given us any credits yet */
+    t.chan->coc_tx.credits = 0;
+
+    for (i = 0; i < 3; i++) {
+        sdu[i] = ble_l2cap_test_coc_kframe(0, buf, sizeof(buf));
+    }
+
+    /* First SDU waits for credits, second one is queued behind it */
+    rc = ble_l2cap_send(t.chan, sdu[0]);
+    TEST_ASSERT(rc == 0);
+    rc = ble_l2cap_send(t.chan, sdu[1]);
+    TEST_ASSERT(rc == 0);
+
+    /* No more room */
+    rc = ble_l2cap_send(t.chan, sdu[2]);
+    TEST_ASSERT(rc == BLE_HS_EBUSY);
+    os_mbuf_free_chain(sdu[2]);
+
+    ble_hs_test_util_tx_all();
+    TEST_ASSERT(ble_hs_test_util_prev_tx_dequeue() == NULL);
+
+    /* Peer gives credits, both SDUs go out */
+    credits.scid = htole16(t.chan->dcid);
+    credits.credits = htole16(2);
+    rc = ble_hs_test_util_inject_rx_l2cap_sig(
+        2, BLE_L2CAP_SIG_OP_FLOW_CTRL_CREDIT, 1, &credits, sizeof(credits));
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(t.event[t.event_iter++].handled);
+
+    for (i = 0; i < 2; i++) {
+        exp = ble_l2cap_test_coc_kframe(sizeof(buf), buf, sizeof(buf));
+        ble_hs_test_util_verify_tx_l2cap(exp);
+        os_mbuf_free_chain(exp);
+    }
+
+    ble_l2cap_test_coc_disc(&t);
+
+    TEST_ASSERT(t.expected_num_of_ev == t.event_iter);
+}
+
+TEST_CASE(ble_l2cap_test_case_coc_recv_data_stream)
+{
+    struct test_data t = {};
+    uint8_t buf1[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+    uint8_t buf2[] = {16, 17, 18, 19, 20, 21, 22, 23, 24, 25};
+
+    ble_l2cap_test_util_init();
+
+    ble_l2cap_test_set_chan_test_conf(BLE_L2CAP_TEST_PSM,
+                                      BLE_L2CAP_TEST_COC_MTU, &t);
+    t.expected_num_of_ev = 4;
+
+    t.event[0].type = BLE_L2CAP_EVENT_COC_CONNECTED;
+    t.event[1].type = BLE_L2CAP_EVENT_COC_DATA_RX_FRAG;
+    t.event[1].data = buf1;
+    t.event[1].data_len = sizeof(buf1);
+    t.event[2].type = BLE_L2CAP_EVENT_COC_DATA_RX_FRAG;
+    t.event[2].data = buf2;
+    t.event[2].data_len = sizeof(buf2);
+    t.event[3].type = BLE_L2CAP_EVENT_COC_DISCONNECTED;
+
+    ble_l2cap_test_coc_connect(&t);
+    ble_l2cap_test_coc_recv_stream(&t);
+    ble_l2cap_test_coc_disc(&t);
+
+    TEST_ASSERT(t.expected_num_of_ev == t.event_iter);
+}
+
 TEST_SUITE(ble_l2cap_test_suite)
 {
     tu_suite_set_post_test_cb(ble_hs_test_util_post_test, NULL);
@@ -1333,11 +1545,14 @@ TEST_SUITE(ble_l2cap_test_suite)
     ble_l2cap_test_case_sig_coc_incoming_conn_rejected_by_app();
     ble_l2cap_test_case_sig_coc_incoming_conn_success();
     ble_l2cap_test_case_sig_coc_disconnect_succeed();
+    ble_l2cap_test_case_sig_coc_disconnect_rsp_bad_cid();
     ble_l2cap_test_case_sig_coc_incoming_disconnect_succeed();
     ble_l2cap_test_case_sig_coc_incoming_disconnect_failed();
     ble_l2cap_test_case_coc_send_data_succeed();
     ble_l2cap_test_case_coc_send_data_failed_too_big_sdu();
     ble_l2cap_test_case_coc_recv_data_succeed();
+    ble_l2cap_test_case_coc_send_data_queued();
+    ble_l2cap_test_case_coc_recv_data_stream();
 }
 
 int
@@ -17,7 +17,10 @@
  * under the License.
  */
 
+#include <stdio.h>
 #include "testutil/testutil.h"
+#include "base64/base64.h"
+#include "config/config.h"
 #include "host/ble_hs_test.h"
 #include "ble_hs_test_util.h"
 
@@ -415,6 +418,215 @@ TEST_CASE(ble_store_test_clear)
     TEST_ASSERT(ble_store_test_util_count(BLE_STORE_OBJ_TYPE_CCCD) == 0);
 }
 
+static void
+ble_store_test_util_verify_sec(const struct ble_store_value_sec *sec)
+{
+    struct ble_store_value_sec value_sec;
+    struct ble_store_key_sec key_sec;
+    int rc;
+
+    memset(&key_sec, 0, sizeof key_sec);
+    key_sec.peer_addr = sec->peer_addr;
+    rc = ble_store_read_peer_sec(&key_sec, &value_sec);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(memcmp(&value_sec, sec, sizeof value_sec) == 0);
+
+    memset(&key_sec, 0, sizeof key_sec);
+    key_sec.peer_addr = *BLE_ADDR_ANY;
+    key_sec.ediv = sec->ediv;
+    key_sec.rand_num = sec->rand_num;
+    key_sec.ediv_rand_present = 1;
+    rc = ble_store_read_peer_sec(&key_sec, &value_sec);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(memcmp(&value_sec, sec, sizeof value_sec) == 0);
+}
+
+static void
+ble_store_test_util_verify_sec_order(const struct ble_store_value_sec *secs,
+                                     int num_secs)
+{
+    struct ble_store_value_sec value_sec;
+    struct ble_store_key_sec key_sec;
+    int rc;
+    int i;
+
+    memset(&key_sec, 0, sizeof key_sec);
+    key_sec.peer_addr = *BLE_ADDR_ANY;
+    for (i = 0; i < num_secs; i++) {
+        key_sec.idx = i;
+        rc = ble_store_read_peer_sec(&key_sec, &value_sec);
+        TEST_ASSERT_FATAL(rc == 0);
+        TEST_ASSERT(memcmp(&value_sec, secs + i, sizeof value_sec) == 0);
+    }
+
+    key_sec.idx = num_secs;
+    rc = ble_store_read_peer_sec(&key_sec, &value_sec);
+    TEST_ASSERT(rc == BLE_HS_ENOENT);
+}
+
+TEST_CASE(ble_store_test_hash_collide)
+{
+    struct ble_store_value_sec secs[MYNEWT_VAL(BLE_STORE_MAX_BONDS)];
+    struct ble_store_value_cccd cccds[MYNEWT_VAL(BLE_STORE_MAX_CCCDS)];
+    struct ble_store_value_cccd value_cccd;
+    struct ble_store_key_cccd key_cccd;
+    int rc;
+    int i;
+
+    ble_hs_test_util_init();
+
+    /* The addresses and ediv values differ by multiples of the bucket
+     * count, so every record lands in the same hash chain.
+     */
+    memset(secs, 0, sizeof secs);
+    for (i = 0; i < MYNEWT_VAL(BLE_STORE_MAX_BONDS); i++) {
+        secs[i].peer_addr = (ble_addr_t){
+            BLE_ADDR_PUBLIC,
+            { 1, 2, 3, 4, 5, i * MYNEWT_VAL(BLE_STORE_MAX_BONDS) }
+        };
+        secs[i].ediv = i * MYNEWT_VAL(BLE_STORE_MAX_BONDS);
+        secs[i].ltk_present = 1;
+        secs[i].ltk[0] = i;
+
+        rc = ble_store_write_peer_sec(secs + i);
+        TEST_ASSERT_FATAL(rc == 0);
+    }
+
+    for (i = 0; i < MYNEWT_VAL(BLE_STORE_MAX_BONDS); i++) {
+        ble_store_test_util_verify_sec(secs + i);
+    }
+    ble_store_test_util_verify_sec_order(secs,
+                                         MYNEWT_VAL(BLE_STORE_MAX_BONDS));
+
+    memset(cccds, 0, sizeof cccds);
+    for (i = 0; i < MYNEWT_VAL(BLE_STORE_MAX_CCCDS); i++) {
+        cccds[i].peer_addr = (ble_addr_t){
+            BLE_ADDR_PUBLIC,
+            { 1, 2, 3, 4, 5, i * MYNEWT_VAL(BLE_STORE_MAX_CCCDS) }
+        };
+        cccds[i].chr_val_handle = 10 + i;
+        cccds[i].flags = BLE_GATTS_CLT_CFG_F_NOTIFY;
+
+        rc = ble_store_write_cccd(cccds + i);
+        TEST_ASSERT_FATAL(rc == 0);
+    }
+
+    for (i = 0; i < MYNEWT_VAL(BLE_STORE_MAX_CCCDS); i++) {
+        memset(&key_cccd, 0, sizeof key_cccd);
+        key_cccd.peer_addr = cccds[i].peer_addr;
+        key_cccd.chr_val_handle = cccds[i].chr_val_handle;
+        rc = ble_store_read_cccd(&key_cccd, &value_cccd);
+        TEST_ASSERT_FATAL(rc == 0);
+        TEST_ASSERT(memcmp(&value_cccd, cccds + i, sizeof value_cccd) == 0);
+    }
+}
+
+TEST_CASE(ble_store_test_delete_shift)
+{
+    struct ble_store_value_sec secs[3];
+    struct ble_store_value_sec value_sec;
+    struct ble_store_key_sec key_sec;
+    int rc;
+    int i;
+
+    ble_hs_test_util_init();
+
+    memset(secs, 0, sizeof secs);
+    for (i = 0; i < 3; i++) {
+        secs[i].peer_addr =
+            (ble_addr_t){ BLE_ADDR_PUBLIC, { 1, 2, 3, 4, 5, 6 + i } };
+        secs[i].ediv = 100 + i;
+        secs[i].rand_num = 0x1122334455667788ULL + i;
+        secs[i].ltk_present = 1;
+
+        rc = ble_store_write_peer_sec(secs + i);
+        TEST_ASSERT_FATAL(rc == 0);
+    }
+
+    /* Delete the middle record; the last one moves down a slot. */
+    ble_store_key_from_value_sec(&key_sec, secs + 1);
+    rc = ble_store_delete_peer_sec(&key_sec);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    TEST_ASSERT(
+        ble_store_test_util_count(BLE_STORE_OBJ_TYPE_PEER_SEC) == 2);
+
+    memset(&key_sec, 0, sizeof key_sec);
+    key_sec.peer_addr = secs[1].peer_addr;
+    rc = ble_store_read_peer_sec(&key_sec, &value_sec);
+    TEST_ASSERT(rc == BLE_HS_ENOENT);
+
+    memset(&key_sec, 0, sizeof key_sec);
+    key_sec.peer_addr = *BLE_ADDR_ANY;
+    key_sec.ediv = secs[1].ediv;
+    key_sec.rand_num = secs[1].rand_num;
+    key_sec.ediv_rand_present = 1;
+    rc = ble_store_read_peer_sec(&key_sec, &value_sec);
+    TEST_ASSERT(rc == BLE_HS_ENOENT);
+
+    secs[1] = secs[2];
+    ble_store_test_util_verify_sec(secs + 0);
+    ble_store_test_util_verify_sec(secs + 1);
+    ble_store_test_util_verify_sec_order(secs, 2);
+}
+
+#if MYNEWT_VAL(BLE_STORE_CONFIG_PERSIST)
+TEST_CASE(ble_store_test_conf_load)
+{
+    struct ble_store_value_sec secs[2];
+    char val[BASE64_ENCODE_SIZE(sizeof secs) + 1];
+    char name[32];
+    int rc;
+    int i;
+
+    memset(secs, 0, sizeof secs);
+    for (i = 0; i < 2; i++) {
+        secs[i].peer_addr =
+            (ble_addr_t){ BLE_ADDR_PUBLIC, { 1, 2, 3, 4, 5, 6 + i } };
+        secs[i].ediv = 200 + i;
+        secs[i].ltk_present = 1;
+    }
+
+    /*** Whole table in a single setting, as saved by older images. */
+    ble_hs_test_util_init();
+
+    base64_encode(secs, sizeof secs, val, 1);
+    strcpy(name, "ble_hs/peer_sec");
+    rc = conf_set_value(name, val);
+    TEST_ASSERT_FATAL(rc == 0);
+    strcpy(name, "ble_hs");
+    rc = conf_commit(name);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    TEST_ASSERT(
+        ble_store_test_util_count(BLE_STORE_OBJ_TYPE_PEER_SEC) == 2);
+    ble_store_test_util_verify_sec(secs + 0);
+    ble_store_test_util_verify_sec(secs + 1);
+    ble_store_test_util_verify_sec_order(secs, 2);
+
+    /*** Per-record settings, with the duplicate an interrupted delete
+     * leaves behind.
+     */
+    ble_hs_test_util_init();
+
+    for (i = 0; i < 3; i++) {
+        base64_encode(secs + (i == 0 ? 0 : 1), sizeof secs[0], val, 1);
+        snprintf(name, sizeof name, "ble_hs/peer_sec/%d", i);
+        rc = conf_set_value(name, val);
+        TEST_ASSERT_FATAL(rc == 0);
+    }
+    strcpy(name, "ble_hs");
+    rc = conf_commit(name);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    TEST_ASSERT(
+        ble_store_test_util_count(BLE_STORE_OBJ_TYPE_PEER_SEC) == 2);
+    ble_store_test_util_verify_sec(secs + 0);
+    ble_store_test_util_verify_sec(secs + 1);
+    ble_store_test_util_verify_sec_order(secs, 2);
+}
+#endif
+
 TEST_SUITE(ble_store_suite)
 {
     tu_suite_set_post_test_cb(ble_hs_test_util_post_test, NULL);
@@ -424,6 +636,11 @@ TEST_SUITE(ble_store_suite)
     ble_store_test_count();
     ble_store_test_overflow();
     ble_store_test_clear();
+    ble_store_test_hash_collide();
+    ble_store_test_delete_shift();
+#if MYNEWT_VAL(BLE_STORE_CONFIG_PERSIST)
+    ble_store_test_conf_load();
+#endif
 }
 
 int
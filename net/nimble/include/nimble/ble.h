@@ -86,13 +86,15 @@ struct ble_mbuf_hdr_rxinfo
 #define BLE_MBUF_HDR_F_SCAN_RSP_CHK     (0x0008)
 #define BLE_MBUF_HDR_F_RXSTATE_MASK     (0x0007)
 
-/* Transmit info. NOTE: no flags defined */
+/*
+ * Transmit info. NOTE: must stay 4 bytes; for host ACL data it overlays the
+ * HCI ACL header that the controller strips off.
+ */
 struct ble_mbuf_hdr_txinfo
 {
-    uint8_t flags;
-    uint8_t offset;
-    uint8_t pyld_len;
     uint8_t hdr_byte;
+    uint8_t pyld_len;
+    uint16_t offset;
 };
 
 struct ble_mbuf_hdr
@@ -145,6 +145,7 @@ bool oc_stop_observe(const char *uri, oc_server_handle_t *server);
 
 struct os_eventq;
 void oc_evq_set(struct os_eventq *evq);
+struct os_eventq *oc_evq_get(void);
 
 #ifdef __cplusplus
 }
@@ -34,6 +34,8 @@ extern CborError g_err;
 
 struct os_mbuf;
 void oc_rep_new(struct os_mbuf *m);
+void oc_rep_new_measure(void);
+int oc_rep_reserve(int len);
 void oc_rep_reset(void);
 int oc_rep_finalize(void);
 
@@ -129,16 +129,11 @@ process_device_object(CborEncoder *device, const char *uuid, const char *rt,
   return matches;
 }
 
-static void
-oc_core_discovery_handler(oc_request_t *req, oc_interface_mask_t interface)
+static int
+oc_core_discovery_encode(oc_request_t *req, oc_interface_mask_t interface,
+                         const char *uuid, const char *rt, int rt_len)
 {
-    char *rt = NULL;
-    int rt_len = 0, matches = 0;
-    char uuid[37];
-
-    rt_len = oc_ri_get_query_value(req->query, req->query_len, "rt", &rt);
-
-    oc_uuid_to_str(oc_core_get_device_id(0), uuid, sizeof(uuid));
+    int matches = 0;
 
     switch (interface) {
     case OC_IF_LL: {
@@ -157,8 +152,38 @@ oc_core_discovery_handler(oc_request_t *req, oc_interface_mask_t interface)
     default:
         break;
     }
+    return matches;
+}
 
-    int response_length = oc_rep_finalize();
+static void
+oc_core_discovery_handler(oc_request_t *req, oc_interface_mask_t interface)
+{
+    char *rt = NULL;
+    int rt_len = 0, matches = 0;
+    char uuid[37];
+    int response_length;
+
+    rt_len = oc_ri_get_query_value(req->query, req->query_len, "rt", &rt);
+
+    oc_uuid_to_str(oc_core_get_device_id(0), uuid, sizeof(uuid));
+
+    /*
+     * The resource list can be long; measure it first, so that the response
+     * is allocated at once.
+     */
+    oc_rep_new_measure();
+    oc_core_discovery_encode(req, interface, uuid, rt, rt_len);
+    response_length = oc_rep_finalize();
+
+    oc_rep_new(req->response->response_buffer->buffer);
+    if (response_length > 0) {
+        /* If this fails, mbufs are allocated as the payload is encoded. */
+        oc_rep_reserve(response_length);
+        matches = oc_core_discovery_encode(req, interface, uuid, rt, rt_len);
+        response_length = oc_rep_finalize();
+    } else {
+        oc_rep_reset();
+    }
 
     if (matches && response_length > 0) {
         req->response->response_buffer->response_length = response_length;
@@ -20,6 +20,7 @@
 
 #include <syscfg/syscfg.h>
 
+#include <tinycbor/cbor_cnt_writer.h>
 #include <tinycbor/cbor_mbuf_writer.h>
 #include <tinycbor/cbor_mbuf_reader.h>
 
@@ -40,6 +41,7 @@ static struct os_mbuf *g_outm;
 CborEncoder g_encoder, root_map, links_array;
 CborError g_err;
 struct cbor_mbuf_writer g_buf_writer;
+static struct CborCntWriter g_cnt_writer;
 
 void
 oc_rep_new(struct os_mbuf *m)
@@ -50,10 +52,45 @@ oc_rep_new(struct os_mbuf *m)
     cbor_encoder_init(&g_encoder, &g_buf_writer.enc, 0);
 }
 
+/*
+ * Starts a measuring pass.  Encoding only counts bytes until the next
+ * oc_rep_finalize(), which returns the count.  The payload can then be
+ * encoded for real after oc_rep_new() and oc_rep_reserve(), into mbufs
+ * allocated at once.
+ */
+void
+oc_rep_new_measure(void)
+{
+    g_err = CborNoError;
+    g_outm = NULL;
+    cbor_cnt_writer_init(&g_cnt_writer);
+    cbor_encoder_init(&g_encoder, &g_cnt_writer.enc, 0);
+}
+
+/*
+ * Reserves room for len more bytes of payload in the mbuf given to
+ * oc_rep_new().
+ */
+int
+oc_rep_reserve(int len)
+{
+    if (cbor_mbuf_writer_reserve(&g_buf_writer, len)) {
+        return -1;
+    }
+    return 0;
+}
+
 int
 oc_rep_finalize(void)
 {
-    int size = OS_MBUF_PKTLEN(g_outm);
+    int size;
+
+    if (g_outm) {
+        cbor_mbuf_writer_release(&g_buf_writer);
+        size = OS_MBUF_PKTLEN(g_outm);
+    } else {
+        size = g_cnt_writer.enc.bytes_written;
+    }
     oc_rep_reset();
     if (g_err != CborNoError) {
         return -1;
@@ -35,6 +35,7 @@ extern "C" {
 #define SYS_EBUSY    (-8)
 #define SYS_ENODEV   (-9)
 #define SYS_ERANGE   (-10)
+#define SYS_ENOTSUP  (-11)
 
 #define SYS_EPERUSER (-65535)
 
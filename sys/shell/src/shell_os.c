@@ -30,6 +30,69 @@
 
 #define SHELL_OS "os"
 
+#if MYNEWT_VAL(OS_PROFILE)
+/*
+ * Lists the profiling results of the tasks; "tasks -v".
+ */
+static int
+shell_os_tasks_profile_display(char *name)
+{
+    struct os_profile_info opi;
+    struct os_task *prev_task;
+    struct os_task_info oti;
+    unsigned long permille;
+    int found;
+
+    found = 0;
+
+    os_profile_info_get(&opi);
+    console_printf("Tasks: %lu ms profiled\n",
+                   (unsigned long)(opi.opi_elapsed_usecs / 1000));
+    console_printf("%8s %8s %6s %8s %8s %8s\n",
+      "task", "cpu_ms", "cpu%", "burst_us", "evqmx_us", "evqav_us");
+    prev_task = NULL;
+    while (1) {
+        prev_task = os_task_info_get_next(prev_task, &oti);
+        if (prev_task == NULL) {
+            break;
+        }
+
+        if (name) {
+            if (strcmp(name, oti.oti_name)) {
+                continue;
+            } else {
+                found = 1;
+            }
+        }
+
+        if (opi.opi_elapsed_usecs != 0) {
+            permille = oti.oti_cpu_usecs * 1000 / opi.opi_elapsed_usecs;
+        } else {
+            permille = 0;
+        }
+        console_printf("%8s %8lu %4lu.%lu %8lu %8lu %8lu\n",
+                oti.oti_name, (unsigned long)(oti.oti_cpu_usecs / 1000),
+                permille / 10, permille % 10,
+                (unsigned long)oti.oti_cpu_burst_max_usecs,
+                (unsigned long)oti.oti_evq_lat_max_usecs,
+                (unsigned long)oti.oti_evq_lat_avg_usecs);
+    }
+
+    console_printf("Critical sections: %lu, %lu us total, "
+                   "max %lu us at %p\n",
+                   (unsigned long)opi.opi_crit_cnt,
+                   (unsigned long)opi.opi_crit_total_usecs,
+                   (unsigned long)opi.opi_crit_max_usecs,
+                   opi.opi_crit_max_addr);
+
+    if (name && !found) {
+        console_printf("Couldn't find task with name %s\n", name);
+    }
+
+    return 0;
+}
+#endif
+
 int
 shell_os_tasks_display_cmd(int argc, char **argv)
 {
@@ -41,6 +104,19 @@ shell_os_tasks_display_cmd(int argc, char **argv)
     name = NULL;
     found = 0;
 
+#if MYNEWT_VAL(OS_PROFILE)
+    if (argc > 1 && !strcmp(argv[1], "-r")) {
+        os_profile_reset();
+        return 0;
+    }
+    if (argc > 1 && !strcmp(argv[1], "-v")) {
+        if (argc > 2 && strcmp(argv[2], "")) {
+            name = argv[2];
+        }
+        return shell_os_tasks_profile_display(name);
+    }
+#endif
+
     if (argc > 1 && strcmp(argv[1], "")) {
         name = argv[1];
     }
@@ -160,6 +236,10 @@ shell_os_date_cmd(int argc, char **argv)
 
 #if MYNEWT_VAL(SHELL_CMD_HELP)
 static const struct shell_param tasks_params[] = {
+#if MYNEWT_VAL(OS_PROFILE)
+    {"-v", "show cpu usage, longest run and event latency"},
+    {"-r", "reset profiling results"},
+#endif
     {"", "task name"},
     {NULL, NULL}
 };
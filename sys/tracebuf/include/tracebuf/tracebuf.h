@@ -0,0 +1,98 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_TRACEBUF_
+#define H_TRACEBUF_
+
+#include <inttypes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Event IDs of the os_trace_*() hooks.  IDs from OS_TRACE_ID_OFFSET up are
+ * the ones passed to os_trace_void(), os_trace_u32() etc.
+ */
+#define TRACEBUF_ID_ISR_ENTER           (1)
+#define TRACEBUF_ID_ISR_EXIT            (2)
+#define TRACEBUF_ID_ISR_EXIT_TO_SCHED   (3)
+#define TRACEBUF_ID_TASK_INFO           (4)     /* task id, prio */
+#define TRACEBUF_ID_TASK_CREATE         (5)     /* task id */
+#define TRACEBUF_ID_TASK_START_EXEC     (6)     /* task id */
+#define TRACEBUF_ID_TASK_STOP_EXEC      (7)
+#define TRACEBUF_ID_TASK_START_READY    (8)     /* task id */
+#define TRACEBUF_ID_TASK_STOP_READY     (9)     /* task id, reason */
+#define TRACEBUF_ID_IDLE                (10)
+#define TRACEBUF_ID_TIMER_ENTER         (11)    /* timer id */
+#define TRACEBUF_ID_TIMER_EXIT          (12)
+#define TRACEBUF_ID_END_CALL            (13)    /* call id [, return value] */
+
+#define TRACEBUF_TASK_NONE              (0xff)
+
+/*
+ * One trace event.  Events with more than two parameters keep the first
+ * two; te_argc is the number recorded by the caller.
+ */
+struct tracebuf_entry {
+    uint32_t te_time;           /* os_cputime */
+    uint8_t te_id;
+    uint8_t te_task;            /* task running at the time, or NONE */
+    uint8_t te_argc;
+    uint8_t te_pad;
+    uint32_t te_arg[2];
+};
+
+/*
+ * Trace file layout: header, tfh_task_cnt task records, then tfh_entry_cnt
+ * entries, oldest first.  Host byte order.
+ */
+#define TRACEBUF_FILE_MAGIC             (0x3142544d)    /* "MTB1" */
+#define TRACEBUF_FILE_NAME_LEN          (28)
+
+struct tracebuf_file_hdr {
+    uint32_t tfh_magic;
+    uint32_t tfh_freq;          /* os_cputime ticks per second */
+    uint16_t tfh_entry_size;
+    uint16_t tfh_task_cnt;
+    uint32_t tfh_entry_cnt;
+    uint32_t tfh_lost;          /* events overwritten before the dump */
+};
+
+struct tracebuf_file_task {
+    uint8_t tft_id;
+    uint8_t tft_prio;
+    uint8_t tft_pad[2];
+    char tft_name[TRACEBUF_FILE_NAME_LEN];
+};
+
+int tracebuf_read(uint32_t seq, struct tracebuf_entry *entries, int max,
+                  uint32_t *first_seq);
+uint32_t tracebuf_head(void);
+void tracebuf_enable(int on);
+void tracebuf_clear(void);
+int tracebuf_dump_file(const char *path);
+int tracebuf_nmgr_register_group(void);
+void tracebuf_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
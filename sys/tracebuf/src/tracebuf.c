@@ -0,0 +1,363 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+#include <stdio.h>
+
+#include "syscfg/syscfg.h"
+#include "sysinit/sysinit.h"
+#include "os/os.h"
+#include "os/os_trace_api.h"
+#include "tracebuf/tracebuf.h"
+
+#if MYNEWT_VAL(OS_TRACEBUF)
+
+#ifdef ARCH_sim
+#include <stdlib.h>
+#endif
+
+#define TRACEBUF_ENTRIES    MYNEWT_VAL(TRACEBUF_ENTRIES)
+
+static struct tracebuf_entry tracebuf_entries[TRACEBUF_ENTRIES];
+
+/* Number of events recorded since the last clear. */
+static uint32_t tracebuf_seq;
+
+/* Recording from the start, so that tasks created in os_init() are seen. */
+static uint8_t tracebuf_on = 1;
+
+static void
+tracebuf_rec(uint8_t id, int argc, uint32_t arg0, uint32_t arg1)
+{
+    struct tracebuf_entry *te;
+    struct os_task *t;
+    os_sr_t sr;
+
+    if (!tracebuf_on) {
+        return;
+    }
+
+    OS_ENTER_CRITICAL(sr);
+    te = &tracebuf_entries[tracebuf_seq % TRACEBUF_ENTRIES];
+    tracebuf_seq++;
+
+    if (g_os_started) {
+        te->te_time = os_cputime_get32();
+    } else {
+        te->te_time = 0;
+    }
+    te->te_id = id;
+    t = os_sched_get_current_task();
+    te->te_task = t != NULL ? t->t_taskid : TRACEBUF_TASK_NONE;
+    te->te_argc = argc;
+    te->te_pad = 0;
+    te->te_arg[0] = arg0;
+    te->te_arg[1] = arg1;
+    OS_EXIT_CRITICAL(sr);
+}
+
+void
+os_trace_enter_isr(void)
+{
+    tracebuf_rec(TRACEBUF_ID_ISR_ENTER, 0, 0, 0);
+}
+
+void
+os_trace_exit_isr(void)
+{
+    tracebuf_rec(TRACEBUF_ID_ISR_EXIT, 0, 0, 0);
+}
+
+void
+os_trace_exit_isr_to_scheduler(void)
+{
+    tracebuf_rec(TRACEBUF_ID_ISR_EXIT_TO_SCHED, 0, 0, 0);
+}
+
+void
+os_trace_task_info(const struct os_task *t)
+{
+    tracebuf_rec(TRACEBUF_ID_TASK_INFO, 2, t->t_taskid, t->t_prio);
+}
+
+void
+os_trace_task_create(uint32_t task_id)
+{
+    tracebuf_rec(TRACEBUF_ID_TASK_CREATE, 1, task_id, 0);
+}
+
+void
+os_trace_task_start_exec(uint32_t task_id)
+{
+    tracebuf_rec(TRACEBUF_ID_TASK_START_EXEC, 1, task_id, 0);
+}
+
+void
+os_trace_task_stop_exec(void)
+{
+    tracebuf_rec(TRACEBUF_ID_TASK_STOP_EXEC, 0, 0, 0);
+}
+
+void
+os_trace_task_start_ready(uint32_t task_id)
+{
+    tracebuf_rec(TRACEBUF_ID_TASK_START_READY, 1, task_id, 0);
+}
+
+void
+os_trace_task_stop_ready(uint32_t task_id, unsigned reason)
+{
+    tracebuf_rec(TRACEBUF_ID_TASK_STOP_READY, 2, task_id, reason);
+}
+
+void
+os_trace_idle(void)
+{
+    tracebuf_rec(TRACEBUF_ID_IDLE, 0, 0, 0);
+}
+
+void
+os_trace_void(unsigned id)
+{
+    tracebuf_rec(id, 0, 0, 0);
+}
+
+void
+os_trace_u32(unsigned id, uint32_t para0)
+{
+    tracebuf_rec(id, 1, para0, 0);
+}
+
+void
+os_trace_u32x2(unsigned id, uint32_t para0, uint32_t para1)
+{
+    tracebuf_rec(id, 2, para0, para1);
+}
+
+void
+os_trace_u32x3(unsigned id, uint32_t para0, uint32_t para1, uint32_t para2)
+{
+    tracebuf_rec(id, 3, para0, para1);
+}
+
+void
+os_trace_u32x4(unsigned id, uint32_t para0, uint32_t para1, uint32_t para2,
+        uint32_t para3)
+{
+    tracebuf_rec(id, 4, para0, para1);
+}
+
+void
+os_trace_u32x5(unsigned id, uint32_t para0, uint32_t para1, uint32_t para2,
+        uint32_t para3, uint32_t para4)
+{
+    tracebuf_rec(id, 5, para0, para1);
+}
+
+void
+os_trace_enter_timer(uint32_t timer_id)
+{
+    tracebuf_rec(TRACEBUF_ID_TIMER_ENTER, 1, timer_id, 0);
+}
+
+void
+os_trace_exit_timer(void)
+{
+    tracebuf_rec(TRACEBUF_ID_TIMER_EXIT, 0, 0, 0);
+}
+
+void
+os_trace_end_call(unsigned id)
+{
+    tracebuf_rec(TRACEBUF_ID_END_CALL, 1, id, 0);
+}
+
+void
+os_trace_end_call_return_value(unsigned id, uint32_t return_value)
+{
+    tracebuf_rec(TRACEBUF_ID_END_CALL, 2, id, return_value);
+}
+
+/**
+ * Copies recorded events, oldest first.  Events are numbered from 0 since
+ * the last clear; only the last TRACEBUF_ENTRIES are kept.
+ *
+ * @param seq                   Number of the first event to read.  If it has
+ *                                  been overwritten already, reading starts
+ *                                  with the oldest event kept.
+ * @param entries               Buffer for the events.
+ * @param max                   Maximum number of events to read.
+ * @param first_seq             On return, the number of the first event
+ *                                  read.
+ *
+ * @return                      The number of events read.
+ */
+int
+tracebuf_read(uint32_t seq, struct tracebuf_entry *entries, int max,
+              uint32_t *first_seq)
+{
+    uint32_t oldest;
+    uint32_t head;
+    os_sr_t sr;
+    int cnt;
+
+    OS_ENTER_CRITICAL(sr);
+    head = tracebuf_seq;
+    if (head > TRACEBUF_ENTRIES) {
+        oldest = head - TRACEBUF_ENTRIES;
+    } else {
+        oldest = 0;
+    }
+    if (seq < oldest) {
+        seq = oldest;
+    }
+    if (seq > head) {
+        seq = head;
+    }
+
+    for (cnt = 0; cnt < max && seq + cnt != head; cnt++) {
+        entries[cnt] = tracebuf_entries[(seq + cnt) % TRACEBUF_ENTRIES];
+    }
+    OS_EXIT_CRITICAL(sr);
+
+    *first_seq = seq;
+    return cnt;
+}
+
+/**
+ * Returns the number of events recorded since the last clear.
+ */
+uint32_t
+tracebuf_head(void)
+{
+    return tracebuf_seq;
+}
+
+/**
+ * Starts or stops recording; e.g. stop before reading the trace out so that
+ * the events the readout causes do not overwrite it.
+ */
+void
+tracebuf_enable(int on)
+{
+    tracebuf_on = !!on;
+}
+
+void
+tracebuf_clear(void)
+{
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    tracebuf_seq = 0;
+    OS_EXIT_CRITICAL(sr);
+}
+
+#ifdef ARCH_sim
+/**
+ * Writes the trace to a file, in the format described in tracebuf.h.
+ *
+ * @return                      0 on success; -1 on failure.
+ */
+int
+tracebuf_dump_file(const char *path)
+{
+    struct tracebuf_entry entries[32];
+    struct tracebuf_file_task tft;
+    struct tracebuf_file_hdr tfh;
+    struct os_task_info oti;
+    struct os_task *prev;
+    uint32_t seq;
+    uint8_t on;
+    FILE *fp;
+    int cnt;
+    int rc;
+
+    fp = fopen(path, "wb");
+    if (fp == NULL) {
+        return -1;
+    }
+
+    on = tracebuf_on;
+    tracebuf_on = 0;
+
+    memset(&tfh, 0, sizeof tfh);
+    tfh.tfh_magic = TRACEBUF_FILE_MAGIC;
+    tfh.tfh_freq = MYNEWT_VAL(OS_CPUTIME_FREQ);
+    tfh.tfh_entry_size = sizeof(struct tracebuf_entry);
+    tfh.tfh_task_cnt = os_task_count();
+    tfh.tfh_entry_cnt = min(tracebuf_seq, TRACEBUF_ENTRIES);
+    tfh.tfh_lost = tracebuf_seq - tfh.tfh_entry_cnt;
+    rc = fwrite(&tfh, sizeof tfh, 1, fp) != 1;
+
+    prev = NULL;
+    while ((prev = os_task_info_get_next(prev, &oti)) != NULL) {
+        memset(&tft, 0, sizeof tft);
+        tft.tft_id = oti.oti_taskid;
+        tft.tft_prio = oti.oti_prio;
+        strncpy(tft.tft_name, oti.oti_name, sizeof tft.tft_name - 1);
+        rc |= fwrite(&tft, sizeof tft, 1, fp) != 1;
+    }
+
+    seq = 0;
+    while ((cnt = tracebuf_read(seq, entries,
+                                sizeof entries / sizeof entries[0],
+                                &seq)) > 0) {
+        rc |= fwrite(entries, sizeof entries[0], cnt, fp) != (size_t)cnt;
+        seq += cnt;
+    }
+
+    tracebuf_on = on;
+
+    rc |= fclose(fp) != 0;
+    return rc ? -1 : 0;
+}
+
+static void
+tracebuf_exit(void)
+{
+    tracebuf_dump_file(MYNEWT_VAL(TRACEBUF_NATIVE_FILE));
+}
+#endif
+
+#endif /* MYNEWT_VAL(OS_TRACEBUF) */
+
+void
+tracebuf_init(void)
+{
+#if MYNEWT_VAL(OS_TRACEBUF) && MYNEWT_VAL(TRACEBUF_NEWTMGR)
+    int rc;
+#endif
+
+    /* Ensure this function only gets called by sysinit. */
+    SYSINIT_ASSERT_ACTIVE();
+
+#if MYNEWT_VAL(OS_TRACEBUF)
+#if MYNEWT_VAL(TRACEBUF_NEWTMGR)
+    rc = tracebuf_nmgr_register_group();
+    SYSINIT_PANIC_ASSERT(rc == 0);
+#endif
+
+#ifdef ARCH_sim
+    if (MYNEWT_VAL(TRACEBUF_NATIVE_FILE)[0] != '\0') {
+        atexit(tracebuf_exit);
+    }
+#endif
+#endif
+}
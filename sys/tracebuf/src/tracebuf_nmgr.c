@@ -0,0 +1,185 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(OS_TRACEBUF) && MYNEWT_VAL(TRACEBUF_NEWTMGR)
+
+#include "os/os.h"
+#include "mgmt/mgmt.h"
+#include "cborattr/cborattr.h"
+#include "tracebuf/tracebuf.h"
+
+static int tracebuf_nmgr_read(struct mgmt_cbuf *cb);
+static int tracebuf_nmgr_tasks(struct mgmt_cbuf *cb);
+static int tracebuf_nmgr_ctrl(struct mgmt_cbuf *cb);
+
+static struct mgmt_group tracebuf_nmgr_group;
+
+#define TRACEBUF_NMGR_ID_READ   (0)
+#define TRACEBUF_NMGR_ID_TASKS  (1)
+#define TRACEBUF_NMGR_ID_CTRL   (2)
+
+/* ORDER MATTERS HERE.
+ * Each element represents the command ID, referenced from newtmgr.
+ */
+static struct mgmt_handler tracebuf_nmgr_group_handlers[] = {
+    [TRACEBUF_NMGR_ID_READ] = {tracebuf_nmgr_read, NULL},
+    [TRACEBUF_NMGR_ID_TASKS] = {tracebuf_nmgr_tasks, NULL},
+    [TRACEBUF_NMGR_ID_CTRL] = {NULL, tracebuf_nmgr_ctrl},
+};
+
+/*
+ * Returns up to TRACEBUF_NMGR_CHUNK events starting with event "off", as a
+ * byte string of struct tracebuf_entry.  The client continues from "next"
+ * until it reaches "head".
+ */
+static int
+tracebuf_nmgr_read(struct mgmt_cbuf *cb)
+{
+    struct tracebuf_entry entries[MYNEWT_VAL(TRACEBUF_NMGR_CHUNK)];
+    unsigned long long off;
+    uint32_t first;
+    struct cbor_attr_t attrs[] = {
+        { "off", CborAttrUnsignedIntegerType, .addr.uinteger = &off },
+        { NULL },
+    };
+    CborError g_err = CborNoError;
+    int cnt;
+
+    off = 0;
+    g_err = cbor_read_object(&cb->it, attrs);
+    if (g_err != 0) {
+        return MGMT_ERR_EINVAL;
+    }
+
+    cnt = tracebuf_read(off, entries, MYNEWT_VAL(TRACEBUF_NMGR_CHUNK),
+                        &first);
+
+    g_err |= cbor_encode_text_stringz(&cb->encoder, "rc");
+    g_err |= cbor_encode_int(&cb->encoder, MGMT_ERR_EOK);
+    g_err |= cbor_encode_text_stringz(&cb->encoder, "off");
+    g_err |= cbor_encode_uint(&cb->encoder, first);
+    g_err |= cbor_encode_text_stringz(&cb->encoder, "next");
+    g_err |= cbor_encode_uint(&cb->encoder, first + cnt);
+    g_err |= cbor_encode_text_stringz(&cb->encoder, "head");
+    g_err |= cbor_encode_uint(&cb->encoder, tracebuf_head());
+    g_err |= cbor_encode_text_stringz(&cb->encoder, "data");
+    g_err |= cbor_encode_byte_string(&cb->encoder, (uint8_t *)entries,
+                                     cnt * sizeof entries[0]);
+
+    if (g_err) {
+        return MGMT_ERR_ENOMEM;
+    }
+    return (0);
+}
+
+/*
+ * Lists the tasks, for naming the task IDs in the trace.
+ */
+static int
+tracebuf_nmgr_tasks(struct mgmt_cbuf *cb)
+{
+    struct os_task_info oti;
+    struct os_task *prev;
+    CborError g_err = CborNoError;
+    CborEncoder tasks;
+    CborEncoder task;
+
+    g_err |= cbor_encode_text_stringz(&cb->encoder, "rc");
+    g_err |= cbor_encode_int(&cb->encoder, MGMT_ERR_EOK);
+    g_err |= cbor_encode_text_stringz(&cb->encoder, "freq");
+    g_err |= cbor_encode_uint(&cb->encoder, MYNEWT_VAL(OS_CPUTIME_FREQ));
+    g_err |= cbor_encode_text_stringz(&cb->encoder, "tasks");
+    g_err |= cbor_encoder_create_array(&cb->encoder, &tasks,
+                                       CborIndefiniteLength);
+
+    prev = NULL;
+    while ((prev = os_task_info_get_next(prev, &oti)) != NULL) {
+        g_err |= cbor_encoder_create_map(&tasks, &task, CborIndefiniteLength);
+        g_err |= cbor_encode_text_stringz(&task, "id");
+        g_err |= cbor_encode_uint(&task, oti.oti_taskid);
+        g_err |= cbor_encode_text_stringz(&task, "prio");
+        g_err |= cbor_encode_uint(&task, oti.oti_prio);
+        g_err |= cbor_encode_text_stringz(&task, "name");
+        g_err |= cbor_encode_text_stringz(&task, oti.oti_name);
+        g_err |= cbor_encoder_close_container(&tasks, &task);
+    }
+    g_err |= cbor_encoder_close_container(&cb->encoder, &tasks);
+
+    if (g_err) {
+        return MGMT_ERR_ENOMEM;
+    }
+    return (0);
+}
+
+/*
+ * {"enable": 0|1, "clear": 0|1}; both optional.
+ */
+static int
+tracebuf_nmgr_ctrl(struct mgmt_cbuf *cb)
+{
+    long long int enable;
+    bool clear;
+    struct cbor_attr_t attrs[] = {
+        { "enable", CborAttrIntegerType, .addr.integer = &enable },
+        { "clear", CborAttrBooleanType, .addr.boolean = &clear },
+        { NULL },
+    };
+    CborError g_err = CborNoError;
+
+    enable = -1;
+    clear = false;
+    g_err = cbor_read_object(&cb->it, attrs);
+    if (g_err != 0) {
+        return MGMT_ERR_EINVAL;
+    }
+
+    if (clear) {
+        tracebuf_clear();
+    }
+    if (enable >= 0) {
+        tracebuf_enable(enable);
+    }
+
+    g_err |= cbor_encode_text_stringz(&cb->encoder, "rc");
+    g_err |= cbor_encode_int(&cb->encoder, MGMT_ERR_EOK);
+
+    if (g_err) {
+        return MGMT_ERR_ENOMEM;
+    }
+    return (0);
+}
+
+/**
+ * Register nmgr group handlers
+ */
+int
+tracebuf_nmgr_register_group(void)
+{
+    MGMT_GROUP_SET_HANDLERS(&tracebuf_nmgr_group,
+                            tracebuf_nmgr_group_handlers);
+    tracebuf_nmgr_group.mg_group_id = MGMT_GROUP_ID_TRACE;
+
+    return mgmt_group_register(&tracebuf_nmgr_group);
+}
+
+#endif /* MYNEWT_VAL(OS_TRACEBUF) && MYNEWT_VAL(TRACEBUF_NEWTMGR) */
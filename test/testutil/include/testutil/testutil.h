@@ -134,6 +134,12 @@ struct ts_config {
 
 void tu_restart(void);
 
+/**
+ * Returns a free-running microsecond count for timing benchmarks.  Only
+ * differences between two readings are meaningful; the count wraps.
+ */
+uint32_t tu_time_usecs(void);
+
 /*
  * Public declarations - test case configuration
  */
@@ -26,6 +26,9 @@
 
 #include <errno.h>
 #include <unistd.h>
+#if MYNEWT_VAL(SELFTEST)
+#include <sys/time.h>
+#endif
 
 struct tc_config tc_config;
 struct tc_config *tc_current_config = &tc_config;
@@ -60,6 +63,20 @@ tu_arch_restart(void)
 #endif
 }
 
+uint32_t
+tu_time_usecs(void)
+{
+#if MYNEWT_VAL(SELFTEST)
+    struct timeval tv;
+
+    /* The simulated OS clock only advances with OS ticks; use the host's. */
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000000 + tv.tv_usec;
+#else
+    return os_cputime_ticks_to_usecs(os_cputime_get32());
+#endif
+}
+
 void
 tu_restart(void)
 {
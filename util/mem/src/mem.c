@@ -170,9 +170,11 @@ mem_init_mbuf_pool(void *mem, struct os_mempool *mempool,
  * Splits an appropriately-sized fragment from the front of an mbuf chain, as
  * neeeded.  If the length of the mbuf chain greater than specified maximum
  * fragment size, a new mbuf is allocated, and data is moved from the source
- * mbuf to the new mbuf.  If the mbuf chain is small enough to fit in a single
- * fragment, the source mbuf itself is returned unmodified, and the suplied
- * pointer is set to NULL.
+ * mbuf to the new mbuf.  Only the data in the source's packet header mbuf and
+ * in the one mbuf that straddles the fragment boundary is copied; mbufs in
+ * between are moved to the fragment as-is.  If the mbuf chain is small enough
+ * to fit in a single fragment, the source mbuf itself is returned
+ * unmodified, and the suplied pointer is set to NULL.
  *
  * This function is expected to be called in a loop until the entire mbuf chain
  * has been consumed.  For example:
@@ -205,41 +207,98 @@ mem_init_mbuf_pool(void *mem, struct os_mempool *mempool,
  *                                  callback function.
  *
  * @return                      The next fragment to send on success;
- *                              NULL on failure.
+ *                              NULL on failure.  On failure the source mbuf
+ *                              chain is left unmodified.
  */
 struct os_mbuf *
 mem_split_frag(struct os_mbuf **om, uint16_t max_frag_sz,
                mem_frag_alloc_fn *alloc_cb, void *cb_arg)
 {
     struct os_mbuf *frag;
+    struct os_mbuf *head;
+    struct os_mbuf *first;
+    struct os_mbuf *last;
+    struct os_mbuf *cur;
+    struct os_mbuf *tmp;
+    uint16_t head_len;
+    uint16_t left;
     int rc;
 
-    if (OS_MBUF_PKTLEN(*om) <= max_frag_sz) {
+    head = *om;
+    if (OS_MBUF_PKTLEN(head) <= max_frag_sz) {
         /* Final fragment. */
-        frag = *om;
         *om = NULL;
-        return frag;
+        return head;
     }
 
     /* Packet needs to be split.  Allocate a new buffer for the fragment. */
     frag = alloc_cb(max_frag_sz, cb_arg);
     if (frag == NULL) {
-        goto err;
+        return NULL;
     }
+    tmp = NULL;
 
-    /* Move data from the front of the packet into the fragment mbuf. */
-    rc = os_mbuf_appendfrom(frag, *om, 0, max_frag_sz);
+    /* The packet header mbuf stays at the front of the source; copy its
+     * data.
+     */
+    head_len = min(head->om_len, max_frag_sz);
+    rc = os_mbuf_append(frag, head->om_data, head_len);
     if (rc != 0) {
         goto err;
     }
-    os_mbuf_adj(*om, max_frag_sz);
+    left = max_frag_sz - head_len;
+
+    /* Find the whole mbufs that follow and belong to the fragment. */
+    first = SLIST_NEXT(head, om_next);
+    last = NULL;
+    cur = first;
+    while (left > 0 && cur->om_len <= left) {
+        left -= cur->om_len;
+        last = cur;
+        cur = SLIST_NEXT(cur, om_next);
+    }
+
+    /* Copy the front of the mbuf that straddles the boundary, if any.  It
+     * goes after the moved mbufs, so it needs an mbuf of its own then.
+     */
+    if (left > 0) {
+        if (last == NULL) {
+            rc = os_mbuf_append(frag, cur->om_data, left);
+        } else {
+            tmp = os_mbuf_get(cur->om_omp, 0);
+            if (tmp == NULL) {
+                goto err;
+            }
+            rc = os_mbuf_append(tmp, cur->om_data, left);
+        }
+        if (rc != 0) {
+            goto err;
+        }
+    }
+
+    /* Nothing can fail from here on; cut the source. */
+    head->om_data += head_len;
+    head->om_len -= head_len;
+    if (last != NULL) {
+        SLIST_NEXT(head, om_next) = cur;
+        SLIST_NEXT(last, om_next) = tmp;
+        os_mbuf_concat(frag, first);
+    }
+    if (left > 0) {
+        cur->om_data += left;
+        cur->om_len -= left;
+    }
+    OS_MBUF_PKTHDR(head)->omp_len -= max_frag_sz;
 
     /* Free unused portion of of source mbuf chain, if possible. */
-    *om = os_mbuf_trim_front(*om);
+    *om = os_mbuf_trim_front(head);
 
     return frag;
 
 err:
+    if (tmp != NULL) {
+        os_mbuf_free(tmp);
+    }
     os_mbuf_free_chain(frag);
     return NULL;
 }
@@ -0,0 +1,208 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "sysinit/sysinit.h"
+#include "mem_test.h"
+
+static os_membuf_t mem_test_src_buf[
+    OS_MEMPOOL_SIZE(MEM_TEST_BUF_COUNT, MEM_TEST_BUF_SIZE)];
+static os_membuf_t mem_test_frag_buf[
+    OS_MEMPOOL_SIZE(MEM_TEST_BUF_COUNT, MEM_TEST_BUF_SIZE)];
+static struct os_mempool mem_test_src_mempool;
+static struct os_mempool mem_test_frag_mempool;
+struct os_mbuf_pool mem_test_src_pool;
+struct os_mbuf_pool mem_test_frag_pool;
+
+static uint8_t mem_test_data[MEM_TEST_DATA_LEN];
+static const uint8_t mem_test_usrhdr[MEM_TEST_USRHDR_LEN] = {
+    0xa1, 0xb2, 0xc3, 0xd4
+};
+
+/* When set, mem_test_frag_alloc() fails */
+int mem_test_alloc_fail;
+
+void
+mem_test_setup(void *arg)
+{
+    int rc;
+    int i;
+
+    rc = mem_init_mbuf_pool(mem_test_src_buf, &mem_test_src_mempool,
+                            &mem_test_src_pool, MEM_TEST_BUF_COUNT,
+                            MEM_TEST_BUF_SIZE, "mem_test_src");
+    TEST_ASSERT_FATAL(rc == 0);
+
+    rc = mem_init_mbuf_pool(mem_test_frag_buf, &mem_test_frag_mempool,
+                            &mem_test_frag_pool, MEM_TEST_BUF_COUNT,
+                            MEM_TEST_BUF_SIZE, "mem_test_frag");
+    TEST_ASSERT_FATAL(rc == 0);
+
+    for (i = 0; i < MEM_TEST_DATA_LEN; i++) {
+        mem_test_data[i] = i;
+    }
+
+    mem_test_alloc_fail = 0;
+}
+
+/**
+ * Builds a packet of consecutive test data, with a user header, in a chain
+ * of num mbufs holding lens[i] bytes each.
+ */
+struct os_mbuf *
+mem_test_chain(const int *lens, int num)
+{
+    struct os_mbuf *om;
+    struct os_mbuf *m;
+    int off;
+    int rc;
+    int i;
+
+    om = os_mbuf_get_pkthdr(&mem_test_src_pool, MEM_TEST_USRHDR_LEN);
+    TEST_ASSERT_FATAL(om != NULL);
+    memcpy(OS_MBUF_USRHDR(om), mem_test_usrhdr, MEM_TEST_USRHDR_LEN);
+
+    off = 0;
+    for (i = 0; i < num; i++) {
+        if (i == 0) {
+            m = om;
+        } else {
+            m = os_mbuf_get(&mem_test_src_pool, 0);
+            TEST_ASSERT_FATAL(m != NULL);
+        }
+
+        TEST_ASSERT_FATAL(OS_MBUF_TRAILINGSPACE(m) >= lens[i]);
+        memcpy(m->om_data, mem_test_data + off, lens[i]);
+        m->om_len = lens[i];
+        off += lens[i];
+
+        if (i == 0) {
+            OS_MBUF_PKTHDR(om)->omp_len = lens[i];
+        } else {
+            os_mbuf_concat(om, m);
+        }
+    }
+
+    rc = os_mbuf_cmpf(om, 0, mem_test_data, off);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    return om;
+}
+
+/**
+ * Allocates a fragment and copies the user header of the source packet,
+ * like the newtmgr transports do.
+ */
+struct os_mbuf *
+mem_test_frag_alloc(uint16_t frag_size, void *arg)
+{
+    struct os_mbuf *src;
+    struct os_mbuf *frag;
+
+    if (mem_test_alloc_fail) {
+        return NULL;
+    }
+
+    src = arg;
+    frag = os_mbuf_get_pkthdr(&mem_test_frag_pool, OS_MBUF_USRHDR_LEN(src));
+    if (frag != NULL) {
+        memcpy(OS_MBUF_USRHDR(frag), OS_MBUF_USRHDR(src),
+               OS_MBUF_USRHDR_LEN(src));
+    }
+
+    return frag;
+}
+
+/**
+ * Checks that a packet holds test data [off, off + len), that its packet
+ * header length matches its mbufs, and that it carries the user header.
+ */
+void
+mem_test_verify(struct os_mbuf *om, int off, int len)
+{
+    struct os_mbuf *cur;
+    int totlen;
+
+    TEST_ASSERT_FATAL(om != NULL);
+    TEST_ASSERT_FATAL(OS_MBUF_IS_PKTHDR(om));
+    TEST_ASSERT(OS_MBUF_PKTLEN(om) == len);
+
+    totlen = 0;
+    for (cur = om; cur != NULL; cur = SLIST_NEXT(cur, om_next)) {
+        if (cur != om) {
+            TEST_ASSERT(!OS_MBUF_IS_PKTHDR(cur));
+        }
+        totlen += cur->om_len;
+    }
+    TEST_ASSERT(totlen == len);
+
+    TEST_ASSERT(os_mbuf_cmpf(om, 0, mem_test_data + off, len) == 0);
+
+    TEST_ASSERT(OS_MBUF_USRHDR_LEN(om) == MEM_TEST_USRHDR_LEN);
+    TEST_ASSERT(memcmp(OS_MBUF_USRHDR(om), mem_test_usrhdr,
+                       MEM_TEST_USRHDR_LEN) == 0);
+}
+
+/**
+ * Checks that a split put the front of the packet in the allocated fragment
+ * and left the rest in the source packet.
+ */
+void
+mem_test_verify_split(struct os_mbuf *frag, struct os_mbuf *om)
+{
+    TEST_ASSERT_FATAL(frag != NULL && om != NULL);
+    TEST_ASSERT(frag->om_omp == &mem_test_frag_pool);
+    TEST_ASSERT(om->om_omp == &mem_test_src_pool);
+}
+
+/**
+ * Checks that every mbuf was returned to its pool.
+ */
+void
+mem_test_verify_pools(void)
+{
+    TEST_ASSERT(mem_test_src_mempool.mp_num_free == MEM_TEST_BUF_COUNT);
+    TEST_ASSERT(mem_test_frag_mempool.mp_num_free == MEM_TEST_BUF_COUNT);
+}
+
+TEST_CASE_DECL(mem_test_split_frag_boundary)
+TEST_CASE_DECL(mem_test_split_frag_inside)
+TEST_CASE_DECL(mem_test_split_frag_single)
+TEST_CASE_DECL(mem_test_split_frag_fail)
+
+TEST_SUITE(mem_test_suite)
+{
+    mem_test_split_frag_boundary();
+    mem_test_split_frag_inside();
+    mem_test_split_frag_single();
+    mem_test_split_frag_fail();
+}
+
+#if MYNEWT_VAL(SELFTEST)
+
+int
+main(int argc, char **argv)
+{
+    sysinit();
+
+    tu_suite_set_init_cb(mem_test_setup, NULL);
+    mem_test_suite();
+
+    return tu_any_failed;
+}
+
+#endif
@@ -0,0 +1,52 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef __MEM_TEST_H
+#define __MEM_TEST_H
+
+#include <string.h>
+#include "syscfg/syscfg.h"
+#include "testutil/testutil.h"
+#include "os/os.h"
+#include "mem/mem.h"
+
+#define MEM_TEST_BUF_SIZE       (128)
+#define MEM_TEST_BUF_COUNT      (8)
+#define MEM_TEST_USRHDR_LEN     (4)
+#define MEM_TEST_DATA_LEN       (256)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern struct os_mbuf_pool mem_test_src_pool;
+extern struct os_mbuf_pool mem_test_frag_pool;
+extern int mem_test_alloc_fail;
+
+void mem_test_setup(void *arg);
+struct os_mbuf *mem_test_chain(const int *lens, int num);
+struct os_mbuf *mem_test_frag_alloc(uint16_t frag_size, void *arg);
+void mem_test_verify(struct os_mbuf *om, int off, int len);
+void mem_test_verify_split(struct os_mbuf *frag, struct os_mbuf *om);
+void mem_test_verify_pools(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MEM_TEST_H */
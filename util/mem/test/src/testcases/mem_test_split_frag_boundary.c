@@ -0,0 +1,52 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "mem_test.h"
+
+TEST_CASE(mem_test_split_frag_boundary)
+{
+    static const int lens[] = { 20, 20, 20 };
+    struct os_mbuf *frag;
+    struct os_mbuf *om;
+
+    /* Cut after the packet header mbuf */
+    om = mem_test_chain(lens, 3);
+    frag = mem_split_frag(&om, 20, mem_test_frag_alloc, om);
+    mem_test_verify_split(frag, om);
+    mem_test_verify(frag, 0, 20);
+    mem_test_verify(om, 20, 40);
+    os_mbuf_free_chain(frag);
+    os_mbuf_free_chain(om);
+    mem_test_verify_pools();
+
+    /* Cut between the second and third mbufs; the second one is moved */
+    om = mem_test_chain(lens, 3);
+    frag = mem_split_frag(&om, 40, mem_test_frag_alloc, om);
+    mem_test_verify_split(frag, om);
+    mem_test_verify(frag, 0, 40);
+    mem_test_verify(om, 40, 20);
+
+    /* What is left is a single fragment */
+    os_mbuf_free_chain(frag);
+    frag = mem_split_frag(&om, 20, mem_test_frag_alloc, om);
+    TEST_ASSERT_FATAL(frag != NULL);
+    TEST_ASSERT(om == NULL);
+    mem_test_verify(frag, 40, 20);
+    os_mbuf_free_chain(frag);
+    mem_test_verify_pools();
+}
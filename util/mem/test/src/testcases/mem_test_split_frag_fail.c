@@ -0,0 +1,65 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "mem_test.h"
+
+TEST_CASE(mem_test_split_frag_fail)
+{
+    static const int lens[] = { 10, 20, 20 };
+    struct os_mbuf *hoard[MEM_TEST_BUF_COUNT + 1];
+    struct os_mbuf *frag;
+    struct os_mbuf *src;
+    struct os_mbuf *om;
+    int num;
+    int i;
+
+    /* The fragment can't be allocated */
+    om = mem_test_chain(lens, 3);
+    src = om;
+    mem_test_alloc_fail = 1;
+    frag = mem_split_frag(&om, 20, mem_test_frag_alloc, om);
+    mem_test_alloc_fail = 0;
+    TEST_ASSERT(frag == NULL);
+    TEST_ASSERT_FATAL(om == src);
+    mem_test_verify(om, 0, 50);
+
+    /* The front of the straddling mbuf can't be copied; the source is
+     * left intact and the fragment is freed.
+     */
+    num = 0;
+    while ((hoard[num] = os_mbuf_get(&mem_test_src_pool, 0)) != NULL) {
+        num++;
+    }
+    frag = mem_split_frag(&om, 40, mem_test_frag_alloc, om);
+    TEST_ASSERT(frag == NULL);
+    TEST_ASSERT_FATAL(om == src);
+    mem_test_verify(om, 0, 50);
+
+    for (i = 0; i < num; i++) {
+        os_mbuf_free(hoard[i]);
+    }
+
+    /* With memory back, the same split succeeds */
+    frag = mem_split_frag(&om, 40, mem_test_frag_alloc, om);
+    mem_test_verify_split(frag, om);
+    mem_test_verify(frag, 0, 40);
+    mem_test_verify(om, 40, 10);
+    os_mbuf_free_chain(frag);
+    os_mbuf_free_chain(om);
+    mem_test_verify_pools();
+}
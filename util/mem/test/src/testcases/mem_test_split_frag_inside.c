@@ -0,0 +1,72 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "mem_test.h"
+
+TEST_CASE(mem_test_split_frag_inside)
+{
+    static const int lens[] = { 20, 20, 20 };
+    struct os_mbuf *frag;
+    struct os_mbuf *om;
+    int off;
+
+    /* Cut inside the packet header mbuf */
+    om = mem_test_chain(lens, 3);
+    frag = mem_split_frag(&om, 10, mem_test_frag_alloc, om);
+    mem_test_verify_split(frag, om);
+    mem_test_verify(frag, 0, 10);
+    mem_test_verify(om, 10, 50);
+    os_mbuf_free_chain(frag);
+    os_mbuf_free_chain(om);
+
+    /* Cut inside the mbuf right after the packet header mbuf */
+    om = mem_test_chain(lens, 3);
+    frag = mem_split_frag(&om, 30, mem_test_frag_alloc, om);
+    mem_test_verify_split(frag, om);
+    mem_test_verify(frag, 0, 30);
+    mem_test_verify(om, 30, 30);
+    os_mbuf_free_chain(frag);
+    os_mbuf_free_chain(om);
+
+    /* Cut inside the third mbuf, after one that is moved whole */
+    om = mem_test_chain(lens, 3);
+    frag = mem_split_frag(&om, 50, mem_test_frag_alloc, om);
+    mem_test_verify_split(frag, om);
+    mem_test_verify(frag, 0, 50);
+    mem_test_verify(om, 50, 10);
+    os_mbuf_free_chain(frag);
+    os_mbuf_free_chain(om);
+    mem_test_verify_pools();
+
+    /* Send the whole packet in fragments */
+    om = mem_test_chain(lens, 3);
+    off = 0;
+    while (om != NULL) {
+        frag = mem_split_frag(&om, 25, mem_test_frag_alloc, om);
+        TEST_ASSERT_FATAL(frag != NULL);
+        mem_test_verify(frag, off, min(25, 60 - off));
+        if (om != NULL) {
+            mem_test_verify_split(frag, om);
+            mem_test_verify(om, off + 25, 60 - off - 25);
+        }
+        off += OS_MBUF_PKTLEN(frag);
+        os_mbuf_free_chain(frag);
+    }
+    TEST_ASSERT(off == 60);
+    mem_test_verify_pools();
+}
@@ -0,0 +1,48 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "mem_test.h"
+
+TEST_CASE(mem_test_split_frag_single)
+{
+    static const int lens[] = { 10, 20 };
+    struct os_mbuf *frag;
+    struct os_mbuf *src;
+    struct os_mbuf *om;
+
+    /* A packet that fits is returned as is */
+    om = mem_test_chain(lens, 2);
+    src = om;
+    frag = mem_split_frag(&om, 30, mem_test_frag_alloc, om);
+    TEST_ASSERT(frag == src);
+    TEST_ASSERT(om == NULL);
+    mem_test_verify(frag, 0, 30);
+    os_mbuf_free_chain(frag);
+
+    /* The allocator is not called */
+    mem_test_alloc_fail = 1;
+    om = mem_test_chain(lens, 2);
+    src = om;
+    frag = mem_split_frag(&om, 100, mem_test_frag_alloc, om);
+    mem_test_alloc_fail = 0;
+    TEST_ASSERT(frag == src);
+    TEST_ASSERT(om == NULL);
+    mem_test_verify(frag, 0, 30);
+    os_mbuf_free_chain(frag);
+    mem_test_verify_pools();
+}